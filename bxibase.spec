@@ -249,6 +249,7 @@ test "x$RPM_BUILD_ROOT" != "x" && rm -rf $RPM_BUILD_ROOT
 
 %files devel
 %{_includedir}/bxi/base/*.h
+%{_includedir}/bxi/base/*.hpp
 %{_includedir}/bxi/base/log/*.h
 %if 0%{?python_name}
 %files -n python%{pythonname:}-%{name}-devel
@@ -0,0 +1,102 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+/*
+ * Measure the cost of reporting many identical errors.
+ *
+ * Errors created at the same place share the same return addresses: only the
+ * first report has to symbolize them, the following ones hit the symbolization
+ * cache. Display the time taken by the first (cold) report, the average time
+ * of the following (warm) ones, and the same for bxierr_backtrace_str().
+ *
+ * Usage: bench-bxierr-report [errors_nb]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <bxi/base/err.h>
+#include <bxi/base/mem.h>
+#include <bxi/base/time.h>
+
+#define DEFAULT_ERRORS_NB 10000
+
+static bxierr_p _fail(size_t i) {
+    return bxierr_gen("Error %zu", i);
+}
+
+static double _since(struct timespec start) {
+    double duration;
+    bxierr_p err = bxitime_duration(CLOCK_MONOTONIC, start, &duration);
+    bxierr_abort_ifko(err);
+    return duration;
+}
+
+static void _bench_report(size_t errors_nb) {
+    bxierr_p * errors = bximem_calloc(errors_nb * sizeof(*errors));
+    struct timespec start;
+    bxierr_p err;
+
+    err = bxitime_get(CLOCK_MONOTONIC, &start);
+    bxierr_abort_ifko(err);
+    for (size_t i = 0; i < errors_nb; i++) {
+        errors[i] = _fail(i);
+    }
+    double create_duration = _since(start);
+
+    double cold = 0, warm = 0;
+    for (size_t i = 0; i < errors_nb; i++) {
+        err = bxitime_get(CLOCK_MONOTONIC, &start);
+        bxierr_abort_ifko(err);
+        char * str = bxierr_str(errors[i]);
+        double duration = _since(start);
+        if (0 == i) cold = duration; else warm += duration;
+        BXIFREE(str);
+        bxierr_destroy(&errors[i]);
+    }
+    BXIFREE(errors);
+
+    printf("%-22s %12.1f %12.1f %12.1f\n", "bxierr_str()",
+           create_duration * 1e6 / (double) errors_nb, cold * 1e6,
+           (errors_nb > 1) ? warm * 1e6 / (double) (errors_nb - 1) : 0);
+}
+
+static void _bench_backtrace(size_t errors_nb) {
+    struct timespec start;
+    double cold = 0, warm = 0;
+
+    for (size_t i = 0; i < errors_nb; i++) {
+        bxierr_p err = bxitime_get(CLOCK_MONOTONIC, &start);
+        bxierr_abort_ifko(err);
+        char * str = NULL;
+        bxierr_backtrace_str(&str);
+        double duration = _since(start);
+        if (0 == i) cold = duration; else warm += duration;
+        BXIFREE(str);
+    }
+
+    printf("%-22s %12s %12.1f %12.1f\n", "bxierr_backtrace_str()", "-", cold * 1e6,
+           (errors_nb > 1) ? warm * 1e6 / (double) (errors_nb - 1) : 0);
+}
+
+int main(int argc, char * argv[]) {
+    size_t errors_nb = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_ERRORS_NB;
+
+    printf("%zu identical errors\n", errors_nb);
+    printf("%-22s %12s %12s %12s\n", "", "create us", "cold us", "warm us");
+    _bench_report(errors_nb);
+    _bench_backtrace(errors_nb);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,144 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+/*
+ * Compare the C macros (printf like formats) with the C++ front end of log.hpp
+ * (compile time `{}` formats).
+ *
+ * A single thread produces logs_nb logs to the null handler with each front end,
+ * for a few typical formats, once at an enabled level and once at a disabled one.
+ * The mean duration of a call, bxilog_flush() included, is displayed.
+ *
+ * Usage: bench-cxx [-i] [-n logs_nb]
+ *
+ *      -i          run the null handler inline (see BXILOG_HANDLERS_INLINE)
+ */
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <string>
+
+#include <bxi/base/log.hpp>
+
+extern "C" {
+#include <bxi/base/time.h>
+#include <bxi/base/log/null_handler.h>
+}
+
+#define DEFAULT_LOGS_NB 1000000
+
+SET_LOGGER(LOGGER, "bxi.base.bench.cxx");
+
+static size_t LOGS_NB = DEFAULT_LOGS_NB;
+
+static double _run(void (*produce)(size_t));
+static void _compare(const char * name, void (*c)(size_t), void (*cxx)(size_t));
+
+// One pair of producers per format: the same message by both front ends
+
+static void _c_int(size_t i) {
+    INFO(LOGGER, "Processing item %zu of the batch", i);
+}
+
+static void _cxx_int(size_t i) {
+    BXILOG_LOG(LOGGER, BXILOG_INFO, "Processing item {} of the batch", i);
+}
+
+static void _c_mixed(size_t i) {
+    INFO(LOGGER, "Node %s: %d retries, %zu bytes, ratio %g", "node-42", 3, i, 0.75);
+}
+
+static void _cxx_mixed(size_t i) {
+    BXILOG_LOG(LOGGER, BXILOG_INFO, "Node {}: {} retries, {} bytes, ratio {}",
+               "node-42", 3, i, 0.75);
+}
+
+static const std::string LONG_STR(256, 'x');
+
+static void _c_string(size_t i) {
+    INFO(LOGGER, "%zu: %s", i, LONG_STR.c_str());
+}
+
+static void _cxx_string(size_t i) {
+    BXILOG_LOG(LOGGER, BXILOG_INFO, "{}: {}", i, LONG_STR);
+}
+
+static void _c_disabled(size_t i) {
+    DEBUG(LOGGER, "Processing item %zu of the batch", i);
+}
+
+static void _cxx_disabled(size_t i) {
+    BXILOG_LOG(LOGGER, BXILOG_DEBUG, "Processing item {} of the batch", i);
+}
+
+int main(int argc, char * argv[]) {
+    bxilog_handlers_mode_e mode = BXILOG_HANDLERS_THREADED;
+
+    int opt;
+    while (-1 != (opt = getopt(argc, argv, "in:"))) {
+        switch (opt) {
+            case 'i': mode = BXILOG_HANDLERS_INLINE; break;
+            case 'n': LOGS_NB = strtoul(optarg, NULL, 10); break;
+            default:
+                fprintf(stderr, "Usage: %s [-i] [-n logs_nb]\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    bxilog_config_p config = bxilog_config_new("bench-cxx");
+    config->handlers_mode = mode;
+    bxilog_filters_p filters = bxilog_filters_new();
+    bxilog_filters_add(&filters, "", BXILOG_INFO);
+    bxilog_config_add_handler(config, BXILOG_NULL_HANDLER, filters);
+    bxierr_p err = bxilog_init(config);
+    bxierr_abort_ifko(err);
+
+    printf("%-12s %12s %12s\n", "format", "C ns/op", "C++ ns/op");
+    _compare("int", _c_int, _cxx_int);
+    _compare("mixed", _c_mixed, _cxx_mixed);
+    _compare("string", _c_string, _cxx_string);
+    _compare("disabled", _c_disabled, _cxx_disabled);
+
+    err = bxilog_finalize();
+    bxierr_abort_ifko(err);
+
+    return EXIT_SUCCESS;
+}
+
+//*********************************************************************************
+//********************************** Static Helpers Implementation ****************
+//*********************************************************************************
+
+// Return the mean duration of a call in ns
+double _run(void (*produce)(size_t)) {
+    struct timespec start;
+    bxierr_p err = bxitime_get(CLOCK_MONOTONIC, &start);
+    bxierr_abort_ifko(err);
+    for (size_t i = 0; i < LOGS_NB; i++) produce(i);
+    err = bxilog_flush();
+    bxierr_abort_ifko(err);
+
+    double duration;
+    err = bxitime_duration(CLOCK_MONOTONIC, start, &duration);
+    bxierr_abort_ifko(err);
+    return duration * 1e9 / (double) LOGS_NB;
+}
+
+void _compare(const char * name, void (*c)(size_t), void (*cxx)(size_t)) {
+    const double c_ns = _run(c);
+    const double cxx_ns = _run(cxx);
+    printf("%-12s %12.1f %12.1f\n", name, c_ns, cxx_ns);
+}
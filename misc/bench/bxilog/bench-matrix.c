@@ -0,0 +1,345 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+/*
+ * Measure the cost of a log call over a matrix of scenarios:
+ *
+ *      threads x handlers x message size x filtered ratio x multi-line
+ *
+ * For each scenario, bxilog is initialized with the given handlers, each thread
+ * produces logs_nb logs of the given size, at a level rejected by the handlers
+ * filters for the given percentage of them, and with a '\n' every
+ * MULTILINE_WIDTH bytes in multi-line mode. The duration of each call is recorded
+ * in a bxilog_histogram_s, the throughput includes the final bxilog_flush().
+ *
+ * A summary is displayed for each scenario and all results are written in JSON to
+ * the given output file so they can be compared across commits.
+ *
+ * Usage: bench-matrix [-i] [-n logs_nb] [-t threads,...] [-H handlers,...]
+ *                     [-s sizes,...] [-f filtered_percents,...] [-l label]
+ *                     [-o output.json]
+ *
+ *      -i          run the handlers inline (see BXILOG_HANDLERS_INLINE)
+ *      -H          a list of handlers set, each made of handlers separated by '+'
+ *                  among "null" and "file", e.g: "null,file,null+file"
+ *      -l          a label stored in the JSON output, such as a commit id
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <bxi/base/err.h>
+#include <bxi/base/mem.h>
+#include <bxi/base/str.h>
+#include <bxi/base/time.h>
+#include <bxi/base/log.h>
+#include <bxi/base/log/null_handler.h>
+#include <bxi/base/log/file_handler.h>
+
+#define DEFAULT_LOGS_NB 100000
+#define DEFAULT_THREADS "1,4"
+#define DEFAULT_HANDLERS "null,file"
+#define DEFAULT_SIZES "32,256,4096"
+#define DEFAULT_FILTERED "0,90"
+#define DEFAULT_OUTPUT "bench-matrix.json"
+#define MULTILINE_WIDTH 80
+#define MAX_VALUES 16
+
+typedef struct {
+    size_t values[MAX_VALUES];
+    size_t nb;
+} list_s;
+
+typedef struct {
+    size_t threads_nb;
+    const char * handlers;
+    size_t size;
+    size_t filtered_pct;
+    bool multiline;
+} scenario_s;
+
+typedef struct {
+    const scenario_s * scenario;
+    size_t logs_nb;
+    pthread_barrier_t * barrier;
+    bxilog_histogram_s latency;
+} thread_data_s;
+
+SET_LOGGER(LOGGER, "bxi.base.bench.matrix");
+
+static const char * LOGFILE = "/tmp/bench-matrix.log";
+
+static list_s _parse_list(const char * str);
+static char * _new_msg(size_t size, bool multiline);
+static void * _logging_thread(void * param);
+static void _merge(bxilog_histogram_p self, const bxilog_histogram_p other);
+static bxilog_config_p _new_config(const char * handlers, bxilog_handlers_mode_e mode);
+static void _bench(FILE * out, bool first, const scenario_s * scenario,
+                   bxilog_handlers_mode_e mode, size_t logs_nb);
+
+int main(int argc, char * argv[]) {
+    bxilog_handlers_mode_e mode = BXILOG_HANDLERS_THREADED;
+    size_t logs_nb = DEFAULT_LOGS_NB;
+    const char * threads = DEFAULT_THREADS;
+    char * handlers = strdup(DEFAULT_HANDLERS);
+    const char * sizes = DEFAULT_SIZES;
+    const char * filtered = DEFAULT_FILTERED;
+    const char * label = "";
+    const char * output = DEFAULT_OUTPUT;
+
+    int opt;
+    while (-1 != (opt = getopt(argc, argv, "in:t:H:s:f:l:o:"))) {
+        switch (opt) {
+            case 'i': mode = BXILOG_HANDLERS_INLINE; break;
+            case 'n': logs_nb = strtoul(optarg, NULL, 10); break;
+            case 't': threads = optarg; break;
+            case 'H': BXIFREE(handlers); handlers = strdup(optarg); break;
+            case 's': sizes = optarg; break;
+            case 'f': filtered = optarg; break;
+            case 'l': label = optarg; break;
+            case 'o': output = optarg; break;
+            default:
+                fprintf(stderr, "Usage: %s [-i] [-n logs_nb] [-t threads,...] "
+                        "[-H handlers,...] [-s sizes,...] [-f filtered_percents,...] "
+                        "[-l label] [-o output.json]\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    list_s threads_l = _parse_list(threads);
+    list_s sizes_l = _parse_list(sizes);
+    list_s filtered_l = _parse_list(filtered);
+    const char * handlers_l[MAX_VALUES];
+    size_t handlers_nb = 0;
+    char * saveptr = NULL;
+    for (char * token = strtok_r(handlers, ",", &saveptr);
+         NULL != token && handlers_nb < MAX_VALUES;
+         token = strtok_r(NULL, ",", &saveptr)) {
+        handlers_l[handlers_nb++] = token;
+    }
+
+    FILE * out = fopen(output, "w");
+    if (NULL == out) {
+        fprintf(stderr, "Can't open %s: %s\n", output, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    fprintf(out, "{\n  \"label\": \"%s\",\n  \"mode\": \"%s\",\n"
+            "  \"logs_per_thread\": %zu,\n  \"scenarios\": [\n",
+            label, BXILOG_HANDLERS_INLINE == mode ? "inline" : "threaded", logs_nb);
+
+    printf("%-8s %-12s %6s %4s %5s %12s %10s %10s %10s %10s\n",
+           "threads", "handlers", "size", "filt", "multi",
+           "logs/s", "p50(ns)", "p99(ns)", "p99.9(ns)", "max(ns)");
+    bool first = true;
+    for (size_t t = 0; t < threads_l.nb; t++) {
+        for (size_t h = 0; h < handlers_nb; h++) {
+            for (size_t s = 0; s < sizes_l.nb; s++) {
+                for (size_t f = 0; f < filtered_l.nb; f++) {
+                    for (int m = 0; m < 2; m++) {
+                        scenario_s scenario = {
+                            .threads_nb = threads_l.values[t],
+                            .handlers = handlers_l[h],
+                            .size = sizes_l.values[s],
+                            .filtered_pct = filtered_l.values[f],
+                            .multiline = (1 == m),
+                        };
+                        _bench(out, first, &scenario, mode, logs_nb);
+                        first = false;
+                    }
+                }
+            }
+        }
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+    fclose(out);
+    unlink(LOGFILE);
+    BXIFREE(handlers);
+
+    return EXIT_SUCCESS;
+}
+
+//*********************************************************************************
+//********************************** Static Helpers Implementation ****************
+//*********************************************************************************
+
+list_s _parse_list(const char * str) {
+    list_s result = { .nb = 0 };
+    const char * next = str;
+    while ('\0' != *next && result.nb < MAX_VALUES) {
+        char * end;
+        size_t value = strtoul(next, &end, 10);
+        if (end == next) break;
+        result.values[result.nb++] = value;
+        next = (',' == *end) ? end + 1 : end;
+    }
+    return result;
+}
+
+char * _new_msg(size_t size, bool multiline) {
+    char * msg = bximem_calloc(size + 1);
+    for (size_t i = 0; i < size; i++) {
+        bool eol = multiline && (MULTILINE_WIDTH - 1 == i % MULTILINE_WIDTH);
+        msg[i] = eol ? '\n' : (char) ('a' + i % 26);
+    }
+    return msg;
+}
+
+void * _logging_thread(void * param) {
+    thread_data_s * data = param;
+    const scenario_s * scenario = data->scenario;
+    char * msg = _new_msg(scenario->size, scenario->multiline);
+
+    pthread_barrier_wait(data->barrier);
+    for (size_t i = 0; i < data->logs_nb; i++) {
+        bxilog_level_e level = (i % 100 < scenario->filtered_pct) ? BXILOG_DEBUG
+                                                                  : BXILOG_INFO;
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        bxilog_logger_log(LOGGER, level,
+                          (char *) __FILE__, ARRAYLEN(__FILE__),
+                          __func__, ARRAYLEN(__func__), __LINE__,
+                          "%s", msg);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        int64_t ns = (int64_t) (end.tv_sec - start.tv_sec) * 1000000000
+                   + (end.tv_nsec - start.tv_nsec);
+        bxilog_histogram_add(&data->latency, (uint64_t) ns);
+    }
+    BXIFREE(msg);
+
+    return NULL;
+}
+
+void _merge(bxilog_histogram_p self, const bxilog_histogram_p other) {
+    if (0 == other->count) return;
+    if (0 == self->count || other->min < self->min) self->min = other->min;
+    if (other->max > self->max) self->max = other->max;
+    self->count += other->count;
+    self->sum += other->sum;
+    for (size_t i = 0; i < BXILOG_HISTOGRAM_BUCKETS_NB; i++) {
+        self->buckets[i] += other->buckets[i];
+    }
+}
+
+bxilog_config_p _new_config(const char * handlers, bxilog_handlers_mode_e mode) {
+    bxilog_config_p config = bxilog_config_new("bench-matrix");
+    config->handlers_mode = mode;
+
+    char * names = strdup(handlers);
+    char * saveptr = NULL;
+    for (char * name = strtok_r(names, "+", &saveptr);
+         NULL != name;
+         name = strtok_r(NULL, "+", &saveptr)) {
+        // Logs at the BXILOG_DEBUG level are the filtered ones
+        bxilog_filters_p filters = bxilog_filters_new();
+        bxilog_filters_add(&filters, "", BXILOG_INFO);
+        if (0 == strcmp("null", name)) {
+            bxilog_config_add_handler(config, BXILOG_NULL_HANDLER, filters);
+        } else if (0 == strcmp("file", name)) {
+            bxilog_config_add_handler(config, BXILOG_FILE_HANDLER, filters,
+                                      "bench-matrix", LOGFILE, BXI_TRUNC_OPEN_FLAGS);
+        } else {
+            fprintf(stderr, "Unknown handler: %s\n", name);
+            exit(EXIT_FAILURE);
+        }
+    }
+    BXIFREE(names);
+
+    return config;
+}
+
+void _bench(FILE * out, bool first, const scenario_s * scenario,
+            bxilog_handlers_mode_e mode, size_t logs_nb) {
+    bxilog_config_p config = _new_config(scenario->handlers, mode);
+    bxierr_p err = bxilog_init(config);
+    bxierr_abort_ifko(err);
+
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, NULL, (unsigned) scenario->threads_nb + 1);
+    pthread_t threads[scenario->threads_nb];
+    thread_data_s * data = bximem_calloc(scenario->threads_nb * sizeof(*data));
+    for (size_t i = 0; i < scenario->threads_nb; i++) {
+        data[i].scenario = scenario;
+        data[i].logs_nb = logs_nb;
+        data[i].barrier = &barrier;
+        pthread_create(&threads[i], NULL, _logging_thread, &data[i]);
+    }
+
+    struct timespec start;
+    pthread_barrier_wait(&barrier);
+    err = bxitime_get(CLOCK_MONOTONIC, &start);
+    bxierr_abort_ifko(err);
+
+    bxilog_histogram_s latency;
+    memset(&latency, 0, sizeof(latency));
+    for (size_t i = 0; i < scenario->threads_nb; i++) {
+        pthread_join(threads[i], NULL);
+        _merge(&latency, &data[i].latency);
+    }
+    err = bxilog_flush();
+    bxierr_abort_ifko(err);
+    double duration;
+    err = bxitime_duration(CLOCK_MONOTONIC, start, &duration);
+    bxierr_abort_ifko(err);
+
+    size_t dropped_nb = 0, retried_nb = 0;
+    bxilog_stats_p stats = NULL;
+    err = bxilog_stats_get(&stats);
+    bxierr_report(&err, STDERR_FILENO);
+    for (size_t i = 0; NULL != stats && i < stats->handlers_nb; i++) {
+        dropped_nb += stats->handlers[i].dropped_nb;
+        retried_nb += stats->handlers[i].retried_nb;
+    }
+    bxilog_stats_destroy(&stats);
+
+    err = bxilog_finalize(true);
+    bxierr_abort_ifko(err);
+    pthread_barrier_destroy(&barrier);
+    BXIFREE(data);
+
+    double throughput = (double) latency.count / duration;
+    uint64_t p50 = bxilog_histogram_percentile(&latency, 50);
+    uint64_t p99 = bxilog_histogram_percentile(&latency, 99);
+    uint64_t p999 = bxilog_histogram_percentile(&latency, 99.9);
+
+    printf("%-8zu %-12s %6zu %3zu%% %5s %12.0f %10" PRIu64 " %10" PRIu64 " %10" PRIu64
+           " %10" PRIu64 "\n",
+           scenario->threads_nb, scenario->handlers, scenario->size,
+           scenario->filtered_pct, scenario->multiline ? "yes" : "no",
+           throughput, p50, p99, p999, latency.max);
+    fflush(stdout);
+
+    fprintf(out, "%s    {\"threads\": %zu, \"handlers\": \"%s\", \"size\": %zu, "
+            "\"filtered_pct\": %zu, \"multiline\": %s, "
+            "\"logs\": %" PRIu64 ", \"dropped\": %zu, \"retried\": %zu, "
+            "\"duration_s\": %.6f, "
+            "\"throughput\": %.1f, "
+            "\"latency_ns\": {\"min\": %" PRIu64 ", \"mean\": %.1f, \"p50\": %" PRIu64 ", "
+            "\"p99\": %" PRIu64 ", \"p99.9\": %" PRIu64 ", \"max\": %" PRIu64 "}}",
+            first ? "" : ",\n",
+            scenario->threads_nb, scenario->handlers, scenario->size,
+            scenario->filtered_pct, scenario->multiline ? "true" : "false",
+            latency.count, dropped_nb, retried_nb, duration, throughput,
+            latency.min, (double) latency.sum / (double) latency.count,
+            p50, p99, p999, latency.max);
+}
@@ -0,0 +1,180 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+/*
+ * Break down the cost of a log call into the stages of the logging pipeline.
+ *
+ * The library must be configured with --enable-stages-timing: each stage (see
+ * bxilog_stage_e) is then timed with the cycle counter and reported by
+ * bxilog_stats_get(). A single thread produces logs_nb logs of the given size to
+ * the null handler, so the time spent in the pipeline only is measured. The level
+ * check, done before entering the library, is timed by this program.
+ *
+ * Usage: bench-stages [-i] [-n logs_nb] [-s size]
+ *
+ *      -i          run the null handler inline (see BXILOG_HANDLERS_INLINE)
+ */
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <bxi/base/err.h>
+#include <bxi/base/mem.h>
+#include <bxi/base/time.h>
+#include <bxi/base/log.h>
+#include <bxi/base/log/null_handler.h>
+
+#define DEFAULT_LOGS_NB 1000000
+#define DEFAULT_SIZE 64
+
+SET_LOGGER(LOGGER, "bxi.base.bench.stages");
+
+static const char * STAGES_NAMES[BXILOG_STAGES_NB] = {
+    [BXILOG_STAGE_FORMAT] = "format (vsnprintf)",
+    [BXILOG_STAGE_RECORD] = "record build",
+    [BXILOG_STAGE_SEND] = "send (zmq)",
+    [BXILOG_STAGE_RECEIVE] = "receive (zmq)",
+    [BXILOG_STAGE_FILTER] = "filter match",
+};
+
+static uint64_t _ticks(void);
+static void _print_stage(const char * name, uint64_t count, uint64_t ticks,
+                         double ticks_per_ns);
+
+int main(int argc, char * argv[]) {
+    bxilog_handlers_mode_e mode = BXILOG_HANDLERS_THREADED;
+    size_t logs_nb = DEFAULT_LOGS_NB;
+    size_t size = DEFAULT_SIZE;
+
+    int opt;
+    while (-1 != (opt = getopt(argc, argv, "in:s:"))) {
+        switch (opt) {
+            case 'i': mode = BXILOG_HANDLERS_INLINE; break;
+            case 'n': logs_nb = strtoul(optarg, NULL, 10); break;
+            case 's': size = strtoul(optarg, NULL, 10); break;
+            default:
+                fprintf(stderr, "Usage: %s [-i] [-n logs_nb] [-s size]\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    bxilog_config_p config = bxilog_config_new("bench-stages");
+    config->handlers_mode = mode;
+    bxilog_filters_p filters = bxilog_filters_new();
+    bxilog_filters_add(&filters, "", BXILOG_INFO);
+    bxilog_config_add_handler(config, BXILOG_NULL_HANDLER, filters);
+    bxierr_p err = bxilog_init(config);
+    bxierr_abort_ifko(err);
+
+    char * msg = bximem_calloc(size + 1);
+    memset(msg, 'x', size);
+
+    // The level check: loggers are at the BXILOG_INFO level
+    volatile bool enabled = false;
+    struct timespec start;
+    err = bxitime_get(CLOCK_MONOTONIC, &start);
+    bxierr_abort_ifko(err);
+    uint64_t level_start = _ticks();
+    for (size_t i = 0; i < logs_nb; i++) {
+        enabled = bxilog_logger_is_enabled_for(LOGGER, BXILOG_DEBUG);
+    }
+    uint64_t level_ticks = _ticks() - level_start;
+    UNUSED(enabled);
+
+    // The whole log call
+    uint64_t log_start = _ticks();
+    for (size_t i = 0; i < logs_nb; i++) {
+        INFO(LOGGER, "%s", msg);
+    }
+    uint64_t log_ticks = _ticks() - log_start;
+    err = bxilog_flush();
+    bxierr_abort_ifko(err);
+
+    double duration;
+    uint64_t total_ticks = _ticks() - level_start;
+    err = bxitime_duration(CLOCK_MONOTONIC, start, &duration);
+    bxierr_abort_ifko(err);
+    double ticks_per_ns = (double) total_ticks / (duration * 1e9);
+
+    bxilog_stats_p stats = NULL;
+    err = bxilog_stats_get(&stats);
+    bxierr_abort_ifko(err);
+
+    printf("%-24s %12s %14s %10s %10s\n", "stage", "count", "ticks", "ticks/op", "ns/op");
+    _print_stage("level check", logs_nb, level_ticks, ticks_per_ns);
+    uint64_t stages_ticks = 0;
+    bool timed = false;
+    for (int i = BXILOG_STAGE_FORMAT; i <= BXILOG_STAGE_SEND; i++) {
+        if (0 == stats->stages[i].count) continue;
+        _print_stage(STAGES_NAMES[i], stats->stages[i].count, stats->stages[i].ticks,
+                     ticks_per_ns);
+        stages_ticks += stats->stages[i].ticks;
+        timed = true;
+    }
+    _print_stage("other (logging thread)", logs_nb,
+                 log_ticks > stages_ticks ? log_ticks - stages_ticks : 0, ticks_per_ns);
+    _print_stage("log call", logs_nb, log_ticks, ticks_per_ns);
+    for (size_t h = 0; h < stats->handlers_nb; h++) {
+        for (int i = BXILOG_STAGE_RECEIVE; i <= BXILOG_STAGE_FILTER; i++) {
+            const bxilog_stage_stats_s * stage = &stats->handlers[h].stages[i];
+            if (0 == stage->count) continue;
+            _print_stage(STAGES_NAMES[i], stage->count, stage->ticks, ticks_per_ns);
+            timed = true;
+        }
+    }
+    printf("%.3f ticks/ns\n", ticks_per_ns);
+    if (!timed) {
+        fprintf(stderr, "No stage was timed: configure the library with "
+                "--enable-stages-timing\n");
+    }
+
+    bxilog_stats_destroy(&stats);
+    BXIFREE(msg);
+    err = bxilog_finalize(true);
+    bxierr_abort_ifko(err);
+
+    return EXIT_SUCCESS;
+}
+
+//*********************************************************************************
+//********************************** Static Helpers Implementation ****************
+//*********************************************************************************
+
+// The same counter than the library, see stats_impl.h
+uint64_t _ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000 + (uint64_t) now.tv_nsec;
+#endif
+}
+
+void _print_stage(const char * name, uint64_t count, uint64_t ticks,
+                  double ticks_per_ns) {
+    double per_op = (0 == count) ? 0 : (double) ticks / (double) count;
+    printf("%-24s %12" PRIu64 " %14" PRIu64 " %10.1f %10.1f\n",
+           name, count, ticks, per_op, per_op / ticks_per_ns);
+}
@@ -0,0 +1,103 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+/*
+ * Measure the cost of fork() in a process using bxilog.
+ *
+ * For each fork mode (see bxilog_fork_mode_e), the parent forks children one
+ * after the other while it logs, and waits for them. Display the time per
+ * fork() as seen by the parent, with children that exit at once and with
+ * children that log one line (in the restart mode, they call bxilog_init()
+ * first).
+ *
+ * Usage: bench-fork [forks_nb] [logfile]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+
+#include <bxi/base/err.h>
+#include <bxi/base/time.h>
+#include <bxi/base/log.h>
+
+#define DEFAULT_FORKS_NB 200
+
+SET_LOGGER(LOGGER, "bxi.base.bench.fork");
+
+static const char * LOGFILE = "/tmp/bench-fork.log";
+
+static void _child(bxilog_fork_mode_e mode, bool child_logs) {
+    if (child_logs) {
+        if (BXILOG_FORK_RESTART == mode) {
+            bxilog_config_p config = bxilog_basic_config("bench-fork-child", LOGFILE,
+                                                         BXI_APPEND_OPEN_FLAGS,
+                                                         BXILOG_FILTERS_ALL_OUTPUT);
+            bxierr_p err = bxilog_init(config);
+            bxierr_abort_ifko(err);
+        }
+        OUT(LOGGER, "Child %d started", getpid());
+        bxierr_p err = bxilog_finalize(true);
+        bxierr_abort_ifko(err);
+    }
+    _exit(EXIT_SUCCESS);
+}
+
+static void _bench(const char * name, bxilog_fork_mode_e mode, bool child_logs,
+                   size_t forks_nb) {
+    bxilog_config_p config = bxilog_basic_config("bench-fork", LOGFILE,
+                                                 BXI_TRUNC_OPEN_FLAGS,
+                                                 BXILOG_FILTERS_ALL_OUTPUT);
+    config->fork_mode = mode;
+    bxierr_p err = bxilog_init(config);
+    bxierr_abort_ifko(err);
+
+    struct timespec start;
+    double duration;
+    err = bxitime_get(CLOCK_MONOTONIC, &start);
+    bxierr_abort_ifko(err);
+    for (size_t i = 0; i < forks_nb; i++) {
+        OUT(LOGGER, "Forking child %zu", i);
+        pid_t pid = fork();
+        if (-1 == pid) bxierr_abort_ifko(bxierr_errno("Calling fork() failed"));
+        if (0 == pid) _child(mode, child_logs);
+        int status;
+        if (pid != waitpid(pid, &status, 0)) {
+            bxierr_abort_ifko(bxierr_errno("Calling waitpid() failed"));
+        }
+    }
+    err = bxitime_duration(CLOCK_MONOTONIC, start, &duration);
+    bxierr_abort_ifko(err);
+
+    err = bxilog_finalize(true);
+    bxierr_abort_ifko(err);
+
+    printf("%-32s %12.1f\n", name, duration * 1e6 / (double) forks_nb);
+}
+
+int main(int argc, char * argv[]) {
+    size_t forks_nb = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_FORKS_NB;
+    if (argc > 2) LOGFILE = argv[2];
+
+    printf("%-32s %12s\n", "", "us/fork");
+    _bench("restart, silent child", BXILOG_FORK_RESTART, false, forks_nb);
+    _bench("quiesce, silent child", BXILOG_FORK_QUIESCE, false, forks_nb);
+    _bench("restart, logging child", BXILOG_FORK_RESTART, true, forks_nb);
+    _bench("quiesce, logging child", BXILOG_FORK_QUIESCE, true, forks_nb);
+
+    return EXIT_SUCCESS;
+}
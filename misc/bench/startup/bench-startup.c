@@ -0,0 +1,92 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+/*
+ * Measure the startup and exit cost of bxilog for a short-lived process.
+ *
+ * For each handlers mode (see bxilog_handlers_mode_e), a process configured with
+ * bxilog_basic_config() calls bxilog_init(), produces a few logs and calls
+ * bxilog_finalize(), many times in a row. Display the mean time spent in each
+ * step.
+ *
+ * Usage: bench-startup [cycles_nb] [logs_nb] [logfile]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <fcntl.h>
+
+#include <bxi/base/err.h>
+#include <bxi/base/time.h>
+#include <bxi/base/log.h>
+
+#define DEFAULT_CYCLES_NB 200
+#define DEFAULT_LOGS_NB 10
+
+SET_LOGGER(LOGGER, "bxi.base.bench.startup");
+
+static const char * LOGFILE = "/tmp/bench-startup.log";
+
+static double _since(struct timespec * start) {
+    double duration;
+    bxierr_p err = bxitime_duration(CLOCK_MONOTONIC, *start, &duration);
+    bxierr_abort_ifko(err);
+    err = bxitime_get(CLOCK_MONOTONIC, start);
+    bxierr_abort_ifko(err);
+    return duration;
+}
+
+static void _bench(const char * name, bxilog_handlers_mode_e mode,
+                   size_t cycles_nb, size_t logs_nb) {
+    double init = 0, logs = 0, finalize = 0;
+    for (size_t i = 0; i < cycles_nb; i++) {
+        struct timespec start;
+        bxierr_p err = bxitime_get(CLOCK_MONOTONIC, &start);
+        bxierr_abort_ifko(err);
+
+        bxilog_config_p config = bxilog_basic_config("bench-startup", LOGFILE,
+                                                     BXI_APPEND_OPEN_FLAGS,
+                                                     BXILOG_FILTERS_ALL_OUTPUT);
+        config->handlers_mode = mode;
+        err = bxilog_init(config);
+        bxierr_abort_ifko(err);
+        init += _since(&start);
+
+        for (size_t j = 0; j < logs_nb; j++) {
+            DEBUG(LOGGER, "Cycle %zu: log %zu", i, j);
+        }
+        logs += _since(&start);
+
+        err = bxilog_finalize(true);
+        bxierr_abort_ifko(err);
+        finalize += _since(&start);
+    }
+    printf("%-12s %12.1f %12.1f %12.1f %12.1f\n", name,
+           init * 1e6 / (double) cycles_nb,
+           logs * 1e6 / (double) cycles_nb,
+           finalize * 1e6 / (double) cycles_nb,
+           (init + logs + finalize) * 1e6 / (double) cycles_nb);
+}
+
+int main(int argc, char * argv[]) {
+    size_t cycles_nb = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_CYCLES_NB;
+    size_t logs_nb = (argc > 2) ? strtoul(argv[2], NULL, 10) : DEFAULT_LOGS_NB;
+    if (argc > 3) LOGFILE = argv[3];
+
+    printf("%-12s %12s %12s %12s %12s\n", "us/cycle", "init", "logs", "finalize", "total");
+    _bench("threaded", BXILOG_HANDLERS_THREADED, cycles_nb, logs_nb);
+    _bench("inline", BXILOG_HANDLERS_INLINE, cycles_nb, logs_nb);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,145 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+/*
+ * Count the memory allocations done while building strings.
+ *
+ * malloc(), calloc() and realloc() are interposed (glibc only) to count the calls
+ * made by libbxibase. For each case, display the number of allocations and the
+ * time per operation:
+ *
+ *      - bxistr_new() of a short and of a long string;
+ *      - a string made of many parts, with bxistr_new() for each part and
+ *        bxistr_join() at the end, as done before bxistr_builder;
+ *      - the same string with a bxistr_builder;
+ *      - bxierr_str() of a chain of three errors.
+ *
+ * Usage: bench-str-alloc [ops_nb]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <bxi/base/err.h>
+#include <bxi/base/mem.h>
+#include <bxi/base/str.h>
+#include <bxi/base/time.h>
+
+#define DEFAULT_OPS_NB 100000
+#define PARTS_NB 64
+
+extern void * __libc_malloc(size_t size);
+extern void * __libc_calloc(size_t nmemb, size_t size);
+extern void * __libc_realloc(void * ptr, size_t size);
+
+static __thread size_t ALLOCS_NB = 0;
+
+void * malloc(size_t size) {
+    ALLOCS_NB++;
+    return __libc_malloc(size);
+}
+
+void * calloc(size_t nmemb, size_t size) {
+    ALLOCS_NB++;
+    return __libc_calloc(nmemb, size);
+}
+
+void * realloc(void * ptr, size_t size) {
+    ALLOCS_NB++;
+    return __libc_realloc(ptr, size);
+}
+
+static char LONG_STR[1024];
+
+static void _short_new(void) {
+    char * s = bxistr_new("Can't send msg through zsocket %p", (void *) LONG_STR);
+    BXIFREE(s);
+}
+
+static void _long_new(void) {
+    char * s = bxistr_new("%s: %d", LONG_STR, 42);
+    BXIFREE(s);
+}
+
+static void _parts_join(void) {
+    char * parts[PARTS_NB];
+    size_t parts_len[PARTS_NB];
+    for (size_t i = 0; i < PARTS_NB; i++) {
+        parts[i] = bxistr_new("{\"name\": \"logger.%zu\", \"level\": %zu}", i, i % 10);
+        parts_len[i] = strlen(parts[i]);
+    }
+    char * s = NULL;
+    bxistr_join(", ", strlen(", "), parts, parts_len, PARTS_NB, &s);
+    for (size_t i = 0; i < PARTS_NB; i++) BXIFREE(parts[i]);
+    BXIFREE(s);
+}
+
+static void _parts_builder(void) {
+    bxistr_builder_p builder = bxistr_builder_get();
+    for (size_t i = 0; i < PARTS_NB; i++) {
+        bxistr_builder_append(builder, "%s{\"name\": \"logger.%zu\", \"level\": %zu}",
+                              (0 == i) ? "" : ", ", i, i % 10);
+    }
+    char * s = bxistr_builder_take(builder, NULL);
+    bxistr_builder_release(&builder);
+    BXIFREE(s);
+}
+
+static void _err_str(void) {
+    bxierr_p err = bxierr_simple(EAGAIN, "Resource unavailable");
+    err = bxierr_new(EINVAL, NULL, NULL, NULL, err, "Invalid argument\nsecond line");
+    err = bxierr_new(EIO, NULL, NULL, NULL, err, "I/O error on %s", "/dev/null");
+    char * s = bxierr_str(err);
+    BXIFREE(s);
+    bxierr_destroy(&err);
+}
+
+static void _bench(const char * name, void (*f)(void), size_t ops_nb) {
+    struct timespec start;
+    double duration;
+
+    // Warm up thread-local buffers
+    f();
+
+    ALLOCS_NB = 0;
+    bxierr_p err = bxitime_get(CLOCK_MONOTONIC, &start);
+    bxierr_abort_ifko(err);
+    for (size_t i = 0; i < ops_nb; i++) f();
+    err = bxitime_duration(CLOCK_MONOTONIC, start, &duration);
+    bxierr_abort_ifko(err);
+    size_t allocs_nb = ALLOCS_NB;
+
+    printf("%-28s %12.2f %12.1f\n", name,
+           (double) allocs_nb / (double) ops_nb, duration * 1e9 / (double) ops_nb);
+}
+
+int main(int argc, char * argv[]) {
+    size_t ops_nb = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_OPS_NB;
+
+    memset(LONG_STR, 'x', sizeof(LONG_STR) - 1);
+    // Backtraces are not what is measured here
+    bxierr_backtrace_disable(EAGAIN);
+    bxierr_backtrace_disable(EINVAL);
+    bxierr_backtrace_disable(EIO);
+
+    printf("%-28s %12s %12s\n", "", "allocs/op", "ns/op");
+    _bench("bxistr_new() short", _short_new, ops_nb);
+    _bench("bxistr_new() long", _long_new, ops_nb);
+    _bench("parts + bxistr_join()", _parts_join, ops_nb / 10);
+    _bench("bxistr_builder", _parts_builder, ops_nb / 10);
+    _bench("bxierr_str() (3 errors)", _err_str, ops_nb);
+
+    return EXIT_SUCCESS;
+}
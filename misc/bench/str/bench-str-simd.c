@@ -0,0 +1,140 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+/*
+ * Compare the scalar and the SIMD versions of the string kernels.
+ *
+ * Each kernel is run on a buffer of the given size with each level available
+ * (see bxistr_simd_set()), the time per byte is displayed:
+ *
+ *      - bxistr_newlines() and bxistr_apply_lines() on a multi-line message;
+ *      - bxistr_count() of the newlines of the same message;
+ *      - bxistr_rsub() of a path with a single '/' at its beginning;
+ *      - bxistr_hex2bytes() and bxistr_bytes2hex().
+ *
+ * Usage: bench-str-simd [size] [ops_nb]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <bxi/base/err.h>
+#include <bxi/base/mem.h>
+#include <bxi/base/str.h>
+#include <bxi/base/time.h>
+
+#define DEFAULT_SIZE 4096
+#define DEFAULT_OPS_NB 100000
+#define LINE_LEN 80
+
+static char * TEXT;
+static char * PATH;
+static char * HEX;
+static uint8_t * BYTES;
+static size_t SIZE;
+
+static bxierr_p _line(char * line, size_t line_len, bool last, void * param) {
+    UNUSED(line);
+    UNUSED(last);
+    *(size_t *) param += line_len;
+    return BXIERR_OK;
+}
+
+static size_t _newlines(void) {
+    size_t offsets[64];
+    return bxistr_newlines(TEXT, SIZE, offsets, 64);
+}
+
+static size_t _apply_lines(void) {
+    size_t total = 0;
+    bxierr_p err = bxistr_apply_lines(TEXT, SIZE, _line, &total);
+    bxierr_abort_ifko(err);
+    return total;
+}
+
+static size_t _count(void) {
+    return bxistr_count(TEXT, '\n');
+}
+
+static size_t _rsub(void) {
+    const char * result;
+    return bxistr_rsub(PATH, SIZE, '/', &result);
+}
+
+static size_t _hex2bytes(void) {
+    bxierr_p err = bxistr_hex2bytes(HEX, SIZE, &BYTES);
+    bxierr_abort_ifko(err);
+    return BYTES[0];
+}
+
+static size_t _bytes2hex(void) {
+    bxierr_p err = bxistr_bytes2hex(BYTES, SIZE / 2, &HEX);
+    bxierr_abort_ifko(err);
+    return (size_t) HEX[0];
+}
+
+static void _bench(const char * name, size_t (*f)(void), size_t ops_nb) {
+    printf("%-24s", name);
+    for (bxistr_simd_e simd = BXISTR_SIMD_SCALAR; simd <= BXISTR_SIMD_AVX2; simd++) {
+        if (simd != bxistr_simd_set(simd)) {
+            printf(" %12s", "-");
+            continue;
+        }
+        struct timespec start;
+        double duration;
+        volatile size_t sink = f();
+
+        bxierr_p err = bxitime_get(CLOCK_MONOTONIC, &start);
+        bxierr_abort_ifko(err);
+        for (size_t i = 0; i < ops_nb; i++) sink += f();
+        err = bxitime_duration(CLOCK_MONOTONIC, start, &duration);
+        bxierr_abort_ifko(err);
+        UNUSED(sink);
+
+        printf(" %12.3f", duration * 1e9 / (double) ops_nb / (double) SIZE);
+    }
+    printf("\n");
+}
+
+int main(int argc, char * argv[]) {
+    SIZE = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_SIZE;
+    size_t ops_nb = (argc > 2) ? strtoul(argv[2], NULL, 10) : DEFAULT_OPS_NB;
+    SIZE &= ~(size_t) 1;
+
+    TEXT = bximem_calloc(SIZE + 1);
+    PATH = bximem_calloc(SIZE + 1);
+    HEX = bximem_calloc(SIZE + 1);
+    BYTES = bximem_calloc(SIZE / 2);
+    for (size_t i = 0; i < SIZE; i++) {
+        TEXT[i] = (LINE_LEN - 1 == i % LINE_LEN) ? '\n' : (char) ('a' + i % 26);
+        PATH[i] = (0 == i) ? '/' : 'p';
+        HEX[i] = "0123456789abcdef"[i % 16];
+    }
+
+    printf("%-24s %12s %12s %12s\n", "ns/byte", "scalar", "sse2", "avx2");
+    _bench("bxistr_newlines()", _newlines, ops_nb);
+    _bench("bxistr_apply_lines()", _apply_lines, ops_nb);
+    _bench("bxistr_count()", _count, ops_nb);
+    _bench("bxistr_rsub()", _rsub, ops_nb);
+    _bench("bxistr_hex2bytes()", _hex2bytes, ops_nb);
+    _bench("bxistr_bytes2hex()", _bytes2hex, ops_nb);
+
+    BXIFREE(TEXT);
+    BXIFREE(PATH);
+    BXIFREE(HEX);
+    BXIFREE(BYTES);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,132 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+/*
+ * Measure the size and the cost of the remote handler wire encoding.
+ *
+ * For various batch sizes and message sizes, display the number of bytes per
+ * record sent on the wire by the former raw encoding (the in-memory
+ * bxilog_record_s followed by its strings) and by the current wire encoding,
+ * and the encoding/decoding time per record.
+ *
+ * Usage: bench-wire [records_nb]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <bxi/base/err.h>
+#include <bxi/base/mem.h>
+#include <bxi/base/time.h>
+
+#include "wire_impl.h"
+
+#define DEFAULT_RECORDS_NB 1000000
+
+static const char FILENAME[] = "remote_handler.c";
+static const char FUNCNAME[] = "_process_log";
+static const char LOGGERNAME[] = "bxi.base.bench.wire";
+
+static void _bench(size_t records_nb, size_t batch_size, size_t msg_len) {
+    char * msg = bximem_calloc(msg_len + 1);
+    memset(msg, 'm', msg_len);
+
+    bxilog_record_s record;
+    record.level = BXILOG_INFO;
+    record.pid = 12345;
+#ifdef __linux__
+    record.tid = 12346;
+#endif
+    record.thread_rank = 3;
+    record.line_nb = 421;
+    record.filename_len = ARRAYLEN(FILENAME);
+    record.funcname_len = ARRAYLEN(FUNCNAME);
+    record.logname_len = ARRAYLEN(LOGGERNAME);
+    record.logmsg_len = msg_len + 1;
+
+    const size_t raw_len = sizeof(record) + record.filename_len + \
+                           record.funcname_len + record.logname_len + \
+                           record.logmsg_len;
+
+    bxilog__wire_encoder_s encoder;
+    bxilog__wire_encoder_init(&encoder);
+    char * buf = NULL;
+    size_t buf_size = 0;
+    size_t wire_bytes = 0;
+    double encode_duration = 0, decode_duration = 0;
+
+    bxierr_p err = bxitime_get(CLOCK_REALTIME, &record.detail_time);
+    bxierr_abort_ifko(err);
+
+    for (size_t done = 0; done < records_nb; done += batch_size) {
+        struct timespec start;
+        double duration;
+
+        err = bxitime_get(CLOCK_MONOTONIC, &start);
+        bxierr_abort_ifko(err);
+        bxilog__wire_encoder_reset(&encoder);
+        for (size_t i = 0; i < batch_size; i++) {
+            // Records are a few microseconds apart
+            record.detail_time.tv_nsec = (record.detail_time.tv_nsec + 3217) % 1000000000;
+            bxilog__wire_encode(&encoder, &record, FILENAME, FUNCNAME, LOGGERNAME, msg);
+        }
+        const uint8_t * data;
+        size_t len = bxilog__wire_encoder_data(&encoder, &data);
+        err = bxitime_duration(CLOCK_MONOTONIC, start, &duration);
+        bxierr_abort_ifko(err);
+        encode_duration += duration;
+        wire_bytes += len;
+
+        err = bxitime_get(CLOCK_MONOTONIC, &start);
+        bxierr_abort_ifko(err);
+        bxilog__wire_decoder_s decoder;
+        err = bxilog__wire_decoder_init(&decoder, data, len);
+        bxierr_abort_ifko(err);
+        while (bxilog__wire_decoder_has_next(&decoder)) {
+            size_t record_len;
+            err = bxilog__wire_decode_next(&decoder, &buf, &buf_size, &record_len);
+            bxierr_abort_ifko(err);
+        }
+        err = bxitime_duration(CLOCK_MONOTONIC, start, &duration);
+        bxierr_abort_ifko(err);
+        decode_duration += duration;
+    }
+
+    const size_t n = (records_nb / batch_size) * batch_size;
+    printf("%10zu %10zu %12zu %12.1f %12.1f %12.1f\n",
+           batch_size, msg_len, raw_len, (double) wire_bytes / (double) n,
+           encode_duration * 1e9 / (double) n, decode_duration * 1e9 / (double) n);
+
+    BXIFREE(buf);
+    BXIFREE(msg);
+    bxilog__wire_encoder_clean(&encoder);
+}
+
+int main(int argc, char * argv[]) {
+    size_t records_nb = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_RECORDS_NB;
+
+    const size_t batch_sizes[] = {1, 16, 256};
+    const size_t msg_lens[] = {0, 32, 128, 1024};
+
+    printf("%10s %10s %12s %12s %12s %12s\n",
+           "batch", "msg_len", "raw B/rec", "wire B/rec", "enc ns/rec", "dec ns/rec");
+    for (size_t b = 0; b < ARRAYLEN(batch_sizes); b++) {
+        for (size_t m = 0; m < ARRAYLEN(msg_lens); m++) {
+            _bench(records_nb, batch_sizes[b], msg_lens[m]);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -23,6 +23,7 @@
 #include <stdarg.h>
 #include <assert.h>
 #include <errno.h>
+#include <time.h>
 #endif
 
 #include "bxi/base/mem.h"
@@ -185,6 +186,13 @@
 #define BXIERR_ALL_CAUSES 64
 #define ERR2STR_MAX_SIZE 1024
 
+/**
+ * Maximum length of the message of a pooled error (longer messages are truncated).
+ *
+ * @see bxierr_pooled()
+ */
+#define BXIERR_POOLED_MSG_MAX 128
+
 
 /**
  * Chain the new error with the current one and adapt the current error accordingly.
@@ -204,6 +212,32 @@
         bxierr_chain(&(current), &(new));\
     } while(false)
 
+/**
+ * Initialize a static error singleton, with the given code and constant message.
+ *
+ * Such an error is immutable: it has no backtrace, no data and no cause, and
+ * bxierr_destroy() does nothing on it. It is meant for errors expected in the normal
+ * flow of a program that must not cost any allocation.
+ *
+ * Use it like this:
+ * ~~~{C}
+ * static bxierr_s EAGAIN_ERR_S = BXIERR_STATIC_INIT(EAGAIN, "Resource unavailable");
+ *
+ * bxierr_p f(...) {
+ *      ...
+ *      if (EAGAIN == errno) return &EAGAIN_ERR_S;
+ * }
+ * ~~~
+ *
+ * @see bxierr_pooled()
+ */
+#define BXIERR_STATIC_INIT(code_, msg_) {                   \
+        .code = (code_),                                    \
+        .msg = (char *) (msg_),                             \
+        .msg_len = sizeof(msg_) - 1,                        \
+        .origin = BXIERR_ORIGIN_STATIC,                     \
+    }
+
 /**
  * Produce a backtrace in the given `file` (a FILE* object).
  */
@@ -251,17 +285,6 @@
                bxierr_list_add_to_report,               \
                NULL, __VA_ARGS__)
 
-/**
- * Transform a bxierr_p with a bxierr_set_p in its data field into a string.
- *
- * @note this function main purpose is to be used as an argument of bxierr_new().
- *
- * @param[in] err the error
- * @param[in] depth the number of error causes to transform to string
- *
- * @see bxierr_new
- */
-#define bxierr_set_add_to_report bxierr_list_add_to_report
 
 /**
  * Define an error with the given code and the given error set.
@@ -338,6 +361,15 @@ typedef bxierr_report_s * bxierr_report_p;
  */
 typedef struct bxierr_s bxierr_s;
 
+/**
+ * How a bxi error instance has been allocated.
+ */
+typedef enum {
+    BXIERR_ORIGIN_HEAP = 0,         //!< by bxierr_new(), released by bxierr_destroy()
+    BXIERR_ORIGIN_STATIC,           //!< by BXIERR_STATIC_INIT(), never released
+    BXIERR_ORIGIN_POOLED,           //!< by bxierr_pooled(), recycled by bxierr_destroy()
+} bxierr_origin_e;
+
 /** \public
  *
  * Represents a bxi error instance.
@@ -352,7 +384,8 @@ typedef struct bxierr_s * bxierr_p;
  */
 struct bxierr_s {
     int    code;                            //!< the error code
-    char * backtrace;                       //!< the backtrace
+    char * backtrace;                       //!< the backtrace, NULL until the error
+                                            //!< is reported (see bxierr_str())
     size_t backtrace_len;                   //!< the backtrace string length (including
                                             //!< the NULL terminating byte)
     void * data;                            //!< some data related to the error
@@ -364,6 +397,11 @@ struct bxierr_s {
     bxierr_p last_cause;                    //!< the initial cause valid only on the first error
     char * msg;                             //!< the message of the error
     size_t msg_len;                         //!< the length of the message
+    void ** pcs;                            //!< the raw return addresses of the
+                                            //!< backtrace, NULL once symbolized
+    int pcs_nb;                             //!< the number of return addresses
+    int tid;                                //!< the thread that created the error
+    bxierr_origin_e origin;                 //!< how the error has been allocated
 };
 
 
@@ -398,6 +436,18 @@ typedef struct {
     size_t * seen_nb;               //!< for each distinct error, count the number of
                                     //!< time it has been seen.
     size_t total_seen_nb;           //!< total number of seen errors
+#ifndef BXICFFI
+    struct timespec * first_seen;   //!< for each distinct error, when it has been
+                                    //!< seen for the first time (CLOCK_REALTIME)
+    struct timespec * last_seen;    //!< for each distinct error, when it has been
+                                    //!< seen for the last time (CLOCK_REALTIME)
+#else
+    void * first_seen;              // fake for CFFI
+    void * last_seen;               // fake for CFFI
+#endif
+    size_t * index;                 //!< open addressing hash table on error codes:
+                                    //!< 1 + the position in distinct_err, 0 if empty
+    size_t index_size;              //!< size of the index (a power of 2)
 } bxierr_set_s;
 
 /**
@@ -463,6 +513,42 @@ __attribute__ ((format (printf, 6, 7)))
 #endif
                     ;
 
+/**
+ * Return a bxi error instance taken from a per-thread pool of recycled instances.
+ *
+ * Once the pool is warm, no memory is allocated: the message is formatted into a
+ * buffer of BXIERR_POOLED_MSG_MAX bytes owned by the instance, and no backtrace is
+ * captured. It is meant for errors expected in the normal flow of a program,
+ * created and destroyed at a high rate.
+ *
+ * The returned error can be used as any other one (its `data` and `free_fn` fields
+ * can be set by the caller). bxierr_destroy() gives it back to the pool of the
+ * calling thread.
+ *
+ * @param[in] code the error code
+ * @param[in] fmt the error message in a printf like style.
+ *
+ * @return a bxi error instance
+ *
+ * @see BXIERR_STATIC_INIT()
+ */
+bxierr_p bxierr_pooled(int code, const char * fmt, ...)
+#ifndef BXICFFI
+__attribute__ ((format (printf, 2, 3)))
+#endif
+                    ;
+
+/**
+ * Return an error that can be modified (chained, given a cause, ...).
+ *
+ * @param[in] self an error
+ *
+ * @return self, or a new copy of self if it is a static error singleton
+ *
+ * @see BXIERR_STATIC_INIT()
+ */
+bxierr_p bxierr_mutable(bxierr_p self);
+
 /**
  * Release all resources in self and self itself.
  *
@@ -730,18 +816,23 @@ inline void bxierr_chain(bxierr_p *err, const bxierr_p *tmp) {
             bxiassert(NULL != (*tmp));
 
             if (bxierr_isko((*tmp)) && bxierr_isko((*err))) {
-                bxiassert(*err != *tmp);
-                if (NULL != (*tmp)->cause) {
-                    bxiassert((*tmp)->last_cause->cause == NULL);
-                    (*tmp)->last_cause->cause = (*err);
+                // Static error singletons are shared: chain copies
+                bxierr_p chained = bxierr_mutable(*tmp);
+                (*err) = bxierr_mutable(*err);
+                bxiassert(*err != chained);
+                if (NULL != chained->cause) {
+                    bxiassert(chained->last_cause->cause == NULL);
+                    chained->last_cause->cause = (*err);
                 } else {
-                    (*tmp)->cause = (*err);
+                    chained->cause = (*err);
                 }
                 if ((*err)->last_cause != NULL) {
-                    (*tmp)->last_cause = (*err)->last_cause;
+                    chained->last_cause = (*err)->last_cause;
                 } else {
-                    (*tmp)->last_cause = (*err);
+                    chained->last_cause = (*err);
                 }
+                (*err) = chained;
+                return;
             }
             (*err) = bxierr_isko((*tmp)) ? (*tmp) : (*err);
 }
@@ -826,6 +917,30 @@ bxierr_p bxierr_vfromidx(int errcode,
  */
 size_t bxierr_backtrace_str(char ** buf);
 
+/**
+ * Do not capture any backtrace when an error with the given code is created.
+ *
+ * Capturing a backtrace is much cheaper than producing its human representation
+ * (done only when the error is reported), but it is still useless for errors
+ * expected in the normal flow of a program, such as EAGAIN.
+ *
+ * @param[in] code an error code
+ *
+ * @return false if too many error codes are already disabled, true otherwise
+ *
+ * @see bxierr_backtrace_enable()
+ */
+bool bxierr_backtrace_disable(int code);
+
+/**
+ * Capture again a backtrace when an error with the given code is created.
+ *
+ * @param[in] code an error code
+ *
+ * @see bxierr_backtrace_disable()
+ */
+void bxierr_backtrace_enable(int code);
+
 
 
 /**
@@ -909,6 +1024,22 @@ void bxierr_list_append(bxierr_list_p list, bxierr_p err);
 void bxierr_list_add_to_report(bxierr_p err, bxierr_report_p report, size_t depth);
 
 
+/**
+ * Add a bxierr_p with a bxierr_set_p in its data field to the given report.
+ *
+ * Each distinct error is reported with the number of times it has been seen,
+ * and when it has been seen for the first and the last time.
+ *
+ * @note this function main purpose is to be used as an argument of bxierr_new().
+ *
+ * @param[in] err the error
+ * @param[inout] report the report
+ * @param[in] depth the number of error causes to transform to string
+ *
+ * @see bxierr_new
+ */
+void bxierr_set_add_to_report(bxierr_p err, bxierr_report_p report, size_t depth);
+
 /**
  * Create a new bxierr_set_p object.
  *
@@ -951,6 +1082,9 @@ void bxierr_set_destroy(bxierr_set_p * errset_p);
 /**
  * Add the given error in the set if no error with the same code exists.
  *
+ * Whether the error is new or not, the number of times an error with its code has
+ * been seen and the last time it has been seen are updated, in constant time.
+ *
  * @note: the given error `*err` is destroyed if an other error with the same code
  * already exists in the given error set.
  *
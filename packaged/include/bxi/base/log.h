@@ -18,6 +18,7 @@ void free(void *ptr);
 #include "bxi/base/log/level.h"
 #include "bxi/base/log/logger.h"
 #include "bxi/base/log/config.h"
+#include "bxi/base/log/stats.h"
 #include "bxi/base/log/report.h"
 #include "bxi/base/log/assert.h"
 #include "bxi/base/log/exit.h"
@@ -88,7 +89,9 @@ void free(void *ptr);
  * - All functions in this library are thread safe.
  * - Fork is supported, but note that after a `fork()`, while the parent remains in same
  *   state as before the `fork()`, the child have to call `bxilog_init()` in order to
- *   produce logs.
+ *   produce logs. With the `::BXILOG_FORK_QUIESCE` fork mode (see bxilog_config_s),
+ *   the parent keeps its handlers running across the `fork()` and the child starts
+ *   the inherited handlers on its first log.
  *
  *
  * ### Full Running Examples
@@ -120,6 +123,16 @@ void free(void *ptr);
  */
 #define BXILOG_FLUSH_ERR 51054
 
+/**
+ * Define the error code when an error occurred while reconfiguring
+ *
+ * @note the bxierr_p.data holds a bxierr_group data containing all errors
+ * encountered while reconfiguring. This data will be freed when the error is freed.
+ *
+ * @see bxilog_reconfigure()
+ */
+#define BXILOG_RECONFIG_ERR 2370
+
 /**
  * Define the error code when a bad level configuration is given.
  *
@@ -228,6 +241,28 @@ bool bxilog_is_ready();
  */
 bxierr_p bxilog_flush(void);
 
+/**
+ * Replace the filters of the running handlers without restarting them.
+ *
+ * The filters_nb must be the number of handlers in the current configuration.
+ * filters[i] becomes the new set of filters of the i-th handler of the configuration,
+ * or the i-th handler is left untouched when filters[i] is NULL.
+ *
+ * Each handler processes the logs it has already received with its previous filters
+ * before switching to the new ones. Then, the level of each logger is recomputed.
+ * Threads producing logs meanwhile are never blocked.
+ *
+ * @note the given filters belong to the library after this call, whatever the result.
+ *
+ * @param[in] filters the new set of filters of each handler
+ * @param[in] filters_nb the number of elements in filters
+ *
+ * @return BXIERR_OK on success, anything else is an error.
+ *
+ * @see bxilog_filters_parse()
+ */
+bxierr_p bxilog_reconfigure(bxilog_filters_p * filters, size_t filters_nb);
+
 
 /**
  * Write the set of registered loggers along with the list of bxilog_level_e to
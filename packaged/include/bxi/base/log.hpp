@@ -0,0 +1,372 @@
+/* -*- coding: utf-8 -*-  */
+
+#ifndef BXILOG_HPP_
+#define BXILOG_HPP_
+
+#include <unistd.h>
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// The library has a C linkage: include this file before any other bxi header
+extern "C" {
+#include "bxi/base/log.h"
+}
+
+/**
+ * @file    log.hpp
+ * @authors agent <agent@local>
+ * @copyright 2026  Bull S.A.S.  -  All rights reserved.\n
+ *         This is not Free or Open Source software.\n
+ *         Please contact Bull SAS for details about its license.\n
+ *         Bull - Rue Jean Jaurès - B.P. 68 - 78340 Les Clayes-sous-Bois
+ * @brief   C++17 front end of the logging module
+ *
+ * ### Overview
+ *
+ * This header only front end replaces the printf like formats of the C macros
+ * (see ::INFO) by `{}` placeholders, checked at compile time:
+ *
+ * ~~~{.cpp}
+ * #include <bxi/base/log.hpp>
+ *
+ * SET_LOGGER(MY_LOGGER, "my.logger");
+ *
+ * void f(const std::string & name, int n) {
+ *     BXILOG_LOG(MY_LOGGER, BXILOG_INFO, "{} has {} items", name, n);
+ *     bxilog::log<BXILOG_DEBUG>(MY_LOGGER, BXILOG_FMT("{{{}}}"), n);
+ * }
+ * ~~~
+ *
+ * The format is parsed once, by the compiler: a format with unbalanced braces,
+ * or a number of `{}` that does not match the number of arguments, does not
+ * compile. At runtime, the exact size of the message is computed from the
+ * arguments, which are then copied in place without vsnprintf(), and the
+ * message is given to bxilog_logger_log_rawstr().
+ *
+ * Supported arguments are: `bool`, `char`, integers, floating point numbers
+ * (in their shortest form, see std::to_chars()), enumerations (as their
+ * underlying integer), C strings, `std::string`, `std::string_view` and
+ * pointers (in hexadecimal).
+ *
+ * `BXILOG_LOG()` checks the level before evaluating its arguments, exactly as the
+ * C macros do, and compiles to nothing for a level above
+ * ::BXILOG_COMPILE_MIN_LEVEL.
+ */
+
+// *********************************************************************************
+// ********************************** Defines **************************************
+// *********************************************************************************
+
+/**
+ * The size of the stack buffer messages are built in. Longer messages are built
+ * in a buffer allocated on the heap.
+ */
+#ifndef BXILOG_CXX_BUF_SIZE
+#define BXILOG_CXX_BUF_SIZE 512
+#endif
+
+/**
+ * Return the compile time format of the given string literal, recording the
+ * call site.
+ *
+ * @see bxilog::log()
+ */
+#define BXILOG_FMT(fmt) ::bxilog::detail::make_format(                                  \
+        [] {                                                                            \
+            struct bxilog_fmt_s {                                                       \
+                static constexpr std::string_view str() { return (fmt); }               \
+                static constexpr std::string_view file() { return __FILE__; }           \
+            };                                                                          \
+            return bxilog_fmt_s{};                                                      \
+        }(),                                                                            \
+        __func__, ARRAYLEN(__func__), __LINE__)
+
+/**
+ * Produce a log at the given level with the given `{}` format and arguments.
+ *
+ * The arguments are evaluated only if the logger is enabled for the level.
+ *
+ * @see bxilog_logger_log()
+ */
+#define BXILOG_LOG(logger, level, fmt, ...) do {                                        \
+        if (BXILOG_IS_COMPILED(level)                                                   \
+            && bxilog_logger_is_enabled_for((logger), (level))) {                       \
+            bxierr_p __err__ = ::bxilog::log_nolevelcheck<(level)>((logger),            \
+                                                                   BXILOG_FMT(fmt),     \
+                                                                   ##__VA_ARGS__);      \
+            if (bxierr_isko(__err__)) {                                                 \
+                bxierr_report(&__err__, STDOUT_FILENO);                                 \
+            }                                                                           \
+        }                                                                               \
+    } while(false)
+
+namespace bxilog {
+namespace detail {
+
+// *********************************************************************************
+// ********************************** Types   **************************************
+// *********************************************************************************
+
+// Large enough for any integer, pointer or floating point number
+constexpr size_t NUMBER_MAX = 32;
+
+constexpr size_t NO_ARG = SIZE_MAX;
+constexpr size_t BAD_FORMAT = SIZE_MAX;
+
+// A piece of a format: either a literal, or an argument
+struct piece_s {
+    size_t offset;          // Of the literal in the format
+    size_t size;            // Of the literal
+    size_t arg;             // Index of the argument, NO_ARG for a literal
+};
+
+// An argument converted to text
+struct arg_s {
+    const char * text;      // The text, NULL when it is in buf
+    size_t size;
+    char buf[NUMBER_MAX];
+
+    const char * data() const { return (nullptr == text) ? buf : text; }
+};
+
+// *********************************************************************************
+// ********************************** Implementation *******************************
+// *********************************************************************************
+
+/*
+ * Split the given format into its pieces, stored in pieces when not NULL.
+ *
+ * Return the number of pieces, or BAD_FORMAT on an unbalanced brace.
+ */
+constexpr size_t parse(const std::string_view fmt, piece_s * const pieces) {
+    size_t nb = 0, arg = 0, start = 0;
+    for (size_t i = 0; i < fmt.size(); i++) {
+        if ('{' != fmt[i] && '}' != fmt[i]) continue;
+        const bool escaped = i + 1 < fmt.size() && fmt[i] == fmt[i + 1];
+        if (!escaped && ('}' == fmt[i] || i + 1 == fmt.size() || '}' != fmt[i + 1])) {
+            return BAD_FORMAT;
+        }
+        // A literal up to the brace, included if escaped
+        const size_t end = escaped ? i + 1 : i;
+        if (start < end) {
+            if (nullptr != pieces) pieces[nb] = piece_s{start, end - start, NO_ARG};
+            nb++;
+        }
+        if (!escaped) {
+            if (nullptr != pieces) pieces[nb] = piece_s{0, 0, arg};
+            nb++;
+            arg++;
+        }
+        i++;
+        start = i + 1;
+    }
+    if (start < fmt.size()) {
+        if (nullptr != pieces) pieces[nb] = piece_s{start, fmt.size() - start, NO_ARG};
+        nb++;
+    }
+    return nb;
+}
+
+template <size_t N>
+constexpr std::array<piece_s, N> pieces_of(const std::string_view fmt) {
+    std::array<piece_s, N> pieces{};
+    parse(fmt, pieces.data());
+    return pieces;
+}
+
+template <size_t N>
+constexpr size_t args_nb(const std::array<piece_s, N> & pieces) {
+    size_t nb = 0;
+    for (size_t i = 0; i < N; i++) if (NO_ARG != pieces[i].arg) nb++;
+    return nb;
+}
+
+template <size_t N>
+constexpr size_t literals_size(const std::array<piece_s, N> & pieces) {
+    size_t size = 0;
+    for (size_t i = 0; i < N; i++) size += pieces[i].size;
+    return size;
+}
+
+// Remove the directories, as bxilog_logger_log() does
+constexpr std::string_view basename(const std::string_view path) {
+    const size_t slash = path.rfind('/');
+    return (std::string_view::npos == slash) ? path : path.substr(slash + 1);
+}
+
+// Everything the compiler knows about a format
+template <typename Fmt>
+struct format_traits {
+    static constexpr std::string_view str = Fmt::str();
+    static constexpr size_t parsed_nb = parse(str, nullptr);
+    static_assert(BAD_FORMAT != parsed_nb,
+                  "bxilog: unbalanced brace in the format, use {} for an argument, "
+                  "{{ and }} for the braces");
+    static constexpr size_t pieces_nb = (BAD_FORMAT == parsed_nb) ? 0 : parsed_nb;
+    static constexpr std::array<piece_s, pieces_nb> pieces = pieces_of<pieces_nb>(str);
+    static constexpr size_t args_nb = detail::args_nb(pieces);
+    static constexpr size_t literals_size = detail::literals_size(pieces);
+    static constexpr std::string_view file = basename(Fmt::file());
+};
+
+inline arg_s to_arg(const char * const value) {
+    if (nullptr == value) return arg_s{"(null)", 6, {}};
+    return arg_s{value, std::strlen(value), {}};
+}
+
+inline arg_s to_arg(const std::string & value) {
+    return arg_s{value.data(), value.size(), {}};
+}
+
+inline arg_s to_arg(const std::string_view value) {
+    return arg_s{value.data(), value.size(), {}};
+}
+
+inline arg_s to_arg(const bool value) {
+    return value ? arg_s{"true", 4, {}} : arg_s{"false", 5, {}};
+}
+
+inline arg_s to_arg(const char value) {
+    arg_s arg{nullptr, 1, {}};
+    arg.buf[0] = value;
+    return arg;
+}
+
+template <typename T>
+std::enable_if_t<std::is_arithmetic_v<T>, arg_s> to_arg(const T value) {
+    arg_s arg{nullptr, 0, {}};
+    std::to_chars_result result;
+    if constexpr (std::is_floating_point_v<T>) {
+        result = std::to_chars(arg.buf, arg.buf + sizeof(arg.buf), value);
+    } else if constexpr (std::is_signed_v<T>) {
+        result = std::to_chars(arg.buf, arg.buf + sizeof(arg.buf),
+                               static_cast<long long>(value));
+    } else {
+        result = std::to_chars(arg.buf, arg.buf + sizeof(arg.buf),
+                               static_cast<unsigned long long>(value));
+    }
+    arg.size = static_cast<size_t>(result.ptr - arg.buf);
+    return arg;
+}
+
+template <typename T>
+std::enable_if_t<std::is_enum_v<T>, arg_s> to_arg(const T value) {
+    return to_arg(static_cast<std::underlying_type_t<T>>(value));
+}
+
+template <typename T>
+arg_s to_arg(const T * const value) {
+    arg_s arg{nullptr, 2, {'0', 'x'}};
+    const std::to_chars_result result = std::to_chars(arg.buf + 2, arg.buf + sizeof(arg.buf),
+                                                      reinterpret_cast<uintptr_t>(value), 16);
+    arg.size = static_cast<size_t>(result.ptr - arg.buf);
+    return arg;
+}
+
+} // namespace detail
+
+/**
+ * A format parsed at compile time, and its call site.
+ *
+ * Use BXILOG_FMT() to create one.
+ */
+template <typename Fmt>
+struct format {
+    const char * funcname;          //!< The calling function
+    size_t funcname_len;            //!< Including the NULL terminating byte
+    int line;                       //!< The calling line
+};
+
+namespace detail {
+
+template <typename Fmt>
+constexpr format<Fmt> make_format(Fmt, const char * const funcname,
+                                  const size_t funcname_len, const int line) {
+    return format<Fmt>{funcname, funcname_len, line};
+}
+
+} // namespace detail
+
+// *********************************************************************************
+// ********************************** Interface ************************************
+// *********************************************************************************
+
+/**
+ * Create a log unconditionally with the given format and arguments.
+ *
+ * @param[in] logger the logger to perform the log with
+ * @param[in] fmt the format, see BXILOG_FMT()
+ * @param[in] args the arguments, one for each `{}` of the format
+ *
+ * @return BXIERR_OK on success, any other value is an error
+ *
+ * @see bxilog_logger_log_rawstr()
+ */
+template <bxilog_level_e Level, typename Fmt, typename... Args>
+bxierr_p log_nolevelcheck(const bxilog_logger_p logger, const format<Fmt> & fmt,
+                          const Args &... args) {
+    using traits = detail::format_traits<Fmt>;
+    static_assert(traits::args_nb == sizeof...(Args),
+                  "bxilog: the number of {} in the format does not match the "
+                  "number of arguments");
+
+    const std::array<detail::arg_s, sizeof...(Args)> converted{{detail::to_arg(args)...}};
+    // The exact size of the message, the NULL terminating byte excluded
+    size_t size = traits::literals_size;
+    for (const detail::arg_s & arg : converted) size += arg.size;
+
+    char stack_buf[BXILOG_CXX_BUF_SIZE];
+    std::unique_ptr<char[]> heap_buf;
+    char * buf = stack_buf;
+    if (size >= sizeof(stack_buf)) {
+        heap_buf.reset(new char[size + 1]);
+        buf = heap_buf.get();
+    }
+
+    char * cursor = buf;
+    for (const detail::piece_s & piece : traits::pieces) {
+        if (detail::NO_ARG == piece.arg) {
+            std::memcpy(cursor, traits::str.data() + piece.offset, piece.size);
+            cursor += piece.size;
+        } else {
+            const detail::arg_s & arg = converted[piece.arg];
+            std::memcpy(cursor, arg.data(), arg.size);
+            cursor += arg.size;
+        }
+    }
+    *cursor = '\0';
+
+    return bxilog_logger_log_rawstr(logger, Level,
+                                    traits::file.data(), traits::file.size() + 1,
+                                    fmt.funcname, fmt.funcname_len, fmt.line,
+                                    buf, size + 1);
+}
+
+/**
+ * Produce a log at the given level with the given format and arguments.
+ *
+ * Contrary to BXILOG_LOG(), the arguments are evaluated even when the logger is
+ * not enabled for the level.
+ *
+ * @param[in] logger the logger to perform the log with
+ * @param[in] fmt the format, see BXILOG_FMT()
+ * @param[in] args the arguments, one for each `{}` of the format
+ */
+template <bxilog_level_e Level, typename Fmt, typename... Args>
+void log(const bxilog_logger_p logger, const format<Fmt> & fmt, const Args &... args) {
+    if (!BXILOG_IS_COMPILED(Level) || !bxilog_logger_is_enabled_for(logger, Level)) return;
+
+    bxierr_p err = log_nolevelcheck<Level>(logger, fmt, args...);
+    if (bxierr_isko(err)) bxierr_report(&err, STDOUT_FILENO);
+}
+
+} // namespace bxilog
+
+#endif /* BXILOG_HPP_ */
@@ -53,6 +53,30 @@
 // ********************************** Types   **************************************
 // *********************************************************************************
 
+/**
+ * What bxilog does in a process calling fork().
+ */
+typedef enum {
+    BXILOG_FORK_RESTART,                        //!< The parent stops its handlers and
+                                                //!< starts them again after the fork(),
+                                                //!< the child must call bxilog_init()
+    BXILOG_FORK_QUIESCE,                        //!< The parent only waits for the logs
+                                                //!< in progress and keeps its handlers,
+                                                //!< the child starts the configured
+                                                //!< handlers on its first log
+} bxilog_fork_mode_e;
+
+/**
+ * Where bxilog runs the handlers callbacks.
+ */
+typedef enum {
+    BXILOG_HANDLERS_THREADED,                   //!< Each handler runs in its own thread,
+                                                //!< logs are sent to it through zmq
+    BXILOG_HANDLERS_INLINE,                     //!< Handlers run on the logging thread
+                                                //!< under a lock: no thread, no zmq.
+                                                //!< Suitable for short-lived processes
+} bxilog_handlers_mode_e;
+
 /**
  * The bxilog configuration structure.
  */
@@ -66,6 +90,20 @@ typedef struct {
                                                 //!< at least)
     bxilog_handler_p * handlers;                //!< The handlers list
     bxilog_handler_param_p * handlers_params;   //!< The handler parameters list
+    bxilog_fork_mode_e fork_mode;               //!< What to do on fork()
+    long handlers_deadline_ms;                  //!< How long to wait in total for
+                                                //!< all handlers to start (resp. stop),
+                                                //!< -1 to wait forever
+    bxilog_handlers_mode_e handlers_mode;       //!< Where handlers run
+    long stats_period_ms;                       //!< How often statistics are logged,
+                                                //!< 0 to never log them
+    bool handlers_process_time;                 //!< Also measure the time handlers
+                                                //!< spend on each record
+    bool handlers_latency_dump;                 //!< Print the latency histograms of
+                                                //!< each handler on stderr at exit
+    bool handlers_talkers;                      //!< Track the loggers and call sites
+                                                //!< producing the most records in
+                                                //!< each handler (see bxilog_talker_s)
 } bxilog_config_s;
 
 /**
@@ -18,6 +18,7 @@
 #include "bxi/base/err.h"
 
 #include "bxi/base/log/filter.h"
+#include "bxi/base/log/stats.h"
 
 
 /**
@@ -247,6 +248,15 @@ struct bxilog_handler_s_f {
      * @param[in] param the log handler parameter as returned by param_new()
      */
     bxierr_p (*param_destroy)(bxilog_handler_param_p* param);
+
+    /**
+     * Fill the handler specific fields of the given statistics (optional).
+     *
+     * @param[in] param the log handler parameter as returned by param_new()
+     * @param[inout] stats the statistics of the handler
+     */
+    bxierr_p (*process_stats)(bxilog_handler_param_p param,
+                              bxilog_handler_stats_p stats);
 };
 
 
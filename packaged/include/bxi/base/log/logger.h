@@ -32,6 +32,31 @@
 // *********************************************************************************
 // ********************************** Defines **************************************
 // *********************************************************************************
+#ifndef BXILOG_COMPILE_MIN_LEVEL
+/**
+ * The most verbose level compiled in: log calls at a level above it
+ * (e.g. `TRACE` with `-DBXILOG_COMPILE_MIN_LEVEL=BXILOG_DEBUG`) compile to nothing.
+ *
+ * Such calls are never produced, whatever the logger level, and their arguments
+ * are not evaluated, but they are still type-checked against the format.
+ * The library itself is compiled with the value given to the
+ * `--with-compile-min-level` configure option.
+ *
+ * @see BXILOG_IS_COMPILED
+ */
+#define BXILOG_COMPILE_MIN_LEVEL BXILOG_LOWEST
+#endif
+
+/**
+ * Return true if log calls at the given level are compiled in.
+ *
+ * This is a constant expression when the level is, so the compiler removes
+ * the log calls it guards.
+ *
+ * @see BXILOG_COMPILE_MIN_LEVEL
+ */
+#define BXILOG_IS_COMPILED(lvl) ((lvl) <= BXILOG_COMPILE_MIN_LEVEL)
+
 /**
  * Produce a log at the `BXILOG_LOWEST` level
  */
@@ -91,7 +116,8 @@
 // TODO: do log the actual log also with the same format than the actual log instead
 // of throwing it away
 #define bxilog_logger_log(logger, lvl, filename, filename_len, funcname, funcname_len, line, ...) do {\
-        if (bxilog_logger_is_enabled_for((logger), (lvl))) {                            \
+        if (BXILOG_IS_COMPILED(lvl)                                                     \
+            && bxilog_logger_is_enabled_for((logger), (lvl))) {                         \
             bxierr_p __err__ = bxilog_logger_log_nolevelcheck((logger), (lvl),          \
                                                        (filename), (filename_len),      \
                                                        (funcname), (funcname_len),      \
@@ -114,7 +140,8 @@
                                         false, \
                                         logger_name,\
                                         ARRAYLEN(logger_name),\
-                                        BXILOG_LOWEST\
+                                        BXILOG_LOWEST,\
+                                        0\
     };\
     static bxilog_logger_p const variable_name = &variable_name ## _s;\
     static __attribute__((constructor)) void __bxilog_register_log__ ## variable_name(void) {\
@@ -166,6 +193,7 @@ struct bxilog_logger_s {
     const char * name;              //!< Logger name
     size_t name_length;             //!< Logger name length, including NULL ending byte
     bxilog_level_e level;           //!< Logger level
+    unsigned epoch;                 //!< Configuration epoch the level was computed for
 };
 
 
@@ -182,7 +210,14 @@ typedef struct bxilog_logger_s * bxilog_logger_p;
 // ********************************** Global Variables *****************************
 // *********************************************************************************
 
-
+#ifndef BXICFFI
+/**
+ * The current configuration epoch, incremented each time the configuration changes.
+ *
+ * @note: this is for internal purpose, see bxilog_logger_is_enabled_for().
+ */
+extern unsigned bxilog__config_epoch;
+#endif
 
 // *********************************************************************************
 // ********************************** Interface ************************************
@@ -319,6 +354,9 @@ void bxilog_logger_set_level(const bxilog_logger_p logger, const bxilog_level_e
 /**
  * Reconfigure the given logger according to the current bxilog configuration.
  *
+ * @note this is done automatically on the first use of a logger after a configuration
+ * change (see bxilog_logger_is_enabled_for()).
+ *
  * @param[inout] logger the logger instance to reconfigure
  */
 void bxilog_logger_reconfigure(const bxilog_logger_p logger);
@@ -336,6 +374,12 @@ inline bool bxilog_logger_is_enabled_for(const bxilog_logger_p logger,
                                          const bxilog_level_e level) {
 
     bxiassert(logger != NULL && level <= BXILOG_LOWEST);
+    // The level is computed lazily: only loggers actually used after a configuration
+    // change pay for it.
+    if (__builtin_expect(__atomic_load_n(&logger->epoch, __ATOMIC_RELAXED)
+                         != __atomic_load_n(&bxilog__config_epoch, __ATOMIC_ACQUIRE), 0)) {
+        bxilog_logger_reconfigure(logger);
+    }
     return level <= logger->level && level != BXILOG_OFF;
 }
 #else
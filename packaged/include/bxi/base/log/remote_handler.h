@@ -9,6 +9,12 @@
  * @brief  The Monitor Logging Handler
  *
  * The remote handler sends logs through a ZMQ socket.
+ *
+ * Records are sent in batches, using a compact encoding independent of the host
+ * word size and byte order. Each record carries its own level: the level header of a
+ * batch is the one of its most severe record, so subscribers filtering on it must
+ * still check the level of each record.
+ * A batch is sent when it is full, and at each flush.
  */
 
 
@@ -56,8 +62,29 @@
  */
 
 extern const bxilog_handler_p BXILOG_REMOTE_HANDLER;
+
+/**
+ * The Relay Handler.
+ *
+ * A remote handler meant to forward upstream the logs received by a
+ * ::bxilog_remote_receiver_p, turning the fan-in of many publishers into a tree.
+ * When the upstream is too slow, or has not subscribed yet, batches are written
+ * to a spool file instead of being dropped, and sent again in order as soon as
+ * possible. Unsent batches
+ * are kept in the spool on exit and sent by the next run.
+ *
+ * Parameters for the ::bxilog_handler_p.param_new() function are those of
+ * ::BXILOG_REMOTE_HANDLER followed by:
+ *
+ * @param[in] spool_dir a `char *` string; the directory of the spool file
+ *
+ * @note requires zeromq >= 4.1, otherwise batches are dropped as with
+ *       ::BXILOG_REMOTE_HANDLER
+ */
+extern const bxilog_handler_p BXILOG_REMOTE_RELAY_HANDLER;
 #else
 extern bxilog_handler_p BXILOG_REMOTE_HANDLER;
+extern bxilog_handler_p BXILOG_REMOTE_RELAY_HANDLER;
 #endif
 
 
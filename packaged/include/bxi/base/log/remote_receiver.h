@@ -30,6 +30,36 @@
 
 typedef struct bxilog_remote_receiver_s * bxilog_remote_receiver_p;
 
+/**
+ * Throughput counters of a remote receiver worker thread.
+ */
+typedef struct {
+    size_t records_nb;          //!< Number of records dispatched to the handlers
+    size_t batches_nb;          //!< Number of batches received
+    size_t bytes_nb;            //!< Number of bytes received
+    size_t errors_nb;           //!< Number of batches or records rejected
+    size_t lost_nb;             //!< Number of records lost on their way
+    size_t reordered_nb;        //!< Number of records received out of order
+} bxilog_remote_receiver_stats_s;
+
+typedef bxilog_remote_receiver_stats_s * bxilog_remote_receiver_stats_p;
+
+/**
+ * Records accounting of a publisher.
+ *
+ * Records of each publisher are numbered: gaps in the numbering are accounted
+ * as lost records (e.g. dropped by a PUB zocket reaching its high water mark).
+ * Records received after a gap that fill it are accounted as reordered.
+ */
+typedef struct {
+    char * url;                 //!< The publisher identifier (its url)
+    size_t received_nb;         //!< Number of records received
+    size_t lost_nb;             //!< Number of records lost
+    size_t reordered_nb;        //!< Number of records received out of order
+} bxilog_remote_receiver_pub_stats_s;
+
+typedef bxilog_remote_receiver_pub_stats_s * bxilog_remote_receiver_pub_stats_p;
+
 
 //*********************************************************************************
 //****************************  Global Variables  *********************************
@@ -96,6 +126,67 @@ bxierr_p bxilog_remote_receiver_stop(bxilog_remote_receiver_p self,
                                      bool wait_remote_exit);
 
 
+/**
+ * Set the number of worker threads receiving the logs.
+ *
+ * Publishers are spread among the workers: when connecting, the i-th url is handled
+ * by the worker i modulo workers_nb; when binding, each worker binds its own data
+ * url and new publishers are assigned to workers in a round-robin fashion.
+ *
+ * The records of a publisher are all received by the same worker: when connecting,
+ * workers_nb can't therefore exceed the number of urls.
+ *
+ * @param[in] self the receiver
+ * @param[in] workers_nb the number of workers (default: 1)
+ *
+ * @return BXIERR_OK on success, anything else on error.
+ *
+ * @note must be called before bxilog_remote_receiver_start()
+ */
+bxierr_p bxilog_remote_receiver_set_workers_nb(bxilog_remote_receiver_p self,
+                                               size_t workers_nb);
+
+
+/**
+ * Fetch the throughput counters of each worker.
+ *
+ * Counters are reset on bxilog_remote_receiver_start() and kept after
+ * bxilog_remote_receiver_stop().
+ *
+ * @param[in] self the receiver
+ * @param[out] stats an array of at least stats_nb counters
+ * @param[in] stats_nb the size of the stats array
+ *
+ * @return the number of workers or 0 if the receiver has never been started
+ */
+size_t bxilog_remote_receiver_get_stats(bxilog_remote_receiver_p self,
+                                        bxilog_remote_receiver_stats_s * stats,
+                                        size_t stats_nb);
+
+
+/**
+ * Fetch the records accounting of each publisher known by the receiver.
+ *
+ * @param[in] self the receiver
+ * @param[out] stats a newly allocated array of the publishers accounting,
+ *             to be released with bxilog_remote_receiver_free_pub_stats()
+ *
+ * @return the number of publishers
+ */
+size_t bxilog_remote_receiver_get_pub_stats(bxilog_remote_receiver_p self,
+                                            bxilog_remote_receiver_pub_stats_p * stats);
+
+
+/**
+ * Release the array returned by bxilog_remote_receiver_get_pub_stats().
+ *
+ * @param[in] stats the array to release
+ * @param[in] stats_nb the number of items in the array
+ */
+void bxilog_remote_receiver_free_pub_stats(bxilog_remote_receiver_pub_stats_p stats,
+                                           size_t stats_nb);
+
+
 /**
  * Return the urls that the internal thread has binded to or NULL if not applicable.
  *
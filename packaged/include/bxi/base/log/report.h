@@ -31,6 +31,9 @@
  *
  * Note the given err is assigned ::BXIERR_OK.
  *
+ * When the given level is not compiled in (see ::BXILOG_COMPILE_MIN_LEVEL),
+ * the error is just destroyed.
+ *
  * Basic usage is:
  * ~~~{C}
  * err = f(...);
@@ -46,10 +49,15 @@
  * @see bxilog_report_keep
  */
 #define BXILOG_REPORT(logger, level, err, ...) do {                                 \
-        bxilog_report((logger), (level), (&err),                                     \
-                      (char *)__FILE__, ARRAYLEN(__FILE__),                         \
-                      __func__, ARRAYLEN(__func__),                                 \
-                      __LINE__, __VA_ARGS__);                                     \
+        if (BXILOG_IS_COMPILED(level)) {                                            \
+            bxilog_report((logger), (level), (&err),                                 \
+                          (char *)__FILE__, ARRAYLEN(__FILE__),                     \
+                          __func__, ARRAYLEN(__func__),                             \
+                          __LINE__, __VA_ARGS__);                                   \
+        } else {                                                                    \
+            bxierr_destroy(&err);                                                   \
+            err = BXIERR_OK;                                                        \
+        }                                                                           \
     } while(false)
 
 
@@ -74,10 +82,12 @@
  * @see bxilog_report
  */
 #define BXILOG_REPORT_KEEP(logger, level, err, ...) do {                             \
-        bxilog_report_keep((logger), (level), (&err),                                     \
-                           (char *)__FILE__, ARRAYLEN(__FILE__),                         \
-                           __func__, ARRAYLEN(__func__),                                 \
-                           __LINE__, __VA_ARGS__);                                     \
+        if (BXILOG_IS_COMPILED(level)) {                                                 \
+            bxilog_report_keep((logger), (level), (&err),                                 \
+                               (char *)__FILE__, ARRAYLEN(__FILE__),                     \
+                               __func__, ARRAYLEN(__func__),                             \
+                               __LINE__, __VA_ARGS__);                                   \
+        }                                                                                \
     } while(false)
 
 // *********************************************************************************
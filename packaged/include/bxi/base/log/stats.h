@@ -0,0 +1,259 @@
+/* -*- coding: utf-8 -*-  */
+
+#ifndef BXILOG_STATS_H_
+#define BXILOG_STATS_H_
+
+#ifndef BXICFFI
+#include <stdlib.h>
+#include <stdint.h>
+#endif
+
+
+#include "bxi/base/mem.h"
+#include "bxi/base/err.h"
+
+
+/**
+ * @file    stats.h
+ * @authors agent <agent@local>
+ * @copyright 2026  Bull S.A.S.  -  All rights reserved.\n
+ *         This is not Free or Open Source software.\n
+ *         Please contact Bull SAS for details about its license.\n
+ *         Bull - Rue Jean Jaurès - B.P. 68 - 78340 Les Clayes-sous-Bois
+ * @brief  BXI Log Statistics
+ *
+ * This module gives access to the counters maintained by the logging threads and
+ * by the handlers since the last call to ::bxilog_init().
+ *
+ * When the configuration field `stats_period_ms` is not 0, those statistics are
+ * also logged periodically at the ::BXILOG_INFO level by the
+ * `BXILOG_LIB_PREFIX "bxilog.stats"` logger, from a thread of the library: the
+ * logging threads never wait for them.
+ */
+
+// *********************************************************************************
+// ********************************** Defines **************************************
+// *********************************************************************************
+
+/**
+ * Define the error code when an error occurred while gathering statistics
+ *
+ * @note the bxierr_p.data holds a bxierr_group data containing all errors
+ * encountered while asking each handler. This data will be freed when the error
+ * is freed.
+ *
+ * @see bxilog_stats_get()
+ */
+#define BXILOG_STATS_ERR 57475   // STATS in leet speak
+
+/**
+ * Number of sub-buckets of each power of 2 in a ::bxilog_histogram_s, as a power of 2:
+ * the relative error of a recorded value is below 1/8 (12.5%).
+ */
+#define BXILOG_HISTOGRAM_SUB_BITS 3
+
+/**
+ * Values greater or equal to 2^BXILOG_HISTOGRAM_MAX_EXP are recorded in the last bucket
+ * (with nanoseconds, this is about 18 minutes).
+ */
+#define BXILOG_HISTOGRAM_MAX_EXP 40
+
+/**
+ * Number of buckets of a ::bxilog_histogram_s:
+ * (BXILOG_HISTOGRAM_MAX_EXP - BXILOG_HISTOGRAM_SUB_BITS + 1) << BXILOG_HISTOGRAM_SUB_BITS
+ */
+#define BXILOG_HISTOGRAM_BUCKETS_NB 304
+
+/**
+ * Number of timed stages of the logging pipeline, see ::bxilog_stage_e
+ */
+#define BXILOG_STAGES_NB 5
+
+/**
+ * Number of top talkers reported per handler, see ::bxilog_talker_s
+ */
+#define BXILOG_TALKERS_NB 10
+
+/**
+ * Maximum length of the name of a talker, including the terminating null byte:
+ * longer names are truncated.
+ */
+#define BXILOG_TALKER_NAME_LEN 64
+
+// *********************************************************************************
+// ********************************** Types   **************************************
+// *********************************************************************************
+
+/**
+ * A log-linear histogram of durations in nanoseconds.
+ *
+ * Values below 2^BXILOG_HISTOGRAM_SUB_BITS have their own bucket, each larger
+ * power of 2 is split into 2^BXILOG_HISTOGRAM_SUB_BITS buckets of the same width.
+ * A histogram is updated by a single thread: it needs neither lock nor atomic.
+ */
+typedef struct {
+    uint64_t count;                                 //!< Number of recorded values
+    uint64_t min;                                   //!< Smallest recorded value
+    uint64_t max;                                   //!< Largest recorded value
+    uint64_t sum;                                   //!< Sum of the recorded values
+    uint64_t buckets[BXILOG_HISTOGRAM_BUCKETS_NB];  //!< Number of values per bucket
+} bxilog_histogram_s;
+
+/**
+ * A histogram.
+ */
+typedef bxilog_histogram_s * bxilog_histogram_p;
+
+/**
+ * The stages of the logging pipeline timed when the library is configured with
+ * `--enable-stages-timing` (BXILOG_STAGES_TIMING).
+ *
+ * The level check is done by the caller before entering the library: it is not
+ * timed here.
+ */
+typedef enum {
+    BXILOG_STAGE_FORMAT,                //!< Formatting of the log message (vsnprintf)
+    BXILOG_STAGE_RECORD,                //!< Building of the record sent to handlers
+    BXILOG_STAGE_SEND,                  //!< Sending the record to all handlers (zmq)
+    BXILOG_STAGE_RECEIVE,               //!< Receiving a record by a handler (zmq)
+    BXILOG_STAGE_FILTER,                //!< Matching a record against handler filters
+} bxilog_stage_e;
+
+/**
+ * The cost of a stage of the logging pipeline.
+ */
+typedef struct {
+    uint64_t count;                     //!< Number of times the stage was run
+    uint64_t ticks;                     //!< Total time spent in the stage, in cycles
+                                        //!< where a cycle counter is available,
+                                        //!< in nanoseconds otherwise
+} bxilog_stage_stats_s;
+
+/**
+ * The volume of records processed by a handler coming from a given logger or a
+ * given call site, when the configuration field `handlers_talkers` is set.
+ *
+ * Each handler tracks a bounded number of loggers and call sites: when a new one
+ * must be tracked, it replaces the one with the fewest bytes and inherits its
+ * counters. Therefore, counters are upper bounds, overestimated by at most
+ * `records_error_nb` and `bytes_error_nb`, and the largest talkers are always found.
+ */
+typedef struct {
+    char name[BXILOG_TALKER_NAME_LEN];  //!< The logger name or the call site file name
+    int line;                           //!< The call site line, 0 for a logger
+    uint64_t records_nb;                //!< Records processed
+    uint64_t bytes_nb;                  //!< Bytes of the log messages processed
+    uint64_t records_error_nb;          //!< Maximum overestimation of records_nb
+    uint64_t bytes_error_nb;            //!< Maximum overestimation of bytes_nb
+} bxilog_talker_s;
+
+/**
+ * The statistics of a single handler.
+ */
+typedef struct {
+    char * name;                        //!< The name of the handler
+    size_t queue_depth;                 //!< Records sent to the handler but not
+                                        //!< processed yet (approximation)
+    size_t processed_nb;                //!< Records given to the handler
+    size_t filtered_nb;                 //!< Records rejected by the handler filters
+    size_t dropped_nb;                  //!< Records that could not be sent to the
+                                        //!< handler
+    size_t retried_nb;                  //!< Records sent to the handler only after
+                                        //!< retries (its queue was full)
+    size_t flushes_nb;                  //!< Implicit and explicit flushes
+    double flushes_duration;            //!< Total time spent flushing, in seconds
+    double flush_max_duration;          //!< Longest flush, in seconds
+    size_t bytes_written;               //!< Bytes written, if the handler counts them
+    size_t bytes_lost;                  //!< Bytes lost, if the handler counts them
+    bxilog_histogram_s queue_delay;     //!< From the creation of each processed record
+                                        //!< to its processing by the handler
+    bxilog_histogram_s process_time;    //!< Time spent by the handler on each processed
+                                        //!< record, if `handlers_process_time` is set
+    bxilog_stage_stats_s stages[BXILOG_STAGES_NB]; //!< Cost of the handler stages
+                                        //!< (BXILOG_STAGE_RECEIVE, BXILOG_STAGE_FILTER)
+    bxilog_talker_s top_loggers[BXILOG_TALKERS_NB]; //!< Loggers producing the most
+                                        //!< bytes first, unused entries have no record
+    bxilog_talker_s top_sites[BXILOG_TALKERS_NB];   //!< Same for call sites
+} bxilog_handler_stats_s;
+
+/**
+ * The statistics of a handler.
+ */
+typedef bxilog_handler_stats_s * bxilog_handler_stats_p;
+
+/**
+ * The logging statistics, aggregated across threads.
+ */
+typedef struct {
+    size_t threads_nb;                  //!< Number of threads that produced logs
+    size_t log_nb;                      //!< Number of logs produced
+    size_t rsz_log_nb;                  //!< Logs that did not fit in the thread buffer
+    size_t min_log_size;                //!< Size of the smallest log message (0 if none)
+    size_t max_log_size;                //!< Size of the largest log message
+    size_t sum_log_size;                //!< Size of all log messages
+    bxilog_stage_stats_s stages[BXILOG_STAGES_NB]; //!< Cost of the logging threads
+                                        //!< stages (BXILOG_STAGE_FORMAT,
+                                        //!< BXILOG_STAGE_RECORD, BXILOG_STAGE_SEND)
+    size_t handlers_nb;                 //!< Number of handlers
+    bxilog_handler_stats_p handlers;    //!< The statistics of each handler
+} bxilog_stats_s;
+
+/**
+ * The logging statistics.
+ */
+typedef bxilog_stats_s * bxilog_stats_p;
+
+// *********************************************************************************
+// ********************************** Global Variables *****************************
+// *********************************************************************************
+
+
+
+// *********************************************************************************
+// ********************************** Interface ************************************
+// *********************************************************************************
+
+/**
+ * Return the current logging statistics.
+ *
+ * Each running handler is asked for its own counters: this function must not be
+ * called from a handler.
+ *
+ * @param[out] result a pointer on the new statistics, to be released with
+ *             ::bxilog_stats_destroy(). It is set even when some handlers could not
+ *             be reached (their counters are then left to 0), unless the library
+ *             is not initialized.
+ *
+ * @return BXIERR_OK on success, any other values is an error
+ */
+bxierr_p bxilog_stats_get(bxilog_stats_p * result);
+
+/**
+ * Record the given value in the given histogram.
+ *
+ * @param[inout] self a histogram
+ * @param[in] value the value to record
+ */
+void bxilog_histogram_add(bxilog_histogram_p self, uint64_t value);
+
+/**
+ * Return the value below which the given percentage of recorded values fall.
+ *
+ * The result is the upper bound of the bucket holding the percentile, bounded by
+ * the largest recorded value.
+ *
+ * @param[in] self a histogram
+ * @param[in] percentile between 0 and 100
+ *
+ * @return the requested percentile, 0 if no value has been recorded
+ */
+uint64_t bxilog_histogram_percentile(const bxilog_histogram_p self, double percentile);
+
+/**
+ * Release the given statistics and nullify the pointer.
+ *
+ * @param[inout] stats_p a pointer on the statistics returned by ::bxilog_stats_get()
+ */
+void bxilog_stats_destroy(bxilog_stats_p * stats_p);
+
+#endif /* BXILOG_STATS_H_ */
@@ -67,6 +67,41 @@ typedef struct {
  */
 typedef bxistr_prefixer_s * bxistr_prefixer_p;
 
+/**
+ * A string builder structure.
+ *
+ * The string being built is always NULL terminated: `buf` can be used directly
+ * as long as the builder is not modified.
+ */
+typedef struct {
+    bool allocated;                 //!< if true, the structure has been mallocated
+    int tls_slot;                   //!< the thread-local slot of the builder, -1 if none
+    char * buf;                     //!< the string being built (NULL until first append)
+    size_t len;                     //!< the length of the string being built
+    size_t size;                    //!< the number of bytes allocated for buf
+} bxistr_builder_s;
+
+/**
+ * A string builder object.
+ *
+ * @see bxistr_builder_get
+ * @see bxistr_builder_release
+ * @see bxistr_builder_init
+ * @see bxistr_builder_cleanup
+ */
+typedef bxistr_builder_s * bxistr_builder_p;
+
+/**
+ * The instruction sets the string kernels can use.
+ *
+ * @see bxistr_simd_set()
+ */
+typedef enum {
+    BXISTR_SIMD_SCALAR,             //!< portable C code only
+    BXISTR_SIMD_SSE2,               //!< 16 bytes at a time (x86_64 only)
+    BXISTR_SIMD_AVX2,               //!< 32 bytes at a time (x86_64 only)
+} bxistr_simd_e;
+
 // *********************************************************************************
 // ********************************** Global Variables *****************************
 // *********************************************************************************
@@ -112,6 +147,40 @@ char * bxistr_new(const char * fmt, ...)
  */
 size_t bxistr_vnew(char ** str_p, const char * fmt, va_list ap);
 
+/**
+ * Format the given printf style `fmt` parameter into the given buffer.
+ *
+ * This is equivalent to vsnprintf() for the C locale: at most `size - 1` bytes
+ * are written followed by a NULL byte, and the length of the whole result is
+ * returned. Integers, strings, characters and pointers are formatted in-tree,
+ * without locale support, floats with snprintf() one at a time. Other
+ * conversions (`%n`, `%ls`, `%m`, positional arguments, ...) fall back to
+ * vsnprintf() for the whole format.
+ *
+ * @param[out] buf the buffer, can be NULL if `size` is 0
+ * @param[in] size the size of `buf` in bytes
+ * @param[in] fmt the printf-like format string
+ * @param[in] ap the list of printf-like format arguments
+ *
+ * @return the length of the formatted string, NULL byte excluded
+ *
+ * @see bxistr_vformat_len()
+ */
+size_t bxistr_vformat(char * buf, size_t size, const char * fmt, va_list ap);
+
+/**
+ * Return the exact length of the string formatted from the given printf
+ * style `fmt` parameter, NULL byte excluded, without writing it.
+ *
+ * @param[in] fmt the printf-like format string
+ * @param[in] ap the list of printf-like format arguments
+ *
+ * @return the length of the formatted string
+ *
+ * @see bxistr_vformat()
+ */
+size_t bxistr_vformat_len(const char * fmt, va_list ap);
+
 /**
  * Return a string representation of the given signal number using the
  * given siginfo or sfdinfo (only one must be NULL).
@@ -129,6 +198,37 @@ char * bxistr_from_signal(const siginfo_t * siginfo,
 
 #endif
 
+/**
+ * Equivalent to `bxistr_vformat()` with a variable number of arguments.
+ *
+ * @param[out] buf the buffer, can be NULL if `size` is 0
+ * @param[in] size the size of `buf` in bytes
+ * @param[in] fmt the printf-like format string and their arguments.
+ *
+ * @return the length of the formatted string, NULL byte excluded
+ */
+size_t bxistr_format(char * buf, size_t size, const char * fmt, ...)
+#ifndef BXICFFI
+    __attribute__ ((format (printf, 3, 4)))
+#endif
+                             ;
+
+/**
+ * Find the newline characters of the given string, in a single pass.
+ *
+ * The scan stops at the `offsets_max`-th newline: when the result is
+ * `offsets_max`, call again from the byte following the last stored offset
+ * to find the next ones.
+ *
+ * @param[in] str the string to scan
+ * @param[in] len the number of bytes to scan
+ * @param[out] offsets the offsets of the newline characters found in `str`
+ * @param[in] offsets_max the number of elements in `offsets`
+ *
+ * @return the number of offsets stored
+ */
+size_t bxistr_newlines(const char * str, size_t len, size_t * offsets, size_t offsets_max);
+
 /**
  * Apply the given function to each line of the given string.
  *
@@ -322,6 +422,132 @@ bxierr_p bxistr_hex2bytes(char * s, size_t len, uint8_t ** pbuf);
  */
 bxierr_p bxistr_bytes2hex(uint8_t * buf, size_t len, char ** ps);
 
+/**
+ * Return a string builder taken from the calling thread, empty.
+ *
+ * The buffers of such builders are kept between uses, so building a string
+ * does not allocate any memory once they have grown enough. A few builders
+ * are available per thread, so a function using a builder can call another
+ * one using a builder too. When all are in use, a new one is allocated.
+ *
+ * The builder must be given back using bxistr_builder_release().
+ *
+ * @return an empty string builder
+ *
+ * @see bxistr_builder_release()
+ * @see bxistr_builder_take()
+ */
+bxistr_builder_p bxistr_builder_get(void);
+
+/**
+ * Give back the given builder taken by bxistr_builder_get().
+ *
+ * @note: the pointer is nullified.
+ *
+ * @param[inout] self_p a pointer on the builder to release
+ */
+void bxistr_builder_release(bxistr_builder_p * self_p);
+
+/**
+ * Initialize the given string builder that does not belong to any thread.
+ *
+ * @param[out] self the builder to initialize
+ *
+ * @see bxistr_builder_cleanup()
+ */
+void bxistr_builder_init(bxistr_builder_p self);
+
+/**
+ * Release the memory used by the given builder initialized by bxistr_builder_init().
+ *
+ * @param[inout] self the builder to cleanup
+ */
+void bxistr_builder_cleanup(bxistr_builder_p self);
+
+/**
+ * Empty the given builder, keeping its buffer.
+ *
+ * @param[inout] self the builder
+ */
+void bxistr_builder_reset(bxistr_builder_p self);
+
+/**
+ * Append a message from the given printf style `fmt` parameter.
+ *
+ * @param[inout] self the builder
+ * @param[in] fmt the printf-like format string and their arguments.
+ *
+ * @return the number of bytes appended
+ */
+size_t bxistr_builder_append(bxistr_builder_p self, const char * fmt, ...)
+#ifndef BXICFFI
+    __attribute__ ((format (printf, 2, 3)))
+#endif
+                             ;
+
+#ifndef BXICFFI
+/**
+ * Equivalent to `bxistr_builder_append()` with a variable argument list.
+ *
+ * @param[inout] self the builder
+ * @param[in] fmt the printf-like format string
+ * @param[in] ap the list of printf-like format arguments
+ *
+ * @return the number of bytes appended
+ */
+size_t bxistr_builder_vappend(bxistr_builder_p self, const char * fmt, va_list ap);
+#endif
+
+/**
+ * Append the given bytes.
+ *
+ * @param[inout] self the builder
+ * @param[in] bytes the bytes to append
+ * @param[in] len the number of bytes to append
+ */
+void bxistr_builder_append_bytes(bxistr_builder_p self, const char * bytes, size_t len);
+
+/**
+ * Append the decimal representation of the given signed integer.
+ *
+ * @param[inout] self the builder
+ * @param[in] n the integer to append
+ */
+void bxistr_builder_append_int(bxistr_builder_p self, int64_t n);
+
+/**
+ * Append the decimal representation of the given unsigned integer.
+ *
+ * @param[inout] self the builder
+ * @param[in] n the integer to append
+ */
+void bxistr_builder_append_uint(bxistr_builder_p self, uint64_t n);
+
+/**
+ * Return a copy of the string built, allocated with the exact size needed.
+ *
+ * The builder is emptied. The returned string must be released (e.g. using BXIFREE()).
+ *
+ * @param[inout] self the builder
+ * @param[out] len_p if not NULL, the length of the returned string
+ *
+ * @return the string built
+ */
+char * bxistr_builder_take(bxistr_builder_p self, size_t * len_p);
+
+/**
+ * Select the instruction set used by the string kernels.
+ *
+ * The best instruction set supported by the processor is selected at load time:
+ * this is only useful to compare or to test the implementations.
+ *
+ * @param[in] simd the wanted instruction set
+ *
+ * @return the instruction set actually selected, which can be lower than the
+ *         wanted one if the processor does not support it
+ */
+bxistr_simd_e bxistr_simd_set(bxistr_simd_e simd);
+
 /**
  * @example bxistr-examples.c
  * Examples of the bxistr.h module. Compile with `-lbxibase`.
@@ -357,6 +357,22 @@ def init():
     from . import config as bxilogconfig
 
     c_config = __BXIBASE_CAPI__.bxilog_config_new(_PROGNAME.encode("utf-8", "replace"))
+    # 'quiesce': keep handlers running across fork(), children log without init()
+    if _CONFIG.get('fork_mode', 'restart') == 'quiesce':
+        c_config.fork_mode = __BXIBASE_CAPI__.BXILOG_FORK_QUIESCE
+    if 'handlers_deadline_ms' in _CONFIG:
+        c_config.handlers_deadline_ms = int(_CONFIG['handlers_deadline_ms'])
+    # 'inline': handlers run on the logging thread, no handler thread is started
+    if _CONFIG.get('handlers_mode', 'threaded') == 'inline':
+        c_config.handlers_mode = __BXIBASE_CAPI__.BXILOG_HANDLERS_INLINE
+    if 'stats_period_ms' in _CONFIG:
+        c_config.stats_period_ms = int(_CONFIG['stats_period_ms'])
+    if 'handlers_process_time' in _CONFIG:
+        c_config.handlers_process_time = _CONFIG.as_bool('handlers_process_time')
+    if 'handlers_latency_dump' in _CONFIG:
+        c_config.handlers_latency_dump = _CONFIG.as_bool('handlers_latency_dump')
+    if 'handlers_talkers' in _CONFIG:
+        c_config.handlers_talkers = _CONFIG.as_bool('handlers_talkers')
 
     if isinstance(_CONFIG['handlers'], six.string_types):
         handlers = [_CONFIG['handlers']]
@@ -446,6 +462,115 @@ def flush():
     bxierr.BXICError.raise_if_ko(err_p)
 
 
+def get_stats():
+    """
+    Return the logging statistics aggregated across threads.
+
+    @return a dict holding the counters of bxilog_stats_s, the 'handlers' key
+            holds a list of dict, one per handler (see bxilog_handler_stats_s),
+            where 'top_loggers' and 'top_sites' only list used entries
+    """
+    stats_p = __FFI__.new('bxilog_stats_p[1]')
+    err_p = __BXIBASE_CAPI__.bxilog_stats_get(stats_p)
+    try:
+        bxierr.BXICError.raise_if_ko(err_p)
+        cstats = stats_p[0]
+        result = {key: getattr(cstats, key)
+                  for key in ('threads_nb', 'log_nb', 'rsz_log_nb',
+                              'min_log_size', 'max_log_size', 'sum_log_size')}
+        result['handlers'] = []
+        for i in range(cstats.handlers_nb):
+            chandler = cstats.handlers[i]
+            handler = {key: getattr(chandler, key)
+                       for key in ('queue_depth', 'processed_nb', 'filtered_nb',
+                                   'dropped_nb', 'retried_nb', 'flushes_nb',
+                                   'flushes_duration', 'flush_max_duration',
+                                   'bytes_written', 'bytes_lost')}
+            handler['name'] = None if chandler.name == __FFI__.NULL \
+                else __FFI__.string(chandler.name).decode('utf-8', 'replace')
+            for key in ('queue_delay', 'process_time'):
+                handler[key] = _histogram_to_dict(getattr(chandler, key))
+            for key in ('top_loggers', 'top_sites'):
+                handler[key] = [_talker_to_dict(ctalker) for ctalker in getattr(chandler, key)
+                                if ctalker.records_nb > 0]
+            result['handlers'].append(handler)
+    finally:
+        __BXIBASE_CAPI__.bxilog_stats_destroy(stats_p)
+    return result
+
+
+def _histogram_to_dict(chistogram):
+    """
+    Convert the given bxilog_histogram_s into a dict
+
+    @param[in] chistogram a bxilog_histogram_s
+    @return a dict holding its count, min, max, sum and some percentiles (in ns)
+    """
+    result = {key: getattr(chistogram, key) for key in ('count', 'min', 'max', 'sum')}
+    for percentile in (50, 90, 99, 99.9):
+        result['p%s' % percentile] = \
+            __BXIBASE_CAPI__.bxilog_histogram_percentile(__FFI__.addressof(chistogram),
+                                                         percentile)
+    return result
+
+
+def _talker_to_dict(ctalker):
+    """
+    Convert the given bxilog_talker_s into a dict
+
+    @param[in] ctalker a bxilog_talker_s
+    @return a dict holding its name, line and counters
+    """
+    result = {key: getattr(ctalker, key)
+              for key in ('line', 'records_nb', 'bytes_nb',
+                          'records_error_nb', 'bytes_error_nb')}
+    result['name'] = __FFI__.string(ctalker.name).decode('utf-8', 'replace')
+    return result
+
+
+def reconfigure(filters):
+    """
+    Replace the filters of some handlers without restarting them.
+
+    @param[in] filters a dict mapping a handler section name of the current
+               configuration to its new filters string (as defined in
+               ::bxilog_filters_parse()). Other handlers are left untouched.
+
+    @return
+    """
+    if not _INITIALIZED:
+        init()
+
+    if isinstance(_CONFIG['handlers'], six.string_types):
+        handlers = [_CONFIG['handlers']]
+    else:
+        handlers = _CONFIG['handlers']
+
+    unknown = set(filters) - set(handlers)
+    if unknown:
+        raise bxierr.BXIError("Unknown handlers: %s" % ', '.join(sorted(unknown)))
+
+    c_filters = __FFI__.new('bxilog_filters_p[%d]' % len(handlers))
+    for i, section in enumerate(handlers):
+        if section not in filters:
+            continue
+        filters_p = __FFI__.new('bxilog_filters_p[1]')
+        err_p = __BXIBASE_CAPI__.bxilog_filters_parse(filters[section].encode("utf-8",
+                                                                              "replace"),
+                                                      filters_p)
+        if __BXIBASE_CAPI__.bxierr_isko(err_p):
+            for j in range(i):
+                __BXIBASE_CAPI__.bxilog_filters_destroy(c_filters + j)
+        bxierr.BXICError.raise_if_ko(err_p)
+        c_filters[i] = filters_p[0]
+
+    # The C library owns the filters from now on
+    err_p = __BXIBASE_CAPI__.bxilog_reconfigure(c_filters, len(handlers))
+    bxierr.BXICError.raise_if_ko(err_p)
+    for section in filters:
+        _CONFIG[section]['filters'] = filters[section]
+
+
 def get_all_loggers_iter():
     """
     Return an iterator over all loggers.
@@ -262,7 +262,7 @@ class BXILogger(object):
         Return the filter level for the current logger
         @return logger filtered level
         """
-        return self.clogger.level
+        return __BXIBASE_CAPI__.bxilog_logger_get_level(self.clogger)
 
     def set_level(self, level):
         """
@@ -43,8 +43,18 @@ def add_handler(configobj, section_name, c_config):
 
     url = __FFI__.new('char[]', url.encode("utf-8", "replace"))
     bind = __FFI__.cast('bool', section.as_bool('bind'))
-    __BXIBASE_CAPI__.bxilog_config_add_handler(c_config,
-                                               __BXIBASE_CAPI__.BXILOG_REMOTE_HANDLER,
-                                               filters._cstruct,
-                                               url,
-                                               bind)
+    spool_dir = section.get('spool_dir', None)
+    if spool_dir is None:
+        __BXIBASE_CAPI__.bxilog_config_add_handler(c_config,
+                                                   __BXIBASE_CAPI__.BXILOG_REMOTE_HANDLER,
+                                                   filters._cstruct,
+                                                   url,
+                                                   bind)
+    else:
+        spool_dir = __FFI__.new('char[]', spool_dir.encode("utf-8", "replace"))
+        __BXIBASE_CAPI__.bxilog_config_add_handler(c_config,
+                                                   __BXIBASE_CAPI__.BXILOG_REMOTE_RELAY_HANDLER,
+                                                   filters._cstruct,
+                                                   url,
+                                                   bind,
+                                                   spool_dir)
@@ -29,7 +29,7 @@ class RemoteReceiver(object):
     Receive log messages from a remote handler.
     """
 
-    def __init__(self, urls, bind, hostname=None):
+    def __init__(self, urls, bind, hostname=None, workers_nb=1):
         """
         Create a new instance connected or binded to given urls.
 
@@ -40,6 +40,7 @@ class RemoteReceiver(object):
         @param[in] pub_nb the number of publishers to synchronize with
         @param[in] bind if true, bind instead of connecting
         @param[in] hostname or ip of the remote node required when binding with tcp
+        @param[in] workers_nb the number of threads receiving the logs
 
         """
         tmpref = []
@@ -53,6 +54,10 @@ class RemoteReceiver(object):
             chostname = hostname.encode("utf-8", "replace")
         self.c_receiver = __BXIBASE_CAPI__.bxilog_remote_receiver_new(c_urls, len(urls),
                                                                       bind, chostname)
+        err = __BXIBASE_CAPI__.bxilog_remote_receiver_set_workers_nb(self.c_receiver,
+                                                                     workers_nb)
+        bxierr.BXICError.raise_if_ko(err)
+        self.workers_nb = workers_nb
 
     def start(self):
         """
@@ -90,3 +95,41 @@ class RemoteReceiver(object):
         if nb == 0:
             return None
         return [__FFI__.string(urls_c[0][i]) for i in range(nb)]
+
+    def get_stats(self):
+        """
+        Return the throughput counters of each worker thread
+
+        @return a list of dict with keys 'records_nb', 'batches_nb', 'bytes_nb',
+                'errors_nb', 'lost_nb' and 'reordered_nb', one per worker
+        """
+        stats_c = __FFI__.new("bxilog_remote_receiver_stats_s[]", self.workers_nb)
+        nb = __BXIBASE_CAPI__.bxilog_remote_receiver_get_stats(self.c_receiver,
+                                                               stats_c,
+                                                               self.workers_nb)
+        return [{'records_nb': stats_c[i].records_nb,
+                 'batches_nb': stats_c[i].batches_nb,
+                 'bytes_nb': stats_c[i].bytes_nb,
+                 'errors_nb': stats_c[i].errors_nb,
+                 'lost_nb': stats_c[i].lost_nb,
+                 'reordered_nb': stats_c[i].reordered_nb} for i in range(nb)]
+
+    def get_publishers_stats(self):
+        """
+        Return the records accounting of each publisher
+
+        @return a dict mapping each publisher url to a dict with keys
+                'received_nb', 'lost_nb' and 'reordered_nb'
+        """
+        stats_c = __FFI__.new("bxilog_remote_receiver_pub_stats_p[1]")
+        nb = __BXIBASE_CAPI__.bxilog_remote_receiver_get_pub_stats(self.c_receiver,
+                                                                   stats_c)
+        result = dict()
+        for i in range(nb):
+            stats = stats_c[0][i]
+            result[__FFI__.string(stats.url).decode('utf-8', 'replace')] = \
+                {'received_nb': stats.received_nb,
+                 'lost_nb': stats.lost_nb,
+                 'reordered_nb': stats.reordered_nb}
+        __BXIBASE_CAPI__.bxilog_remote_receiver_free_pub_stats(stats_c[0], nb)
+        return result
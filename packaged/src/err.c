@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <errno.h>
 #include <signal.h>
+#include <pthread.h>
 #include <sys/syscall.h>
 #include <backtrace.h>
 #include <backtrace-supported.h>
@@ -24,6 +25,9 @@
 #include "bxi/base/mem.h"
 #include "bxi/base/str.h"
 #include "bxi/base/err.h"
+#include "bxi/base/time.h"
+
+#include "err_impl.h"
 
 // *********************************************************************************
 // ********************************** Defines **************************************
@@ -31,6 +35,12 @@
 #define OK_MSG "No problem found - everything is ok"
 
 #define BACKTRACE_MAX 64 // Number of maximum depth of a backtrace
+#define BT_DISABLED_CODES_MAX 64 // Number of error codes without backtrace
+#define SYMCACHE_BITS 12         // 4096 symbolized return addresses at most
+#define SYMCACHE_SLOTS (1u << SYMCACHE_BITS)
+#define SYMCACHE_PROBES 8        // Slots looked at before evicting an entry
+#define POOL_MAX 32              // Number of recycled errors kept per thread
+#define SET_INDEX_MIN_SIZE 32    // Initial size of the index of an error set
 #define ERR_BT_PREFIX   "##trce## "
 #define ERR_CODE_PREFIX "##code## "
 #define ERR_MSG_PREFIX  "##mesg## "
@@ -40,6 +50,20 @@
 // ********************************** Types ****************************************
 // *********************************************************************************
 
+// A symbolized return address
+typedef struct {
+    uintptr_t pc;                   // 0 if unused
+    char * str;                     // "function at file:line" or backtrace_symbols()
+} symcache_entry_s;
+
+// A pooled error with its message buffer
+typedef struct pooled_err_s pooled_err_s;
+struct pooled_err_s {
+    bxierr_s err;                   // Must be the first field
+    char msg[BXIERR_POOLED_MSG_MAX];
+    pooled_err_s * next;            // Next free error in the pool
+};
+
 // *********************************************************************************
 // **************************** Static function declaration ************************
 // *********************************************************************************
@@ -47,8 +71,27 @@ static void _err_list_init(bxierr_list_p errlist);
 static int _bt_full_cb(void *data, uintptr_t pc,
                        const char *filename, int lineno, const char *function);
 static void _bt_error_cb(void *data, const char *msg, int errnum);
-static char** _pretty_backtrace(void* addresses[], int array_size);
+static char** _symbolize(void* addresses[], int array_size);
+static char * _symbolize_pc(void * address);
+static size_t _symcache_slot(uintptr_t pc);
+static char * _symcache_get(uintptr_t pc);
+static void _symcache_put(uintptr_t pc, const char * str);
+static size_t _backtrace_str(void* addresses[], int array_size, int tid, char ** result);
+static void _capture_backtrace(bxierr_p self);
+static void _symbolize_backtrace(bxierr_p self);
+static bool _backtrace_enabled(int code);
+static int _gettid(void);
+static void _reset_tid(void);
+static void _symcache_before_fork(void);
+static void _symcache_parent_after_fork(void);
+static void _child_after_fork(void);
 static void __bt_init__(void);
+static void _pool_put(pooled_err_s * item);
+static void _pool_create_key(void);
+static void _pool_release(void * dummy);
+static size_t _set_slot(const bxierr_set_p set, int code);
+static void _set_index_rebuild(bxierr_set_p set, size_t index_size);
+static void _set_grow(bxierr_set_p set);
 // *********************************************************************************
 // ********************************** Global Variables *****************************
 // *********************************************************************************
@@ -66,6 +109,31 @@ const int BXIERR_CAUSED_BY_STR_LEN = ARRAYLEN(CAUSED_BY_STR);
 
 struct backtrace_state * BT_STATE = NULL;
 
+// Error codes created without backtrace, read without lock
+static int BT_DISABLED_CODES[BT_DISABLED_CODES_MAX];
+static size_t BT_DISABLED_CODES_NB = 0;
+static pthread_mutex_t BT_DISABLED_CODES_LOCK = PTHREAD_MUTEX_INITIALIZER;
+
+// Cache of the current thread id, reset in the child after a fork()
+static __thread int TID = 0;
+
+// Process-wide cache of symbolized return addresses, bounded in size
+static symcache_entry_s SYMCACHE[SYMCACHE_SLOTS];
+static pthread_mutex_t SYMCACHE_LOCK = PTHREAD_MUTEX_INITIALIZER;
+// True while the current thread holds SYMCACHE_LOCK: a crash report from a
+// signal handler must not wait for it.
+static __thread bool SYMCACHE_OWNER = false;
+// Lookups of the cache, under SYMCACHE_LOCK
+static size_t SYMCACHE_HITS_NB = 0;
+static size_t SYMCACHE_MISSES_NB = 0;
+
+// Per-thread pool of recycled errors, released when the thread exits
+static __thread pooled_err_s * POOL = NULL;
+static __thread size_t POOL_NB = 0;
+static __thread bool POOL_REGISTERED = false;
+static pthread_key_t POOL_KEY;
+static pthread_once_t POOL_KEY_ONCE = PTHREAD_ONCE_INIT;
+
 // *********************************************************************************
 // ********************************** Implementation   *****************************
 // *********************************************************************************
@@ -91,16 +159,16 @@ bxierr_p bxierr_new(int code,
 
     bxierr_p self = bximem_calloc(sizeof(*self));
     self->code = code;
-    char * tmp = NULL;
-    self->backtrace_len = bxierr_backtrace_str(&tmp);
-    self->backtrace = tmp;
+    // Symbolized only when reported
+    if (_backtrace_enabled(code)) _capture_backtrace(self);
     self->data = data;
     self->free_fn = free_fn;
     self->add_to_report = (NULL == add_to_report) ?
                                 bxierr_report_add_from_limit :
                                 add_to_report;
 
-    self->cause = bxierr_isok(cause) ? NULL : cause;
+    // A static error singleton is shared: its last cause must not be modified
+    self->cause = bxierr_isok(cause) ? NULL : bxierr_mutable(cause);
 
     if (self->cause != NULL) {
         if (self->cause->last_cause != NULL) {
@@ -118,16 +186,54 @@ bxierr_p bxierr_new(int code,
     return self;
 }
 
+bxierr_p bxierr_pooled(int code, const char * fmt, ...) {
+    pooled_err_s * item = POOL;
+    if (NULL != item) {
+        POOL = item->next;
+        POOL_NB--;
+    } else {
+        item = bximem_calloc(sizeof(*item));
+    }
+
+    bxierr_p self = &item->err;
+    memset(self, 0, sizeof(*self));
+    self->code = code;
+    self->origin = BXIERR_ORIGIN_POOLED;
+    self->add_to_report = bxierr_report_add_from_limit;
+    self->msg = item->msg;
+
+    va_list ap;
+    va_start(ap, fmt);
+    size_t n = bxistr_vformat(item->msg, sizeof(item->msg), fmt, ap);
+    va_end(ap);
+    self->msg_len = (n < sizeof(item->msg)) ? n : sizeof(item->msg) - 1;
+
+    return self;
+}
+
+bxierr_p bxierr_mutable(bxierr_p self) {
+    if (NULL == self || bxierr_isok(self)) return self;
+    if (BXIERR_ORIGIN_STATIC != self->origin) return self;
+
+    return bxierr_new(self->code, NULL, NULL, NULL, NULL, "%s", self->msg);
+}
+
 void bxierr_free(bxierr_p self) {
     if (NULL == self) return;
     if (self == BXIERR_OK) return;
+    if (BXIERR_ORIGIN_STATIC == self->origin) return;
     if (NULL != self->cause) bxierr_destroy(&(self->cause));
     if (NULL != self->free_fn) {
         self->free_fn(self->data);
         self->data = NULL;
     }
-    BXIFREE(self->msg);
     BXIFREE(self->backtrace);
+    BXIFREE(self->pcs);
+    if (BXIERR_ORIGIN_POOLED == self->origin) {
+        _pool_put((pooled_err_s *) self);
+        return;
+    }
+    BXIFREE(self->msg);
     BXIFREE(self);
 }
 
@@ -194,24 +300,30 @@ void bxierr_report_add_from_limit(bxierr_p self, bxierr_report_p report, size_t
     bxiassert(NULL != self);
     bxiassert(NULL != report);
 
-    bxistr_prefixer_s data;
-    bxistr_prefixer_init(&data, ERR_MSG_PREFIX, ARRAYLEN(ERR_MSG_PREFIX) - 1);
-    bxierr_p tmp = bxistr_apply_lines(self->msg,
-                                      self->msg_len,
-                                      bxistr_prefixer_line, &data);
-    assert(bxierr_isok(tmp));
-    char * final_msg;
-    bxistr_join("\n", ARRAYLEN("\n") - 1,
-                data.lines, data.lines_len, data.lines_nb,
-                &final_msg);
-
-    char * result = bxistr_new(ERR_CODE_PREFIX"%d\n%s", self->code, final_msg);
+    bxistr_builder_p result = bxistr_builder_get();
+    bxistr_builder_append_bytes(result, ERR_CODE_PREFIX, ARRAYLEN(ERR_CODE_PREFIX) - 1);
+    bxistr_builder_append_int(result, self->code);
+    bxistr_builder_append_bytes(result, "\n", 1);
+    // Prefix each line of the message, except a last empty one
+    const char * line = self->msg;
+    const char * const eol = self->msg + self->msg_len;
+    for (bool first = true; ; first = false) {
+        const char * next = memchr(line, '\n', (size_t) (eol - line));
+        next = (NULL == next) ? eol : next;
+        if (next == eol && next == line) break;
+        if (!first) bxistr_builder_append_bytes(result, "\n", 1);
+        bxistr_builder_append_bytes(result, ERR_MSG_PREFIX, ARRAYLEN(ERR_MSG_PREFIX) - 1);
+        bxistr_builder_append_bytes(result, line, (size_t) (next - line));
+        if (next == eol) break;
+        line = next + 1;
+    }
 
+    _symbolize_backtrace(self);
     char * bt = (NULL == self->backtrace) ? "" : self->backtrace;
     size_t bt_len = (NULL == self->backtrace) ? 1 : (self->backtrace_len + 1);
 
-    bxierr_report_add(report, result, strlen(result) + 1, bt, bt_len);
-    BXIFREE(result);
+    bxierr_report_add(report, result->buf, result->len + 1, bt, bt_len);
+    bxistr_builder_release(&result);
 
     if (NULL == self->cause) {
         // Nothing to do!
@@ -228,32 +340,27 @@ void bxierr_report_add_from_limit(bxierr_p self, bxierr_report_p report, size_t
             bxierr_report_add_from_limit(self->cause, report, depth-1);
         }
     }
-
-    bxistr_prefixer_cleanup(&data);
-    BXIFREE(final_msg);
 }
 
 size_t bxierr_report_str(bxierr_report_p report, char** result_p) {
     bxiassert(NULL != report);
     bxiassert(NULL != result_p);
 
-    char * lines[report->err_nb];
-    size_t lines_len[report->err_nb];
+    bxistr_builder_p result = bxistr_builder_get();
     for (size_t i = 0; i < report->err_nb; i++) {
-        char * tmp[2] = {report->err_msgs[i], report->err_bts[i]};
+        if (0 < i) bxistr_builder_append_bytes(result, "\n", 1);
         // Remove the NULL terminating byte from the length
-        size_t tmp_len[2] = {report->err_msglens[i] - 1, report->err_btslens[i] - 1};
-        char * result = NULL;
-        lines_len[i] = bxistr_join("\n", ARRAYLEN("\n") - 1,
-                                   tmp, tmp_len, 2,
-                                   &result);
-        lines[i] = result;
-    }
-    size_t len = bxistr_join("\n", ARRAYLEN("\n") - 1, lines, lines_len, report->err_nb,
-                             result_p);
-    for (size_t i = 0; i < report->err_nb; i++) {
-        BXIFREE(lines[i]);
+        bxistr_builder_append_bytes(result, report->err_msgs[i],
+                                    strnlen(report->err_msgs[i],
+                                            report->err_msglens[i] - 1));
+        bxistr_builder_append_bytes(result, "\n", 1);
+        bxistr_builder_append_bytes(result, report->err_bts[i],
+                                    strnlen(report->err_bts[i],
+                                            report->err_btslens[i] - 1));
     }
+    size_t len;
+    *result_p = bxistr_builder_take(result, &len);
+    bxistr_builder_release(&result);
 
     return len;
 }
@@ -353,59 +460,47 @@ bxierr_p bxierr_vfromidx(const int erridx,
 }
 
 size_t bxierr_backtrace_str(char ** result) {
-    *result = NULL;
-    size_t size;
-    errno = 0;
-    FILE * faked_file = open_memstream(result, &size);
-    if (NULL == faked_file) {
-        perror("Calling open_memstream() failed");
-        *result = strdup("Unavailable backtrace (open_memstream() failed)");
-        return strlen(*result) + 1;
-    }
     void *addresses[BACKTRACE_MAX];
-    sigset_t orig_set;
-    sigset_t mask;
-    sigfillset(&mask);
-    sigemptyset(&orig_set);
-
-    int rc = pthread_sigmask(SIG_BLOCK, &mask, &orig_set);
-    if (rc != 0) {
-        perror("Calling pthread_sigmask() failed");
-        *result = strdup("Unavailable backtrace (pthread_sigmask() failed)");
-        return strlen(*result) + 1;
-    }
     int c = backtrace(addresses, BACKTRACE_MAX);
-    errno = 0;
-    char **symbols = backtrace_symbols(addresses, c);
-    char **strings = _pretty_backtrace(addresses, c);
 
-    rc = pthread_sigmask(SIG_SETMASK, &orig_set, NULL);
-    if (rc != 0) {
-        perror("Calling pthread_sigmask() unblocking failed");
+    return _backtrace_str(addresses, c, _gettid(), result);
+}
+
+bool bxierr_backtrace_disable(int code) {
+    bool result = true;
+    int rc = pthread_mutex_lock(&BT_DISABLED_CODES_LOCK);
+    bxiassert(0 == rc);
+    size_t i = 0;
+    for (; i < BT_DISABLED_CODES_NB; i++) {
+        if (BT_DISABLED_CODES[i] == code) break;
+    }
+    if (i == BT_DISABLED_CODES_NB) {
+        if (BT_DISABLED_CODES_MAX <= i) {
+            result = false;
+        } else {
+            __atomic_store_n(&BT_DISABLED_CODES[i], code, __ATOMIC_RELAXED);
+            __atomic_store_n(&BT_DISABLED_CODES_NB, i + 1, __ATOMIC_RELEASE);
+        }
     }
+    rc = pthread_mutex_unlock(&BT_DISABLED_CODES_LOCK);
+    bxiassert(0 == rc);
 
-#ifdef __linux__
-    pid_t tid = (pid_t) syscall(SYS_gettid);
-#else
-    int tid;
-    bxierr_p err = bxilog_get_thread_rank(&tid);
-    if (BXIERR_OK != err) tid = -1;
-#endif
-    const char * const truncated = (c == BACKTRACE_MAX) ? "(truncated) " : "";
+    return result;
+}
 
-    fprintf(faked_file,
-            ERR_BT_PREFIX"Backtrace of tid %d: %d function calls %s\n",
-            tid, c, truncated);
-    for(int i = 0; i < c; i++) {
-        fprintf(faked_file, ERR_BT_PREFIX"[%02d] %s\n", i,
-                NULL == strings[i] ? symbols[i] : strings[i]);
-        BXIFREE(strings[i]);
+void bxierr_backtrace_enable(int code) {
+    int rc = pthread_mutex_lock(&BT_DISABLED_CODES_LOCK);
+    bxiassert(0 == rc);
+    for (size_t i = 0; i < BT_DISABLED_CODES_NB; i++) {
+        if (BT_DISABLED_CODES[i] != code) continue;
+        // A concurrent bxierr_new() may still see the code as disabled: harmless
+        const size_t last = BT_DISABLED_CODES_NB - 1;
+        __atomic_store_n(&BT_DISABLED_CODES[i], BT_DISABLED_CODES[last], __ATOMIC_RELAXED);
+        __atomic_store_n(&BT_DISABLED_CODES_NB, last, __ATOMIC_RELEASE);
+        break;
     }
-    fprintf(faked_file,ERR_BT_PREFIX"Backtrace end\n");
-    fclose(faked_file);
-    BXIFREE(symbols);
-    BXIFREE(strings);
-    return size;
+    rc = pthread_mutex_unlock(&BT_DISABLED_CODES_LOCK);
+    bxiassert(0 == rc);
 }
 
 void bxierr_assert_fail(const char *assertion, const char *file,
@@ -494,9 +589,12 @@ bxierr_set_p bxierr_set_new() {
 
     _err_list_init(&result->distinct_err);
 
-    result->seen_nb = bximem_calloc(result->distinct_err.errors_size * \
-                                                            sizeof(*result->seen_nb));
+    const size_t size = result->distinct_err.errors_size;
+    result->seen_nb = bximem_calloc(size * sizeof(*result->seen_nb));
+    result->first_seen = bximem_calloc(size * sizeof(*result->first_seen));
+    result->last_seen = bximem_calloc(size * sizeof(*result->last_seen));
     result->total_seen_nb = 0;
+    _set_index_rebuild(result, SET_INDEX_MIN_SIZE);
 
     return result;
 }
@@ -505,6 +603,9 @@ void bxierr_set_free(bxierr_set_p errset) {
     if (NULL == errset) return;
 
     BXIFREE(errset->seen_nb);
+    BXIFREE(errset->first_seen);
+    BXIFREE(errset->last_seen);
+    BXIFREE(errset->index);
     bxierr_list_free(&errset->distinct_err);
 }
 
@@ -513,37 +614,74 @@ bool bxierr_set_add(bxierr_set_p set, bxierr_p * err) {
     bxiassert(NULL != err);
     bxiassert(NULL != *err);
 
+    struct timespec now = {0, 0};
+    clock_gettime(CLOCK_REALTIME, &now);
+
     set->total_seen_nb++;
-    size_t i = 0;
-    bxierr_p slot = NULL;
-    for (; i < set->distinct_err.errors_size; i++) {
-        slot = set->distinct_err.errors[i];
-        if (NULL == slot) break;
-        if (slot->code == (*err)->code) {
+    const int code = (*err)->code;
+    size_t slot = _set_slot(set, code);
+    while (0 != set->index[slot]) {
+        const size_t i = set->index[slot] - 1;
+        if (set->distinct_err.errors[i]->code == code) {
             // An error with same code is already recorded, delete the new one.
             bxierr_destroy(err);
             set->seen_nb[i]++;
+            set->last_seen[i] = now;
             return false;
         }
+        slot = (slot + 1) & (set->index_size - 1);
     }
 
-    if (i >= set->distinct_err.errors_size) {
-        // Not enough space, allocate some new
-        size_t old_len = set->distinct_err.errors_size;
-        // Add one to prevent product with zero!
-        size_t new_len = (set->distinct_err.errors_size + 1) * 2;
-        set->seen_nb = bximem_realloc(set->seen_nb,
-                                      old_len*sizeof(*set->seen_nb),
-                                      new_len*sizeof(*set->seen_nb));
+    if (set->distinct_err.errors_nb >= set->distinct_err.errors_size) _set_grow(set);
+    // Keep the index at most half full
+    if (2 * (set->distinct_err.errors_nb + 1) > set->index_size) {
+        _set_index_rebuild(set, 2 * set->index_size);
+        slot = _set_slot(set, code);
+        while (0 != set->index[slot]) slot = (slot + 1) & (set->index_size - 1);
     }
 
-//    bxiassert(NULL == slot);
+    const size_t i = set->distinct_err.errors_nb;
     bxierr_list_append(&set->distinct_err, *err);
-    set->seen_nb[i]++;
+    set->index[slot] = i + 1;
+    set->seen_nb[i] = 1;
+    set->first_seen[i] = now;
+    set->last_seen[i] = now;
 
     return true;
 }
 
+void bxierr_set_add_to_report(bxierr_p err, bxierr_report_p report, size_t depth) {
+    bxierr_report_add_from_limit(err, report, depth);
+    bxierr_set_p set = err->data;
+    for (size_t i = 0; i < set->distinct_err.errors_nb; i++) {
+        bxierr_p ierr = set->distinct_err.errors[i];
+        char * first = NULL, * last = NULL;
+        bxierr_p tmp = bxitime_str(&set->first_seen[i], &first);
+        bxierr_destroy(&tmp);
+        tmp = bxitime_str(&set->last_seen[i], &last);
+        bxierr_destroy(&tmp);
+        char * s = bxistr_new("Error n°%zu: seen %zu times, first at %s, last at %s",
+                              i, set->seen_nb[i],
+                              (NULL == first) ? "?" : first,
+                              (NULL == last) ? "?" : last);
+        bxierr_report_add(report, s, strlen(s) + 1, "", 1);
+        BXIFREE(s);
+        BXIFREE(first);
+        BXIFREE(last);
+        ierr->add_to_report(ierr, report, depth);
+    }
+}
+
+
+void bxierr__symcache_counters(size_t * hits_nb, size_t * misses_nb) {
+    bxiassert(NULL != hits_nb);
+    bxiassert(NULL != misses_nb);
+
+    pthread_mutex_lock(&SYMCACHE_LOCK);
+    *hits_nb = SYMCACHE_HITS_NB;
+    *misses_nb = SYMCACHE_MISSES_NB;
+    pthread_mutex_unlock(&SYMCACHE_LOCK);
+}
 
 //*********************************************************************************
 //********************************** Static Helpers Implementation ****************
@@ -556,18 +694,267 @@ void _err_list_init(bxierr_list_p errlist) {
 }
 
 
-char** _pretty_backtrace(void* addresses[], int array_size) {
+char** _symbolize(void* addresses[], int array_size) {
     // Used to return the strings generated from the addresses
-    char** backtrace_strings = bximem_calloc(sizeof(*backtrace_strings) * (unsigned)array_size);
+    char** strings = bximem_calloc(sizeof(*strings) * (unsigned)array_size);
+
+    // From a signal handler, the interrupted code may hold the lock already
+    bool cached = !SYMCACHE_OWNER;
+    if (cached) {
+        SYMCACHE_OWNER = true;
+        pthread_mutex_lock(&SYMCACHE_LOCK);
+        for (int i = 0; i < array_size; i++) {
+            strings[i] = _symcache_get((uintptr_t) addresses[i]);
+            if (NULL == strings[i]) SYMCACHE_MISSES_NB++; else SYMCACHE_HITS_NB++;
+        }
+        pthread_mutex_unlock(&SYMCACHE_LOCK);
+        SYMCACHE_OWNER = false;
+    }
+
+    // Symbolization is slow: do it without the lock
+    bool missed = false;
+    for (int i = 0; i < array_size; i++) {
+        if (NULL != strings[i]) continue;
+        strings[i] = _symbolize_pc(addresses[i]);
+        missed = true;
+    }
+
+    if (cached && missed) {
+        SYMCACHE_OWNER = true;
+        pthread_mutex_lock(&SYMCACHE_LOCK);
+        for (int i = 0; i < array_size; i++) {
+            _symcache_put((uintptr_t) addresses[i], strings[i]);
+        }
+        pthread_mutex_unlock(&SYMCACHE_LOCK);
+        SYMCACHE_OWNER = false;
+    }
+    return strings;
+}
+
+char * _symbolize_pc(void * address) {
+    char * result = NULL;
+    int rc = backtrace_pcinfo(BT_STATE,
+                              (uintptr_t) address,
+                              _bt_full_cb,
+                              _bt_error_cb,
+                              &result);
+    bxiassert(0 == rc);
+    if (NULL != result) return result;
+
+    // No debug information: fall back to the symbol table
+    char ** symbols = backtrace_symbols(&address, 1);
+    if (NULL == symbols) return strdup("??");
+    result = strdup(symbols[0]);
+    BXIFREE(symbols);
+    return result;
+}
+
+size_t _symcache_slot(uintptr_t pc) {
+    // Fibonacci hashing: return addresses are aligned and close to each other
+    return (size_t) ((pc * 11400714819323198485ull) >> (64 - SYMCACHE_BITS));
+}
+
+char * _symcache_get(uintptr_t pc) {
+    size_t slot = _symcache_slot(pc);
+    for (size_t i = 0; i < SYMCACHE_PROBES; i++) {
+        symcache_entry_s * entry = &SYMCACHE[(slot + i) & (SYMCACHE_SLOTS - 1)];
+        if (0 == entry->pc) return NULL;
+        if (pc == entry->pc) return strdup(entry->str);
+    }
+    return NULL;
+}
+
+void _symcache_put(uintptr_t pc, const char * str) {
+    if (0 == pc) return;
+    size_t slot = _symcache_slot(pc);
+    for (size_t i = 0; i < SYMCACHE_PROBES; i++) {
+        symcache_entry_s * entry = &SYMCACHE[(slot + i) & (SYMCACHE_SLOTS - 1)];
+        if (pc == entry->pc) return;
+        if (0 == entry->pc) {
+            entry->pc = pc;
+            entry->str = strdup(str);
+            return;
+        }
+    }
+    // All probed slots are used: evict the home one to keep the cache bounded
+    symcache_entry_s * entry = &SYMCACHE[slot];
+    BXIFREE(entry->str);
+    entry->pc = pc;
+    entry->str = strdup(str);
+}
+
+size_t _backtrace_str(void* addresses[], int array_size, int tid, char ** result) {
+    *result = NULL;
+    size_t size;
+    errno = 0;
+    FILE * faked_file = open_memstream(result, &size);
+    if (NULL == faked_file) {
+        perror("Calling open_memstream() failed");
+        *result = strdup("Unavailable backtrace (open_memstream() failed)");
+        return strlen(*result) + 1;
+    }
+    sigset_t orig_set;
+    sigset_t mask;
+    sigfillset(&mask);
+    sigemptyset(&orig_set);
+
+    int rc = pthread_sigmask(SIG_BLOCK, &mask, &orig_set);
+    if (rc != 0) {
+        perror("Calling pthread_sigmask() failed");
+        fclose(faked_file);
+        BXIFREE(*result);
+        *result = strdup("Unavailable backtrace (pthread_sigmask() failed)");
+        return strlen(*result) + 1;
+    }
+    char **strings = _symbolize(addresses, array_size);
+
+    rc = pthread_sigmask(SIG_SETMASK, &orig_set, NULL);
+    if (rc != 0) {
+        perror("Calling pthread_sigmask() unblocking failed");
+    }
+
+    const char * const truncated = (array_size == BACKTRACE_MAX) ? "(truncated) " : "";
+
+    fprintf(faked_file,
+            ERR_BT_PREFIX"Backtrace of tid %d: %d function calls %s\n",
+            tid, array_size, truncated);
     for(int i = 0; i < array_size; i++) {
-        int rc = backtrace_pcinfo(BT_STATE,
-                                  (uintptr_t) addresses[i],
-                                  _bt_full_cb,
-                                  _bt_error_cb,
-                                  &backtrace_strings[i]);
+        fprintf(faked_file, ERR_BT_PREFIX"[%02d] %s\n", i, strings[i]);
+        BXIFREE(strings[i]);
+    }
+    fprintf(faked_file,ERR_BT_PREFIX"Backtrace end\n");
+    fclose(faked_file);
+    BXIFREE(strings);
+    return size;
+}
+
+void _capture_backtrace(bxierr_p self) {
+    void *addresses[BACKTRACE_MAX];
+    // No need to block signals here: backtrace() has been loaded by __bt_init__()
+    // and does not allocate anymore.
+    int c = backtrace(addresses, BACKTRACE_MAX);
+    if (0 >= c) return;
+    self->pcs = bximem_calloc((size_t) c * sizeof(*self->pcs));
+    memcpy(self->pcs, addresses, (size_t) c * sizeof(*self->pcs));
+    self->pcs_nb = c;
+    self->tid = _gettid();
+}
+
+void _symbolize_backtrace(bxierr_p self) {
+    if (NULL != self->backtrace || NULL == self->pcs) return;
+
+    char * tmp = NULL;
+    self->backtrace_len = _backtrace_str(self->pcs, self->pcs_nb, self->tid, &tmp);
+    self->backtrace = tmp;
+    BXIFREE(self->pcs);
+    self->pcs_nb = 0;
+}
+
+bool _backtrace_enabled(int code) {
+    const size_t nb = __atomic_load_n(&BT_DISABLED_CODES_NB, __ATOMIC_ACQUIRE);
+    for (size_t i = 0; i < nb; i++) {
+        if (__atomic_load_n(&BT_DISABLED_CODES[i], __ATOMIC_RELAXED) == code) return false;
+    }
+    return true;
+}
+
+int _gettid(void) {
+    if (0 != TID) return TID;
+#ifdef __linux__
+    TID = (int) syscall(SYS_gettid);
+#else
+    uintptr_t rank;
+    bxierr_p err = bxilog_get_thread_rank(&rank);
+    TID = (BXIERR_OK != err) ? -1 : (int) rank;
+#endif
+    return TID;
+}
+
+void _reset_tid(void) {
+    TID = 0;
+}
+
+// The cache is not left half updated in the child by a thread which does not exist there
+void _symcache_before_fork(void) {
+    pthread_mutex_lock(&SYMCACHE_LOCK);
+    SYMCACHE_OWNER = true;
+}
+
+void _symcache_parent_after_fork(void) {
+    SYMCACHE_OWNER = false;
+    pthread_mutex_unlock(&SYMCACHE_LOCK);
+}
+
+void _child_after_fork(void) {
+    _reset_tid();
+    SYMCACHE_OWNER = false;
+    int rc = pthread_mutex_init(&SYMCACHE_LOCK, NULL);
+    bxiassert(0 == rc);
+}
+
+void _pool_put(pooled_err_s * item) {
+    if (POOL_NB >= POOL_MAX) {
+        BXIFREE(item);
+        return;
+    }
+    if (!POOL_REGISTERED) {
+        // Only for the destructor to be called when the thread exits
+        int rc = pthread_once(&POOL_KEY_ONCE, _pool_create_key);
+        bxiassert(0 == rc);
+        rc = pthread_setspecific(POOL_KEY, &POOL);
         bxiassert(0 == rc);
+        POOL_REGISTERED = true;
     }
-    return backtrace_strings;
+    item->next = POOL;
+    POOL = item;
+    POOL_NB++;
+}
+
+size_t _set_slot(const bxierr_set_p set, int code) {
+    // Multiplicative hashing: error codes are often small or close to each other
+    return (size_t) (((uint32_t) code * 2654435761u) & (set->index_size - 1));
+}
+
+void _set_index_rebuild(bxierr_set_p set, size_t index_size) {
+    BXIFREE(set->index);
+    set->index = bximem_calloc(index_size * sizeof(*set->index));
+    set->index_size = index_size;
+    for (size_t i = 0; i < set->distinct_err.errors_nb; i++) {
+        size_t slot = _set_slot(set, set->distinct_err.errors[i]->code);
+        while (0 != set->index[slot]) slot = (slot + 1) & (index_size - 1);
+        set->index[slot] = i + 1;
+    }
+}
+
+void _set_grow(bxierr_set_p set) {
+    // Same growth as bxierr_list_append()
+    const size_t old_len = set->distinct_err.errors_size;
+    const size_t new_len = (old_len + 1) * 2;
+    set->seen_nb = bximem_realloc(set->seen_nb,
+                                  old_len * sizeof(*set->seen_nb),
+                                  new_len * sizeof(*set->seen_nb));
+    set->first_seen = bximem_realloc(set->first_seen,
+                                     old_len * sizeof(*set->first_seen),
+                                     new_len * sizeof(*set->first_seen));
+    set->last_seen = bximem_realloc(set->last_seen,
+                                    old_len * sizeof(*set->last_seen),
+                                    new_len * sizeof(*set->last_seen));
+}
+
+void _pool_create_key(void) {
+    int rc = pthread_key_create(&POOL_KEY, _pool_release);
+    bxiassert(0 == rc);
+}
+
+void _pool_release(void * dummy) {
+    UNUSED(dummy);
+    while (NULL != POOL) {
+        pooled_err_s * item = POOL;
+        POOL = item->next;
+        BXIFREE(item);
+    }
+    POOL_NB = 0;
+    POOL_REGISTERED = false;
 }
 
 __attribute__((constructor)) void __bt_init__(void) {
@@ -575,6 +962,14 @@ __attribute__((constructor)) void __bt_init__(void) {
                                       BACKTRACE_SUPPORTS_THREADS,
                                       _bt_error_cb, NULL);
     bxiassert(NULL != BT_STATE);
+
+    // The first call to backtrace() loads libgcc: do it once for all here
+    void * addresses[1];
+    backtrace(addresses, 1);
+
+    int rc = pthread_atfork(_symcache_before_fork, _symcache_parent_after_fork,
+                            _child_after_fork);
+    bxiassert(0 == rc);
 }
 
 void _bt_error_cb(void *data, const char *msg, int errnum) {
@@ -0,0 +1,29 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+#ifndef BXIERR_IMPL_H
+#define BXIERR_IMPL_H
+
+#include <stdlib.h>
+
+//*********************************************************************************
+//********************************** Interface         ****************************
+//*********************************************************************************
+
+/*
+ * Return the number of return addresses found (hits_nb) and not found
+ * (misses_nb) in the process-wide cache of symbolized return addresses so far.
+ */
+void bxierr__symcache_counters(size_t * hits_nb, size_t * misses_nb);
+
+#endif
@@ -55,6 +55,8 @@
 #include "log/handler_impl.h"
 #include "log/fork_impl.h"
 #include "log/registry_impl.h"
+#include "log/inline_impl.h"
+#include "log/stats_impl.h"
 
 #include "log/log_impl.h"
 
@@ -81,10 +83,20 @@ static bxierr_p _cleanup(void);
 
 static bxierr_p _start_handler_thread(bxilog_handler_p handler,
                                       bxilog_handler_param_p param);
-static bxierr_p _sync_handler();
+static void _sync_handlers(bxierr_list_p errlist);
 static bxierr_p _join_handler(size_t handler_rank, bxierr_p *handler_err);
 static void _setprocname();
-static bxierr_p _zmq_str_rcv_timeout(void * zocket, char ** reply, long timeout);
+static void _deadline_init(struct timespec * deadline);
+static long _deadline_remaining(const struct timespec * deadline);
+static bxierr_p _ask_handlers(const char * request,
+                              void ** zockets, size_t * pending, size_t * pending_nb);
+static bxierr_p _poll_handlers(void ** zockets, size_t * pending, size_t * pending_nb,
+                               long timeout, size_t * ready, size_t * ready_nb);
+static void _close_handlers_zockets(void ** zockets, size_t zockets_nb,
+                                    bxierr_list_p errlist);
+static bxierr_p _reconfig_handler(size_t handler_rank,
+                                  bxilog_filters_p filters,
+                                  bxilog_filters_p * old);
 //*********************************************************************************
 //********************************** Global Variables  ****************************
 //*********************************************************************************
@@ -130,6 +142,12 @@ bxierr_p bxilog_init(bxilog_config_p config) {
         if (bxierr_isko(err)) goto UNLOCK; // Stay in the BROKEN state
         BXILOG__GLOBALS->state = UNSET;
     }
+    // A child forked in the BXILOG_FORK_QUIESCE mode replaces the inherited configuration
+    if (QUIESCED == BXILOG__GLOBALS->state) {
+        err = bxilog__config_destroy(&BXILOG__GLOBALS->config);
+        if (bxierr_isko(err)) goto UNLOCK;
+        BXILOG__GLOBALS->state = FINALIZED;
+    }
 
     // WARNING: If you change the FSM transition,
     // comment your changes in bxilog_state_e above.
@@ -204,6 +222,12 @@ bxierr_p bxilog_finalize() {
         err = BXIERR_OK;
         goto UNLOCK;
     }
+    if (QUIESCED == BXILOG__GLOBALS->state) {
+        // Forked child which never logged: no handler to stop
+        err = bxilog__config_destroy(&BXILOG__GLOBALS->config);
+        BXILOG__GLOBALS->state = bxierr_isok(err) ? FINALIZED : BROKEN;
+        goto UNLOCK;
+    }
     if (BXILOG__GLOBALS->state != INITIALIZED && BXILOG__GLOBALS->state != BROKEN) {
         err = bxierr_new(BXILOG_ILLEGAL_STATE_ERR,
                          NULL, NULL, NULL, NULL,
@@ -221,7 +245,7 @@ bxierr_p bxilog_finalize() {
         DEBUG(LOGGER_CONFIG_LOGGERS,
               "Logging level of %s: %s",
               loggers[i]->name,
-              level_names[loggers[i]->level]);
+              level_names[bxilog_logger_get_level(loggers[i])]);
     }
 
     BXIFREE(loggers);
@@ -235,7 +259,10 @@ bxierr_p bxilog_finalize() {
     }
     bxiassert(FINALIZING == BXILOG__GLOBALS->state);
 
-    err = bxilog__config_destroy(&BXILOG__GLOBALS->config);
+    // Leaked on purpose: a handler left behind still uses its parameters
+    if (!BXILOG__GLOBALS->handlers_detached) {
+        err = bxilog__config_destroy(&BXILOG__GLOBALS->config);
+    }
 
     if (bxierr_isko(err)) {
         BXILOG__GLOBALS->state = BROKEN;
@@ -273,6 +300,8 @@ bool bxilog_is_ready() {
 bxierr_p bxilog_flush(void) {
     if (INITIALIZED != BXILOG__GLOBALS->state) return BXIERR_OK;
     FINE(LOGGER, "Requesting a flush()");
+    if (bxilog__inline_mode()) return bxilog__inline_flush();
+
     tsd_p tsd = NULL;
     bxierr_p err = bxilog__tsd_get(&tsd);
     if (bxierr_isko(err)) return err;
@@ -318,6 +347,52 @@ bxierr_p bxilog_flush(void) {
     return BXIERR_OK;
 }
 
+bxierr_p bxilog_reconfigure(bxilog_filters_p * filters, size_t filters_nb) {
+    bxierr_p err = BXIERR_OK;
+    if (INITIALIZED != BXILOG__GLOBALS->state) {
+        err = bxierr_new(BXILOG_ILLEGAL_STATE_ERR, NULL, NULL, NULL, NULL,
+                         "Illegal state: %d", BXILOG__GLOBALS->state);
+    } else if (filters_nb != BXILOG__GLOBALS->config->handlers_nb) {
+        err = bxierr_gen("%zu filters given for %zu handlers",
+                         filters_nb, BXILOG__GLOBALS->config->handlers_nb);
+    }
+    if (bxierr_isko(err)) {
+        for (size_t i = 0; i < filters_nb; i++) bxilog_filters_destroy(&filters[i]);
+        return err;
+    }
+
+    FINE(LOGGER, "Requesting a reconfiguration of %zu handlers", filters_nb);
+    bxilog_filters_p olds[filters_nb];
+    bxierr_list_p errlist = bxierr_list_new();
+    for (size_t i = 0; i < filters_nb; i++) {
+        olds[i] = NULL;
+        if (NULL == filters[i]) continue;
+
+        bxierr_p ierr = _reconfig_handler(i, filters[i], &olds[i]);
+        if (bxierr_isko(ierr)) bxierr_list_append(errlist, ierr);
+        filters[i] = NULL;
+    }
+
+    // Handlers filter with their new set already: raising a logger level now
+    // does not produce logs a handler would not expect.
+    bxierr_p ierr = bxilog__config_loggers();
+    if (bxierr_isko(ierr)) bxierr_list_append(errlist, ierr);
+
+    for (size_t i = 0; i < filters_nb; i++) bxilog_filters_destroy(&olds[i]);
+
+    if (0 < errlist->errors_nb) {
+        return bxierr_from_list(BXILOG_RECONFIG_ERR,
+                                errlist,
+                                "At least one error occured while "
+                                "reconfiguring %zu handlers.",
+                                filters_nb);
+    }
+    bxierr_list_destroy(&errlist);
+
+    FINE(LOGGER, "Reconfiguration done succesfully on all %zu handlers", filters_nb);
+    return BXIERR_OK;
+}
+
 
 void bxilog_display_loggers(int fd) {
     char ** level_names;
@@ -348,6 +423,22 @@ void bxilog_display_loggers(int fd) {
 }
 
 
+void bxilog__core_before_fork(void) {
+    int rc = pthread_mutex_lock(&BXILOG_INITIALIZED_MUTEX);
+    bxiassert(0 == rc);
+}
+
+void bxilog__core_parent_after_fork(void) {
+    int rc = pthread_mutex_unlock(&BXILOG_INITIALIZED_MUTEX);
+    bxiassert(0 == rc);
+}
+
+void bxilog__core_child_after_fork(void) {
+    int rc = pthread_mutex_init(&BXILOG_INITIALIZED_MUTEX, NULL);
+    bxiassert(0 == rc);
+}
+
+
 void bxilog__wipeout() {
     // Remove allocated configuration
     bxilog_registry_reset();
@@ -355,6 +446,9 @@ void bxilog__wipeout() {
     // Remove allocated loggers
     bxilog__cfg_release_loggers();
 
+    // Remove compiled filters
+    bxilog__config_release_filters();
+
     // Remove mallocated signal stack
     stack_t sigstack;
     errno = 0;
@@ -370,39 +464,49 @@ void bxilog__wipeout() {
 bxierr_p bxilog__init_globals() {
     BXILOG__GLOBALS->pid = getpid();
     pthread_t * threads = bximem_calloc(BXILOG__GLOBALS->config->handlers_nb * sizeof(*threads));
+    size_t * dropped = bximem_calloc(BXILOG__GLOBALS->config->handlers_nb * sizeof(*dropped));
+    size_t * retried = bximem_calloc(BXILOG__GLOBALS->config->handlers_nb * sizeof(*retried));
     BXILOG__GLOBALS->internal_handlers_nb = 0;
     BXILOG__GLOBALS->handlers_threads = threads;
+    BXILOG__GLOBALS->handlers_dropped = dropped;
+    BXILOG__GLOBALS->handlers_retried = retried;
+    BXILOG__GLOBALS->handlers_detached = false;
+    bxilog__stats_reset();
 
     bxiassert(NULL == BXILOG__GLOBALS->zmq_ctx);
 
-    void * ctx = NULL;
-    bxierr_p err = bxizmq_context_new(&ctx);
-    if (bxierr_isko(err)) {
-        BXILOG__GLOBALS->state = ILLEGAL;
-        return err;
-    }
-    errno = 0;
-    int rc;
-    // Since we normally use inproc://, there is no need for ZMQ_IO_THREADS
-    rc = zmq_ctx_set(ctx, ZMQ_IO_THREADS, 0);
-    if (0 != rc) {
-        return bxierr_errno("Calling zmq_ctx_set() failed");
-    }
+    // Inline handlers do not communicate with the loggers through zmq
+    if (!bxilog__inline_mode()) {
+        void * ctx = NULL;
+        bxierr_p err = bxizmq_context_new(&ctx);
+        if (bxierr_isko(err)) {
+            BXILOG__GLOBALS->state = ILLEGAL;
+            return err;
+        }
+        errno = 0;
+        // Since we normally use inproc://, there is no need for ZMQ_IO_THREADS
+        int rc = zmq_ctx_set(ctx, ZMQ_IO_THREADS, 0);
+        if (0 != rc) {
+            return bxierr_errno("Calling zmq_ctx_set() failed");
+        }
 
-    BXILOG__GLOBALS->zmq_ctx = ctx;
+        BXILOG__GLOBALS->zmq_ctx = ctx;
+    }
 
-    rc = pthread_once(&BXILOG__GLOBALS->tsd_key_once, bxilog__tsd_key_new);
+    int rc = pthread_once(&BXILOG__GLOBALS->tsd_key_once, bxilog__tsd_key_new);
     if (0 != rc) {
         BXILOG__GLOBALS->state = ILLEGAL;
         return bxierr_fromidx(rc, NULL,
                               "Calling pthread_once() failed (rc=%d)", rc);
     }
 
-    return BXIERR_OK;
+    return bxilog__stats_start();
 }
 
 bxierr_p bxilog__start_handlers(void) {
     bxiassert(INITIALIZING == BXILOG__GLOBALS->state);
+    if (bxilog__inline_mode()) return bxilog__inline_start();
+
     bxierr_p err = BXIERR_OK;
     bxierr_list_p errlist = bxierr_list_new();
 
@@ -424,16 +528,7 @@ bxierr_p bxilog__start_handlers(void) {
     }
 
     // Synchronizing handlers
-    for (size_t i = 0; i < BXILOG__GLOBALS->config->handlers_nb; i++) {
-        bxilog_handler_p handler = BXILOG__GLOBALS->config->handlers[i];
-        if (NULL == handler) {
-            bxierr_p ierr = bxierr_gen("Handler %zu is NULL!", i);
-            bxierr_list_append(errlist, ierr);
-            continue;
-        }
-        bxierr_p ierr = _sync_handler();
-        if (bxierr_isko(ierr)) bxierr_list_append(errlist, ierr);
-    }
+    _sync_handlers(errlist);
 
     if (0 < errlist->errors_nb) {
         err = bxierr_from_list(BXIERR_GROUP_CODE,
@@ -448,6 +543,47 @@ bxierr_p bxilog__start_handlers(void) {
 }
 
 
+bxierr_p bxilog__resume(void) {
+    bxierr_p err = BXIERR_OK;
+    bool resumed = false;
+    int rc = pthread_mutex_lock(&BXILOG_INITIALIZED_MUTEX);
+    if (0 != rc) {
+        return bxierr_fromidx(rc, NULL,
+                              "Calling pthread_mutex_lock() failed (rc=%d)", rc);
+    }
+    // WARNING: If you change the FSM transition,
+    // comment your changes in bxilog_state_e above.
+    // Another thread might have been faster
+    if (QUIESCED != BXILOG__GLOBALS->state) goto UNLOCK;
+
+    BXILOG__GLOBALS->state = INITIALIZING;
+    err = bxilog__init_globals();
+    if (bxierr_isko(err)) {
+        BXILOG__GLOBALS->state = BROKEN;
+        goto UNLOCK;
+    }
+    err = bxilog__start_handlers();
+    if (bxierr_isko(err)) {
+        BXILOG__GLOBALS->state = BROKEN;
+        goto UNLOCK;
+    }
+    BXILOG__GLOBALS->state = INITIALIZED;
+    resumed = true;
+
+UNLOCK:
+    rc = pthread_mutex_unlock(&BXILOG_INITIALIZED_MUTEX);
+    if (0 != rc) {
+        BXILOG__GLOBALS->state = ILLEGAL;
+        bxierr_p err2 = bxierr_fromidx(rc, NULL,
+                                       "Calling pthread_mutex_unlock() failed (rc=%d)",
+                                       rc);
+        BXIERR_CHAIN(err, err2);
+    }
+    if (resumed && bxierr_isok(err)) FINE(LOGGER, "Handlers started after a fork()");
+
+    return err;
+}
+
 bxierr_p bxilog__finalize(void) {
     // WARNING: If you change the FSM transition,
     // comment your changes in bxilog_state_e above.
@@ -459,6 +595,9 @@ bxierr_p bxilog__finalize(void) {
     }
     BXILOG__GLOBALS->state = FINALIZING;
     bxierr_p err = BXIERR_OK, err2;
+    // It might be waiting for the handlers
+    err2 = bxilog__stats_stop();
+    BXIERR_CHAIN(err, err2);
     err2 = bxilog__stop_handlers();
     BXIERR_CHAIN(err, err2);
 
@@ -472,122 +611,102 @@ bxierr_p bxilog__finalize(void) {
 bxierr_p bxilog__stop_handlers(void) {
     // TODO: hack around zeromq issue
     // https://github.com/zeromq/libzmq/issues/1590
+    if (bxilog__inline_mode()) return bxilog__inline_stop();
+
     bxierr_p err = BXIERR_OK, err2;
     bxierr_list_p errlist = bxierr_list_new();
-
-    for (size_t i = 0; i < BXILOG__GLOBALS->internal_handlers_nb; i++) {
-        pthread_t handler_thread = BXILOG__GLOBALS->handlers_threads[i];
-        int ret = pthread_kill(handler_thread, 0);
-
-        if (ESRCH == ret) continue;
-
-        char * url = BXILOG__GLOBALS->config->handlers_params[i]->ctrl_url;
-        bxiassert(NULL != url);
-
-        void * zocket = NULL;
-        err2 = bxizmq_zocket_create_connected(BXILOG__GLOBALS->zmq_ctx,
-                                              ZMQ_REQ,
-                                              url,
-                                              &zocket);
-        BXIERR_CHAIN(err, err2);
-        bxierr_abort_ifko(err);
-
-        err2 = bxizmq_str_snd(EXIT_CTRL_MSG_REQ, zocket, 0, 0, 0);
-        BXIERR_CHAIN(err, err2);
-
-        char * msg = NULL;
-        // FIXME: this _zmq_str_rcv_timeout() looks strange to me??
-        // We might be able to replace it by a normal call to the bxizmq library.
-        // For the moment, it seems to work though
-        while (ret != ESRCH && msg == NULL) {
-            bxierr_destroy(&err2);
-            ret = pthread_kill(handler_thread, 0);
-            err2 = _zmq_str_rcv_timeout(zocket, &msg, 500);
-            if (ret == ESRCH && msg == NULL) {
-                bxierr_destroy(&err2);
-                break;
-            }
+    size_t handlers_nb = BXILOG__GLOBALS->internal_handlers_nb;
+
+    struct timespec deadline;
+    _deadline_init(&deadline);
+
+    // All handlers are asked to exit at once, each one through its own control
+    // zocket, and their replies are waited for concurrently.
+    void * zockets[handlers_nb + 1];
+    size_t pending[handlers_nb + 1];
+    size_t pending_nb = 0;
+    for (size_t i = 0; i < handlers_nb; i++) {
+        zockets[i] = NULL;
+        // Already joined when it failed to start, see _sync_handlers()
+        if (BXI_LOG_HANDLER_ERROR == BXILOG__GLOBALS->config->handlers_params[i]->status) {
+            continue;
+        }
+        if (ESRCH == pthread_kill(BXILOG__GLOBALS->handlers_threads[i], 0)) continue;
+        pending[pending_nb++] = i;
+    }
+    err2 = _ask_handlers(EXIT_CTRL_MSG_REQ, zockets, pending, &pending_nb);
+    if (bxierr_isko(err2)) bxierr_list_append(errlist, err2);
+
+    while (0 < pending_nb) {
+        long remaining = _deadline_remaining(&deadline);
+        if (0 == remaining) break;
+        // A handler might die without replying: check them from time to time.
+        long timeout = (0 > remaining || 500 < remaining) ? 500 : remaining;
+
+        size_t ready[pending_nb];
+        size_t ready_nb;
+        err2 = _poll_handlers(zockets, pending, &pending_nb, timeout, ready, &ready_nb);
+        if (bxierr_isko(err2)) {
+            bxierr_list_append(errlist, err2);
+            break;
+        }
+        for (size_t r = 0; r < ready_nb; r++) {
+            size_t i = ready[r];
+            char * msg = NULL;
+            err2 = bxizmq_str_rcv(zockets[i], 0, false, &msg);
             if (bxierr_isko(err2)) {
-                bxierr_destroy(&err2);
-            } else {
-                break;
+                bxierr_list_append(errlist, err2);
+                continue;
+            }
+            if (0 != strncmp(EXIT_CTRL_MSG_REP, msg, ARRAYLEN(EXIT_CTRL_MSG_REP) - 1)) {
+                // We just notify the end user there is a minor problem, but
+                // returning such an error is useless at this point, we want to exit.
+                bxierr_p tmp = bxierr_new(BXIZMQ_PROTOCOL_ERR, NULL, NULL, NULL, NULL,
+                                          "Wrong message received. "
+                                          "Expected: %s, received: %s",
+                                          EXIT_CTRL_MSG_REP, msg);
+                bxierr_report(&tmp, STDERR_FILENO);
+                BXIFREE(msg);
+                continue;
             }
-        }
-
-        err2 = bxizmq_zocket_destroy(&zocket);
-        BXIERR_CHAIN(err, err2);
-
-        if (ESRCH == ret && msg == NULL) continue;
-
-        if (NULL == msg || 0 != strncmp(EXIT_CTRL_MSG_REP, msg, ARRAYLEN(EXIT_CTRL_MSG_REP) - 1)) {
-            // We just notify the end user there is a minor problem, but
-            // returning such an error is useless at this point, we want to exit.
-            bxierr_p tmp = bxierr_new(BXIZMQ_PROTOCOL_ERR, NULL, NULL, NULL, NULL,
-                                      "Wrong message received. Expected: %s, received: %s",
-                                      EXIT_CTRL_MSG_REP, msg);
-            bxierr_report(&tmp, STDERR_FILENO);
             BXIFREE(msg);
-            continue;
-        }
-        BXIFREE(msg);
 
-        bxierr_p handler_err;
-        err2 = _join_handler(i, &handler_err);
-        BXIERR_CHAIN(err, err2);
+            bxierr_p handler_err;
+            err2 = _join_handler(i, &handler_err);
+            if (bxierr_isko(handler_err)) bxierr_list_append(errlist, handler_err);
+            if (bxierr_isko(err2)) bxierr_list_append(errlist, err2);
+        }
+        // Forget about handlers that died without replying
+        size_t alive_nb = 0;
+        for (size_t p = 0; p < pending_nb; p++) {
+            pthread_t thread = BXILOG__GLOBALS->handlers_threads[pending[p]];
+            if (ESRCH != pthread_kill(thread, 0)) pending[alive_nb++] = pending[p];
+        }
+        pending_nb = alive_nb;
+    }
 
-        if (bxierr_isko(handler_err)) bxierr_list_append(errlist, handler_err);
-        if (bxierr_isko(err)) bxierr_list_append(errlist, err);
+    for (size_t p = 0; p < pending_nb; p++) {
+        // Joining it would block forever: leave it behind
+        pthread_detach(BXILOG__GLOBALS->handlers_threads[pending[p]]);
+        BXILOG__GLOBALS->handlers_detached = true;
+        err2 = bxierr_new(BXIZMQ_TIMEOUT_ERR, NULL, NULL, NULL, NULL,
+                          "Handler %zu did not exit within %ld ms",
+                          pending[p], BXILOG__GLOBALS->config->handlers_deadline_ms);
+        bxierr_list_append(errlist, err2);
     }
+    _close_handlers_zockets(zockets, handlers_nb, errlist);
 
     if (0 < errlist->errors_nb) {
         err2 = bxierr_from_list(BXIERR_GROUP_CODE, errlist,
                                  "Some errors occurred in at least"
                                  " one of %zu internal handlers.",
-                                 BXILOG__GLOBALS->internal_handlers_nb);
+                                 handlers_nb);
         BXIERR_CHAIN(err, err2);
     } else {
         bxierr_list_destroy(&errlist);
     }
 
     return err;
-
-//    errno = 0;
-//    tsd_p tsd;
-//    bxierr_p err = BXIERR_OK, err2;
-//
-//    err2 = bxilog__tsd_get(&tsd);
-//    BXIERR_CHAIN(err, err2);
-//    if (bxierr_isko(err)) return err;
-//
-//    bxierr_group_p errlist = bxierr_group_new();
-//
-//    size_t handlers_nb = BXILOG__GLOBALS->param->handlers_nb;
-//
-//    for (size_t i = 0; i < handlers_nb; i++) {
-//        bxierr_p herr = BXIERR_OK, herr2;
-//        fprintf(stderr, "Sending EXIT\n");
-//        herr2 = bxizmq_str_snd(EXIT_CTRL_MSG_REQ, tsd->ctrl_channel, 0, 0, 0);
-//        BXIERR_CHAIN(herr, herr2);
-//
-//        bxierr_p handler_err;
-//        herr2 = _join_handler(i, &handler_err);
-//        BXIERR_CHAIN(herr, herr2);
-//
-//        if (bxierr_isko(handler_err)) bxierr_list_append(errlist, handler_err);
-//        if (bxierr_isko(herr)) bxierr_list_append(errlist, herr);
-//    }
-//
-//    if (0 < errlist->errors_nb) {
-//        err2 = bxierr_from_group(BXIERR_GROUP_CODE, errlist,
-//                                 "Some errors occurred in at least"
-//                                 " one of %zu internal handlers.",
-//                                 BXILOG__GLOBALS->internal_handlers_nb);
-//        BXIERR_CHAIN(err, err2);
-//    } else {
-//        bxierr_group_destroy(&errlist);
-//    }
-//
-//    return err;
 }
 
 
@@ -608,7 +727,11 @@ void bxilog_rawprint(char* msg, int fd) {
 bxierr_p _reset_globals() {
     bxierr_p err = BXIERR_OK, err2;
     errno = 0;
-    if (NULL != BXILOG__GLOBALS->zmq_ctx) {
+    if (BXILOG__GLOBALS->handlers_detached) {
+        // zmq_ctx_term() would wait for the sockets of a handler left behind:
+        // leak the context on purpose
+        BXILOG__GLOBALS->zmq_ctx = NULL;
+    } else if (NULL != BXILOG__GLOBALS->zmq_ctx) {
         err2 = bxizmq_context_destroy(&BXILOG__GLOBALS->zmq_ctx);
         BXIERR_CHAIN(err, err2);
     }
@@ -617,13 +740,23 @@ bxierr_p _reset_globals() {
     BXILOG__GLOBALS->tsd_key_once = PTHREAD_ONCE_INIT;
     BXILOG__GLOBALS->internal_handlers_nb = 0;
     BXIFREE(BXILOG__GLOBALS->handlers_threads);
+    BXIFREE(BXILOG__GLOBALS->handlers_dropped);
+    BXIFREE(BXILOG__GLOBALS->handlers_retried);
 
     return err;
 }
 
 bxierr_p _cleanup(void) {
+    // Started even when the initialization failed afterwards
+    bxierr_p err = bxilog__stats_stop();
+    if (bxierr_isko(err)) return err;
+
+    // Already done by a bxilog__finalize() which failed: getting the tsd would
+    // require the zmq context released then
+    if (NULL == BXILOG__GLOBALS->handlers_threads) return BXIERR_OK;
+
     tsd_p tsd;
-    bxierr_p err = bxilog__tsd_get(&tsd);
+    err = bxilog__tsd_get(&tsd);
     if (tsd != NULL) {
         bxilog__tsd_free(tsd);
     }
@@ -673,49 +806,82 @@ bxierr_p _start_handler_thread(bxilog_handler_p handler, bxilog_handler_param_p
     return err;
 }
 
-bxierr_p _sync_handler() {
-    tsd_p tsd;
-    bxierr_p fatal_err = bxilog__tsd_get(&tsd);
-    bxierr_abort_ifko(fatal_err);
-
-    bxierr_p err = BXIERR_OK, err2;
-
-    // We send only 1 message per handler but we don't know
-    // which one will get it. The one who replies will be synced.
-    err2 = bxizmq_str_snd(READY_CTRL_MSG_REQ, tsd->ctrl_channel,
-                          ZMQ_DONTWAIT, 1000, 1e3); // Retry 1000, wait 1 µs max
-    BXIERR_CHAIN(err, err2);
-    if (bxierr_isko(err)) return err;
-
-    char * msg;
-    err2 = bxizmq_str_rcv(tsd->ctrl_channel, 0, false, &msg);
-    BXIERR_CHAIN(err, err2);
-    // We always expect the rank to be sent!
-    size_t *rank = NULL;
-    size_t received_size;
-    err2 = bxizmq_data_rcv((void**)&rank, sizeof(*rank), tsd->ctrl_channel,
-                           0, true, &received_size);
-    BXIERR_CHAIN(err, err2);
+void _sync_handlers(bxierr_list_p errlist) {
+    bxierr_p err2;
+    size_t handlers_nb = BXILOG__GLOBALS->internal_handlers_nb;
+
+    struct timespec deadline;
+    _deadline_init(&deadline);
+
+    // All handlers are asked at once, each one through its own control zocket,
+    // and their replies are waited for concurrently.
+    void * zockets[handlers_nb + 1];
+    size_t pending[handlers_nb + 1];
+    size_t pending_nb = handlers_nb;
+    for (size_t i = 0; i < handlers_nb; i++) {
+        zockets[i] = NULL;
+        pending[i] = i;
+    }
+    err2 = _ask_handlers(READY_CTRL_MSG_REQ, zockets, pending, &pending_nb);
+    if (bxierr_isko(err2)) bxierr_list_append(errlist, err2);
+
+    while (0 < pending_nb) {
+        long remaining = _deadline_remaining(&deadline);
+        if (0 == remaining) break;
+
+        size_t ready[pending_nb];
+        size_t ready_nb;
+        err2 = _poll_handlers(zockets, pending, &pending_nb, remaining, ready, &ready_nb);
+        if (bxierr_isko(err2)) {
+            bxierr_list_append(errlist, err2);
+            break;
+        }
+        for (size_t r = 0; r < ready_nb; r++) {
+            size_t i = ready[r];
+            bxierr_p err = BXIERR_OK;
+            char * msg = NULL;
+            err2 = bxizmq_str_rcv(zockets[i], 0, false, &msg);
+            BXIERR_CHAIN(err, err2);
+            // We always expect the rank to be sent!
+            size_t *rank = NULL;
+            size_t received_size;
+            err2 = bxizmq_data_rcv((void**)&rank, sizeof(*rank), zockets[i],
+                                   0, true, &received_size);
+            BXIERR_CHAIN(err, err2);
+            if (bxierr_isko(err)) {
+                BXIFREE(msg);
+                BXIFREE(rank);
+                bxierr_list_append(errlist, err);
+                continue;
+            }
 
-    if (0 != strncmp(READY_CTRL_MSG_REP, msg, ARRAYLEN(READY_CTRL_MSG_REP))) {
-        // Ok, the handler sends us an error msg.
-        // We expect the handler to display its own error message so we can free it
-        BXILOG__GLOBALS->config->handlers_params[*rank]->status = BXI_LOG_HANDLER_ERROR;
-        // We expect it to die and the actual error will be returned
-        bxierr_p handler_err;
-        fatal_err = _join_handler(*rank, &handler_err);
-        bxierr_abort_ifko(fatal_err);
-
-        bxiassert(bxierr_isko(handler_err));
-        err2 = handler_err;
-        BXIERR_CHAIN(err, err2);
-    } else {
-        BXILOG__GLOBALS->config->handlers_params[*rank]->status = BXI_LOG_HANDLER_READY;
+            if (0 != strncmp(READY_CTRL_MSG_REP, msg, ARRAYLEN(READY_CTRL_MSG_REP))) {
+                // Ok, the handler sends us an error msg.
+                // We expect the handler to display its own error message so we can
+                // free it
+                BXILOG__GLOBALS->config->handlers_params[i]->status = BXI_LOG_HANDLER_ERROR;
+                // We expect it to die and the actual error will be returned
+                bxierr_p handler_err;
+                bxierr_p fatal_err = _join_handler(i, &handler_err);
+                bxierr_abort_ifko(fatal_err);
+
+                bxiassert(bxierr_isko(handler_err));
+                bxierr_list_append(errlist, handler_err);
+            } else {
+                BXILOG__GLOBALS->config->handlers_params[i]->status = BXI_LOG_HANDLER_READY;
+            }
+            BXIFREE(msg);
+            BXIFREE(rank);
+        }
     }
-    BXIFREE(msg);
-    BXIFREE(rank);
 
-    return err;
+    for (size_t p = 0; p < pending_nb; p++) {
+        err2 = bxierr_new(BXIZMQ_TIMEOUT_ERR, NULL, NULL, NULL, NULL,
+                          "Handler %zu not ready within %ld ms",
+                          pending[p], BXILOG__GLOBALS->config->handlers_deadline_ms);
+        bxierr_list_append(errlist, err2);
+    }
+    _close_handlers_zockets(zockets, handlers_nb, errlist);
 }
 
 
@@ -747,24 +913,171 @@ void _setprocname(char * name) {
 #endif
 }
 
-bxierr_p _zmq_str_rcv_timeout(void * zocket, char ** reply, long timeout) {
-    bxierr_p err = BXIERR_OK, err2 = BXIERR_OK;
-    zmq_pollitem_t poll_set[] = {{ zocket, 0, ZMQ_POLLIN, 0 },};
-    int rc = zmq_poll(poll_set, 1, timeout);
-    if (-1 == rc) {
-        err2 = bxierr_errno("Calling zmq_poll() failed");
+// Send the given filters to the given handler, *old is set to the filters the
+// caller must release: the previous ones, or the given ones if they were not sent.
+// Once sent, the given filters belong to the handler: when its reply is lost, the
+// previous ones are leaked rather than released while the handler might use them.
+bxierr_p _reconfig_handler(size_t handler_rank,
+                           bxilog_filters_p filters,
+                           bxilog_filters_p * old) {
+    if (bxilog__inline_mode()) return bxilog__inline_reconfig(handler_rank, filters, old);
+
+    *old = filters;
+    int rc = pthread_kill(BXILOG__GLOBALS->handlers_threads[handler_rank], 0);
+    if (ESRCH == rc) return bxierr_gen("Handler %zu is not running", handler_rank);
+
+    bxierr_p err = BXIERR_OK, err2;
+    // The thread control channel is load-balanced over all handlers:
+    // a dedicated one is required to reach a given handler.
+    void * zocket = NULL;
+    const char * url = BXILOG__GLOBALS->config->handlers_params[handler_rank]->ctrl_url;
+    err2 = bxizmq_zocket_create_connected(BXILOG__GLOBALS->zmq_ctx, ZMQ_REQ,
+                                          url, &zocket);
+    BXIERR_CHAIN(err, err2);
+    if (bxierr_isko(err)) return err;
+
+    err2 = bxizmq_str_snd(RECONFIG_CTRL_MSG_REQ, zocket, ZMQ_SNDMORE, 0, 0);
+    BXIERR_CHAIN(err, err2);
+    if (bxierr_isok(err)) {
+        err2 = bxizmq_data_snd(&filters, sizeof(filters), zocket, 0, 0, 0);
         BXIERR_CHAIN(err, err2);
-        return err;
     }
+    if (bxierr_isko(err)) goto QUIT;
+    *old = NULL;
 
-    if (0 == (poll_set[0].revents & ZMQ_POLLIN)) {
-        err2 = bxierr_gen("Calling zmq_poll() timeout %ld", timeout);
+    char * reply = NULL;
+    err2 = bxizmq_str_rcv(zocket, 0, false, &reply);
+    BXIERR_CHAIN(err, err2);
+    if (bxierr_isko(err)) goto QUIT;
+
+    bxilog_filters_p previous = NULL;
+    bxilog_filters_p * previous_p = &previous;
+    err2 = bxizmq_data_rcv((void**) &previous_p, sizeof(previous), zocket,
+                           0, true, NULL);
+    BXIERR_CHAIN(err, err2);
+    // From now on, the handler does not use what it sent us
+    if (bxierr_isok(err2)) *old = previous;
+
+    if (0 != strcmp(RECONFIG_CTRL_MSG_REP, reply)) {
+        err2 = bxierr_new(BXILOG_IHT2BC_PROTO_ERR, NULL, NULL, NULL, NULL,
+                          "Wrong message received in reply to %s: %s. Expecting: %s",
+                          RECONFIG_CTRL_MSG_REQ, reply, RECONFIG_CTRL_MSG_REP);
         BXIERR_CHAIN(err, err2);
-        return err;
     }
+    BXIFREE(reply);
 
-    err2 = bxizmq_str_rcv(zocket, 0, false, reply);
+QUIT:
+    err2 = bxizmq_zocket_destroy(&zocket);
     BXIERR_CHAIN(err, err2);
 
     return err;
 }
+
+void _deadline_init(struct timespec * deadline) {
+    long ms = BXILOG__GLOBALS->config->handlers_deadline_ms;
+    deadline->tv_sec = 0;
+    deadline->tv_nsec = 0;
+    if (0 > ms) return;
+
+    bxierr_p fatal_err = bxitime_get(CLOCK_MONOTONIC, deadline);
+    bxierr_abort_ifko(fatal_err);
+
+    deadline->tv_sec += ms / 1000;
+    deadline->tv_nsec += (ms % 1000) * 1000000;
+    if (deadline->tv_nsec >= 1000000000) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000;
+    }
+}
+
+// Return the number of ms before the given deadline: 0 when it expired,
+// -1 when there is no deadline (zmq_poll() convention).
+long _deadline_remaining(const struct timespec * deadline) {
+    if (0 > BXILOG__GLOBALS->config->handlers_deadline_ms) return -1;
+
+    struct timespec now;
+    bxierr_p fatal_err = bxitime_get(CLOCK_MONOTONIC, &now);
+    bxierr_abort_ifko(fatal_err);
+
+    long ms = (deadline->tv_sec - now.tv_sec) * 1000
+            + (deadline->tv_nsec - now.tv_nsec) / 1000000;
+    // Round up so a sub-millisecond remainder is still waited for
+    if (0 == ms && (deadline->tv_sec > now.tv_sec || deadline->tv_nsec > now.tv_nsec)) {
+        ms = 1;
+    }
+    return (0 > ms) ? 0 : ms;
+}
+
+// Send the given request to each pending handler through its own control zocket,
+// handlers that can't be reached are removed from the pending ones.
+bxierr_p _ask_handlers(const char * request,
+                       void ** zockets, size_t * pending, size_t * pending_nb) {
+    bxierr_p err = BXIERR_OK, err2;
+    size_t asked_nb = 0;
+    for (size_t p = 0; p < *pending_nb; p++) {
+        size_t i = pending[p];
+        const char * url = BXILOG__GLOBALS->config->handlers_params[i]->ctrl_url;
+        bxiassert(NULL != url);
+
+        err2 = bxizmq_zocket_create_connected(BXILOG__GLOBALS->zmq_ctx, ZMQ_REQ,
+                                              url, &zockets[i]);
+        BXIERR_CHAIN(err, err2);
+        if (bxierr_isko(err2)) continue;
+
+        err2 = bxizmq_str_snd(request, zockets[i],
+                              ZMQ_DONTWAIT, 1000, 1e3); // Retry 1000, wait 1 µs max
+        BXIERR_CHAIN(err, err2);
+        if (bxierr_isko(err2)) continue;
+
+        pending[asked_nb++] = i;
+    }
+    *pending_nb = asked_nb;
+
+    return err;
+}
+
+// Wait at most timeout ms for a reply from the pending handlers: those that
+// replied are moved from pending to ready.
+bxierr_p _poll_handlers(void ** zockets, size_t * pending, size_t * pending_nb,
+                        long timeout, size_t * ready, size_t * ready_nb) {
+    *ready_nb = 0;
+    zmq_pollitem_t items[*pending_nb];
+    for (size_t p = 0; p < *pending_nb; p++) {
+        items[p] = (zmq_pollitem_t) { zockets[pending[p]], 0, ZMQ_POLLIN, 0 };
+    }
+
+    int rc;
+    do {
+        errno = 0;
+        rc = zmq_poll(items, (int) *pending_nb, timeout);
+        // On EINTR, waiting again for timeout ms is fine: the caller checks its
+        // deadline anyway.
+    } while (-1 == rc && EINTR == errno);
+    if (-1 == rc) return bxierr_errno("Calling zmq_poll() failed");
+
+    size_t still_nb = 0;
+    for (size_t p = 0; p < *pending_nb; p++) {
+        if (items[p].revents & ZMQ_POLLIN) {
+            ready[(*ready_nb)++] = pending[p];
+        } else {
+            pending[still_nb++] = pending[p];
+        }
+    }
+    *pending_nb = still_nb;
+
+    return BXIERR_OK;
+}
+
+void _close_handlers_zockets(void ** zockets, size_t zockets_nb,
+                             bxierr_list_p errlist) {
+    for (size_t i = 0; i < zockets_nb; i++) {
+        if (NULL == zockets[i]) continue;
+        // A handler which did not reply must not delay the closing
+        int linger = 0;
+        bxierr_p err = bxizmq_zocket_setopt(zockets[i], ZMQ_LINGER,
+                                            &linger, sizeof(linger));
+        if (bxierr_isko(err)) bxierr_list_append(errlist, err);
+        err = bxizmq_zocket_destroy(&zockets[i]);
+        if (bxierr_isko(err)) bxierr_list_append(errlist, err);
+    }
+}
@@ -38,10 +38,35 @@
 //********************************** Types ****************************************
 //*********************************************************************************
 
+/*
+ * The filters of all handlers compiled into a single list of prefixes.
+ *
+ * The level of a logger only depends on the longest prefix it matches across all
+ * handlers: every other matching prefix is a prefix of this one. Therefore, each
+ * prefix holds the level of the loggers it is the longest match of.
+ */
+typedef struct {
+    char * prefix;
+    size_t len;                         // strlen(prefix)
+    bxilog_level_e level;
+} compiled_filter_s;
+
+typedef struct {
+    size_t nb;
+    compiled_filter_s list[];           // Longest prefixes first, "" is the last one
+} compiled_filters_s;
+
+typedef compiled_filters_s * compiled_filters_p;
+
 //*********************************************************************************
 //********************************** Static Functions  ****************************
 //*********************************************************************************
 //--------------------------------- Generic Helpers --------------------------------
+static compiled_filters_p _compile_filters(bxilog_config_p config);
+static bxilog_level_e _level_for(bxilog_config_p config,
+                                 const char * name, size_t name_length);
+static int _compiled_filter_compar(const void * f1, const void * f2);
+static void _compiled_filters_free(compiled_filters_p compiled);
 
 //*********************************************************************************
 //********************************** Global Variables  ****************************
@@ -50,6 +75,12 @@
 // The internal logger
 SET_LOGGER(LOGGER, BXILOG_LIB_PREFIX "bxilog.cfg");
 
+// Incremented on each configuration change (see bxilog_logger_is_enabled_for())
+unsigned bxilog__config_epoch = 0;
+
+static compiled_filters_p COMPILED_FILTERS = NULL;
+static pthread_mutex_t COMPILED_FILTERS_LOCK = PTHREAD_MUTEX_INITIALIZER;
+
 
 //*********************************************************************************
 //********************************** Implementation    ****************************
@@ -140,6 +171,13 @@ bxilog_config_p bxilog_config_new(const char * const progname) {
     config->handlers_nb = 0;
     config->ctrl_hwm = 1000;
     config->data_hwm = 1000;
+    config->fork_mode = BXILOG_FORK_RESTART;
+    config->handlers_deadline_ms = 10000;
+    config->handlers_mode = BXILOG_HANDLERS_THREADED;
+    config->stats_period_ms = 0;
+    config->handlers_process_time = false;
+    config->handlers_latency_dump = false;
+    config->handlers_talkers = false;
 
     return config;
 }
@@ -192,25 +230,71 @@ bxierr_p bxilog__config_destroy(bxilog_config_p * config_p) {
 }
 
 bxierr_p bxilog__config_loggers() {
-    bxilog_logger_p *loggers;
-    static char ** level_names;
-    bxilog_level_names(&level_names);
-    size_t loggers_nb = bxilog_registry_getall(&loggers);
-    for (size_t i = 0; i < loggers_nb; i++) {
-//        bxilog_level_e old_level = loggers[i]->level;
-        bxilog_logger_reconfigure(loggers[i]);
-//        bxilog_level_e new_level = loggers[i]->level;
-        //TODO: use DBG macro when available
-//        fprintf(stderr, "Configuration of %s: %s -> %s\n",
-//                loggers[i]->name,
-//                level_names[old_level],
-//                level_names[new_level]);
+    compiled_filters_p compiled = _compile_filters(BXILOG__GLOBALS->config);
+
+    int rc = pthread_mutex_lock(&COMPILED_FILTERS_LOCK);
+    if (0 != rc) {
+        _compiled_filters_free(compiled);
+        return bxierr_fromidx(rc, NULL, "Calling pthread_mutex_lock() failed (rc=%d)", rc);
     }
-    BXIFREE(loggers);
+    compiled_filters_p old = COMPILED_FILTERS;
+    COMPILED_FILTERS = compiled;
+    // Loggers refresh their level lazily on their next use
+    __atomic_add_fetch(&bxilog__config_epoch, 1, __ATOMIC_RELEASE);
+    rc = pthread_mutex_unlock(&COMPILED_FILTERS_LOCK);
+    if (0 != rc) return bxierr_fromidx(rc, NULL,
+                                       "Calling pthread_mutex_unlock() failed (rc=%d)", rc);
+
+    _compiled_filters_free(old);
 
     return BXIERR_OK;
 }
 
+bool bxilog__config_level(const char * name, size_t name_length, bxilog_level_e * level) {
+    bool found = false;
+    int rc = pthread_mutex_lock(&COMPILED_FILTERS_LOCK);
+    bxiassert(0 == rc);
+    compiled_filters_p compiled = COMPILED_FILTERS;
+    for (size_t i = 0; NULL != compiled && i < compiled->nb; i++) {
+        const compiled_filter_s * filter = &compiled->list[i];
+        if (name_length <= filter->len) continue;
+        if (0 != strncmp(filter->prefix, name, filter->len)) continue;
+        *level = filter->level;
+        found = true;
+        break;
+    }
+    rc = pthread_mutex_unlock(&COMPILED_FILTERS_LOCK);
+    bxiassert(0 == rc);
+
+    return found;
+}
+
+void bxilog__config_release_filters() {
+    int rc = pthread_mutex_lock(&COMPILED_FILTERS_LOCK);
+    bxiassert(0 == rc);
+    compiled_filters_p old = COMPILED_FILTERS;
+    COMPILED_FILTERS = NULL;
+    rc = pthread_mutex_unlock(&COMPILED_FILTERS_LOCK);
+    bxiassert(0 == rc);
+
+    _compiled_filters_free(old);
+}
+
+void bxilog__config_before_fork(void) {
+    int rc = pthread_mutex_lock(&COMPILED_FILTERS_LOCK);
+    bxiassert(0 == rc);
+}
+
+void bxilog__config_parent_after_fork(void) {
+    int rc = pthread_mutex_unlock(&COMPILED_FILTERS_LOCK);
+    bxiassert(0 == rc);
+}
+
+void bxilog__config_child_after_fork(void) {
+    int rc = pthread_mutex_init(&COMPILED_FILTERS_LOCK, NULL);
+    bxiassert(0 == rc);
+}
+
 bxierr_p bxilog_get_level_from_str(char * level_str, bxilog_level_e *level) {
     if (0 == strcasecmp("off", level_str)) {
         *level = BXILOG_OFF;
@@ -277,3 +361,94 @@ bxierr_p bxilog_get_level_from_str(char * level_str, bxilog_level_e *level) {
 //*********************************************************************************
 //********************************** Static Helpers Implementation ****************
 //*********************************************************************************
+
+compiled_filters_p _compile_filters(bxilog_config_p config) {
+    if (NULL == config) return NULL;
+
+    size_t nb = 1; // The empty prefix, matched by all loggers
+    for (size_t i = 0; i < config->handlers_nb; i++) {
+        const bxilog_filters_p filters = __atomic_load_n(&config->handlers_params[i]->filters,
+                                                         __ATOMIC_ACQUIRE);
+        nb += filters->nb;
+    }
+
+    compiled_filters_p result = bximem_calloc(sizeof(*result) + nb * sizeof(result->list[0]));
+    result->list[0].prefix = strdup("");
+    size_t n = 1;
+    for (size_t i = 0; i < config->handlers_nb; i++) {
+        const bxilog_filters_p filters = __atomic_load_n(&config->handlers_params[i]->filters,
+                                                         __ATOMIC_ACQUIRE);
+        for (size_t f = 0; f < filters->nb; f++) {
+            // Filters may be released before their compiled version
+            result->list[n++].prefix = strdup(filters->list[f]->prefix);
+        }
+    }
+    for (size_t i = 0; i < n; i++) result->list[i].len = strlen(result->list[i].prefix);
+    qsort(result->list, n, sizeof(result->list[0]), _compiled_filter_compar);
+
+    // Remove duplicates, then compute each level once and for all
+    size_t j = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (0 < j && result->list[j - 1].len == result->list[i].len
+            && 0 == strcmp(result->list[j - 1].prefix, result->list[i].prefix)) {
+            BXIFREE(result->list[i].prefix);
+            continue;
+        }
+        result->list[j++] = result->list[i];
+    }
+    result->nb = j;
+    for (size_t i = 0; i < result->nb; i++) {
+        compiled_filter_s * filter = &result->list[i];
+        filter->level = _level_for(config, filter->prefix, filter->len + 1);
+    }
+
+    return result;
+}
+
+bxilog_level_e _level_for(bxilog_config_p config, const char * name, size_t name_length) {
+    bxilog_level_e minimum_level = BXILOG_OFF; // The minimum level required for the current logger
+                                               // across all handlers
+    for (size_t i = 0; i < config->handlers_nb; i++) {
+        const bxilog_filters_p filters = __atomic_load_n(&config->handlers_params[i]->filters,
+                                                         __ATOMIC_ACQUIRE);
+        size_t best_match_len = 0; // The length of the most precise matching filter
+                                   // inside each handler
+        bxilog_level_e best_match_level = BXILOG_LOWEST; // The best match level inside
+                                                         // each handler
+        // First, look after the most precise filter in the current handler
+        for (size_t f = 0; f < filters->nb; f++) {
+            const bxilog_filter_p filter = filters->list[f];
+            const size_t filter_pre_len = strlen(filter->prefix);
+            if (name_length < filter_pre_len) continue;
+            if (0 != strncmp(filter->prefix, name, filter_pre_len)) continue;
+            // This filter prefix matches the logger name
+            // Let see if it is the maximum match
+            if (best_match_len > filter_pre_len) continue;
+            // We found a new good match, make it the last best known
+            best_match_len = filter_pre_len;
+            best_match_level = filter->level;
+        }
+        // At that stage, we know the most precise filter's level
+        // However, other handlers might have other requirements
+        // If another handler specifies a more detailed level, it must be set in
+        // the logger, otherwise, it won't be seen by expected handlers.
+        // Therefore, the minimum level is the one with the greatest details across
+        // handlers
+        if (best_match_level < minimum_level) continue;
+        minimum_level = best_match_level;
+    }
+    return minimum_level;
+}
+
+int _compiled_filter_compar(const void * f1, const void * f2) {
+    const compiled_filter_s * filter1 = f1;
+    const compiled_filter_s * filter2 = f2;
+    if (filter1->len != filter2->len) return (filter1->len < filter2->len) ? 1 : -1;
+    return strcmp(filter1->prefix, filter2->prefix);
+}
+
+void _compiled_filters_free(compiled_filters_p compiled) {
+    if (NULL == compiled) return;
+    for (size_t i = 0; i < compiled->nb; i++) BXIFREE(compiled->list[i].prefix);
+    BXIFREE(compiled);
+}
@@ -36,5 +36,13 @@
 
 bxierr_p bxilog__config_destroy(bxilog_config_p * config_p);
 bxierr_p bxilog__config_loggers();
+// Set *level to the level of the given logger name in the current configuration,
+// return false if there is no current configuration
+bool bxilog__config_level(const char * name, size_t name_length, bxilog_level_e * level);
+void bxilog__config_release_filters();
+// COMPILED_FILTERS_LOCK is held across a fork(), see _parent_before_fork()
+void bxilog__config_before_fork(void);
+void bxilog__config_parent_after_fork(void);
+void bxilog__config_child_after_fork(void);
 
 #endif
@@ -423,7 +423,6 @@ bxierr_p _process_ierr(bxierr_p *err, bxilog_console_handler_param_p data) {
 
 bxierr_p _process_cfg(bxilog_console_handler_param_p data) {
     UNUSED(data);
-    bxiunreachable_statement;
     return BXIERR_OK;
 }
 
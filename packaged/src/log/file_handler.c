@@ -133,6 +133,8 @@ static bxierr_p _process_explicit_flush(bxilog_file_handler_param_p data);
 static bxierr_p _process_exit(bxilog_file_handler_param_p data);
 static bxierr_p _process_cfg(bxilog_file_handler_param_p data);
 static bxierr_p _param_destroy(bxilog_file_handler_param_p *data_p);
+static bxierr_p _process_stats(bxilog_file_handler_param_p data,
+                               bxilog_handler_stats_p stats);
 
 static bxierr_p _get_file_fd(bxilog_file_handler_param_p data);
 
@@ -200,6 +202,8 @@ static const bxilog_handler_s BXILOG_FILE_HANDLER_S = {
                   .process_exit = (bxierr_p (*) (bxilog_handler_param_p)) _process_exit,
                   .process_cfg = (bxierr_p (*) (bxilog_handler_param_p)) _process_cfg,
                   .param_destroy = (bxierr_p (*) (bxilog_handler_param_p*)) _param_destroy,
+                  .process_stats = (bxierr_p (*) (bxilog_handler_param_p,
+                                                  bxilog_handler_stats_p)) _process_stats,
 };
 const bxilog_handler_p BXILOG_FILE_HANDLER = (bxilog_handler_p) &BXILOG_FILE_HANDLER_S;
 
@@ -312,18 +316,21 @@ bxierr_p _process_exit(bxilog_file_handler_param_p data) {
         char * str = bxistr_new("BXI Log File Handler Error Summary:\n"
                                 "\tNumber of bytes written: %zu\n"
                                 "\tNumber of bytes lost: %zu\n"
-                                "\tNumber of reported distinct errors: %zu\n",
+                                "\tNumber of reported distinct errors: %zu\n"
+                                "\tNumber of internal errors: %zu\n",
                                 data->bytes_written,
                                 data->bytes_lost,
-                                data->errset->distinct_err.errors_nb);
+                                data->errset->distinct_err.errors_nb,
+                                data->errset->total_seen_nb);
         bxilog_rawprint(str, STDERR_FILENO);
         BXIFREE(str);
     }
 
     if (0 < data->errset->distinct_err.errors_nb) {
         err2 = bxierr_from_set(BXIERR_GROUP_CODE, data->errset,
-                               "Error Set (%zu distinct errors)",
-                               data->errset->distinct_err.errors_nb);
+                               "Error Set (%zu distinct errors, seen %zu times)",
+                               data->errset->distinct_err.errors_nb,
+                               data->errset->total_seen_nb);
         BXIERR_CHAIN(err, err2);
     } else {
         bxierr_set_destroy(&data->errset);
@@ -434,7 +441,13 @@ bxierr_p _process_ierr(bxierr_p *err, bxilog_file_handler_param_p data) {
 
 bxierr_p _process_cfg(bxilog_file_handler_param_p data) {
     UNUSED(data);
-    bxiunreachable_statement;
+    return BXIERR_OK;
+}
+
+bxierr_p _process_stats(bxilog_file_handler_param_p data,
+                        bxilog_handler_stats_p stats) {
+    stats->bytes_written = data->bytes_written;
+    stats->bytes_lost = data->bytes_lost;
     return BXIERR_OK;
 }
 
@@ -12,14 +12,21 @@
  */
 
 #include <pthread.h>
+#include <sched.h>
 #include <errno.h>
 #include <sysexits.h>
+#include <unistd.h>
 
 #include "bxi/base/str.h"
 #include "bxi/base/log.h"
 
 #include "log_impl.h"
+#include "config_impl.h"
+#include "registry_impl.h"
+#include "tsd_impl.h"
 #include "fork_impl.h"
+#include "inline_impl.h"
+#include "stats_impl.h"
 
 //*********************************************************************************
 //********************************** Defines **************************************
@@ -33,8 +40,13 @@
 //********************************** Static Functions  ****************************
 //*********************************************************************************
 static void _parent_before_fork(void);
+static void _prepare(void);
 static void _parent_after_fork(void);
+static void _resume(void);
 static void _child_after_fork(void);
+static bool _quiesce_mode(void);
+static void _quiesce_producers(void);
+static void _resume_producers(void);
 
 //*********************************************************************************
 //********************************** Global Variables  ****************************
@@ -43,6 +55,12 @@ static void _child_after_fork(void);
 // The internal logger
 SET_LOGGER(LOGGER, BXILOG_LIB_PREFIX "bxilog.fork");
 
+// Number of threads producing a log, and whether a fork() is waiting for them
+static size_t PRODUCERS_NB = 0;
+static bool QUIESCING = false;
+// Logs produced while producing a log do not count twice
+static __thread unsigned PRODUCER_DEPTH = 0;
+
 
 //*********************************************************************************
 //********************************** Implementation    ****************************
@@ -55,12 +73,45 @@ void bxilog__fork_install_handlers(void) {
     bxiassert(0 == rc);
 }
 
+void bxilog__fork_producer_enter(void) {
+    if (0 < PRODUCER_DEPTH++) return;
+    while (true) {
+        __atomic_add_fetch(&PRODUCERS_NB, 1, __ATOMIC_SEQ_CST);
+        if (!__atomic_load_n(&QUIESCING, __ATOMIC_SEQ_CST)) return;
+        // A fork() is in progress: step back and wait for its end
+        __atomic_sub_fetch(&PRODUCERS_NB, 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&QUIESCING, __ATOMIC_ACQUIRE)) sched_yield();
+    }
+}
+
+void bxilog__fork_producer_leave(void) {
+    bxiassert(0 < PRODUCER_DEPTH);
+    if (0 < --PRODUCER_DEPTH) return;
+    __atomic_sub_fetch(&PRODUCERS_NB, 1, __ATOMIC_RELEASE);
+}
+
 //*********************************************************************************
 //********************************** Static Helpers Implementation ****************
 //*********************************************************************************
 
 
+/*
+ * The library locks are held across the fork(): the child gets them unlocked
+ * with the data they protect in a consistent state, whatever the other threads,
+ * handlers included, were doing.
+ */
 void _parent_before_fork(void) {
+    // Taken first: its owner might log, and logs wait once producers are quiesced
+    bxilog__core_before_fork();
+    _prepare();
+    // Taken last: no producer is left to take them, and bxilog__wipeout() takes
+    // them when _prepare() calls exit()
+    bxilog__registry_before_fork();
+    bxilog__config_before_fork();
+    bxilog__tsd_before_fork();
+}
+
+void _prepare(void) {
     // WARNING: If you change the FSM transition,
     // comment you changes in bxilog_state_e above.
     if (INITIALIZING == BXILOG__GLOBALS->state || FINALIZING == BXILOG__GLOBALS->state) {
@@ -72,6 +123,18 @@ void _parent_before_fork(void) {
     if(INITIALIZED != BXILOG__GLOBALS->state) return;
     FINE(LOGGER, "Preparing for a fork() (state == %d)", BXILOG__GLOBALS->state);
     bxierr_p err = BXIERR_OK, err2;
+    if (_quiesce_mode()) {
+        // Handlers keep running: wait for the logs in progress, then flush them,
+        // no new log can slip in between.
+        _quiesce_producers();
+        // Our own logs do not wait for the fork() to complete
+        PRODUCER_DEPTH++;
+        err = bxilog_flush();
+        PRODUCER_DEPTH--;
+        if (bxierr_isko(err)) bxierr_report(&err, STDERR_FILENO);
+        BXILOG__GLOBALS->state = FORKED;
+        return;
+    }
     err2 = bxilog_flush();
     BXIERR_CHAIN(err, err2);
     err2 = bxilog__finalize();
@@ -97,10 +160,33 @@ void _parent_before_fork(void) {
 }
 
 void _parent_after_fork(void) {
+    // Released first: restarting the handlers takes them
+    bxilog__tsd_parent_after_fork();
+    bxilog__config_parent_after_fork();
+    bxilog__registry_parent_after_fork();
+    _resume();
+    bxilog__core_parent_after_fork();
+}
+
+void _resume(void) {
     // WARNING: If you change the FSM transition,
     // comment your changes in bxilog_state_e above.
     if (FORKED != BXILOG__GLOBALS->state) return;
 
+    if (_quiesce_mode()) {
+        BXILOG__GLOBALS->state = INITIALIZED;
+        _resume_producers();
+        return;
+    }
+    if (BXILOG__GLOBALS->handlers_detached) {
+        // New handlers would share the parameters of the one left behind
+        bxierr_p err = bxierr_gen("A handler did not exit before the fork(), "
+                                  "bxilog can't be restarted in the parent");
+        bxierr_report(&err, STDERR_FILENO);
+        BXILOG__GLOBALS->state = BROKEN;
+        return;
+    }
+
     BXILOG__GLOBALS->state = INITIALIZING;
 
     bxierr_p err = bxilog__init_globals();
@@ -132,11 +218,71 @@ void _parent_after_fork(void) {
 }
 
 void _child_after_fork(void) {
+    // Held by the forking thread, see _parent_before_fork()
+    bxilog__core_child_after_fork();
+    bxilog__registry_child_after_fork();
+    bxilog__config_child_after_fork();
+    bxilog__stats_child_after_fork();
     // WARNING: If you change the FSM transition,
     // comment your changes in bxilog_state_e above.
-    if (FORKED != BXILOG__GLOBALS->state) return;
+    if (FORKED != BXILOG__GLOBALS->state) {
+        bxilog__tsd_child_after_fork(false);
+        return;
+    }
+    // Threads are not duplicated: no handler is left behind in the child
+    BXILOG__GLOBALS->handlers_detached = false;
+    if (_quiesce_mode() && bxilog__inline_mode()) {
+        // Inline handlers need neither thread nor zmq: the child keeps them
+        BXILOG__GLOBALS->pid = getpid();
+        bxilog__inline_child_after_fork();
+        bxilog__tsd_child_after_fork(true);
+        PRODUCERS_NB = 0;
+        bxierr_p err = bxilog__stats_start();
+        if (bxierr_isko(err)) bxierr_report(&err, STDERR_FILENO);
+        BXILOG__GLOBALS->state = INITIALIZED;
+        _resume_producers();
+        return;
+    }
+    if (_quiesce_mode()) {
+        // The zmq context and the sockets of the parent can be neither used nor
+        // destroyed in the child (zmq threads are not duplicated): forget them.
+        BXILOG__GLOBALS->zmq_ctx = NULL;
+        BXILOG__GLOBALS->internal_handlers_nb = 0;
+        BXIFREE(BXILOG__GLOBALS->handlers_threads);
+        BXIFREE(BXILOG__GLOBALS->handlers_dropped);
+        BXIFREE(BXILOG__GLOBALS->handlers_retried);
+        tsd_p tsd = pthread_getspecific(BXILOG__GLOBALS->tsd_key);
+        if (NULL != tsd) {
+            BXIFREE(tsd->log_buf);
+            BXIFREE(tsd);
+            int rc = pthread_setspecific(BXILOG__GLOBALS->tsd_key, NULL);
+            bxiassert(0 == rc);
+        }
+        bxilog__tsd_child_after_fork(false);
+        // Only the forking thread exists in the child
+        PRODUCERS_NB = 0;
+        BXILOG__GLOBALS->state = QUIESCED;
+        _resume_producers();
+        // Handlers are started on the first log, see bxilog__resume()
+        return;
+    }
+    bxilog__tsd_child_after_fork(false);
     BXILOG__GLOBALS->state = FINALIZED;
     // The child remain in the finalized state
     // It has to call bxilog_init() if it wants to do some log.
 }
 
+bool _quiesce_mode(void) {
+    return NULL != BXILOG__GLOBALS->config &&
+           BXILOG_FORK_QUIESCE == BXILOG__GLOBALS->config->fork_mode;
+}
+
+void _quiesce_producers(void) {
+    __atomic_store_n(&QUIESCING, true, __ATOMIC_SEQ_CST);
+    while (0 < __atomic_load_n(&PRODUCERS_NB, __ATOMIC_SEQ_CST)) sched_yield();
+}
+
+void _resume_producers(void) {
+    __atomic_store_n(&QUIESCING, false, __ATOMIC_RELEASE);
+}
+
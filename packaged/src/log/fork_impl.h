@@ -31,4 +31,11 @@
 
 void bxilog__fork_install_handlers(void);
 
+/*
+ * Bracket the production of a log, so a fork() in the BXILOG_FORK_QUIESCE mode
+ * waits for it, and a new one waits for the fork() to complete.
+ */
+void bxilog__fork_producer_enter(void);
+void bxilog__fork_producer_leave(void);
+
 #endif
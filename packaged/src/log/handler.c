@@ -17,6 +17,7 @@
 #include <pthread.h>
 #include <sysexits.h>
 #include <string.h>
+#include <inttypes.h>
 
 #include "bxi/base/err.h"
 #include "bxi/base/mem.h"
@@ -29,6 +30,8 @@
 
 #include "handler_impl.h"
 #include "log_impl.h"
+#include "stats_impl.h"
+#include "talkers_impl.h"
 
 
 //*********************************************************************************
@@ -43,6 +46,8 @@
 typedef struct {
     void * ctrl_zocket;
     void * data_zocket;
+    bxilog_handler_stats_s stats;           // Returned by the STATS control message
+    bxilog__talkers_p talkers;              // NULL unless talkers are tracked
 
 #ifdef __linux__
     pid_t tid;                              // the thread pid
@@ -100,6 +105,14 @@ static bxierr_p _process_explicit_flush(bxilog_handler_p,
 static bxierr_p _process_exit(bxilog_handler_p,
                               bxilog_handler_param_p,
                               handler_data_p);
+static bxierr_p _process_reconfig(bxilog_handler_p,
+                                  bxilog_handler_param_p,
+                                  handler_data_p);
+static bxierr_p _process_stats(bxilog_handler_p,
+                               bxilog_handler_param_p,
+                               handler_data_p);
+static uint64_t _elapsed_ns(const struct timespec * from, const struct timespec * to);
+static char * _histogram_str(const char * title, const bxilog_histogram_p histogram);
 
 //*********************************************************************************
 //********************************** Global Variables  ****************************
@@ -185,10 +198,148 @@ CLEANUP:
     return eerr;
 }
 
+bxierr_p bxilog__handler_process_record(bxilog_handler_p handler,
+                                        bxilog_handler_param_p param,
+                                        bxilog_record_p record,
+                                        bxilog_handler_stats_p stats,
+                                        bxilog__talkers_p talkers) {
+
+    // Fetch other strings: filename, funcname, loggername, logmsg
+    char * filename = (char *) record + sizeof(*record);
+    char * funcname = filename + record->filename_len;
+    char * loggername = funcname + record->funcname_len;
+    char * logmsg = loggername + record->logname_len;
+
+    BXILOG__STAGE_START(filter_start);
+    bxilog_level_e filter_level = BXILOG_OFF;
+
+    for (size_t i = 0; i < param->filters->nb; i++) {
+        bxilog_filter_p filter = param->filters->list[i];
+        if (NULL == filter) break;
+
+        if (0 == strncmp(filter->prefix, loggername, strlen(filter->prefix))) {
+            filter_level = filter->level;
+//            fprintf(stderr, "%d.%d: %s MATCH [%zu] %s:%d\n",
+//                                    record->pid, record->tid, loggername,
+//                                    i, filter->prefix, filter->level);
+        } else {
+//            fprintf(stderr, "%d.%d: %s MISMATCH [%zu] %s:%d\n",
+//                                                record->pid, record->tid, loggername,
+//                                                i, filter->prefix, filter->level);
+        }
+    }
+    BXILOG__STAGE_END(stats->stages, BXILOG_STAGE_FILTER, filter_start);
+    bxierr_p err = BXIERR_OK;
+    if (record->level > filter_level) {
+        stats->filtered_nb++;
+        return err;
+    }
+    stats->processed_nb++;
+    bxilog__talkers_count(talkers, record);
+
+    // The record was created by the logging thread at detail_time
+    struct timespec now, end;
+    bxierr_p err2 = bxitime_get(CLOCK_REALTIME, &now);
+    if (bxierr_isko(err2)) bxierr_report(&err2, STDERR_FILENO);
+    bxilog_histogram_add(&stats->queue_delay, _elapsed_ns(&record->detail_time, &now));
+
+    if (NULL != handler->process_log) {
+        err = handler->process_log(record,
+                                   filename, funcname, loggername, logmsg,
+                                   param);
+    }
+    if (BXILOG__GLOBALS->config->handlers_process_time) {
+        err2 = bxitime_get(CLOCK_REALTIME, &end);
+        if (bxierr_isko(err2)) bxierr_report(&err2, STDERR_FILENO);
+        bxilog_histogram_add(&stats->process_time, _elapsed_ns(&now, &end));
+    }
+
+    return err;
+}
+
+bxierr_p bxilog__handler_flush(bxilog_handler_p handler,
+                               bxilog_handler_param_p param,
+                               bool explicit,
+                               bxilog_handler_stats_p stats) {
+
+    bxierr_p (*flush)(bxilog_handler_param_p) = explicit ?
+                                                handler->process_explicit_flush :
+                                                handler->process_implicit_flush;
+    stats->flushes_nb++;
+    if (NULL == flush) return BXIERR_OK;
+
+    struct timespec start;
+    bxierr_p err = BXIERR_OK, err2;
+    err2 = bxitime_get(CLOCK_MONOTONIC, &start);
+    if (bxierr_isko(err2)) bxierr_report(&err2, STDERR_FILENO);
+
+    err = flush(param);
+
+    double duration;
+    err2 = bxitime_duration(CLOCK_MONOTONIC, start, &duration);
+    if (bxierr_isko(err2)) {
+        bxierr_report(&err2, STDERR_FILENO);
+        return err;
+    }
+    stats->flushes_duration += duration;
+    if (duration > stats->flush_max_duration) stats->flush_max_duration = duration;
+
+    return err;
+}
+
+bxierr_p bxilog__handler_get_stats(bxilog_handler_p handler,
+                                   bxilog_handler_param_p param,
+                                   const bxilog_handler_stats_p stats,
+                                   const bxilog__talkers_p talkers,
+                                   bxilog_handler_stats_p result) {
+
+    *result = *stats;
+    bxilog__talkers_top(talkers, result);
+    return (NULL == handler->process_stats) ? BXIERR_OK :
+            handler->process_stats(param, result);
+}
+
+void bxilog__handler_dump_latency(bxilog_handler_p handler,
+                                  bxilog_handler_param_p param,
+                                  const bxilog_handler_stats_p stats) {
+
+    if (!BXILOG__GLOBALS->config->handlers_latency_dump) return;
+
+    char * queue_delay = _histogram_str("Queue delay", &stats->queue_delay);
+    char * process_time = BXILOG__GLOBALS->config->handlers_process_time ?
+                          _histogram_str("Processing time", &stats->process_time) :
+                          strdup("");
+    char * str = bxistr_new("BXI Log Handler Latency Summary (%s, rank %zu):\n%s%s",
+                            handler->name, param->rank, queue_delay, process_time);
+    bxilog_rawprint(str, STDERR_FILENO);
+    BXIFREE(str);
+    BXIFREE(process_time);
+    BXIFREE(queue_delay);
+}
+
 //*********************************************************************************
 //********************************** Static Helpers Implementation ****************
 //*********************************************************************************
 
+// Clocks may go backward: a negative duration is 0
+uint64_t _elapsed_ns(const struct timespec * from, const struct timespec * to) {
+    const int64_t ns = (int64_t) (to->tv_sec - from->tv_sec) * 1000000000
+                     + (to->tv_nsec - from->tv_nsec);
+    return (0 > ns) ? 0 : (uint64_t) ns;
+}
+
+char * _histogram_str(const char * title, const bxilog_histogram_p histogram) {
+    return bxistr_new("\t%s of %" PRIu64 " records (us): min=%.1f p50=%.1f p90=%.1f "
+                      "p99=%.1f p99.9=%.1f max=%.1f\n",
+                      title, histogram->count,
+                      (double) histogram->min / 1e3,
+                      (double) bxilog_histogram_percentile(histogram, 50) / 1e3,
+                      (double) bxilog_histogram_percentile(histogram, 90) / 1e3,
+                      (double) bxilog_histogram_percentile(histogram, 99) / 1e3,
+                      (double) bxilog_histogram_percentile(histogram, 99.9) / 1e3,
+                      (double) histogram->max / 1e3);
+}
+
 // All signals are blocked in this thread, they must be dealt with
 // by other threads. Note: this is only true for asynchronous signals
 // such as SIGINT, SIGQUIT and so on...
@@ -297,7 +448,7 @@ bxierr_p _bind_data_zocket(bxilog_handler_p handler,
 bxierr_p _init_handler(bxilog_handler_p handler,
                        bxilog_handler_param_p param,
                        handler_data_p data) {
-    UNUSED(data);
+    data->talkers = bxilog__talkers_new();
     return (NULL == handler->init) ? BXIERR_OK : handler->init(param);
 }
 
@@ -474,6 +625,8 @@ bxierr_p _cleanup(bxilog_handler_p handler,
     err2 = bxizmq_zocket_destroy(&data->ctrl_zocket);
     BXIERR_CHAIN(err, err2);
 
+    bxilog__talkers_destroy(&data->talkers);
+
     return err;
 }
 
@@ -505,6 +658,7 @@ bxierr_p _process_log_record(bxilog_handler_p handler,
 
     bxierr_p err = BXIERR_OK, err2;
 
+    BXILOG__STAGE_START(receive_start);
     err2 = bxizmq_msg_rcv(data->data_zocket, &zmsg, ZMQ_DONTWAIT);
     BXIERR_CHAIN(err, err2);
 
@@ -513,6 +667,8 @@ bxierr_p _process_log_record(bxilog_handler_p handler,
         BXIERR_CHAIN(err, err2);
         return err;
     }
+    // Only received records: the EAGAIN ending each flush is not one
+    BXILOG__STAGE_END(data->stats.stages, BXILOG_STAGE_RECEIVE, receive_start);
 
     err2 = _process_log_zmsg(handler, param, data, zmsg);
     BXIERR_CHAIN(err, err2);
@@ -535,39 +691,8 @@ bxierr_p _process_log_zmsg(bxilog_handler_p handler,
 
     bxilog_record_s * record = zmq_msg_data(&zmsg);
 
-    // Fetch other strings: filename, funcname, loggername, logmsg
-    char * filename = (char *) record + sizeof(*record);
-    char * funcname = filename + record->filename_len;
-    char * loggername = funcname + record->funcname_len;
-    char * logmsg = loggername + record->logname_len;
-
-    bxilog_level_e filter_level = BXILOG_OFF;
-
-    for (size_t i = 0; i < param->filters->nb; i++) {
-        bxilog_filter_p filter = param->filters->list[i];
-        if (NULL == filter) break;
-
-        if (0 == strncmp(filter->prefix, loggername, strlen(filter->prefix))) {
-            filter_level = filter->level;
-//            fprintf(stderr, "%d.%d: %s MATCH [%zu] %s:%d\n",
-//                                    record->pid, record->tid, loggername,
-//                                    i, filter->prefix, filter->level);
-        } else {
-//            fprintf(stderr, "%d.%d: %s MISMATCH [%zu] %s:%d\n",
-//                                                record->pid, record->tid, loggername,
-//                                                i, filter->prefix, filter->level);
-        }
-    }
-    bxierr_p err = BXIERR_OK;
-    if ((record->level <= filter_level) && (NULL != handler->process_log)) {
-            err = handler->process_log(record,
-                                       filename, funcname, loggername, logmsg,
-                                       param);
-    } else {
-        UNUSED(data);
-    }
-
-    return err;
+    return bxilog__handler_process_record(handler, param, record,
+                                          &data->stats, data->talkers);
 }
 
 bxierr_p _process_ctrl_cmd(bxilog_handler_p handler,
@@ -619,8 +744,21 @@ bxierr_p _process_ctrl_cmd(bxilog_handler_p handler,
         err2 = bxizmq_str_snd(EXIT_CTRL_MSG_REP, data->ctrl_zocket, 0, 0, 0);
         BXIERR_CHAIN(err, err2);
 
-        return bxierr_new(BXILOG_HANDLER_EXIT_CODE, err, NULL, NULL, NULL,
-                          "Exit requested");
+        err2 = bxierr_pooled(BXILOG_HANDLER_EXIT_CODE, "Exit requested");
+        err2->data = err;
+        return err2;
+    }
+    if (0 == strncmp(RECONFIG_CTRL_MSG_REQ, cmd, ARRAYLEN(RECONFIG_CTRL_MSG_REQ))) {
+        BXIFREE(cmd);
+        err2 = _process_reconfig(handler, param, data);
+        BXIERR_CHAIN(err, err2);
+        return err;
+    }
+    if (0 == strncmp(STATS_CTRL_MSG_REQ, cmd, ARRAYLEN(STATS_CTRL_MSG_REQ))) {
+        BXIFREE(cmd);
+        err2 = _process_stats(handler, param, data);
+        BXIERR_CHAIN(err, err2);
+        return err;
     }
     err2 = bxierr_gen("%s: unknown control command: %s", handler->name, cmd);
     BXIERR_CHAIN(err, err2);
@@ -637,8 +775,7 @@ bxierr_p _process_implicit_flush(bxilog_handler_p handler,
     err2 = _internal_flush(handler, param, data);
     BXIERR_CHAIN(err, err2);
 
-    err2 = (NULL == handler->process_implicit_flush) ? BXIERR_OK :
-            handler->process_implicit_flush(param);
+    err2 = bxilog__handler_flush(handler, param, false, &data->stats);
 
     BXIERR_CHAIN(err, err2);
 
@@ -654,8 +791,7 @@ bxierr_p _process_explicit_flush(bxilog_handler_p handler,
     err2 = _internal_flush(handler, param, data);
     BXIERR_CHAIN(err, err2);
 
-    err2 = (NULL == handler->process_explicit_flush) ? BXIERR_OK :
-            handler->process_explicit_flush(param);
+    err2 = bxilog__handler_flush(handler, param, true, &data->stats);
 
     BXIERR_CHAIN(err, err2);
 
@@ -666,14 +802,69 @@ bxierr_p _process_exit(bxilog_handler_p handler,
                        bxilog_handler_param_p param,
                        handler_data_p data) {
 
-    UNUSED(handler);
-    UNUSED(data);
+    bxilog__handler_dump_latency(handler, param, &data->stats);
 
     return (NULL == handler->process_exit) ?
             BXIERR_OK :
             handler->process_exit(param);
 }
 
+bxierr_p _process_reconfig(bxilog_handler_p handler,
+                           bxilog_handler_param_p param,
+                           handler_data_p data) {
+
+    bxierr_p err = BXIERR_OK, err2;
+
+    bxilog_filters_p filters = NULL;
+    bxilog_filters_p * filters_p = &filters;
+    err2 = bxizmq_data_rcv((void**) &filters_p, sizeof(filters), data->ctrl_zocket,
+                           0, true, NULL);
+    BXIERR_CHAIN(err, err2);
+
+    bxilog_filters_p old = NULL;
+    if (bxierr_isok(err)) {
+        // Logs already received were emitted under the previous filters
+        err2 = _internal_flush(handler, param, data);
+        BXIERR_CHAIN(err, err2);
+
+        old = param->filters;
+        // The BC reads the filters of each handler to compute loggers level
+        __atomic_store_n(&param->filters, filters, __ATOMIC_RELEASE);
+
+        err2 = (NULL == handler->process_cfg) ? BXIERR_OK : handler->process_cfg(param);
+        BXIERR_CHAIN(err, err2);
+    }
+
+    // The BC waits for our reply in any case: it releases the previous filters
+    // (or the rejected ones) once no logger can use them anymore.
+    if (NULL == old) old = filters;
+    err2 = bxizmq_str_snd(RECONFIG_CTRL_MSG_REP, data->ctrl_zocket, ZMQ_SNDMORE, 0, 0);
+    BXIERR_CHAIN(err, err2);
+    err2 = bxizmq_data_snd(&old, sizeof(old), data->ctrl_zocket, 0, 0, 0);
+    BXIERR_CHAIN(err, err2);
+
+    return err;
+}
+
+bxierr_p _process_stats(bxilog_handler_p handler,
+                        bxilog_handler_param_p param,
+                        handler_data_p data) {
+
+    bxierr_p err = BXIERR_OK, err2;
+
+    bxilog_handler_stats_s stats;
+    err2 = bxilog__handler_get_stats(handler, param, &data->stats, data->talkers, &stats);
+    BXIERR_CHAIN(err, err2);
+
+    // The BC waits for our reply in any case
+    err2 = bxizmq_str_snd(STATS_CTRL_MSG_REP, data->ctrl_zocket, ZMQ_SNDMORE, 0, 0);
+    BXIERR_CHAIN(err, err2);
+    err2 = bxizmq_data_snd(&stats, sizeof(stats), data->ctrl_zocket, 0, 0, 0);
+    BXIERR_CHAIN(err, err2);
+
+    return err;
+}
+
 bxierr_p _process_ierr(bxilog_handler_p handler,
                        bxilog_handler_param_p param,
                        bxierr_p err) {
@@ -14,9 +14,13 @@
 #ifndef BXILOG_HANDLER_IMPL_H
 #define BXILOG_HANDLER_IMPL_H
 
+#include <stdbool.h>
+
 #include "bxi/base/err.h"
 #include "bxi/base/log.h"
 
+#include "talkers_impl.h"
+
 //*********************************************************************************
 //********************************** Defines **************************************
 //*********************************************************************************
@@ -26,6 +30,13 @@
 #define FLUSH_CTRL_MSG_REP "H->BC: flushed!"
 #define EXIT_CTRL_MSG_REQ "BC->H: exit?"
 #define EXIT_CTRL_MSG_REP "H->BC: exited!"
+// Followed by a frame holding the new bxilog_filters_p,
+// replied with a frame holding the previous one
+#define RECONFIG_CTRL_MSG_REQ "BC->H: reconfig?"
+#define RECONFIG_CTRL_MSG_REP "H->BC: reconfigured!"
+// Replied with a frame holding a bxilog_handler_stats_s
+#define STATS_CTRL_MSG_REQ "BC->H: stats?"
+#define STATS_CTRL_MSG_REP "H->BC: stats!"
 
 
 //*********************************************************************************
@@ -49,4 +60,30 @@ typedef bxilog__handler_thread_bundle_s * bxilog__handler_thread_bundle_p;
 // Can be used directly with pthread_create()
 bxierr_p bxilog__handler_start(bxilog__handler_thread_bundle_p bundle);
 
+// Give the given record (followed by its strings) to the handler if its filters
+// accept it
+bxierr_p bxilog__handler_process_record(bxilog_handler_p handler,
+                                        bxilog_handler_param_p param,
+                                        bxilog_record_p record,
+                                        bxilog_handler_stats_p stats,
+                                        bxilog__talkers_p talkers);
+
+// Call the explicit (resp. implicit) flush callback of the handler, and time it
+bxierr_p bxilog__handler_flush(bxilog_handler_p handler,
+                               bxilog_handler_param_p param,
+                               bool explicit,
+                               bxilog_handler_stats_p stats);
+
+// Print the latency histograms of the handler on stderr, if configured
+void bxilog__handler_dump_latency(bxilog_handler_p handler,
+                                  bxilog_handler_param_p param,
+                                  const bxilog_handler_stats_p stats);
+
+// Copy the given stats into result, completed by the top talkers and the handler itself
+bxierr_p bxilog__handler_get_stats(bxilog_handler_p handler,
+                                   bxilog_handler_param_p param,
+                                   const bxilog_handler_stats_p stats,
+                                   const bxilog__talkers_p talkers,
+                                   bxilog_handler_stats_p result);
+
 #endif
@@ -0,0 +1,315 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+#include <pthread.h>
+#include <time.h>
+
+#include "bxi/base/err.h"
+#include "bxi/base/mem.h"
+#include "bxi/base/time.h"
+#include "bxi/base/log.h"
+
+#include "log_impl.h"
+#include "handler_impl.h"
+#include "inline_impl.h"
+#include "talkers_impl.h"
+
+//*********************************************************************************
+//********************************** Defines **************************************
+//*********************************************************************************
+
+//*********************************************************************************
+//********************************** Types ****************************************
+//*********************************************************************************
+
+typedef struct {
+    struct timespec last_flush;     // Time of the last implicit flush
+    bxierr_p err;                   // Error the handler exited with, if any
+    bxilog_handler_stats_s stats;   // Returned by bxilog__inline_stats()
+    bxilog__talkers_p talkers;      // NULL unless talkers are tracked
+} inline_handler_s;
+
+//*********************************************************************************
+//********************************** Static Functions  ****************************
+//*********************************************************************************
+static void _lock(void);
+static void _unlock(void);
+static void _process_ierr(size_t handler_rank, bxierr_p err);
+static long _elapsed_ms(const struct timespec * from, const struct timespec * to);
+
+//*********************************************************************************
+//********************************** Global Variables  ****************************
+//*********************************************************************************
+
+// Handlers are not thread-safe: they process one log at a time
+static pthread_mutex_t INLINE_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+// Logs produced by a handler while it processes a log are dropped
+static __thread bool INLINE_BUSY = false;
+// One per configured handler, NULL when handlers are not started
+static inline_handler_s * HANDLERS = NULL;
+
+//*********************************************************************************
+//********************************** Implementation    ****************************
+//*********************************************************************************
+
+bool bxilog__inline_mode(void) {
+    return NULL != BXILOG__GLOBALS->config &&
+           BXILOG_HANDLERS_INLINE == BXILOG__GLOBALS->config->handlers_mode;
+}
+
+bxierr_p bxilog__inline_start(void) {
+    bxilog_config_p config = BXILOG__GLOBALS->config;
+    bxierr_p err = BXIERR_OK;
+    bxierr_list_p errlist = bxierr_list_new();
+
+    struct timespec now;
+    bxierr_p ierr = bxitime_get(CLOCK_REALTIME, &now);
+    if (bxierr_isko(ierr)) bxierr_list_append(errlist, ierr);
+
+    _lock();
+    bxiassert(NULL == HANDLERS);
+    HANDLERS = bximem_calloc(config->handlers_nb * sizeof(*HANDLERS));
+    for (size_t i = 0; i < config->handlers_nb; i++) {
+        bxilog_handler_p handler = config->handlers[i];
+        if (NULL == handler) {
+            ierr = bxierr_gen("Handler %zu is NULL!", i);
+            bxierr_list_append(errlist, ierr);
+            continue;
+        }
+        bxilog_handler_param_p param = config->handlers_params[i];
+        param->rank = i;
+        param->status = BXI_LOG_HANDLER_NOT_READY;
+        HANDLERS[i].last_flush = now;
+        HANDLERS[i].err = BXIERR_OK;
+        HANDLERS[i].talkers = bxilog__talkers_new();
+
+        bxierr_p herr = BXIERR_OK, herr2;
+        herr2 = (NULL == handler->init) ? BXIERR_OK : handler->init(param);
+        BXIERR_CHAIN(herr, herr2);
+        if (bxierr_isok(herr) && 0 < param->private_items_nb) {
+            // Only the loop of a handler thread polls them
+            herr2 = bxierr_gen("Handler %s polls its own items: it can't run inline",
+                               handler->name);
+            BXIERR_CHAIN(herr, herr2);
+        }
+        if (bxierr_isko(herr)) {
+            param->status = BXI_LOG_HANDLER_ERROR;
+            herr2 = (NULL == handler->process_exit) ? BXIERR_OK :
+                    handler->process_exit(param);
+            BXIERR_CHAIN(herr, herr2);
+            bxierr_list_append(errlist, herr);
+            continue;
+        }
+        param->status = BXI_LOG_HANDLER_READY;
+    }
+    _unlock();
+
+    if (0 < errlist->errors_nb) {
+        err = bxierr_from_list(BXIERR_GROUP_CODE,
+                               errlist,
+                               "Starting bxilog inline handlers yield %zu errors",
+                               errlist->errors_nb);
+    } else {
+        bxierr_list_destroy(&errlist);
+    }
+
+    return err;
+}
+
+bxierr_p bxilog__inline_stop(void) {
+    if (NULL == HANDLERS) return BXIERR_OK;
+    // Called by the signal handler on a thread interrupted while it processes a log:
+    // INLINE_MUTEX is already held and the handler state is unknown
+    if (INLINE_BUSY) return bxierr_gen("Inline handlers can't be stopped"
+                                       " while one of them processes a log");
+
+    bxilog_config_p config = BXILOG__GLOBALS->config;
+    bxierr_p err = BXIERR_OK;
+    bxierr_list_p errlist = bxierr_list_new();
+
+    _lock();
+    for (size_t i = 0; i < config->handlers_nb; i++) {
+        bxilog_handler_p handler = config->handlers[i];
+        if (NULL == handler) continue;
+        bxilog_handler_param_p param = config->handlers_params[i];
+
+        if (BXI_LOG_HANDLER_READY == param->status) {
+            bxierr_p herr = bxilog__handler_flush(handler, param, false,
+                                                  &HANDLERS[i].stats);
+            _process_ierr(i, herr);
+        }
+        bxilog__handler_dump_latency(handler, param, &HANDLERS[i].stats);
+        if (BXI_LOG_HANDLER_READY == param->status) {
+            bxierr_p herr = (NULL == handler->process_exit) ? BXIERR_OK :
+                            handler->process_exit(param);
+            if (bxierr_isko(herr)) bxierr_list_append(errlist, herr);
+            param->status = BXI_LOG_HANDLER_NOT_READY;
+        }
+        if (bxierr_isko(HANDLERS[i].err)) bxierr_list_append(errlist, HANDLERS[i].err);
+        bxilog__talkers_destroy(&HANDLERS[i].talkers);
+    }
+    BXIFREE(HANDLERS);
+    _unlock();
+
+    if (0 < errlist->errors_nb) {
+        err = bxierr_from_list(BXIERR_GROUP_CODE, errlist,
+                               "Some errors occurred in at least"
+                               " one of %zu inline handlers.",
+                               config->handlers_nb);
+    } else {
+        bxierr_list_destroy(&errlist);
+    }
+
+    return err;
+}
+
+bxierr_p bxilog__inline_log(bxilog_record_p record) {
+    bxilog_config_p config = BXILOG__GLOBALS->config;
+    // Called back by a handler processing a log: it would deadlock
+    if (INLINE_BUSY) {
+        for (size_t i = 0; i < config->handlers_nb; i++) {
+            __atomic_add_fetch(&BXILOG__GLOBALS->handlers_dropped[i], 1, __ATOMIC_RELAXED);
+        }
+        return BXIERR_OK;
+    }
+
+    _lock();
+    for (size_t i = 0; NULL != HANDLERS && i < config->handlers_nb; i++) {
+        bxilog_handler_param_p param = config->handlers_params[i];
+        if (BXI_LOG_HANDLER_READY != param->status) continue;
+        bxilog_handler_p handler = config->handlers[i];
+
+        bxierr_p herr = bxilog__handler_process_record(handler, param, record,
+                                                       &HANDLERS[i].stats,
+                                                       HANDLERS[i].talkers);
+        _process_ierr(i, herr);
+        if (BXI_LOG_HANDLER_READY != param->status) continue;
+
+        // No thread wakes up for the implicit flush: the logs themselves do it
+        long elapsed = _elapsed_ms(&HANDLERS[i].last_flush, &record->detail_time);
+        if (0 <= elapsed && elapsed < param->flush_freq_ms) continue;
+
+        HANDLERS[i].last_flush = record->detail_time;
+        herr = bxilog__handler_flush(handler, param, false, &HANDLERS[i].stats);
+        _process_ierr(i, herr);
+    }
+    _unlock();
+
+    return BXIERR_OK;
+}
+
+bxierr_p bxilog__inline_flush(void) {
+    if (INLINE_BUSY) return BXIERR_OK;
+
+    bxilog_config_p config = BXILOG__GLOBALS->config;
+    _lock();
+    for (size_t i = 0; NULL != HANDLERS && i < config->handlers_nb; i++) {
+        bxilog_handler_param_p param = config->handlers_params[i];
+        if (BXI_LOG_HANDLER_READY != param->status) continue;
+        bxilog_handler_p handler = config->handlers[i];
+
+        bxierr_p herr = bxilog__handler_flush(handler, param, true, &HANDLERS[i].stats);
+        _process_ierr(i, herr);
+    }
+    _unlock();
+
+    return BXIERR_OK;
+}
+
+bxierr_p bxilog__inline_reconfig(size_t handler_rank,
+                                 bxilog_filters_p filters,
+                                 bxilog_filters_p * old) {
+    *old = filters;
+    if (INLINE_BUSY) return bxierr_gen("Handler %zu can't be reconfigured"
+                                       " while it processes a log", handler_rank);
+
+    bxierr_p err = BXIERR_OK;
+    _lock();
+    bxilog_handler_p handler = BXILOG__GLOBALS->config->handlers[handler_rank];
+    bxilog_handler_param_p param = BXILOG__GLOBALS->config->handlers_params[handler_rank];
+    if (NULL == HANDLERS || BXI_LOG_HANDLER_READY != param->status) {
+        err = bxierr_gen("Handler %zu is not running", handler_rank);
+    } else {
+        *old = param->filters;
+        // The BC reads the filters of each handler to compute loggers level
+        __atomic_store_n(&param->filters, filters, __ATOMIC_RELEASE);
+
+        bxierr_p herr = (NULL == handler->process_cfg) ? BXIERR_OK :
+                        handler->process_cfg(param);
+        _process_ierr(handler_rank, herr);
+    }
+    _unlock();
+
+    return err;
+}
+
+bxierr_p bxilog__inline_stats(size_t handler_rank, bxilog_handler_stats_p stats) {
+    if (INLINE_BUSY) return bxierr_gen("Handler %zu statistics can't be gathered"
+                                       " while it processes a log", handler_rank);
+
+    bxierr_p err = BXIERR_OK;
+    _lock();
+    bxilog_handler_p handler = BXILOG__GLOBALS->config->handlers[handler_rank];
+    bxilog_handler_param_p param = BXILOG__GLOBALS->config->handlers_params[handler_rank];
+    if (NULL != HANDLERS && NULL != handler) {
+        err = bxilog__handler_get_stats(handler, param, &HANDLERS[handler_rank].stats,
+                                        HANDLERS[handler_rank].talkers, stats);
+    }
+    _unlock();
+
+    return err;
+}
+
+void bxilog__inline_child_after_fork(void) {
+    // The lock might have been held by a thread which does not exist in the child
+    int rc = pthread_mutex_init(&INLINE_MUTEX, NULL);
+    bxiassert(0 == rc);
+    INLINE_BUSY = false;
+}
+
+//*********************************************************************************
+//********************************** Static Helpers Implementation ****************
+//*********************************************************************************
+
+void _lock(void) {
+    int rc = pthread_mutex_lock(&INLINE_MUTEX);
+    bxiassert(0 == rc);
+    INLINE_BUSY = true;
+}
+
+void _unlock(void) {
+    INLINE_BUSY = false;
+    int rc = pthread_mutex_unlock(&INLINE_MUTEX);
+    bxiassert(0 == rc);
+}
+
+// Give the error to the handler: when it does not recover, it exits as its thread
+// would do, and the error is returned by bxilog__inline_stop()
+void _process_ierr(size_t handler_rank, bxierr_p err) {
+    if (bxierr_isok(err)) return;
+
+    bxilog_handler_p handler = BXILOG__GLOBALS->config->handlers[handler_rank];
+    bxilog_handler_param_p param = BXILOG__GLOBALS->config->handlers_params[handler_rank];
+    if (NULL != handler->process_ierr) err = handler->process_ierr(&err, param);
+    if (bxierr_isok(err)) return;
+
+    param->status = BXI_LOG_HANDLER_ERROR;
+    bxierr_p err2 = (NULL == handler->process_exit) ? BXIERR_OK :
+                    handler->process_exit(param);
+    BXIERR_CHAIN(err, err2);
+    HANDLERS[handler_rank].err = err;
+}
+
+long _elapsed_ms(const struct timespec * from, const struct timespec * to) {
+    return (to->tv_sec - from->tv_sec) * 1000 + (to->tv_nsec - from->tv_nsec) / 1000000;
+}
@@ -0,0 +1,69 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+#ifndef BXILOG_INLINE_IMPL_H
+#define BXILOG_INLINE_IMPL_H
+
+#include <stdbool.h>
+
+#include "bxi/base/err.h"
+#include "bxi/base/log.h"
+
+//*********************************************************************************
+//********************************** Defines **************************************
+//*********************************************************************************
+
+//*********************************************************************************
+//********************************** Types ****************************************
+//*********************************************************************************
+
+//*********************************************************************************
+//********************************** Global Variables  ****************************
+//*********************************************************************************
+
+//*********************************************************************************
+//********************************** Interface         ****************************
+//*********************************************************************************
+
+/*
+ * The BXILOG_HANDLERS_INLINE mode: the handlers callbacks are called by the logging
+ * threads themselves, one at a time. Neither handler thread nor zmq is involved.
+ */
+
+/* Return true if the current configuration runs handlers inline */
+bool bxilog__inline_mode(void);
+
+/* Initialize all handlers on the calling thread */
+bxierr_p bxilog__inline_start(void);
+
+/* Flush and exit all handlers, return the errors they met since their start */
+bxierr_p bxilog__inline_stop(void);
+
+/* Give the given record (followed by its strings) to all handlers */
+bxierr_p bxilog__inline_log(bxilog_record_p record);
+
+/* Request an explicit flush of all handlers */
+bxierr_p bxilog__inline_flush(void);
+
+/* Set the filters of the given handler, *old is set to the ones the caller releases */
+bxierr_p bxilog__inline_reconfig(size_t handler_rank,
+                                 bxilog_filters_p filters,
+                                 bxilog_filters_p * old);
+
+/* Fill the given stats with the counters of the given handler */
+bxierr_p bxilog__inline_stats(size_t handler_rank, bxilog_handler_stats_p stats);
+
+/* Reset the lock in a child forked in the BXILOG_FORK_QUIESCE mode */
+void bxilog__inline_child_after_fork(void);
+
+#endif
@@ -36,9 +36,19 @@
  * Parent: _parent_before_fork() --> FINALIZING --> FINALIZED --> FORKED
  *         _parent_after_fork(): FORKED --> _init() --> INITIALIZING --> INITIALIZED
  * Child:  _child_after_fork(): FORKED --> FINALIZED
+ *
+ * With the BXILOG_FORK_QUIESCE fork mode, handlers are not stopped:
+ * Parent: _parent_before_fork() --> FORKED
+ *         _parent_after_fork(): FORKED --> INITIALIZED
+ * Child:  _child_after_fork(): FORKED --> QUIESCED
+ *         first log: QUIESCED --> _resume() --> INITIALIZING --> INITIALIZED
+ *         _init(), _finalize(): QUIESCED --> FINALIZED --> ...
+ * With inline handlers (BXILOG_HANDLERS_INLINE), the child keeps them:
+ * Child:  _child_after_fork(): FORKED --> INITIALIZED
  */
 typedef enum {
     UNSET, INITIALIZING, BROKEN, INITIALIZED, FINALIZING, FINALIZED, ILLEGAL, FORKED,
+    QUIESCED,
 } bxilog_state_e;
 
 
@@ -63,6 +73,13 @@ typedef struct {
 
     size_t internal_handlers_nb;
     pthread_t *handlers_threads;
+    /* Records that could not be sent to each handler */
+    size_t *handlers_dropped;
+    /* Records sent to each handler only after retries */
+    size_t *handlers_retried;
+    /* A handler did not exit in time: its thread still uses the zmq context
+     * and the configuration, none of them can be released */
+    bool handlers_detached;
 } bxilog__core_globals_s;
 
 typedef bxilog__core_globals_s * bxilog__core_globals_p;
@@ -81,4 +98,9 @@ void bxilog__wipeout();
 bxierr_p bxilog__finalize(void);
 bxierr_p bxilog__start_handlers(void);
 bxierr_p bxilog__stop_handlers(void);
+bxierr_p bxilog__resume(void);
+// BXILOG_INITIALIZED_MUTEX is held across a fork(), see _parent_before_fork()
+void bxilog__core_before_fork(void);
+void bxilog__core_parent_after_fork(void);
+void bxilog__core_child_after_fork(void);
 #endif
@@ -47,8 +47,11 @@
 #include "bxi/base/log/logger.h"
 
 #include "log_impl.h"
+#include "config_impl.h"
 #include "tsd_impl.h"
 #include "fork_impl.h"
+#include "inline_impl.h"
+#include "stats_impl.h"
 
 //*********************************************************************************
 //********************************** Defines **************************************
@@ -68,6 +71,7 @@
 //*********************************************************************************
 static bxierr_p _send2handlers(const bxilog_logger_p logger, const bxilog_level_e level,
                                void * log_channel,
+                               bxilog_stage_stats_s * stages,
 #ifdef __linux__
                                pid_t tid,
 #endif
@@ -76,6 +80,14 @@ static bxierr_p _send2handlers(const bxilog_logger_p logger, const bxilog_level_
                                const char * funcname, size_t funcname_len,
                                int line,
                                const char * rawstr, size_t rawstr_len);
+static bxierr_p _vlog(const bxilog_logger_p logger, const bxilog_level_e level,
+                      const char * fullfilename, size_t fullfilename_len,
+                      const char * funcname, size_t funcname_len,
+                      int line,
+                      const char * fmt, va_list arglist);
+static void _count_log(tsd_p tsd, size_t logmsg_len);
+static bool _producer_enter(bxierr_p * err_p);
+static void _producer_leave(bool gated);
 //*********************************************************************************
 //********************************** Global Variables  ****************************
 //*********************************************************************************
@@ -90,6 +102,10 @@ SET_LOGGER(LOGGER, BXILOG_LIB_PREFIX "bxilog.logger");
 
 bxilog_level_e bxilog_logger_get_level(const bxilog_logger_p logger) {
     bxiassert(NULL != logger);
+    if (__atomic_load_n(&logger->epoch, __ATOMIC_RELAXED)
+        != __atomic_load_n(&bxilog__config_epoch, __ATOMIC_ACQUIRE)) {
+        bxilog_logger_reconfigure(logger);
+    }
     return logger->level;
 }
 
@@ -97,41 +113,21 @@ void bxilog_logger_set_level(const bxilog_logger_p logger, const bxilog_level_e
     bxiassert(NULL != logger);
     bxiassert(BXILOG_LOWEST >= level);
     logger->level = level;
+    // Until the next configuration change
+    __atomic_store_n(&logger->epoch,
+                     __atomic_load_n(&bxilog__config_epoch, __ATOMIC_ACQUIRE),
+                     __ATOMIC_RELEASE);
 }
 
 void bxilog_logger_reconfigure(const bxilog_logger_p logger) {
-    if (NULL == BXILOG__GLOBALS || NULL == BXILOG__GLOBALS->config) return;
-    bxilog_level_e minimum_level = BXILOG_OFF; // The minimum level required for the current logger
-                                               // across all handlers
-    for (size_t i = 0; i < BXILOG__GLOBALS->config->handlers_nb; i++) {
-        const bxilog_filters_p filters = BXILOG__GLOBALS->config->handlers_params[i]->filters;
-        size_t best_match_len = 0; // The length of the most precise matching filter
-                                   // inside each handler
-        bxilog_level_e best_match_level = BXILOG_LOWEST; // The best match level inside
-                                                         // each handler
-        // First, look after the most precise filter in the current handler
-        for (size_t f = 0; f < filters->nb; f++) {
-            const bxilog_filter_p filter = filters->list[f];
-            const size_t filter_pre_len = strlen(filter->prefix);
-            if (logger->name_length < filter_pre_len) continue;
-            if (0 != strncmp(filter->prefix, logger->name, filter_pre_len)) continue;
-            // This filter prefix matches the logger name
-            // Let see if it is the maximum match
-            if (best_match_len > filter_pre_len) continue;
-            // We found a new good match, make it the last best known
-            best_match_len = filter_pre_len;
-            best_match_level = filter->level;
-        }
-        // At that stage, we know the most precise filter's level
-        // However, other handlers might have other requirements
-        // If another handler specifies a more detailed level, it must be set in
-        // the logger, otherwise, it won't be seen by expected handlers.
-        // Therefore, the minimum level is the one with the greatest details across
-        // handlers
-        if (best_match_level < minimum_level) continue;
-        minimum_level = best_match_level;
+    // Read first: a concurrent change makes the next use compute the level again
+    const unsigned epoch = __atomic_load_n(&bxilog__config_epoch, __ATOMIC_ACQUIRE);
+    bxilog_level_e level;
+    if (bxilog__config_level(logger->name, logger->name_length, &level)) {
+        // Do not dirty the cache line read by logging threads when nothing changed
+        if (level != logger->level) logger->level = level;
     }
-    logger->level = minimum_level;
+    __atomic_store_n(&logger->epoch, epoch, __ATOMIC_RELEASE);
 }
 
 
@@ -159,19 +155,28 @@ bxierr_p bxilog_logger_log_rawstr(const bxilog_logger_p logger, const bxilog_lev
                                   const char * const funcname, const size_t funcname_len,
                                   const int line,
                                   const char * const rawstr, const size_t rawstr_len) {
-    if (INITIALIZED != BXILOG__GLOBALS->state) return BXIERR_OK;
-    tsd_p tsd;
-    bxierr_p err = bxilog__tsd_get(&tsd);
-    if (bxierr_isko(err)) return err;
-    err = _send2handlers(logger, level, tsd->data_channel,
+    bxierr_p err = BXIERR_OK;
+    const bool gated = _producer_enter(&err);
+
+    if (bxierr_isok(err) && INITIALIZED == BXILOG__GLOBALS->state) {
+        tsd_p tsd;
+        err = bxilog__tsd_get(&tsd);
+        if (bxierr_isok(err)) {
+            _count_log(tsd, rawstr_len);
+            err = _send2handlers(logger, level, tsd->data_channel, tsd->stages,
 #ifdef __linux__
-                    tsd->tid,
+                                 tsd->tid,
 #endif
-                    tsd->thread_rank,
-                    filename, filename_len,
-                    funcname, funcname_len,
-                    line,
-                    rawstr, rawstr_len);
+                                 tsd->thread_rank,
+                                 filename, filename_len,
+                                 funcname, funcname_len,
+                                 line,
+                                 rawstr, rawstr_len);
+        }
+    }
+
+    _producer_leave(gated);
+
     return err;
 }
 
@@ -184,56 +189,92 @@ bxierr_p bxilog_logger_vlog_nolevelcheck(const bxilog_logger_p logger,
                                          const int line,
                                          const char * const fmt, va_list arglist) {
 
-    if (INITIALIZED != BXILOG__GLOBALS->state) return BXIERR_OK;
+    bxierr_p err = BXIERR_OK;
+    const bool gated = _producer_enter(&err);
+
+    if (bxierr_isok(err) && INITIALIZED == BXILOG__GLOBALS->state) {
+        err = _vlog(logger, level,
+                    fullfilename, fullfilename_len,
+                    funcname, funcname_len,
+                    line,
+                    fmt, arglist);
+    }
+
+    _producer_leave(gated);
+
+    return err;
+}
+
+bxierr_p bxilog_logger_log_nolevelcheck(const bxilog_logger_p logger,
+                                        const bxilog_level_e level,
+                                        char * filename, size_t filename_len,
+                                        const char * funcname, size_t funcname_len,
+                                        const int line,
+                                        const char * fmt, ...) {
+    va_list ap;
+    bxierr_p err;
+
+    va_start(ap, fmt);
+    err = bxilog_logger_vlog_nolevelcheck(logger, level,
+                                          filename, filename_len,
+                                          funcname, funcname_len,
+                                          line,
+                                          fmt, ap);
+    va_end(ap);
+
+    return err;
+}
+
+//*********************************************************************************
+//********************************** Static Helpers Implementation ****************
+//*********************************************************************************
+
+bxierr_p _vlog(const bxilog_logger_p logger,
+               const bxilog_level_e level,
+               const char * const fullfilename,
+               const size_t fullfilename_len,
+               const char * const funcname,
+               const size_t funcname_len,
+               const int line,
+               const char * const fmt, va_list arglist) {
 
     tsd_p tsd;
     bxierr_p err = bxilog__tsd_get(&tsd);
     if (bxierr_isko(err)) return err;
 
-    // Start creating the logmsg so the length can be computed
-    // We start in the thread local buffer
-
+    // Format straight into the thread local buffer: the exact length is
+    // returned, so a too small buffer is replaced at once by one of the right size
     char * logmsg = tsd->log_buf;
     size_t logmsg_len = BXILOG__GLOBALS->config->tsd_log_buf_size;
     bool logmsg_allocated = false; // When true,  means that a new special buffer has been
                                    // allocated -> it will have to be freed
-    while (true) {
-        va_list arglist_copy;
-        va_copy(arglist_copy, arglist);
-        // Does not include the null terminated byte
-        int n = vsnprintf(logmsg, logmsg_len, fmt, arglist_copy);
-        va_end(arglist_copy);
-
-        // Check error
-        bxiassert(n >= 0);
-
-        // Ok
-        if ((size_t) n < logmsg_len) {
-            logmsg_len = (size_t) n + 1; // Record the actual size of the message
-            break;
-        }
-
-        if (logmsg_allocated) BXIFREE(logmsg);
+    BXILOG__STAGE_START(format_start);
+    va_list arglist_copy;
+    va_copy(arglist_copy, arglist);
+    // Does not include the null terminated byte
+    size_t n = bxistr_vformat(logmsg, logmsg_len, fmt, arglist_copy);
+    va_end(arglist_copy);
+
+    if (n >= logmsg_len) {
         // Not enough space, mallocate a new special buffer of the precise size
-        logmsg_len = (size_t) (n + 1);
-        logmsg = malloc(logmsg_len); // Include the null terminated byte
+        logmsg = malloc(n + 1); // Include the null terminated byte
         bxiassert(NULL != logmsg);
         logmsg_allocated = true;
+        bxistr_vformat(logmsg, n + 1, fmt, arglist);
 
-        tsd->rsz_log_nb++;
+        __atomic_store_n(&tsd->rsz_log_nb, tsd->rsz_log_nb + 1, __ATOMIC_RELAXED);
     }
+    BXILOG__STAGE_END(tsd->stages, BXILOG_STAGE_FORMAT, format_start);
+    logmsg_len = n + 1; // Record the actual size of the message
 
-    tsd->max_log_size = tsd->max_log_size > logmsg_len ? tsd->max_log_size : logmsg_len;
-    tsd->min_log_size = tsd->min_log_size < logmsg_len ? tsd->min_log_size : logmsg_len;
-    tsd->sum_log_size += logmsg_len;
-    tsd->log_nb++;
+    _count_log(tsd, logmsg_len);
 
     bxiassert(bxierr_isok(err));
 
     const char * filename;
     size_t filename_len = bxistr_rsub(fullfilename, fullfilename_len, '/', &filename);
 
-    err = _send2handlers(logger, level, tsd->data_channel,
+    err = _send2handlers(logger, level, tsd->data_channel, tsd->stages,
 #ifdef __linux__
                          tsd->tid,
 #endif
@@ -252,33 +293,10 @@ bxierr_p bxilog_logger_vlog_nolevelcheck(const bxilog_logger_p logger,
     return err;
 }
 
-bxierr_p bxilog_logger_log_nolevelcheck(const bxilog_logger_p logger,
-                                        const bxilog_level_e level,
-                                        char * filename, size_t filename_len,
-                                        const char * funcname, size_t funcname_len,
-                                        const int line,
-                                        const char * fmt, ...) {
-    va_list ap;
-    bxierr_p err;
-
-    va_start(ap, fmt);
-    err = bxilog_logger_vlog_nolevelcheck(logger, level,
-                                          filename, filename_len,
-                                          funcname, funcname_len,
-                                          line,
-                                          fmt, ap);
-    va_end(ap);
-
-    return err;
-}
-
-//*********************************************************************************
-//********************************** Static Helpers Implementation ****************
-//*********************************************************************************
-
 bxierr_p _send2handlers(const bxilog_logger_p logger,
                         const bxilog_level_e level,
                         void * const log_channel,
+                        bxilog_stage_stats_s * const stages,
 #ifdef __linux__
                         const pid_t tid,
 #endif
@@ -292,6 +310,7 @@ bxierr_p _send2handlers(const bxilog_logger_p logger,
     bxilog_record_p record;
     char * data;
 
+    BXILOG__STAGE_START(record_start);
     size_t var_len = filename_len + funcname_len + logger->name_length;
     size_t data_len = sizeof(*record) + var_len + rawstr_len;
 
@@ -335,25 +354,43 @@ bxierr_p _send2handlers(const bxilog_logger_p logger,
     memcpy(data, logger->name, logger->name_length);
     data += logger->name_length;
     memcpy(data, rawstr, rawstr_len);
+    BXILOG__STAGE_END(stages, BXILOG_STAGE_RECORD, record_start);
+
+    if (bxilog__inline_mode()) {
+        UNUSED(log_channel);
+        err2 = bxilog__inline_log(record);
+        BXIERR_CHAIN(err, err2);
+        BXIFREE(record);
+        return err;
+    }
 
+    BXILOG__STAGE_START(send_start);
     for (size_t i = 0; i< BXILOG__GLOBALS->internal_handlers_nb; i++) {
         // Send the frame
         // normal version if record comes from the stack 'buf'
+        // BXIZMQ_RETRIES_MAX_ERR means the frame was sent, after retries
         err2 = bxizmq_data_snd(&i, sizeof(i),
                                log_channel, ZMQ_DONTWAIT | ZMQ_SNDMORE,
                                RETRIES_MAX, RETRY_DELAY);
-        if (err2->code == BXIZMQ_RETRIES_MAX_ERR) {
+        if (BXIZMQ_RETRIES_MAX_ERR == err2->code) {
             bxierr_destroy(&err2);
-        } else {
+            err2 = BXIERR_OK;
+        }
+        if (bxierr_isko(err2)) {
+            __atomic_add_fetch(&BXILOG__GLOBALS->handlers_dropped[i], 1, __ATOMIC_RELAXED);
             BXIERR_CHAIN(err, err2);
+            continue;
         }
 
         err2 = bxizmq_data_snd(record, data_len,
                                log_channel, ZMQ_DONTWAIT,
                                RETRIES_MAX, RETRY_DELAY);
-        if (err2->code == BXIZMQ_RETRIES_MAX_ERR) {
+        if (BXIZMQ_RETRIES_MAX_ERR == err2->code) {
+            __atomic_add_fetch(&BXILOG__GLOBALS->handlers_retried[i], 1, __ATOMIC_RELAXED);
             bxierr_destroy(&err2);
-        } else {
+            err2 = BXIERR_OK;
+        } else if (bxierr_isko(err2)) {
+            __atomic_add_fetch(&BXILOG__GLOBALS->handlers_dropped[i], 1, __ATOMIC_RELAXED);
             BXIERR_CHAIN(err, err2);
         }
 
@@ -362,13 +399,38 @@ bxierr_p _send2handlers(const bxilog_logger_p logger,
 //                                 log_channel[i], ZMQ_DONTWAIT,
 //                                 RETRIES_MAX, RETRY_DELAY,
 //                                 bxizmq_data_free, NULL);
-
-        if (err2->code == BXIZMQ_RETRIES_MAX_ERR) {
-            bxierr_destroy(&err2);
-        } else {
-            BXIERR_CHAIN(err, err2);
-        }
     }
+    BXILOG__STAGE_END(stages, BXILOG_STAGE_SEND, send_start);
     BXIFREE(record);
     return err;
 }
+
+// Return true if the calling producer must leave the fork gate when done
+bool _producer_enter(bxierr_p * const err_p) {
+    const bxilog_state_e state = BXILOG__GLOBALS->state;
+    // A fork() in the BXILOG_FORK_QUIESCE mode waits for the logs in progress
+    const bool gated = (INITIALIZED == state || FORKED == state) &&
+                       BXILOG_FORK_QUIESCE == BXILOG__GLOBALS->config->fork_mode;
+    if (gated) bxilog__fork_producer_enter();
+
+    // A child forked in the BXILOG_FORK_QUIESCE mode starts its handlers on its first log
+    if (QUIESCED == BXILOG__GLOBALS->state) *err_p = bxilog__resume();
+
+    return gated;
+}
+
+void _producer_leave(const bool gated) {
+    if (gated) bxilog__fork_producer_leave();
+}
+
+// Only the owner thread writes the counters, bxilog_stats_get() reads them
+void _count_log(tsd_p tsd, size_t logmsg_len) {
+    if (logmsg_len > tsd->max_log_size) {
+        __atomic_store_n(&tsd->max_log_size, logmsg_len, __ATOMIC_RELAXED);
+    }
+    if (logmsg_len < tsd->min_log_size) {
+        __atomic_store_n(&tsd->min_log_size, logmsg_len, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&tsd->sum_log_size, tsd->sum_log_size + logmsg_len, __ATOMIC_RELAXED);
+    __atomic_store_n(&tsd->log_nb, tsd->log_nb + 1, __ATOMIC_RELAXED);
+}
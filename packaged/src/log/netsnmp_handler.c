@@ -283,7 +283,6 @@ bxierr_p _process_ierr(bxierr_p *err, bxilog_snmplog_handler_param_p data) {
 
 bxierr_p _process_cfg(bxilog_snmplog_handler_param_p data) {
     UNUSED(data);
-    bxiunreachable_statement;
     return BXIERR_OK;
 }
 
@@ -15,6 +15,7 @@
 #include <errno.h>
 #include <string.h>
 #include <pthread.h>
+#include <sched.h>
 
 #include "bxi/base/err.h"
 #include "bxi/base/mem.h"
@@ -32,11 +33,30 @@
 //*********************************************************************************
 #define REGISTERED_LOGGERS_DEFAULT_ARRAY_SIZE 64
 
+// Initial number of slots of the hash index (a power of 2)
+#define INDEX_DEFAULT_SIZE 128
+
+// Slot of a logger removed from the index: lookups must probe past it
+#define INDEX_TOMBSTONE ((bxilog_logger_p) -1)
+
 //*********************************************************************************
 //********************************** Types ****************************************
 //*********************************************************************************
 
+/*
+ * Open addressing hash index of the registered loggers.
+ *
+ * Lookups do not take REGISTER_LOCK: an index is never modified but by filling an
+ * empty slot or replacing a logger by a tombstone, and it is replaced (when full)
+ * by publishing a new one. Memory is reclaimed only after a grace period.
+ */
+typedef struct {
+    size_t size;                    // Number of slots, a power of 2
+    size_t used;                    // Number of non empty slots (tombstones included)
+    bxilog_logger_p slots[];        // NULL, INDEX_TOMBSTONE or a logger
+} index_s;
 
+typedef index_s * index_p;
 
 //*********************************************************************************
 //********************************** Static Functions  ****************************
@@ -45,6 +65,12 @@
 static void _sort(void);
 static int _logger_compar(const void * l1, const void * l2);
 static void _reset_config();
+static void _add(bxilog_logger_p logger);
+static bxilog_logger_p _lookup(const char * name, size_t name_length);
+static uint64_t _hash(const char * name, size_t name_length);
+static void _index_insert(index_p index, bxilog_logger_p logger);
+static void _index_grow(void);
+static void _synchronize(void);
 
 //*********************************************************************************
 //********************************** Global Variables  ****************************
@@ -55,13 +81,28 @@ static void _reset_config();
  */
 static size_t REGISTERED_LOGGERS_ARRAY_SIZE = REGISTERED_LOGGERS_DEFAULT_ARRAY_SIZE;
 /**
- * The array of registered loggers.
+ * The array of registered loggers, the first REGISTERED_LOGGERS_NB being used.
  */
 static bxilog_logger_p * REGISTERED_LOGGERS = NULL;
 /**
  * Number of registered loggers.
  */
 static size_t REGISTERED_LOGGERS_NB = 0;
+/**
+ * True when REGISTERED_LOGGERS must be sorted before being returned
+ */
+static bool REGISTERED_LOGGERS_UNSORTED = false;
+
+/**
+ * The hash index, read without lock.
+ */
+static index_p INDEX = NULL;
+
+/**
+ * Lookups in progress, by epoch (see _synchronize()).
+ */
+static size_t READERS[2] = {0, 0};
+static unsigned READERS_EPOCH = 0;
 
 static pthread_mutex_t REGISTER_LOCK = PTHREAD_MUTEX_INITIALIZER;
 
@@ -75,48 +116,8 @@ void bxilog_registry_add(bxilog_logger_p logger) {
     int rc = pthread_mutex_lock(&REGISTER_LOCK);
     bxiassert(0 == rc);
 
-    if (REGISTERED_LOGGERS == NULL) {
-        size_t bytes = REGISTERED_LOGGERS_ARRAY_SIZE * sizeof(*REGISTERED_LOGGERS);
-        REGISTERED_LOGGERS = bximem_calloc(bytes);
-        int rc = atexit(bxilog__wipeout);
-        bxiassert(0 == rc);
-
-    } else if (REGISTERED_LOGGERS_NB >= REGISTERED_LOGGERS_ARRAY_SIZE) {
-        size_t old_size = REGISTERED_LOGGERS_ARRAY_SIZE;
-        REGISTERED_LOGGERS_ARRAY_SIZE *= 2;
-        size_t bytes = REGISTERED_LOGGERS_ARRAY_SIZE * sizeof(*REGISTERED_LOGGERS);
-        REGISTERED_LOGGERS = bximem_realloc(REGISTERED_LOGGERS,
-                                            old_size * sizeof(*REGISTERED_LOGGERS),
-                                            bytes);
-
-        DBG("[I] Reallocation of %zu slots for (currently) "
-            "%zu registered loggers\n",
-            REGISTERED_LOGGERS_ARRAY_SIZE,
-            REGISTERED_LOGGERS_NB);
-    }
+    _add(logger);
 
-    size_t slot = REGISTERED_LOGGERS_NB;
-    for (size_t i = 0; i < REGISTERED_LOGGERS_ARRAY_SIZE; i++) {
-        // Find next free slot
-        if (NULL == REGISTERED_LOGGERS[i]) {
-            if (slot == REGISTERED_LOGGERS_NB) slot = i;
-
-        } else if (0 == strncmp(REGISTERED_LOGGERS[i]->name,
-                                logger->name,
-                                logger->name_length)) {
-            // TODO: provide something better here!
-            fprintf(stderr,
-                    "[W] Logger name '%s' already registered at position %zu, "
-                    "this can lead to various problems such as wrong logging level "
-                    "configuration or misleading messages!\n",
-                    logger->name, i);
-        }
-    }
-    DBG("Registering new logger[%zu]: %s\n", slot, logger->name);
-    REGISTERED_LOGGERS[slot] = logger;
-    REGISTERED_LOGGERS_NB++;
-    _sort();
-    bxilog_logger_reconfigure(logger);
     rc = pthread_mutex_unlock(&REGISTER_LOCK);
     bxiassert(0 == rc);
 }
@@ -127,33 +128,38 @@ void bxilog_registry_del(bxilog_logger_p logger) {
     bxiassert(0 == rc);
     bool found = false;
     DBG("Nb Registered loggers: %zu\n", REGISTERED_LOGGERS_NB);
-    for (size_t i = 0; i < REGISTERED_LOGGERS_ARRAY_SIZE; i++) {
-        bxilog_logger_p current = REGISTERED_LOGGERS[i];
-        if (NULL == current) continue;
-        DBG("Logger[%zu]: %s\n", i, current->name);
-        if (current == logger) {
-         DBG("Unregistering loggers[%zu]: %s\n", i, current->name);
-            REGISTERED_LOGGERS[i] = NULL;
-            found = true;
+    for (size_t i = 0; i < REGISTERED_LOGGERS_NB; i++) {
+        if (REGISTERED_LOGGERS[i] != logger) continue;
+        DBG("Unregistering loggers[%zu]: %s\n", i, logger->name);
+        // Keep the order, the array remains sorted if it was
+        memmove(REGISTERED_LOGGERS + i, REGISTERED_LOGGERS + i + 1,
+                (REGISTERED_LOGGERS_NB - i - 1) * sizeof(*REGISTERED_LOGGERS));
+        REGISTERED_LOGGERS_NB--;
+        found = true;
+        break;
+    }
+
+    if (found) {
+        const size_t mask = INDEX->size - 1;
+        size_t i = (size_t) _hash(logger->name, logger->name_length) & mask;
+        while (NULL != INDEX->slots[i]) {
+            if (INDEX->slots[i] == logger) {
+                __atomic_store_n(&INDEX->slots[i], INDEX_TOMBSTONE, __ATOMIC_RELEASE);
+                break;
+            }
+            i = (i + 1) & mask;
         }
+        // The caller may release the logger as soon as we return
+        _synchronize();
     }
-    if (!found) {
-//        bxierr_p bxierr = bxierr_gen("[W] Can't find registered logger: %s\n",
-//                                     logger->name);
-//        char * str = NULL;
-//        if (err->str != NULL) {
-//            err_str = err->str(err);
-//        } else {
-//            err_str = bxierr_str(err);
-//        }
-//        _display_err_msg(str);
-//        BXIFREE(str);
-    } else REGISTERED_LOGGERS_NB--;
 
     if (0 == REGISTERED_LOGGERS_NB) {
         BXIFREE(REGISTERED_LOGGERS);
-    } else {
-        _sort();
+        REGISTERED_LOGGERS_ARRAY_SIZE = REGISTERED_LOGGERS_DEFAULT_ARRAY_SIZE;
+        index_p index = INDEX;
+        __atomic_store_n(&INDEX, NULL, __ATOMIC_RELEASE);
+        _synchronize();
+        BXIFREE(index);
     }
     rc = pthread_mutex_unlock(&REGISTER_LOCK);
     bxiassert(0 == rc);
@@ -161,32 +167,33 @@ void bxilog_registry_del(bxilog_logger_p logger) {
 
 
 bxierr_p bxilog_registry_get(const char * logger_name, bxilog_logger_p * result) {
-    *result = NULL;
-
-    int rc = pthread_mutex_lock(&REGISTER_LOCK);
-    if (0 != rc) return bxierr_errno("Call to pthread_mutex_lock() failed (rc=%d)", rc);
+    const size_t name_length = strlen(logger_name) + 1;
 
-    for (size_t i = 0; i < REGISTERED_LOGGERS_ARRAY_SIZE; i++) {
-        bxilog_logger_p logger = REGISTERED_LOGGERS[i];
-        if (NULL == logger) continue;
-        if (strncmp(logger->name, logger_name, logger->name_length) == 0) {
-            *result = logger;
-            break;
-        }
+    *result = _lookup(logger_name, name_length);
+    if (NULL != *result) {
+        // Callers usually check the level right after
+        (void) bxilog_logger_get_level(*result);
+        return BXIERR_OK;
     }
 
-    rc = pthread_mutex_unlock(&REGISTER_LOCK);
-    if (0 != rc) return bxierr_errno("Call to pthread_mutex_unlock() failed (rc=%d)", rc);
+    int rc = pthread_mutex_lock(&REGISTER_LOCK);
+    if (0 != rc) return bxierr_errno("Call to pthread_mutex_lock() failed (rc=%d)", rc);
 
+    // Another thread may have created it in the meantime
+    *result = _lookup(logger_name, name_length);
     if (NULL == *result) { // Not found
         bxilog_logger_p self = bximem_calloc(sizeof(*self));
         self->allocated = true;
         self->name = strdup(logger_name);
-        self->name_length = strlen(logger_name) + 1;
+        self->name_length = name_length;
         self->level = BXILOG_LOWEST;
-        bxilog_registry_add(self);
+        _add(self);
         *result = self;
     }
+
+    rc = pthread_mutex_unlock(&REGISTER_LOCK);
+    if (0 != rc) return bxierr_errno("Call to pthread_mutex_unlock() failed (rc=%d)", rc);
+
     DBG("Returning %s %d\n", (*result)->name, (*result)->level);
     return BXIERR_OK;
 }
@@ -196,12 +203,13 @@ size_t bxilog_registry_getall(bxilog_logger_p *loggers[]) {
     bxiassert(NULL != loggers);
     int rc = pthread_mutex_lock(&REGISTER_LOCK);
     bxiassert(0 == rc);
+    // Sorting is deferred until someone needs the sorted view
+    if (REGISTERED_LOGGERS_UNSORTED) _sort();
     bxilog_logger_p * result = bximem_calloc(REGISTERED_LOGGERS_NB * sizeof(*result));
-    size_t j = 0;
-    for (size_t i = 0; i < REGISTERED_LOGGERS_ARRAY_SIZE; i++) {
-        if (NULL == REGISTERED_LOGGERS[i]) continue;
-        result[j++] = REGISTERED_LOGGERS[i];
+    if (0 != REGISTERED_LOGGERS_NB) {
+        memcpy(result, REGISTERED_LOGGERS, REGISTERED_LOGGERS_NB * sizeof(*result));
     }
+    size_t j = REGISTERED_LOGGERS_NB;
     rc = pthread_mutex_unlock(&REGISTER_LOCK);
     bxiassert(0 == rc);
     *loggers = result;
@@ -218,22 +226,41 @@ void bxilog_registry_reset() {
 }
 
 
+void bxilog__registry_before_fork(void) {
+    int rc = pthread_mutex_lock(&REGISTER_LOCK);
+    bxiassert(0 == rc);
+}
+
+void bxilog__registry_parent_after_fork(void) {
+    int rc = pthread_mutex_unlock(&REGISTER_LOCK);
+    bxiassert(0 == rc);
+}
+
+void bxilog__registry_child_after_fork(void) {
+    int rc = pthread_mutex_init(&REGISTER_LOCK, NULL);
+    bxiassert(0 == rc);
+    // Lookups do not take REGISTER_LOCK: those in progress in other threads at
+    // fork() time are counted but will never end in the child
+    READERS[0] = 0;
+    READERS[1] = 0;
+    READERS_EPOCH = 0;
+}
+
+
 void bxilog__cfg_release_loggers() {
     if (NULL != REGISTERED_LOGGERS) {
         DBG("Nb Registered loggers: %zu\n", REGISTERED_LOGGERS_NB);
-        for (size_t i = 0; i < REGISTERED_LOGGERS_ARRAY_SIZE; i++) {
-            if (NULL == REGISTERED_LOGGERS[i]) {
-                continue;
-            }
+        // No lookup can be in progress anymore
+        BXIFREE(INDEX);
+        for (size_t i = 0; i < REGISTERED_LOGGERS_NB; i++) {
             DBG("loggers[%zu]: %s\n", i, REGISTERED_LOGGERS[i]->name);
             if (REGISTERED_LOGGERS[i]->allocated) {
                 DBG("[I] Destroying %s\n", REGISTERED_LOGGERS[i]->name);
                 bxilog_logger_destroy(&REGISTERED_LOGGERS[i]);
             }
             REGISTERED_LOGGERS[i] = NULL;
-            REGISTERED_LOGGERS_NB--;
         }
-        bxiassert(0 == REGISTERED_LOGGERS_NB);
+        REGISTERED_LOGGERS_NB = 0;
         DBG("[I] Removing registered loggers\n");
         BXIFREE(REGISTERED_LOGGERS);
         REGISTERED_LOGGERS_ARRAY_SIZE = 0;
@@ -243,9 +270,138 @@ void bxilog__cfg_release_loggers() {
 //*********************************************************************************
 //********************************** Static Helpers Implementation ****************
 //*********************************************************************************
+void _add(bxilog_logger_p logger) {
+    if (REGISTERED_LOGGERS == NULL) {
+        if (0 == REGISTERED_LOGGERS_ARRAY_SIZE) {
+            REGISTERED_LOGGERS_ARRAY_SIZE = REGISTERED_LOGGERS_DEFAULT_ARRAY_SIZE;
+        }
+        size_t bytes = REGISTERED_LOGGERS_ARRAY_SIZE * sizeof(*REGISTERED_LOGGERS);
+        REGISTERED_LOGGERS = bximem_calloc(bytes);
+        static bool atexit_registered = false;
+        if (!atexit_registered) {
+            int rc = atexit(bxilog__wipeout);
+            bxiassert(0 == rc);
+            atexit_registered = true;
+        }
+
+    } else if (REGISTERED_LOGGERS_NB >= REGISTERED_LOGGERS_ARRAY_SIZE) {
+        size_t old_size = REGISTERED_LOGGERS_ARRAY_SIZE;
+        REGISTERED_LOGGERS_ARRAY_SIZE *= 2;
+        size_t bytes = REGISTERED_LOGGERS_ARRAY_SIZE * sizeof(*REGISTERED_LOGGERS);
+        REGISTERED_LOGGERS = bximem_realloc(REGISTERED_LOGGERS,
+                                            old_size * sizeof(*REGISTERED_LOGGERS),
+                                            bytes);
+
+        DBG("[I] Reallocation of %zu slots for (currently) "
+            "%zu registered loggers\n",
+            REGISTERED_LOGGERS_ARRAY_SIZE,
+            REGISTERED_LOGGERS_NB);
+    }
+
+    bxilog_logger_p other = _lookup(logger->name, logger->name_length);
+    if (NULL != other) {
+        // TODO: provide something better here!
+        fprintf(stderr,
+                "[W] Logger name '%s' already registered, "
+                "this can lead to various problems such as wrong logging level "
+                "configuration or misleading messages!\n",
+                logger->name);
+    }
+
+    if (NULL == INDEX || 2 * (INDEX->used + 1) > INDEX->size) _index_grow();
+
+    DBG("Registering new logger[%zu]: %s\n", REGISTERED_LOGGERS_NB, logger->name);
+    REGISTERED_LOGGERS[REGISTERED_LOGGERS_NB++] = logger;
+    REGISTERED_LOGGERS_UNSORTED = true;
+    bxilog_logger_reconfigure(logger);
+    // Published once configured
+    _index_insert(INDEX, logger);
+}
+
+bxilog_logger_p _lookup(const char * name, size_t name_length) {
+    const unsigned epoch = __atomic_load_n(&READERS_EPOCH, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&READERS[epoch], 1, __ATOMIC_SEQ_CST);
+
+    bxilog_logger_p result = NULL;
+    // Not before the count above, see _synchronize()
+    index_p index = __atomic_load_n(&INDEX, __ATOMIC_SEQ_CST);
+    if (NULL != index) {
+        const size_t mask = index->size - 1;
+        size_t i = (size_t) _hash(name, name_length) & mask;
+        while (true) {
+            bxilog_logger_p logger = __atomic_load_n(&index->slots[i], __ATOMIC_ACQUIRE);
+            if (NULL == logger) break;
+            if (INDEX_TOMBSTONE != logger
+                && logger->name_length == name_length
+                && 0 == memcmp(logger->name, name, name_length)) {
+                result = logger;
+                break;
+            }
+            i = (i + 1) & mask;
+        }
+    }
+
+    __atomic_sub_fetch(&READERS[epoch], 1, __ATOMIC_RELEASE);
+    return result;
+}
+
+uint64_t _hash(const char * name, size_t name_length) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < name_length; i++) {
+        hash = (hash ^ (uint8_t) name[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+void _index_insert(index_p index, bxilog_logger_p logger) {
+    const size_t mask = index->size - 1;
+    size_t i = (size_t) _hash(logger->name, logger->name_length) & mask;
+    while (NULL != index->slots[i]) i = (i + 1) & mask;
+    index->used++;
+    __atomic_store_n(&index->slots[i], logger, __ATOMIC_RELEASE);
+}
+
+void _index_grow(void) {
+    // Tombstones are dropped: the new index may not need to be larger
+    size_t size = INDEX_DEFAULT_SIZE;
+    while (2 * (REGISTERED_LOGGERS_NB + 1) > size) size *= 2;
+
+    index_p index = bximem_calloc(sizeof(*index) + size * sizeof(*index->slots));
+    index->size = size;
+    for (size_t i = 0; i < REGISTERED_LOGGERS_NB; i++) {
+        _index_insert(index, REGISTERED_LOGGERS[i]);
+    }
+
+    index_p old = INDEX;
+    __atomic_store_n(&INDEX, index, __ATOMIC_RELEASE);
+    if (NULL != old) {
+        _synchronize();
+        BXIFREE(old);
+    }
+}
+
+void _synchronize(void) {
+    // Wait for the end of lookups that may have seen the old state. New lookups
+    // are counted on the other epoch so a continuous flow of lookups cannot
+    // delay us forever.
+    // A lookup may load the epoch, then be delayed until after a flip: it is then
+    // counted on the epoch not waited for. Both epochs are therefore waited for,
+    // one flip each, as SRCU does.
+    for (size_t i = 0; i < 2; i++) {
+        const unsigned old = __atomic_load_n(&READERS_EPOCH, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&READERS_EPOCH, 1 - old, __ATOMIC_SEQ_CST);
+        // Sequentially consistent: this load must not be reordered before the
+        // flip, otherwise a reader that has just entered on the old epoch may be
+        // missed
+        while (0 != __atomic_load_n(&READERS[old], __ATOMIC_SEQ_CST)) sched_yield();
+    }
+}
+
 void _sort(void) {
-    qsort(REGISTERED_LOGGERS, REGISTERED_LOGGERS_ARRAY_SIZE, sizeof(*REGISTERED_LOGGERS),
+    qsort(REGISTERED_LOGGERS, REGISTERED_LOGGERS_NB, sizeof(*REGISTERED_LOGGERS),
           _logger_compar);
+    REGISTERED_LOGGERS_UNSORTED = false;
 }
 
 int _logger_compar(const void * l1, const void * l2) {
@@ -254,11 +410,6 @@ int _logger_compar(const void * l1, const void * l2) {
 
     if (logger1 == logger2) return 0;
 
-    if (NULL == logger1) return -1; // l2 is different, therefore it is not NULL and greater
-    if (NULL == logger2) return 1; // Reverse case
-
-
-
     return strcmp(logger1->name, logger2->name);
 }
 
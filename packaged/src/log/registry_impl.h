@@ -32,5 +32,10 @@
 
 void bxilog__cfg_release_loggers();
 
+// REGISTER_LOCK is held across a fork(), see _parent_before_fork()
+void bxilog__registry_before_fork(void);
+void bxilog__registry_parent_after_fork(void);
+void bxilog__registry_child_after_fork(void);
+
 
 #endif
@@ -13,6 +13,11 @@
 
 
 #include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 
 #include "bxi/base/err.h"
 #include "bxi/base/mem.h"
@@ -22,6 +27,7 @@
 
 #include "bxi/base/log.h"
 #include "log_impl.h"
+#include "wire_impl.h"
 
 #include "bxi/base/log/remote_handler.h"
 
@@ -34,6 +40,21 @@
 
 #define _ilog(level, data, ...) _internal_log_func(level, data, __func__, ARRAYLEN(__func__), __LINE__, __VA_ARGS__)
 
+// A batch is sent as soon as it reaches this size
+#define BATCH_MAX_SIZE (64 * 1024)
+
+// Implicit flush frequency: maximum time a record waits in a batch
+#define BATCH_FLUSH_FREQ_MS 100
+
+// Name of the spool file in the spool directory of the relay handler
+#define SPOOL_FILENAME "bxilog-relay.spool"
+
+// Each spooled batch is preceded by its level (u8) and its size (u32 LE)
+#define SPOOL_ENTRY_HEADER_SIZE 5
+
+// Batches are dropped when the spool reaches this size
+#define SPOOL_MAX_SIZE (1024l * 1024 * 1024)
+
 //*********************************************************************************
 //********************************** Types ****************************************
 //*********************************************************************************
@@ -51,7 +72,18 @@ typedef struct bxilog_remote_handler_param_s_f {
     void * cfg_zock;  // Only when bind is false
     void * ctrl_zock;
     void * data_zock;
-
+    bxilog__wire_encoder_s encoder;     // The current batch of records
+    bxilog_level_e batch_level;         // The most severe level of the batch
+    char * source;                      // Identifier sent with each batch
+    char * spool_dir;   // Only for the relay handler
+    int spool_fd;       // Spool file, -1 when not opened
+    off_t spool_rd_off; // Offset of the next spooled batch to send
+    off_t spool_wr_off; // Size of the spool file
+    uint8_t * spool_buf;        // Buffer used when replaying the spool
+    size_t spool_buf_size;      // Size of spool_buf
+    size_t spooled_nb;          // Number of batches written to the spool
+    size_t dropped_nb;          // Number of batches dropped, spool being full
+    size_t subscriptions_nb;    // Current subscriptions to the XPUB data zocket
 } bxilog_remote_handler_param_s;
 
 
@@ -78,6 +110,15 @@ static bxierr_p _process_ctrl_msg(bxilog_remote_handler_param_p data, int revent
 static bxierr_p _process_get_cfg_msg(bxilog_remote_handler_param_p data,
                                      zmq_msg_t id_frame);
 static bxierr_p _sync_pub(bxilog_remote_handler_param_p data);
+static bxierr_p _send_batch(bxilog_remote_handler_param_p data);
+static bxierr_p _try_send(bxilog_remote_handler_param_p data, bxilog_level_e level,
+                          const uint8_t * batch, size_t batch_len, bool * sent);
+static bxierr_p _spool_open(bxilog_remote_handler_param_p data);
+static bxierr_p _spool_write(bxilog_remote_handler_param_p data, bxilog_level_e level,
+                             const uint8_t * batch, size_t batch_len);
+static bxierr_p _spool_drain(bxilog_remote_handler_param_p data);
+static bxierr_p _spool_close(bxilog_remote_handler_param_p data);
+static bxierr_p _read_subscriptions(bxilog_remote_handler_param_p data);
 
 //*********************************************************************************
 //********************************** Global Variables  ****************************
@@ -102,6 +143,25 @@ static const bxilog_handler_s BXILOG_REMOTE_HANDLER_S = {
 };
 const bxilog_handler_p BXILOG_REMOTE_HANDLER = (bxilog_handler_p) &BXILOG_REMOTE_HANDLER_S;
 
+static const bxilog_handler_s BXILOG_REMOTE_RELAY_HANDLER_S = {
+                  .name = "BXI Logging Relay Handler",
+                  .param_new = _param_new,
+                  .init = (bxierr_p (*) (bxilog_handler_param_p)) _init,
+                  .process_log = (bxierr_p (*)(bxilog_record_p record,
+                                               char * filename,
+                                               char * funcname,
+                                               char * loggername,
+                                               char * logmsg,
+                                               bxilog_handler_param_p param)) _process_log,
+                  .process_ierr = (bxierr_p (*) (bxierr_p*, bxilog_handler_param_p)) _process_ierr,
+                  .process_implicit_flush = (bxierr_p (*) (bxilog_handler_param_p)) _process_implicit_flush,
+                  .process_explicit_flush = (bxierr_p (*) (bxilog_handler_param_p)) _process_explicit_flush,
+                  .process_exit = (bxierr_p (*) (bxilog_handler_param_p)) _process_exit,
+                  .process_cfg = (bxierr_p (*) (bxilog_handler_param_p)) _process_cfg,
+                  .param_destroy = (bxierr_p (*) (bxilog_handler_param_p*)) _param_destroy,
+};
+const bxilog_handler_p BXILOG_REMOTE_RELAY_HANDLER = (bxilog_handler_p) &BXILOG_REMOTE_RELAY_HANDLER_S;
+
 static const char * const _LOG_LEVEL_HEADER[] = {
         BXILOG_REMOTE_HANDLER_RECORD_HEADER,                             // BXILOG_OFF
         BXILOG_REMOTE_HANDLER_RECORD_HEADER "LTFDIONWECAP",              // BXILOG_PANIC
@@ -126,15 +186,18 @@ bxilog_handler_param_p _param_new(bxilog_handler_p self,
                                   bxilog_filters_p filters,
                                   va_list ap) {
 
-    bxiassert(BXILOG_REMOTE_HANDLER == self);
+    bxiassert(BXILOG_REMOTE_HANDLER == self || BXILOG_REMOTE_RELAY_HANDLER == self);
 
     char * url = va_arg(ap, char *);
     bool bind_flag = va_arg(ap, int); // YES, THIS IS *REQUIRED* IN C99,
                                       // bool will be promoted to int
+    char * spool_dir = NULL;
+    if (BXILOG_REMOTE_RELAY_HANDLER == self) spool_dir = va_arg(ap, char *);
     va_end(ap);
 
     bxilog_remote_handler_param_p result = bximem_calloc(sizeof(*result));
     bxilog_handler_init_param(self, filters, &result->generic);
+    result->generic.flush_freq_ms = BATCH_FLUSH_FREQ_MS;
 
     if (bind_flag) {
         result->cfg_url = NULL;
@@ -149,6 +212,10 @@ bxilog_handler_param_p _param_new(bxilog_handler_p self,
     result->ctx = NULL;
     result->ctrl_zock = NULL;
     result->data_zock = NULL;
+    bxilog__wire_encoder_init(&result->encoder);
+    result->batch_level = BXILOG_OFF;
+    result->spool_dir = (NULL == spool_dir) ? NULL : strdup(spool_dir);
+    result->spool_fd = -1;
 
     return (bxilog_handler_param_p) result;
 }
@@ -166,6 +233,16 @@ bxierr_p _init(bxilog_remote_handler_param_p data) {
 
     if (bxierr_isko(err)) return err;
 
+    if (NULL != data->spool_dir) {
+        err2 = _spool_open(data);
+        BXIERR_CHAIN(err, err2);
+        if (bxierr_isko(err)) return err;
+    }
+
+    // The relay handler must know when the upstream is slow: a XPUB zocket
+    // is used since, unlike PUB, it can report a full queue instead of dropping
+    const int data_zock_type = (NULL == data->spool_dir) ? ZMQ_PUB : ZMQ_XPUB;
+
     if (data->bind) {
         int port;
 
@@ -186,7 +263,7 @@ bxierr_p _init(bxilog_remote_handler_param_p data) {
         DBG("Binding data zocket to %s\n", data->ctrl_url);
         // Creating and binding the ZMQ data socket
         err2 = bxizmq_zocket_create_binded(data->ctx,
-                                           ZMQ_PUB,
+                                           data_zock_type,
                                            pub_url,
                                            &port,
                                            &data->data_zock);
@@ -210,7 +287,7 @@ bxierr_p _init(bxilog_remote_handler_param_p data) {
         err2 = bxizmq_zocket_create(data->ctx, ZMQ_ROUTER, &data->ctrl_zock);
         BXIERR_CHAIN(err, err2);
 
-        err2 = bxizmq_zocket_create(data->ctx, ZMQ_PUB, &data->data_zock);
+        err2 = bxizmq_zocket_create(data->ctx, data_zock_type, &data->data_zock);
         BXIERR_CHAIN(err, err2);
 
         DBG("Requesting urls on %s\n", data->cfg_url);
@@ -275,6 +352,32 @@ bxierr_p _init(bxilog_remote_handler_param_p data) {
         bxierr_p tmp = _sync_pub(data);
         if (bxierr_isko(tmp)) bxierr_report(&tmp, STDERR_FILENO);
     }
+    // Records are numbered so receivers can account for lost ones:
+    // when connecting, the pub url is the receiver one, shared by all publishers
+    if (NULL == data->pub_url) {
+        data->source = NULL;
+    } else if (data->bind) {
+        data->source = strdup(data->pub_url);
+    } else {
+        char hostname[256] = "";
+        gethostname(hostname, sizeof(hostname) - 1);
+        data->source = bxistr_new("%s#%s:%d", data->pub_url, hostname, getpid());
+    }
+    bxilog__wire_encoder_set_source(&data->encoder, data->source);
+
+    if (NULL != data->spool_dir && NULL != data->data_zock) {
+#ifdef ZMQ_XPUB_NODROP
+        int nodrop = 1;
+        err2 = bxizmq_zocket_setopt(data->data_zock, ZMQ_XPUB_NODROP,
+                                    &nodrop, sizeof(nodrop));
+        BXIERR_CHAIN(err, err2);
+#else
+        bxierr_p dummy = bxierr_gen("ZMQ_XPUB_NODROP is not supported by this zeromq "
+                                    "version: %s never spools, messages might be "
+                                    "lost", INTERNAL_LOGGER_NAME);
+        bxierr_report(&dummy, STDERR_FILENO);
+#endif
+    }
     data->generic.private_items_nb = 1;
     data->generic.private_items = bximem_calloc(data->generic.private_items_nb * \
                                                 sizeof(*data->generic.private_items));
@@ -290,6 +393,15 @@ bxierr_p _init(bxilog_remote_handler_param_p data) {
 bxierr_p _process_exit(bxilog_remote_handler_param_p data) {
     bxierr_p err = BXIERR_OK, err2;
 
+    err2 = _send_batch(data);
+    BXIERR_CHAIN(err, err2);
+
+    if (NULL != data->spool_dir) {
+        // Remaining batches are kept in the spool for the next run
+        err2 = _spool_close(data);
+        BXIERR_CHAIN(err, err2);
+    }
+
     // Inform potential receiver that we are exiting
     const char * header =  BXILOG_REMOTE_HANDLER_EXITING_HEADER;
 
@@ -330,14 +442,24 @@ bxierr_p _process_exit(bxilog_remote_handler_param_p data) {
     BXIFREE(data->pub_url);
     BXIFREE(data->generic.private_items);
     BXIFREE(data->generic.cbs);
+    bxilog__wire_encoder_clean(&data->encoder);
+    BXIFREE(data->source);
 
     return err;
 }
 
 bxierr_p _process_implicit_flush(bxilog_remote_handler_param_p data) {
-    UNUSED(data);
+    bxierr_p err = BXIERR_OK, err2;
 
-    return BXIERR_OK;
+    if (NULL != data->spool_dir) {
+        err2 = _spool_drain(data);
+        BXIERR_CHAIN(err, err2);
+    }
+
+    err2 = _send_batch(data);
+    BXIERR_CHAIN(err, err2);
+
+    return err;
 }
 
 bxierr_p _process_explicit_flush(bxilog_remote_handler_param_p data) {
@@ -353,25 +475,18 @@ bxierr_p _process_log(bxilog_record_p record,
 
     bxierr_p err = BXIERR_OK, err2;
 
-    UNUSED(filename);
-    UNUSED(funcname);
-    UNUSED(loggername);
-    UNUSED(logmsg);
-
-    const char * header =  _LOG_LEVEL_HEADER[record->level];
-
-    err2 = bxizmq_str_snd_zc(header, data->data_zock, ZMQ_SNDMORE,
-                             0, 0, false);
-    BXIERR_CHAIN(err, err2);
+    // Records of any level share the batch: subscribers filtering on the level
+    // header must receive it as soon as one of its records is wanted
+    if (0 == data->encoder.records_nb || record->level < data->batch_level) {
+        data->batch_level = record->level;
+    }
 
-    size_t record_len = sizeof(*record) +\
-            record->filename_len +\
-            record->funcname_len +\
-            record->logname_len +\
-            record->logmsg_len;
+    bxilog__wire_encode(&data->encoder, record, filename, funcname, loggername, logmsg);
 
-    err2 = bxizmq_data_snd(record, record_len, data->data_zock, 0, 0, 0);
-    BXIERR_CHAIN(err, err2);
+    if (data->encoder.len >= BATCH_MAX_SIZE) {
+        err2 = _send_batch(data);
+        BXIERR_CHAIN(err, err2);
+    }
 
     return err;
 }
@@ -397,6 +512,7 @@ bxierr_p _param_destroy(bxilog_remote_handler_param_p * data_p) {
 
     BXIFREE(data->ctrl_url);
     BXIFREE(data->hostname);
+    BXIFREE(data->spool_dir);
 
     bximem_destroy((char**) data_p);
 
@@ -456,13 +572,13 @@ bxierr_p _process_get_cfg_msg(bxilog_remote_handler_param_p data, zmq_msg_t id_f
     // We will create the JSON string. It is made of several parts:
     // '{'
     // 'global': ...
-    // 'handler-0': ...
-    // ...
-    // 'handler-N': ...
-    // 'logger-0': ...
-    // 'logger-N: ...
+    // 'handlers': [handler-0, ..., handler-N]
+    // 'loggers': [logger-0, ..., logger-N]
     // '}'
-    char * global_str = bxistr_new("{"
+    // All are appended to a single thread-local builder.
+    bxistr_builder_p json = bxistr_builder_get();
+    bxistr_builder_append(json, "{"
+            "\"global\": {"
             "\"ctrl_url\": \"%s\", "
             "\"pub_url\": \"%s\", "
             "\"pid\": %d, "
@@ -473,7 +589,7 @@ bxierr_p _process_get_cfg_msg(bxilog_remote_handler_param_p data, zmq_msg_t id_f
             "\"ctrl_hwm\": %d, "
             "\"data_hwm\": %d, "
             "\"buf_size\": %zu"
-            "}",
+            "}, ",
             data->ctrl_url,
             data->pub_url,
             BXILOG__GLOBALS->pid,
@@ -485,100 +601,54 @@ bxierr_p _process_get_cfg_msg(bxilog_remote_handler_param_p data, zmq_msg_t id_f
             BXILOG__GLOBALS->config->data_hwm,
             BXILOG__GLOBALS->config->tsd_log_buf_size);
 
-    char * handlers_str_parts[BXILOG__GLOBALS->internal_handlers_nb];
-    size_t handlers_str_parts_len[BXILOG__GLOBALS->internal_handlers_nb];
+    bxistr_builder_append(json, "\"handlers\": [");
     for (size_t i = 0; i < BXILOG__GLOBALS->internal_handlers_nb; i++) {
         bxilog_handler_param_p param = BXILOG__GLOBALS->config->handlers_params[i];
         bxilog_filters_p filters = param->filters;
-        char * filters_str_parts[filters->nb];
-        size_t filters_str_parts_len[filters->nb];
 
+        bxistr_builder_append(json, "%s{"
+                              "\"name\": \"%s\", "
+                              "\"filters\": \"",
+                              (0 == i) ? "" : ", ",
+                              BXILOG__GLOBALS->config->handlers[i]->name);
         for (size_t f = 0; f < filters->nb; f++) {
             bxilog_filter_p filter = filters->list[f];
-            filters_str_parts[f] = bxistr_new("%s:%u", filter->prefix, filter->level);
-            filters_str_parts_len[f] = strlen(filters_str_parts[f]);
-        }
-        char * filters_str = NULL;
-        bxistr_join(", ", strlen(", "),
-                    filters_str_parts, filters_str_parts_len,
-                    filters->nb,
-                    &filters_str);
-
-        handlers_str_parts[i] = bxistr_new("{"
-                            "\"name\": \"%s\", "
-                            "\"filters\": \"%s\", "
-                            "\"status\": %d, "
-                            "\"flush_freq_ms\": %lu, "
-                            "\"ierr_max\": %zu, "
-                            "\"ctrl_hwm\": %d, "
-                            "\"data_hwm\": %d"
-                            "}",
-                            BXILOG__GLOBALS->config->handlers[i]->name,
-                            filters_str,
-                            param->status,
-                            param->flush_freq_ms,
-                            param->ierr_max,
-                            param->ctrl_hwm,
-                            param->data_hwm);
-        handlers_str_parts_len[i] = strlen(handlers_str_parts[i]);
-
-        for (size_t f = 0; f < filters->nb; f++) {
-            BXIFREE(filters_str_parts[f]);
+            bxistr_builder_append(json, "%s%s:%u",
+                                  (0 == f) ? "" : ", ", filter->prefix, filter->level);
         }
-        BXIFREE(filters_str);
+        bxistr_builder_append(json, "\", "
+                              "\"status\": %d, "
+                              "\"flush_freq_ms\": %lu, "
+                              "\"ierr_max\": %zu, "
+                              "\"ctrl_hwm\": %d, "
+                              "\"data_hwm\": %d"
+                              "}",
+                              param->status,
+                              param->flush_freq_ms,
+                              param->ierr_max,
+                              param->ctrl_hwm,
+                              param->data_hwm);
     }
-    char * handlers_str = NULL;
-    bxistr_join(", ", strlen(", "),
-                handlers_str_parts, handlers_str_parts_len,
-                BXILOG__GLOBALS->internal_handlers_nb,
-                &handlers_str);
-
-    char * loggers_str_parts[loggers_nb];
-    size_t loggers_str_parts_len[loggers_nb];
+    bxistr_builder_append(json, "], \"loggers\": [");
+
     for (size_t i = 0; i < loggers_nb; i++) {
-        loggers_str_parts[i] = bxistr_new("{"
-                                "\"name\": \"%s\", "
-                                "\"allocated\": %s, "
-                                "\"level\": %d"
-                                "}",
-                                loggers[i]->name,
-                                loggers[i]->allocated ? "true" : "false",
-                                loggers[i]->level);
-        loggers_str_parts_len[i] = strlen(loggers_str_parts[i]);
+        bxistr_builder_append(json, "%s{"
+                              "\"name\": \"%s\", "
+                              "\"allocated\": %s, "
+                              "\"level\": %d"
+                              "}",
+                              (0 == i) ? "" : ", ",
+                              loggers[i]->name,
+                              loggers[i]->allocated ? "true" : "false",
+                              bxilog_logger_get_level(loggers[i]));
     }
+    bxistr_builder_append(json, "] }");
 
-    char * loggers_str = NULL;
-    bxistr_join(", ", strlen(", "),
-                loggers_str_parts, loggers_str_parts_len,
-                loggers_nb,
-                &loggers_str);
-
-    // Now we join all parts together
-    char * json_str = bxistr_new("{"
-            "\"global\": %s, "
-            "\"handlers\": [%s], "
-            "\"loggers\": [%s] "
-            "}",
-            global_str,
-            handlers_str,
-            loggers_str);
-
-    DBG("Sending: %s", json_str);
-    err2 = bxizmq_str_snd(json_str, data->ctrl_zock, 0, 0, 0);
+    DBG("Sending: %s", json->buf);
+    err2 = bxizmq_str_snd(json->buf, data->ctrl_zock, 0, 0, 0);
     BXIERR_CHAIN(err, err2);
 
-    BXIFREE(global_str);
-    BXIFREE(handlers_str);
-    for (size_t i = 0; i < BXILOG__GLOBALS->internal_handlers_nb; i++) {
-        BXIFREE(handlers_str_parts[i]);
-    }
-
-    BXIFREE(loggers_str);
-    for (size_t i = 0; i < loggers_nb; i++) {
-        BXIFREE(loggers_str_parts[i]);
-    }
-    BXIFREE(json_str);
-
+    bxistr_builder_release(&json);
     BXIFREE(loggers);
 
     return err;
@@ -637,3 +707,271 @@ bxierr_p _sync_pub(bxilog_remote_handler_param_p data) {
     return err;
 
 }
+
+bxierr_p _send_batch(bxilog_remote_handler_param_p data) {
+    bxierr_p err = BXIERR_OK, err2;
+
+    const uint8_t * batch;
+    size_t batch_len = bxilog__wire_encoder_data(&data->encoder, &batch);
+    if (0 == batch_len) return err;
+
+    if (NULL != data->spool_dir) {
+        err2 = _read_subscriptions(data);
+        BXIERR_CHAIN(err, err2);
+        // Batches already spooled must be sent first to preserve the order,
+        // and batches sent before the upstream subscribed are lost
+        bool sent = false;
+        if (data->spool_rd_off == data->spool_wr_off && 0 < data->subscriptions_nb) {
+            err2 = _try_send(data, data->batch_level, batch, batch_len, &sent);
+            BXIERR_CHAIN(err, err2);
+        }
+        if (!sent && bxierr_isok(err)) {
+            err2 = _spool_write(data, data->batch_level, batch, batch_len);
+            BXIERR_CHAIN(err, err2);
+        }
+        bxilog__wire_encoder_reset(&data->encoder);
+        return err;
+    }
+
+    const char * header =  _LOG_LEVEL_HEADER[data->batch_level];
+
+    err2 = bxizmq_str_snd_zc(header, data->data_zock, ZMQ_SNDMORE,
+                             0, 0, false);
+    BXIERR_CHAIN(err, err2);
+
+    err2 = bxizmq_data_snd(batch, batch_len, data->data_zock, 0, 0, 0);
+    BXIERR_CHAIN(err, err2);
+
+    bxilog__wire_encoder_reset(&data->encoder);
+
+    return err;
+}
+
+bxierr_p _try_send(bxilog_remote_handler_param_p data, bxilog_level_e level,
+                   const uint8_t * batch, size_t batch_len, bool * sent) {
+
+    const char * header =  _LOG_LEVEL_HEADER[level];
+
+    *sent = false;
+    errno = 0;
+    int rc = zmq_send(data->data_zock, header, strlen(header),
+                      ZMQ_SNDMORE | ZMQ_DONTWAIT);
+    if (-1 == rc) {
+        if (EAGAIN == errno) return BXIERR_OK;
+        return bxizmq_err(errno, "Can't send msg through zsocket %p", data->data_zock);
+    }
+    // Once the first frame has been queued, the others are guaranteed to be
+    *sent = true;
+    return bxizmq_data_snd(batch, batch_len, data->data_zock, 0, 0, 0);
+}
+
+bxierr_p _spool_open(bxilog_remote_handler_param_p data) {
+    char * path = bxistr_new("%s/%s", data->spool_dir, SPOOL_FILENAME);
+
+    errno = 0;
+    data->spool_fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC,
+                          S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+    if (-1 == data->spool_fd) {
+        bxierr_p err = bxierr_errno("Can't open spool file '%s'", path);
+        BXIFREE(path);
+        return err;
+    }
+    BXIFREE(path);
+
+    // Batches left by a previous run are sent first
+    data->spool_rd_off = 0;
+    const off_t size = lseek(data->spool_fd, 0, SEEK_END);
+    if (-1 == size) return bxierr_errno("Can't seek the spool file");
+
+    // A crash might have left a partial entry at the end: new batches must not
+    // be appended after it, they would be discarded with it
+    data->spool_wr_off = 0;
+    while (data->spool_wr_off < size) {
+        uint8_t header[SPOOL_ENTRY_HEADER_SIZE];
+        ssize_t n = pread(data->spool_fd, header, sizeof(header), data->spool_wr_off);
+        if (n != (ssize_t) sizeof(header)) break;
+        size_t batch_len = 0;
+        for (size_t i = 0; i < 4; i++) batch_len |= (size_t) header[1 + i] << (8 * i);
+        if (header[0] >= ARRAYLEN(_LOG_LEVEL_HEADER)
+            || data->spool_wr_off + (off_t) (sizeof(header) + batch_len) > size) break;
+        data->spool_wr_off += (off_t) (sizeof(header) + batch_len);
+    }
+    if (data->spool_wr_off < size) {
+        bxierr_p dummy = bxierr_gen("Corrupted spool entry at offset %ld, discarding "
+                                    "the last %ld bytes of the spool",
+                                    (long) data->spool_wr_off,
+                                    (long) (size - data->spool_wr_off));
+        bxierr_report(&dummy, STDERR_FILENO);
+        errno = 0;
+        if (-1 == ftruncate(data->spool_fd, data->spool_wr_off)) {
+            return bxierr_errno("Can't truncate the spool file");
+        }
+    }
+
+    return BXIERR_OK;
+}
+
+bxierr_p _spool_write(bxilog_remote_handler_param_p data, bxilog_level_e level,
+                      const uint8_t * batch, size_t batch_len) {
+
+    if (data->spool_wr_off + SPOOL_ENTRY_HEADER_SIZE + (off_t) batch_len > SPOOL_MAX_SIZE) {
+        data->dropped_nb++;
+        // Report only once per spool filling
+        if (1 != data->dropped_nb) return BXIERR_OK;
+        return bxierr_gen("Spool of %s is full (%ld bytes): batches are dropped",
+                          INTERNAL_LOGGER_NAME, SPOOL_MAX_SIZE);
+    }
+
+    uint8_t header[SPOOL_ENTRY_HEADER_SIZE];
+    header[0] = (uint8_t) level;
+    for (size_t i = 0; i < 4; i++) header[1 + i] = (uint8_t) (batch_len >> (8 * i));
+
+    struct iovec iov[] = {{header, sizeof(header)}, {(void *) batch, batch_len}};
+    size_t len = sizeof(header) + batch_len;
+    errno = 0;
+    ssize_t n = pwritev(data->spool_fd, iov, 2, data->spool_wr_off);
+    if (n != (ssize_t) len) {
+        // Do not leave a partial entry in the spool
+        if (-1 == ftruncate(data->spool_fd, data->spool_wr_off)) {
+            // Nothing more can be done
+        }
+        return bxierr_errno("Can't write %zu bytes to the spool file", len);
+    }
+    data->spool_wr_off += (off_t) len;
+    data->spooled_nb++;
+
+    return BXIERR_OK;
+}
+
+bxierr_p _spool_drain(bxilog_remote_handler_param_p data) {
+    bxierr_p err = BXIERR_OK, err2;
+
+    err2 = _read_subscriptions(data);
+    BXIERR_CHAIN(err, err2);
+    // Wait for the upstream: XPUB drops what is sent without subscription
+    if (0 == data->subscriptions_nb) return err;
+
+    while (data->spool_rd_off < data->spool_wr_off) {
+        uint8_t header[SPOOL_ENTRY_HEADER_SIZE];
+        errno = 0;
+        ssize_t n = pread(data->spool_fd, header, sizeof(header), data->spool_rd_off);
+        if (n != (ssize_t) sizeof(header)) {
+            err2 = bxierr_errno("Can't read spool entry at offset %ld",
+                                (long) data->spool_rd_off);
+            BXIERR_CHAIN(err, err2);
+            break;
+        }
+        bxilog_level_e level = header[0];
+        size_t batch_len = 0;
+        for (size_t i = 0; i < 4; i++) batch_len |= (size_t) header[1 + i] << (8 * i);
+
+        if (level >= ARRAYLEN(_LOG_LEVEL_HEADER)
+            || data->spool_rd_off + (off_t) (sizeof(header) + batch_len) > data->spool_wr_off) {
+            err2 = bxierr_gen("Corrupted spool entry at offset %ld, discarding the spool",
+                              (long) data->spool_rd_off);
+            BXIERR_CHAIN(err, err2);
+            data->spool_rd_off = data->spool_wr_off;
+            break;
+        }
+
+        if (data->spool_buf_size < batch_len) {
+            data->spool_buf = bximem_realloc(data->spool_buf, data->spool_buf_size,
+                                             batch_len);
+            data->spool_buf_size = batch_len;
+        }
+        n = pread(data->spool_fd, data->spool_buf, batch_len,
+                  data->spool_rd_off + (off_t) sizeof(header));
+        if (n != (ssize_t) batch_len) {
+            err2 = bxierr_errno("Can't read spool entry at offset %ld",
+                                (long) data->spool_rd_off);
+            BXIERR_CHAIN(err, err2);
+            break;
+        }
+
+        bool sent = false;
+        err2 = _try_send(data, level, data->spool_buf, batch_len, &sent);
+        BXIERR_CHAIN(err, err2);
+        if (!sent || bxierr_isko(err)) break;
+        data->spool_rd_off += (off_t) (sizeof(header) + batch_len);
+    }
+
+    if (data->spool_rd_off == data->spool_wr_off && 0 != data->spool_wr_off) {
+        // Everything has been sent: start again with an empty spool
+        errno = 0;
+        if (-1 == ftruncate(data->spool_fd, 0)) {
+            err2 = bxierr_errno("Can't truncate the spool file");
+            BXIERR_CHAIN(err, err2);
+        }
+        data->spool_rd_off = 0;
+        data->spool_wr_off = 0;
+        data->dropped_nb = 0;
+    }
+
+    return err;
+}
+
+bxierr_p _spool_close(bxilog_remote_handler_param_p data) {
+    bxierr_p err = BXIERR_OK, err2;
+
+    err2 = _spool_drain(data);
+    BXIERR_CHAIN(err, err2);
+
+    if (data->spool_rd_off < data->spool_wr_off) {
+        // Keep only unsent batches for the next run
+        off_t remaining = data->spool_wr_off - data->spool_rd_off;
+        DBG("%ld bytes remain in the spool\n", (long) remaining);
+        for (off_t off = 0; off < remaining && bxierr_isok(err);) {
+            uint8_t chunk[64 * 1024];
+            ssize_t n = pread(data->spool_fd, chunk, sizeof(chunk),
+                              data->spool_rd_off + off);
+            if (n <= 0 || n != pwrite(data->spool_fd, chunk, (size_t) n, off)) {
+                err2 = bxierr_errno("Can't compact the spool file");
+                BXIERR_CHAIN(err, err2);
+                break;
+            }
+            off += n;
+        }
+        if (bxierr_isok(err) && -1 == ftruncate(data->spool_fd, remaining)) {
+            err2 = bxierr_errno("Can't truncate the spool file");
+            BXIERR_CHAIN(err, err2);
+        }
+    }
+
+    if (0 != data->dropped_nb) {
+        err2 = bxierr_gen("%zu batches have been dropped by %s, its spool being full",
+                          data->dropped_nb, INTERNAL_LOGGER_NAME);
+        BXIERR_CHAIN(err, err2);
+    }
+
+    errno = 0;
+    if (-1 == close(data->spool_fd)) {
+        err2 = bxierr_errno("Can't close the spool file");
+        BXIERR_CHAIN(err, err2);
+    }
+    data->spool_fd = -1;
+    BXIFREE(data->spool_buf);
+    data->spool_buf_size = 0;
+
+    return err;
+}
+
+bxierr_p _read_subscriptions(bxilog_remote_handler_param_p data) {
+    // Each (un)subscription of the upstream is a message starting with 1 (0)
+    uint8_t msg[256];
+    while (true) {
+        errno = 0;
+        int rc = zmq_recv(data->data_zock, msg, sizeof(msg), ZMQ_DONTWAIT);
+        if (-1 == rc) {
+            if (EAGAIN == errno) return BXIERR_OK;
+            if (EINTR == errno) continue;
+            return bxizmq_err(errno, "Can't receive subscriptions from zsocket %p",
+                              data->data_zock);
+        }
+        if (0 == rc) continue;
+        if (1 == msg[0]) {
+            data->subscriptions_nb++;
+        } else if (0 == msg[0] && 0 < data->subscriptions_nb) {
+            data->subscriptions_nb--;
+        }
+    }
+}
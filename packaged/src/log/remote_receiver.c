@@ -13,6 +13,7 @@
 
 #include <bxi/base/mem.h>
 #include <bxi/base/zmq.h>
+#include <bxi/base/str.h>
 #include <bxi/base/log/remote_handler.h>
 #include <bxi/base/log/remote_receiver.h>
 #include <bxi/base/time.h>
@@ -23,6 +24,7 @@
 
 #include "tsd_impl.h"
 #include "log_impl.h"
+#include "wire_impl.h"
 
 
 SET_LOGGER(LOGGER, BXILOG_LIB_PREFIX "bxilog.remote");
@@ -35,11 +37,58 @@ SET_LOGGER(LOGGER, BXILOG_LIB_PREFIX "bxilog.remote");
 #define _EXIT_NORMAL_ERR 38170247   // EXIT.OR.AL in leet speak
 #define _BAD_HEADER_ERR  34034032   // B4D.EADER in leet speak
 #define _BAD_RECORD_ERR  34023020   // B4DRE.ORD in leet speak
+
+// Period of the lost records summary of each worker
+#define BXILOG_RECEIVER_LOSS_SUMMARY_PERIOD_S 60.0
+
+// Initial size of the publishers table of each worker (a power of 2)
+#define BXILOG_RECEIVER_PUBLISHERS_INIT_SIZE 16
 //*********************************************************************************
 //********************************** Types ****************************************
 //*********************************************************************************
 
 
+/**
+ * Records accounting of a publisher, from the sequence numbers of its batches
+ */
+typedef struct {
+    char * source;              //!< Publisher identifier, NULL for a free slot
+    size_t source_len;          //!< Length of source
+    uint64_t next_seq;          //!< Next sequence number expected
+    size_t received_nb;         //!< Number of records received
+    size_t lost_nb;             //!< Number of records lost
+    size_t reordered_nb;        //!< Number of records received out of order
+} publisher_s;
+
+typedef publisher_s * publisher_p;
+
+/**
+ * A worker thread receiving logs from a subset of the publishers
+ */
+typedef struct {
+    bxilog_remote_receiver_p receiver;  //!< The receiver the worker belongs to
+    size_t rank;                        //!< The worker rank
+    bool started;                       //!< True while the worker thread runs
+    bool detached;                      //!< Left behind by _stop_workers()
+    pthread_t thread;                   //!< The worker thread
+    void * zmq_ctx;                     //!< The ZMQ context of its sockets
+    void * it_zock;                     //!< Control zocket, internal thread side
+    void * ctrl_zock;                   //!< Control zocket, worker side
+    void * data_zock;                   //!< The socket that actually receive logs
+    char * data_url;                    //!< Data url binded to (if bind is true)
+    struct timespec start;              //!< When the worker started
+    bxilog_remote_receiver_stats_s stats; //!< Throughput counters (atomic)
+    pthread_mutex_t publishers_lock;    //!< Protect the publishers table
+    publisher_p publishers;             //!< Open addressing table of publishers
+    size_t publishers_size;             //!< Size of the publishers table
+    size_t publishers_nb;               //!< Number of publishers in the table
+    struct timespec last_summary;       //!< When the last loss summary was logged
+    size_t summary_lost_nb;             //!< Records lost at the last summary
+    size_t summary_reordered_nb;        //!< Records reordered at the last summary
+} worker_s;
+
+typedef worker_s * worker_p;
+
 /**
  * BXILog remote receiver parameters
  */
@@ -53,13 +102,16 @@ struct bxilog_remote_receiver_s {
     void * cfg_zock;           //!< The socket that receive configuration request
                                //!< NULL if bind is true.
     void * ctrl_zock;          //!< The control zocket
-    void * data_zock;          //!< The socket that actually receive logs
     size_t urls_nb;            //!< Number of urls to connect/bind to
     const char ** urls;        //!< The urls to connect/bind to
     const char ** cfg_urls;    //!< Config urls used (if bind is true)
     const char ** ctrl_urls;   //!< Control urls used
     const char ** data_urls;   //!< Data urls used
     const char *  hostname;    //!< hostname of the remote handler
+    pthread_t thread;          //!< The internal thread
+    size_t workers_nb;         //!< Number of worker threads receiving logs
+    worker_p workers;          //!< The workers
+    size_t next_worker;        //!< Worker given to the next publisher (if bind is true)
 };
 
 
@@ -67,16 +119,29 @@ struct bxilog_remote_receiver_s {
 //********************************** Static Functions  ****************************
 //*********************************************************************************
 //--------------------------------- Generic Helpers --------------------------------
-static bxierr_p _process_ctrl_msg(bxilog_remote_receiver_p self, tsd_p tsd);
-static bxierr_p _process_new_log(bxilog_remote_receiver_p self, tsd_p tsd);
-static bxierr_p _recv_log_record(void * zock, bxilog_record_p * record_p, size_t * record_len);
-static bxierr_p _dispatch_log_record(tsd_p tsd, bxilog_record_p record, size_t data_len);
+static bxierr_p _process_ctrl_msg(bxilog_remote_receiver_p self);
+static bxierr_p _process_new_log(worker_p worker, tsd_p tsd);
+static bxierr_p _recv_log_batch(void * zock, zmq_msg_t * zmsg,
+                                bxilog__wire_decoder_p decoder);
+static bxierr_p _new_record_zmsg(bxilog__wire_decoder_p decoder, zmq_msg_t * zmsg);
+static bxierr_p _dispatch_log_record(tsd_p tsd, zmq_msg_t * zmsg);
 static bxierr_p _connect_zocket(bxilog_remote_receiver_p self);
 static bxierr_p _recv_loop(bxilog_remote_receiver_p self);
 static bxierr_p _recv_async(bxilog_remote_receiver_p self);
+static bxierr_p _start_workers(bxilog_remote_receiver_p self);
+static bxierr_p _stop_workers(bxilog_remote_receiver_p self, bool wait_remote_exit);
+static bxierr_p _close_workers_zockets(bxilog_remote_receiver_p self);
+static bxierr_p _worker_loop(worker_p worker);
+static bxierr_p _process_worker_ctrl_msg(worker_p worker, tsd_p tsd);
+static void _free_workers(bxilog_remote_receiver_p self);
+static bool _workers_detached(bxilog_remote_receiver_p self);
+static publisher_p _get_publisher(worker_p worker, const char * source, size_t len);
+static publisher_p _publisher_slot(worker_p worker, const char * source, size_t len);
+static void _account_sequence(worker_p worker, bxilog__wire_decoder_p decoder);
+static void _loss_summary(worker_p worker, bool force);
 //static void _sync_sub(bxilog_remote_receiver_p self);
 static bxierr_p _process_cfg_request(bxilog_remote_receiver_p self);
-static bxierr_p _process_data_header(bxilog_remote_receiver_p self, char *header,
+static bxierr_p _process_data_header(worker_p worker, char *header,
                                      tsd_p tsd, bool exiting);
 
 //*********************************************************************************
@@ -91,6 +156,7 @@ static bxierr_p _process_data_header(bxilog_remote_receiver_p self, char *header
 #define BXILOG_RECEIVER_SYNC_TIMEOUT 1000
 
 #define BXILOG_REMOTE_RECEIVER_BC2IT_URL "inproc://bxilog_remote_receiver_sync"
+#define BXILOG_REMOTE_RECEIVER_WORKER_URL "inproc://bxilog_remote_receiver_worker"
 #define BXILOG_RECEIVER_SYNC_OK "OK"
 #define BXILOG_RECEIVER_SYNC_NOK "NOK"
 #define BXILOG_RECEIVER_EXIT "EXIT"
@@ -130,6 +196,9 @@ bxilog_remote_receiver_p bxilog_remote_receiver_new(const char ** urls, size_t u
     result->data_urls = bximem_calloc(urls_nb * sizeof(*result->data_urls));
     result->bind = bind;
     result->pub_connected = 0;
+    result->workers_nb = 1;
+    result->workers = NULL;
+    result->next_worker = 0;
 
     return result;
 }
@@ -150,7 +219,14 @@ void bxilog_remote_receiver_destroy(bxilog_remote_receiver_p *self_p) {
     if (self->bind) BXIFREE(self->cfg_urls);
     BXIFREE(self->ctrl_urls);
     BXIFREE(self->data_urls);
-    bximem_destroy((char**) self_p);
+    // A worker left behind still uses the receiver: leaked on purpose
+    const bool detached = _workers_detached(self);
+    _free_workers(self);
+    if (detached) {
+        *self_p = NULL;
+    } else {
+        bximem_destroy((char**) self_p);
+    }
 }
 
 bxierr_p bxilog_remote_receiver_start(bxilog_remote_receiver_p self) {
@@ -162,6 +238,17 @@ bxierr_p bxilog_remote_receiver_start(bxilog_remote_receiver_p self) {
                              "been started. Stop it first!", self);
     }
 
+    // Workers are kept until the next start() so their statistics remain
+    // available once the receiver has been stopped
+    _free_workers(self);
+    self->workers = bximem_calloc(self->workers_nb * sizeof(*self->workers));
+    for (size_t i = 0; i < self->workers_nb; i++) {
+        self->workers[i].receiver = self;
+        self->workers[i].rank = i;
+        pthread_mutex_init(&self->workers[i].publishers_lock, NULL);
+    }
+    self->next_worker = 0;
+
     TRACE(LOGGER, "Creating the ZMQ context");
     err2 = bxizmq_context_new(&self->zmq_ctx);
     BXIERR_CHAIN(err, err2);
@@ -174,7 +261,6 @@ bxierr_p bxilog_remote_receiver_start(bxilog_remote_receiver_p self) {
                                           &self->bc2it_zock);
     BXIERR_CHAIN(err, err2);
 
-    pthread_t thrd;
     pthread_attr_t attr;
     int rc = pthread_attr_init(&attr);
     if (0 != rc) {
@@ -190,12 +276,13 @@ bxierr_p bxilog_remote_receiver_start(bxilog_remote_receiver_p self) {
         BXIERR_CHAIN(err, err2);
     }
 
-    rc = pthread_create(&thrd, NULL, (void* (*) (void*)) _recv_async, self);
+    rc = pthread_create(&self->thread, &attr, (void* (*) (void*)) _recv_async, self);
     if (0 != rc) {
         err2 = bxierr_fromidx(rc, NULL,
                               "Calling pthread_create() failed (rc=%d)", rc);
         BXIERR_CHAIN(err, err2);
     }
+    pthread_attr_destroy(&attr);
 
     zmq_pollitem_t poller[] = {{self->bc2it_zock, 0, ZMQ_POLLIN, 0}};
 
@@ -277,16 +364,114 @@ bxierr_p bxilog_remote_receiver_stop(bxilog_remote_receiver_p self,
 
     BXIFREE(msg);
 
+    TRACE(LOGGER, "Joining the internal thread");
+    bxierr_p it_err = BXIERR_OK;
+    int rc2 = pthread_join(self->thread, (void**) &it_err);
+    if (0 != rc2) {
+        err2 = bxierr_fromidx(rc2, NULL,
+                              "Calling pthread_join() failed (rc=%d)", rc2);
+        BXIERR_CHAIN(err, err2);
+    } else {
+        BXIERR_CHAIN(err, it_err);
+    }
+
     TRACE(LOGGER, "Cleaning up");
     err2 = bxizmq_zocket_destroy(&self->bc2it_zock);
     BXIERR_CHAIN(err, err2);
 
-    err2 = bxizmq_context_destroy(&self->zmq_ctx);
-    BXIERR_CHAIN(err, err2);
+    if (_workers_detached(self)) {
+        // zmq_ctx_term() would wait for the sockets of the workers left behind:
+        // leak the context on purpose
+        self->zmq_ctx = NULL;
+    } else {
+        err2 = bxizmq_context_destroy(&self->zmq_ctx);
+        BXIERR_CHAIN(err, err2);
+    }
 
     return err;
 }
 
+bxierr_p bxilog_remote_receiver_set_workers_nb(bxilog_remote_receiver_p self,
+                                               size_t workers_nb) {
+    BXIASSERT(LOGGER, NULL != self);
+
+    if (NULL != self->zmq_ctx) {
+        return bxierr_simple(1,
+                             "Operation not permitted: this receiver %p has already "
+                             "been started. Stop it first!", self);
+    }
+    if (0 == workers_nb) {
+        return bxierr_gen("At least one worker is required, %zu given", workers_nb);
+    }
+    // A publisher is read by a single worker: extra workers would never receive
+    if (!self->bind && workers_nb > self->urls_nb) {
+        return bxierr_gen("Can't spread %zu urls among %zu workers: connecting "
+                          "requires at most one worker per url", self->urls_nb,
+                          workers_nb);
+    }
+    _free_workers(self);
+    self->workers_nb = workers_nb;
+
+    return BXIERR_OK;
+}
+
+size_t bxilog_remote_receiver_get_stats(bxilog_remote_receiver_p self,
+                                        bxilog_remote_receiver_stats_s * stats,
+                                        size_t stats_nb) {
+    BXIASSERT(LOGGER, NULL != self);
+
+    if (NULL == self->workers) return 0;
+
+    for (size_t i = 0; i < stats_nb && i < self->workers_nb; i++) {
+        bxilog_remote_receiver_stats_p src = &self->workers[i].stats;
+        stats[i].records_nb = __atomic_load_n(&src->records_nb, __ATOMIC_RELAXED);
+        stats[i].batches_nb = __atomic_load_n(&src->batches_nb, __ATOMIC_RELAXED);
+        stats[i].bytes_nb = __atomic_load_n(&src->bytes_nb, __ATOMIC_RELAXED);
+        stats[i].errors_nb = __atomic_load_n(&src->errors_nb, __ATOMIC_RELAXED);
+        stats[i].lost_nb = __atomic_load_n(&src->lost_nb, __ATOMIC_RELAXED);
+        stats[i].reordered_nb = __atomic_load_n(&src->reordered_nb, __ATOMIC_RELAXED);
+    }
+
+    return self->workers_nb;
+}
+
+size_t bxilog_remote_receiver_get_pub_stats(bxilog_remote_receiver_p self,
+                                            bxilog_remote_receiver_pub_stats_p * stats) {
+    BXIASSERT(LOGGER, NULL != self);
+    BXIASSERT(LOGGER, NULL != stats);
+
+    *stats = NULL;
+    if (NULL == self->workers) return 0;
+
+    size_t nb = 0;
+    for (size_t w = 0; w < self->workers_nb; w++) {
+        worker_p worker = &self->workers[w];
+        pthread_mutex_lock(&worker->publishers_lock);
+        if (0 != worker->publishers_nb) {
+            *stats = bximem_realloc(*stats, nb * sizeof(**stats),
+                                    (nb + worker->publishers_nb) * sizeof(**stats));
+        }
+        for (size_t i = 0; i < worker->publishers_size; i++) {
+            publisher_p pub = &worker->publishers[i];
+            if (NULL == pub->source) continue;
+            (*stats)[nb].url = strdup(pub->source);
+            (*stats)[nb].received_nb = pub->received_nb;
+            (*stats)[nb].lost_nb = pub->lost_nb;
+            (*stats)[nb].reordered_nb = pub->reordered_nb;
+            nb++;
+        }
+        pthread_mutex_unlock(&worker->publishers_lock);
+    }
+
+    return nb;
+}
+
+void bxilog_remote_receiver_free_pub_stats(bxilog_remote_receiver_pub_stats_p stats,
+                                           size_t stats_nb) {
+    for (size_t i = 0; i < stats_nb; i++) BXIFREE(stats[i].url);
+    BXIFREE(stats);
+}
+
 size_t bxilog_get_binded_urls(bxilog_remote_receiver_p self, const char*** result) {
     BXIASSERT(LOGGER, NULL != self);
 
@@ -307,9 +492,17 @@ bxierr_p _recv_async(bxilog_remote_receiver_p self) {
     err2 = _connect_zocket(self);
     BXIERR_CHAIN(err, err2);
 
+    if (bxierr_isok(err)) {
+        err2 = _start_workers(self);
+        BXIERR_CHAIN(err, err2);
+    }
+
     if (bxierr_isko(err)) {
         BXILOG_REPORT_KEEP(LOGGER, BXILOG_FINE, err,
                            "An error occurred in the internal thread.");
+        err2 = _stop_workers(self, false);
+        BXIERR_CHAIN(err, err2);
+
         LOWEST(LOGGER, "Sending synchronization message with error");
         err2 = bxizmq_str_snd(BXILOG_RECEIVER_SYNC_NOK, self->it2bc_zock, 0, 2, 500);
         BXIERR_CHAIN(err, err2);
@@ -317,17 +510,27 @@ bxierr_p _recv_async(bxilog_remote_receiver_p self) {
         err2 = bxizmq_zocket_destroy(&self->it2bc_zock);
         BXIERR_CHAIN(err, err2);
 
-        err2 = bxizmq_zocket_destroy(&self->data_zock);
+        err2 = _close_workers_zockets(self);
         BXIERR_CHAIN(err, err2);
 
+        if (NULL != self->ctrl_zock) {
+            err2 = bxizmq_zocket_destroy(&self->ctrl_zock);
+            BXIERR_CHAIN(err, err2);
+        }
+
         if (NULL != self->cfg_zock) {
             err2 = bxizmq_zocket_destroy(&self->cfg_zock);
             BXIERR_CHAIN(err, err2);
         }
 
         TRACE(LOGGER, "Closing the context");
-        err2 = bxizmq_context_destroy(&self->zmq_ctx);
-        BXIERR_CHAIN(err, err2);
+        if (_workers_detached(self)) {
+            // See bxilog_remote_receiver_stop()
+            self->zmq_ctx = NULL;
+        } else {
+            err2 = bxizmq_context_destroy(&self->zmq_ctx);
+            BXIERR_CHAIN(err, err2);
+        }
 
         return err;
     } else {
@@ -355,12 +558,13 @@ bxierr_p _recv_async(bxilog_remote_receiver_p self) {
     err2 = _recv_loop(self);
     BXIERR_CHAIN(err, err2);
 
+    // Workers are normally stopped on exit request, but not if the loop failed
+    err2 = _stop_workers(self, false);
+    BXIERR_CHAIN(err, err2);
+
     DEBUG(LOGGER, "Leaving");
     TRACE(LOGGER, "Closing the sockets");
 
-    err2 = bxizmq_zocket_destroy(&self->data_zock);
-    BXIERR_CHAIN(err, err2);
-
     err2 = bxizmq_zocket_destroy(&self->ctrl_zock);
     BXIERR_CHAIN(err, err2);
 
@@ -376,30 +580,24 @@ bxierr_p _recv_async(bxilog_remote_receiver_p self) {
 }
 
 bxierr_p _recv_loop(bxilog_remote_receiver_p self) {
-    bxierr_p err = BXIERR_OK, err2;
-
-    tsd_p tsd;
-    err2 = bxilog__tsd_get(&tsd);
-    BXIERR_CHAIN(err, err2);
-
-    if (bxierr_isko(err)) return err;
-
-    bool loop = true;
+    bxierr_p err = BXIERR_OK;
 
+    // Logs are received by the workers: only the control and configuration
+    // requests are processed here
     zmq_pollitem_t poller[] = {{self->it2bc_zock, 0, ZMQ_POLLIN, 0},
-                               {self->cfg_zock, 0, ZMQ_POLLIN, 0},
-                               {self->data_zock, 0, ZMQ_POLLIN, 0}};
+                               {self->cfg_zock, 0, ZMQ_POLLIN, 0}};
+    const int items_nb = (NULL == self->cfg_zock) ? 1 : 2;
 
-    while (loop) {
+    while (true) {
         errno = 0;
-        int rc =  zmq_poll(poller, 3, BXILOG_RECEIVER_POLLING_TIMEOUT);
+        int rc =  zmq_poll(poller, items_nb, BXILOG_RECEIVER_POLLING_TIMEOUT);
 
         if (0 == rc) continue;
         if (-1 == rc) return bxierr_errno("A problem occurs while polling");
 
         if (poller[0].revents & ZMQ_POLLIN) {
             // Control command received from BC
-            bxierr_p tmp = _process_ctrl_msg(self, tsd);
+            bxierr_p tmp = _process_ctrl_msg(self);
             if (bxierr_isko(tmp)) {
                 if (_EXIT_NORMAL_ERR == tmp->code) {
                     bxierr_destroy(&tmp);
@@ -411,27 +609,17 @@ bxierr_p _recv_loop(bxilog_remote_receiver_p self) {
                 break;
             }
         }
-        if (poller[1].revents & ZMQ_POLLIN) {
+        if (items_nb > 1 && (poller[1].revents & ZMQ_POLLIN)) {
             // Configuration request received from remote side
-            _process_cfg_request(self);
-        }
-
-        if (poller[2].revents & ZMQ_POLLIN) {
-            // Log received from remote side
-            char * header;
-            err2 = bxizmq_str_rcv(poller[2].socket, 0, false, &header);
-            BXIERR_CHAIN(err, err2);
-
-            err2 = _process_data_header(self, header, tsd, false);
-            BXIERR_CHAIN(err, err2);
-            BXIFREE(header);
-            if (bxierr_isko(err)) break;
+            bxierr_p tmp = _process_cfg_request(self);
+            BXILOG_REPORT(LOGGER, BXILOG_WARNING, tmp,
+                          "Problem while processing a configuration request");
         }
     }
     return err;
 }
 
-bxierr_p _process_ctrl_msg(bxilog_remote_receiver_p self, tsd_p tsd) {
+bxierr_p _process_ctrl_msg(bxilog_remote_receiver_p self) {
     bxierr_p err = BXIERR_OK, err2;
 
     char * msg;
@@ -454,74 +642,322 @@ bxierr_p _process_ctrl_msg(bxilog_remote_receiver_p self, tsd_p tsd) {
                                0, true, NULL);
         BXIERR_CHAIN(err, err2);
 
-        struct timespec last_message;
-        err2 = bxitime_get(CLOCK_MONOTONIC, &last_message);
+        err2 = _stop_workers(self, wait_remote_exit);
         BXIERR_CHAIN(err, err2);
+        BXILOG_REPORT(LOGGER, BXILOG_WARNING, err,
+                      "Problem while stopping the receiver workers");
 
-        // Fetch all remaining logs before exiting
-        while (true) {
-            char * header;
-            err2 = bxizmq_str_rcv(self->data_zock, ZMQ_DONTWAIT, false, &header);
+        FINE(LOGGER, "Sending back the exit confirmation message");
+        err2 = bxizmq_str_snd(BXILOG_RECEIVER_EXITING, self->it2bc_zock, 0, 2, 500);
+        BXIERR_CHAIN(err, err2);
+
+        return bxierr_new(_EXIT_NORMAL_ERR, NULL, NULL, NULL, err,
+                          "Normal error meaning exit");
+    }
+
+    err2 = bxierr_gen("Unknown control message received: '%s'", msg);
+    BXIFREE(msg);
+    return err2;
+}
+
+bxierr_p _start_workers(bxilog_remote_receiver_p self) {
+    bxierr_p err = BXIERR_OK, err2;
+
+    for (size_t i = 0; i < self->workers_nb; i++) {
+        worker_p worker = &self->workers[i];
+        err2 = bxitime_get(CLOCK_MONOTONIC, &worker->start);
+        BXIERR_CHAIN(err, err2);
+
+        // Sockets created here are only used by the worker from now on:
+        // pthread_create() provides the required memory barrier
+        int rc = pthread_create(&worker->thread, NULL,
+                                (void* (*) (void*)) _worker_loop, worker);
+        if (0 != rc) {
+            err2 = bxierr_fromidx(rc, NULL,
+                                  "Calling pthread_create() failed (rc=%d)", rc);
             BXIERR_CHAIN(err, err2);
+            break;
+        }
+        worker->started = true;
+    }
+    FINE(LOGGER, "%zu workers started", self->workers_nb);
 
-            // When ZMQ_DONTWAIT, if header == NULL it means we have nothing to receive
-            if (NULL == header) {
-                if (wait_remote_exit) {
-                    double duration = 0;
-                    err2 = bxitime_duration(CLOCK_MONOTONIC, last_message,
-                                            &duration);
-                    BXIERR_CHAIN(err, err2);
-                    if (0 < self->pub_connected && duration < 5.0) {
-                        LOWEST(LOGGER,
-                               "%zu publishers still connected and wait remote "
-                               "exit requested", self->pub_connected);
-                        bxierr_p tmp = bxitime_sleep(CLOCK_MONOTONIC, 0, 500000);
-                        bxierr_destroy(&tmp);
-                        continue;
-                    }
+    return err;
+}
+
+bxierr_p _stop_workers(bxilog_remote_receiver_p self, bool wait_remote_exit) {
+    bxierr_p err = BXIERR_OK, err2;
+
+    // First ask all workers to exit, they drain their queue concurrently
+    for (size_t i = 0; i < self->workers_nb; i++) {
+        worker_p worker = &self->workers[i];
+        if (!worker->started || worker->detached) continue;
+
+        TRACE(LOGGER, "Sending the exit message to worker %zu", i);
+        err2 = bxizmq_str_snd(BXILOG_RECEIVER_EXIT, worker->it_zock, ZMQ_SNDMORE, 2, 500);
+        BXIERR_CHAIN(err, err2);
+        err2 = bxizmq_data_snd(&wait_remote_exit, sizeof(wait_remote_exit),
+                               worker->it_zock, 0, 2, 500);
+        BXIERR_CHAIN(err, err2);
+    }
+
+    // Then wait all of them within a single deadline
+    struct timespec start;
+    err2 = bxitime_get(CLOCK_MONOTONIC, &start);
+    BXIERR_CHAIN(err, err2);
+    for (size_t i = 0; i < self->workers_nb; i++) {
+        worker_p worker = &self->workers[i];
+        if (!worker->started || worker->detached) continue;
+
+        double elapsed = 0;
+        err2 = bxitime_duration(CLOCK_MONOTONIC, start, &elapsed);
+        BXIERR_CHAIN(err, err2);
+        long timeout = BXILOG_RECEIVER_SYNC_TIMEOUT * 8 - (long) (elapsed * 1e3);
+
+        zmq_pollitem_t poller[] = {{worker->it_zock, 0, ZMQ_POLLIN, 0}};
+        int rc = zmq_poll(poller, 1, (timeout > 0) ? timeout : 0);
+        if (rc <= 0) {
+            // Joining it might block forever: leave it behind. Its sockets, the
+            // zmq context, its state and the receiver are never released then.
+            pthread_detach(worker->thread);
+            worker->detached = true;
+            err2 = bxierr_simple(BXIZMQ_TIMEOUT_ERR,
+                                 "Worker %zu did not exit in time", i);
+            BXIERR_CHAIN(err, err2);
+            continue;
+        }
+        char * msg = NULL;
+        err2 = bxizmq_str_rcv(worker->it_zock, 0, false, &msg);
+        BXIERR_CHAIN(err, err2);
+        BXIFREE(msg);
+
+        bxierr_p worker_err = BXIERR_OK;
+        rc = pthread_join(worker->thread, (void**) &worker_err);
+        if (0 != rc) {
+            err2 = bxierr_fromidx(rc, NULL,
+                                  "Calling pthread_join() failed (rc=%d)", rc);
+            BXIERR_CHAIN(err, err2);
+            continue;
+        }
+        BXIERR_CHAIN(err, worker_err);
+        worker->started = false;
+
+        double duration = 0;
+        err2 = bxitime_duration(CLOCK_MONOTONIC, worker->start, &duration);
+        BXIERR_CHAIN(err, err2);
+        DEBUG(LOGGER,
+              "Worker %zu: %zu records in %zu batches (%zu bytes), %zu errors, "
+              "%zu lost, %zu reordered, %.1f records/s",
+              i, worker->stats.records_nb, worker->stats.batches_nb,
+              worker->stats.bytes_nb, worker->stats.errors_nb,
+              worker->stats.lost_nb, worker->stats.reordered_nb,
+              (duration > 0) ? (double) worker->stats.records_nb / duration : 0.0);
+    }
+
+    for (size_t i = 0; i < self->workers_nb; i++) {
+        worker_p worker = &self->workers[i];
+        if (worker->started || NULL == worker->it_zock) continue;
+        err2 = bxizmq_zocket_destroy(&worker->it_zock);
+        BXIERR_CHAIN(err, err2);
+    }
+
+    return err;
+}
+
+bxierr_p _close_workers_zockets(bxilog_remote_receiver_p self) {
+    bxierr_p err = BXIERR_OK, err2;
+
+    for (size_t i = 0; i < self->workers_nb; i++) {
+        worker_p worker = &self->workers[i];
+        if (worker->started) continue;
+        if (NULL != worker->it_zock) {
+            err2 = bxizmq_zocket_destroy(&worker->it_zock);
+            BXIERR_CHAIN(err, err2);
+        }
+        if (NULL != worker->ctrl_zock) {
+            err2 = bxizmq_zocket_destroy(&worker->ctrl_zock);
+            BXIERR_CHAIN(err, err2);
+        }
+        if (NULL != worker->data_zock) {
+            err2 = bxizmq_zocket_destroy(&worker->data_zock);
+            BXIERR_CHAIN(err, err2);
+        }
+    }
+
+    return err;
+}
+
+bxierr_p _worker_loop(worker_p worker) {
+    bxierr_p err = BXIERR_OK, err2;
+
+    tsd_p tsd;
+    err2 = bxilog__tsd_get(&tsd);
+    BXIERR_CHAIN(err, err2);
+
+    zmq_pollitem_t poller[] = {{worker->ctrl_zock, 0, ZMQ_POLLIN, 0},
+                               {worker->data_zock, 0, ZMQ_POLLIN, 0}};
+
+    // Even on error, the worker waits for the exit request of the internal thread
+    const int items_nb = bxierr_isok(err) ? 2 : 1;
+
+    err2 = bxitime_get(CLOCK_MONOTONIC, &worker->last_summary);
+    BXIERR_CHAIN(err, err2);
+
+    while (true) {
+        errno = 0;
+        int rc =  zmq_poll(poller, items_nb, BXILOG_RECEIVER_POLLING_TIMEOUT);
+
+        _loss_summary(worker, false);
+
+        if (0 == rc) continue;
+        if (-1 == rc) {
+            if (EINTR == errno) continue;
+            err2 = bxierr_errno("A problem occurs while polling");
+            BXIERR_CHAIN(err, err2);
+            break;
+        }
+
+        if (poller[0].revents & ZMQ_POLLIN) {
+            // Control command received from the internal thread
+            bxierr_p tmp = _process_worker_ctrl_msg(worker, tsd);
+            if (bxierr_isko(tmp)) {
+                if (_EXIT_NORMAL_ERR == tmp->code) {
+                    bxierr_destroy(&tmp);
+                } else {
+                    BXIERR_CHAIN(err, tmp);
+                    BXILOG_REPORT(LOGGER, BXILOG_CRITICAL, err,
+                                  "An error occured in worker %zu, exiting",
+                                  worker->rank);
                 }
-                TRACE(LOGGER, "No remaining stuff to process, ready to exit");
                 break;
             }
+        }
 
-            TRACE(LOGGER, "Header '%s' remains to be processed while exiting", header);
-            err2 = _process_data_header(self, header, tsd, true);
-            BXIERR_CHAIN(err, err2);
-            BXIFREE(header);
-            if (bxierr_isko(err)) break;
-            err2 = bxitime_get(CLOCK_MONOTONIC, &last_message);
+        if (items_nb > 1 && (poller[1].revents & ZMQ_POLLIN)) {
+            // Log received from remote side
+            char * header;
+            err2 = bxizmq_str_rcv(worker->data_zock, 0, false, &header);
             BXIERR_CHAIN(err, err2);
+
+            if (NULL != header) {
+                err2 = _process_data_header(worker, header, tsd, false);
+                BXIERR_CHAIN(err, err2);
+                BXIFREE(header);
+            }
+            BXILOG_REPORT(LOGGER, BXILOG_WARNING, err,
+                          "Worker %zu: problem while receiving - continuing "
+                          "(best effort)", worker->rank);
         }
+    }
 
-        FINE(LOGGER, "Sending back the exit confirmation message");
-        err2 = bxizmq_str_snd(BXILOG_RECEIVER_EXITING, self->it2bc_zock, 0, 2, 500);
+    _loss_summary(worker, true);
+
+    TRACE(LOGGER, "Worker %zu: closing the sockets", worker->rank);
+    err2 = bxizmq_zocket_destroy(&worker->data_zock);
+    BXIERR_CHAIN(err, err2);
+
+    err2 = bxizmq_zocket_destroy(&worker->ctrl_zock);
+    BXIERR_CHAIN(err, err2);
+
+    return err;
+}
+
+bxierr_p _process_worker_ctrl_msg(worker_p worker, tsd_p tsd) {
+    bxierr_p err = BXIERR_OK, err2;
+
+    char * msg;
+    err2 = bxizmq_str_rcv(worker->ctrl_zock, 0, false, &msg);
+    BXIERR_CHAIN(err, err2);
+
+    if (bxierr_isko(err)) return err;
+
+    if (0 != strncmp(BXILOG_RECEIVER_EXIT, msg, ARRAYLEN(BXILOG_RECEIVER_EXIT) - 1)) {
+        err2 = bxierr_gen("Unknown control message received: '%s'", msg);
+        BXIFREE(msg);
+        return err2;
+    }
+    FINE(LOGGER, "Worker %zu: received message '%s' indicating to exit",
+         worker->rank, msg);
+    BXIFREE(msg);
+
+    bool wait_remote_exit;
+    bool *tmp_p = &wait_remote_exit;
+    err2 = bxizmq_data_rcv((void**)&tmp_p, sizeof(*tmp_p), worker->ctrl_zock,
+                           0, true, NULL);
+    BXIERR_CHAIN(err, err2);
+
+    struct timespec last_message;
+    err2 = bxitime_get(CLOCK_MONOTONIC, &last_message);
+    BXIERR_CHAIN(err, err2);
+
+    bxilog_remote_receiver_p self = worker->receiver;
+
+    // Fetch all remaining logs before exiting
+    while (NULL != worker->data_zock) {
+        char * header;
+        err2 = bxizmq_str_rcv(worker->data_zock, ZMQ_DONTWAIT, false, &header);
         BXIERR_CHAIN(err, err2);
 
-        return bxierr_simple(_EXIT_NORMAL_ERR, "Normal error meaning exit");
+        // When ZMQ_DONTWAIT, if header == NULL it means we have nothing to receive
+        if (NULL == header) {
+            if (wait_remote_exit) {
+                double duration = 0;
+                err2 = bxitime_duration(CLOCK_MONOTONIC, last_message,
+                                        &duration);
+                BXIERR_CHAIN(err, err2);
+                size_t pub_connected = __atomic_load_n(&self->pub_connected,
+                                                       __ATOMIC_RELAXED);
+                if (0 < pub_connected && duration < 5.0) {
+                    LOWEST(LOGGER,
+                           "%zu publishers still connected and wait remote "
+                           "exit requested", pub_connected);
+                    bxierr_p tmp = bxitime_sleep(CLOCK_MONOTONIC, 0, 500000);
+                    bxierr_destroy(&tmp);
+                    continue;
+                }
+            }
+            TRACE(LOGGER, "Worker %zu: no remaining stuff to process, ready to exit",
+                  worker->rank);
+            break;
+        }
+
+        TRACE(LOGGER, "Header '%s' remains to be processed while exiting", header);
+        err2 = _process_data_header(worker, header, tsd, true);
+        BXIERR_CHAIN(err, err2);
+        BXIFREE(header);
+        if (bxierr_isko(err)) break;
+        err2 = bxitime_get(CLOCK_MONOTONIC, &last_message);
+        BXIERR_CHAIN(err, err2);
     }
 
-    BXIFREE(msg);
-    return bxierr_gen("Unknown control message received: '%s'", msg);
+    FINE(LOGGER, "Worker %zu: sending back the exit confirmation message", worker->rank);
+    err2 = bxizmq_str_snd(BXILOG_RECEIVER_EXITING, worker->ctrl_zock, 0, 2, 500);
+    BXIERR_CHAIN(err, err2);
+
+    return bxierr_new(_EXIT_NORMAL_ERR, NULL, NULL, NULL, err,
+                      "Normal error meaning exit");
 }
 
 
-bxierr_p _process_data_header(bxilog_remote_receiver_p self, char *header, tsd_p tsd,
+bxierr_p _process_data_header(worker_p worker, char *header, tsd_p tsd,
                               bool exiting) {
-    BXIASSERT(LOGGER, NULL != self);
+    BXIASSERT(LOGGER, NULL != worker);
     BXIASSERT(LOGGER, NULL != header);
 
+    bxilog_remote_receiver_p self = worker->receiver;
+
     if (0 == strncmp(BXIZMQ_PUBSUB_SYNC_HEADER, header,
                      ARRAYLEN(BXIZMQ_PUBSUB_SYNC_HEADER) - 1)) {
         // Synchronization required
         TRACE(LOGGER, "Received sync message");
         if (exiting) {
             char * sync_url = NULL;
-            bxierr_p err = bxizmq_str_rcv(self->data_zock,
+            bxierr_p err = bxizmq_str_rcv(worker->data_zock,
                                           ZMQ_DONTWAIT, false, &sync_url);
             BXIFREE(sync_url);
             return err;
         }
-        bxierr_p err = bxizmq_sub_sync_manage(self->zmq_ctx, self->data_zock);
+        bxierr_p err = bxizmq_sub_sync_manage(worker->zmq_ctx, worker->data_zock);
         BXILOG_REPORT(LOGGER, BXILOG_WARNING, err,
                       "Problem during SUB synchronization - continuing (best effort)");
         return BXIERR_OK;
@@ -530,19 +966,20 @@ bxierr_p _process_data_header(bxilog_remote_receiver_p self, char *header, tsd_p
                      ARRAYLEN(BXILOG_REMOTE_HANDLER_EXITING_HEADER) - 1)) {
         // One other end has exited, fetch its URL
         char * url = NULL;
-        bxierr_p err = bxizmq_str_rcv(self->data_zock, 0, true, &url);
+        bxierr_p err = bxizmq_str_rcv(worker->data_zock, 0, true, &url);
         if (bxierr_isko(err)) return err;
-        self->pub_connected--;
+        size_t pub_connected = __atomic_sub_fetch(&self->pub_connected, 1,
+                                                  __ATOMIC_RELAXED);
         FINE(LOGGER,
              "Publisher %s has sent its exit message. "
              "Number of connected publishers: %zu",
-             url, self->pub_connected);
+             url, pub_connected);
         BXIFREE(url);
         return BXIERR_OK;
     }
     if (0 == strncmp(BXILOG_REMOTE_HANDLER_RECORD_HEADER,
                      header, ARRAYLEN(BXILOG_REMOTE_HANDLER_RECORD_HEADER)-1)) {
-        bxierr_p err  = _process_new_log(self, tsd);
+        bxierr_p err  = _process_new_log(worker, tsd);
         BXILOG_REPORT(LOGGER, BXILOG_WARNING, err,
                       "Problem while receiving bxilog record - continuing (best effort)");
         return BXIERR_OK;
@@ -555,41 +992,54 @@ bxierr_p _process_data_header(bxilog_remote_receiver_p self, char *header, tsd_p
     return BXIERR_OK;
 }
 
-bxierr_p _recv_log_record(void * zock, bxilog_record_p * record_p, size_t * record_len) {
+bxierr_p _recv_log_batch(void * zock, zmq_msg_t * zmsg,
+                         bxilog__wire_decoder_p decoder) {
 
     bxierr_p err = BXIERR_OK, err2;
 
-    // Initialize
-    *record_p = NULL;
-    *record_len = 0;
-
-    bxilog_record_p record = NULL;
-    size_t size;
-    err2 = bxizmq_data_rcv((void**)&record, 0, zock, 0, true, &size);
+    err2 = bxizmq_msg_rcv(zock, zmsg, 0);
     BXIERR_CHAIN(err, err2);
+    if (bxierr_isko(err)) return err;
 
-    size_t expected_len = sizeof(*record) + \
-            record->filename_len + \
-            record->funcname_len + \
-            record->logname_len + \
-            record->logmsg_len;
-
-    if (size != expected_len) {
-        return bxierr_simple(_BAD_RECORD_ERR,
-                             "Wrong bxilog record: expected size=%zu, received size=%zu",
-                             expected_len, size);
+    size_t size = zmq_msg_size(zmsg);
+    err2 = bxilog__wire_decoder_init(decoder, zmq_msg_data(zmsg), size);
+    BXIERR_CHAIN(err, err2);
+    if (bxierr_isko(err)) {
+        return bxierr_new(_BAD_RECORD_ERR, NULL, NULL, NULL, err,
+                          "Wrong bxilog batch received, size=%zu", size);
     }
-    LOWEST(LOGGER, "Record received, size: %zu", size);
 
-    if (bxierr_isok(err)) {
-        *record_p = record;
-        *record_len = size;
-    }
+    LOWEST(LOGGER, "Batch received, size: %zu, records: %u", size, decoder->records_nb);
+
     return err;
 }
 
 
-bxierr_p _dispatch_log_record(tsd_p tsd, bxilog_record_p record, size_t data_len) {
+bxierr_p _new_record_zmsg(bxilog__wire_decoder_p decoder, zmq_msg_t * zmsg) {
+
+    bxilog_record_s record;
+    const char * strings;
+    bxierr_p err = bxilog__wire_decode_record(decoder, &record, &strings);
+    if (bxierr_isko(err)) return err;
+
+    const size_t var_len = record.filename_len + record.funcname_len + \
+                           record.logname_len + record.logmsg_len;
+
+    // The decoded record is built directly in the message sent to the handlers:
+    // this is the only copy of the record in the receiver
+    errno = 0;
+    int rc = zmq_msg_init_size(zmsg, sizeof(record) + var_len);
+    if (0 != rc) return bxizmq_err(errno, "Can't initialize a zmq message of size %zu",
+                                   sizeof(record) + var_len);
+
+    char * data = zmq_msg_data(zmsg);
+    memcpy(data, &record, sizeof(record));
+    memcpy(data + sizeof(record), strings, var_len);
+
+    return err;
+}
+
+bxierr_p _dispatch_log_record(tsd_p tsd, zmq_msg_t * zmsg) {
 
     bxierr_p err = BXIERR_OK, err2;
 
@@ -599,22 +1049,25 @@ bxierr_p _dispatch_log_record(tsd_p tsd, bxilog_record_p record, size_t data_len
 
     for (size_t i = 0; i < BXILOG__GLOBALS->internal_handlers_nb; i++) {
       // Send the frame
-      // normal version if record comes from the stack 'buf'
       err2 = bxizmq_data_snd(&i, sizeof(i),
                              tsd->data_channel, ZMQ_DONTWAIT|ZMQ_SNDMORE,
                              BXILOG_RECEIVER_RETRIES_MAX,
                              BXILOG_RECEIVER_RETRY_DELAY);
       BXIERR_CHAIN(err, err2);
-      err2 = bxizmq_data_snd(record, data_len,
-                             tsd->data_channel, ZMQ_DONTWAIT,
-                             BXILOG_RECEIVER_RETRIES_MAX,
-                             BXILOG_RECEIVER_RETRY_DELAY);
 
-      // Zero-copy version (if record has been mallocated).
-      //            err2 = bxizmq_data_snd_zc(record, data_len,
-      //                                      tsd->data_channel, ZMQ_DONTWAIT,
-      //                                      RETRIES_MAX, RETRY_DELAY,
-      //                                      bxizmq_data_free, NULL);
+      // Each handler receives a reference on the same record: zmq_msg_copy()
+      // does not copy the content, it is released with the last reference
+      zmq_msg_t copy;
+      err2 = bxizmq_msg_init(&copy);
+      BXIERR_CHAIN(err, err2);
+      err2 = bxizmq_msg_copy(zmsg, &copy);
+      BXIERR_CHAIN(err, err2);
+      err2 = bxizmq_msg_snd(&copy,
+                            tsd->data_channel, ZMQ_DONTWAIT,
+                            BXILOG_RECEIVER_RETRIES_MAX,
+                            BXILOG_RECEIVER_RETRY_DELAY);
+      BXIERR_CHAIN(err, err2);
+      err2 = bxizmq_msg_close(&copy);
       BXIERR_CHAIN(err, err2);
     }
 
@@ -635,9 +1088,24 @@ bxierr_p _connect_zocket(bxilog_remote_receiver_p self) {
     err2 = bxizmq_zocket_create(self->zmq_ctx, ZMQ_DEALER, &self->ctrl_zock);
     BXIERR_CHAIN(err, err2);
 
-    TRACE(LOGGER, "Creating data zocket");
-    err2 = bxizmq_zocket_create(self->zmq_ctx, ZMQ_SUB, &self->data_zock);
-    BXIERR_CHAIN(err, err2);
+    TRACE(LOGGER, "Creating %zu workers zockets", self->workers_nb);
+    for (size_t w = 0; w < self->workers_nb; w++) {
+        worker_p worker = &self->workers[w];
+        // Kept by the worker: the receiver forgets it when the worker is left behind
+        worker->zmq_ctx = self->zmq_ctx;
+        err2 = bxizmq_zocket_create(self->zmq_ctx, ZMQ_SUB, &worker->data_zock);
+        BXIERR_CHAIN(err, err2);
+
+        char * url = bxistr_new("%s/%zu", BXILOG_REMOTE_RECEIVER_WORKER_URL, w);
+        err2 = bxizmq_zocket_create_binded(self->zmq_ctx, ZMQ_PAIR, url, NULL,
+                                           &worker->it_zock);
+        BXIERR_CHAIN(err, err2);
+        err2 = bxizmq_zocket_create_connected(self->zmq_ctx, ZMQ_PAIR, url,
+                                              &worker->ctrl_zock);
+        BXIERR_CHAIN(err, err2);
+        BXIFREE(url);
+    }
+    if (bxierr_isko(err)) return err;
 
     FINE(LOGGER, "Binding/connecting zocket to %zu urls", self->urls_nb);
     for (size_t i = 0; i < self->urls_nb; i++) {
@@ -664,15 +1132,27 @@ bxierr_p _connect_zocket(bxilog_remote_receiver_p self) {
             self->ctrl_urls[i] = bxizmq_create_url_from(url, port);
             FINE(LOGGER, "Control zocket binded to '%s", self->ctrl_urls[i]);
 
-            url = NULL;
-            bxizmq_generate_new_url_from(self->cfg_urls[i], &url);
-            TRACE(LOGGER,
-                  "Binding data zocket to url: '%s'", url);
-            port = 0;
-            err2 = bxizmq_zocket_bind(self->data_zock, url, &port);
-            BXIERR_CHAIN(err, err2);
-            self->data_urls[i] = bxizmq_create_url_from(url, port);
-            FINE(LOGGER, "Data zocket binded to '%s", self->data_urls[i]);
+            // Each worker binds its own data zocket, publishers are spread
+            // among workers by _process_cfg_request()
+            for (size_t w = 0; w < self->workers_nb; w++) {
+                worker_p worker = &self->workers[w];
+                url = NULL;
+                bxizmq_generate_new_url_from(self->cfg_urls[i], &url);
+                TRACE(LOGGER,
+                      "Binding worker %zu data zocket to url: '%s'", w, url);
+                port = 0;
+                err2 = bxizmq_zocket_bind(worker->data_zock, url, &port);
+                BXIERR_CHAIN(err, err2);
+                char * data_url = bxizmq_create_url_from(url, port);
+                FINE(LOGGER, "Worker %zu data zocket binded to '%s", w, data_url);
+                // Publishers are given the first url only
+                if (NULL == worker->data_url) {
+                    worker->data_url = data_url;
+                } else {
+                    BXIFREE(data_url);
+                }
+            }
+            self->data_urls[i] = strdup(self->workers[0].data_url);
         } else {
             self->ctrl_urls[i] = strdup(self->urls[i]);
             TRACE(LOGGER, "Connecting control zocket to url: '%s'", self->ctrl_urls[i]);
@@ -696,18 +1176,22 @@ bxierr_p _connect_zocket(bxilog_remote_receiver_p self) {
             err2 = bxizmq_str_rcv(self->ctrl_zock, 0, false, &url);
             BXIERR_CHAIN(err, err2);
 
-            TRACE(LOGGER, "Connecting data zocket to url: '%s'", url);
-            err2 = bxizmq_zocket_connect(self->data_zock, url);
+            // Publishers are spread among workers
+            worker_p worker = &self->workers[i % self->workers_nb];
+            TRACE(LOGGER, "Connecting worker %zu data zocket to url: '%s'",
+                  worker->rank, url);
+            err2 = bxizmq_zocket_connect(worker->data_zock, url);
             BXIERR_CHAIN(err, err2);
 
             self->data_urls[i] = url;
         }
     }
 
-    if (NULL != self->data_zock) {
-        TRACE(LOGGER, "Updating the subscription to everything on data zocket");
+    TRACE(LOGGER, "Updating the subscription to everything on data zockets");
+    for (size_t w = 0; w < self->workers_nb; w++) {
         char * tree = "";
-        err2 = bxizmq_zocket_setopt(self->data_zock, ZMQ_SUBSCRIBE, tree, strlen(tree));
+        err2 = bxizmq_zocket_setopt(self->workers[w].data_zock, ZMQ_SUBSCRIBE,
+                                    tree, strlen(tree));
         BXIERR_CHAIN(err, err2);
     }
 
@@ -739,32 +1223,47 @@ bxierr_p _connect_zocket(bxilog_remote_receiver_p self) {
 //}
 
 
-bxierr_p _process_new_log(bxilog_remote_receiver_p self, tsd_p tsd) {
+bxierr_p _process_new_log(worker_p worker, tsd_p tsd) {
     bxierr_p err = BXIERR_OK, err2;
 
-    bxilog_record_p record;
-    size_t record_len;
+    zmq_msg_t zmsg;
+    err2 = bxizmq_msg_init(&zmsg);
+    BXIERR_CHAIN(err, err2);
+    if (bxierr_isko(err)) return err;
 
-    bxierr_p tmp = _recv_log_record(self->data_zock, &record, &record_len);
+    bxilog__wire_decoder_s decoder;
+    bxierr_p tmp = _recv_log_batch(worker->data_zock, &zmsg, &decoder);
 
     if (bxierr_isko(tmp)) {
-        bxierr_report_keep(tmp, STDERR_FILENO);
-        if (_BAD_HEADER_ERR == tmp->code) {
-            LOWEST(LOGGER,
-                   "Skipping bad header error, looks like a "
-                   "PUB/SUB sync. Error message is: %s", tmp->msg);
-            bxierr_destroy(&tmp);
-        } else {
-            BXILOG_REPORT(LOGGER, BXILOG_WARNING, tmp,
-                          "An error occured while retrieving a bxilog record, "
-                          "a message might be missing");
-        }
+        __atomic_add_fetch(&worker->stats.errors_nb, 1, __ATOMIC_RELAXED);
+        BXILOG_REPORT(LOGGER, BXILOG_WARNING, tmp,
+                      "An error occured while retrieving a bxilog batch, "
+                      "messages might be missing");
     } else {
-        err2 = _dispatch_log_record(tsd, record, record_len);
-        BXIERR_CHAIN(err, err2);
+        __atomic_add_fetch(&worker->stats.batches_nb, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&worker->stats.bytes_nb, decoder.len, __ATOMIC_RELAXED);
+        if (decoder.sequenced) _account_sequence(worker, &decoder);
+        while (bxilog__wire_decoder_has_next(&decoder)) {
+            zmq_msg_t record_zmsg;
+            tmp = _new_record_zmsg(&decoder, &record_zmsg);
+            if (bxierr_isko(tmp)) {
+                __atomic_add_fetch(&worker->stats.errors_nb, 1, __ATOMIC_RELAXED);
+                BXILOG_REPORT(LOGGER, BXILOG_WARNING, tmp,
+                              "Wrong bxilog record in batch, "
+                              "%u remaining messages are lost",
+                              decoder.records_nb - decoder.decoded_nb);
+                break;
+            }
+            err2 = _dispatch_log_record(tsd, &record_zmsg);
+            BXIERR_CHAIN(err, err2);
+            __atomic_add_fetch(&worker->stats.records_nb, 1, __ATOMIC_RELAXED);
+            err2 = bxizmq_msg_close(&record_zmsg);
+            BXIERR_CHAIN(err, err2);
+        }
     }
 
-    BXIFREE(record);
+    err2 = bxizmq_msg_close(&zmsg);
+    BXIERR_CHAIN(err, err2);
 
     return err;
 }
@@ -828,20 +1327,166 @@ bxierr_p _process_cfg_request(bxilog_remote_receiver_p self) {
         err2 = bxizmq_str_snd(self->ctrl_urls[i], self->cfg_zock, ZMQ_SNDMORE, 0, 0);
         BXIERR_CHAIN(err, err2);
     }
-    // Then all data urls
+    // Then the data url of the worker in charge of this publisher
+    worker_p worker = &self->workers[self->next_worker];
+    self->next_worker = (self->next_worker + 1) % self->workers_nb;
     for (size_t i = 0; i < self->urls_nb - 1; i++) {
-        err2 = bxizmq_str_snd(self->data_urls[i], self->cfg_zock, ZMQ_SNDMORE, 0, 0);
+        err2 = bxizmq_str_snd(worker->data_url, self->cfg_zock, ZMQ_SNDMORE, 0, 0);
         BXIERR_CHAIN(err, err2);
     }
     // Then last frame
-    err2 = bxizmq_str_snd(self->data_urls[self->urls_nb - 1], self->cfg_zock, 0, 0, 0);
+    err2 = bxizmq_str_snd(worker->data_url, self->cfg_zock, 0, 0, 0);
     BXIERR_CHAIN(err, err2);
 
-    self->pub_connected++;
+    size_t pub_connected = __atomic_add_fetch(&self->pub_connected, 1,
+                                              __ATOMIC_RELAXED);
     FINE(LOGGER,
-         "New publisher synchronization completed. "
+         "New publisher synchronization completed, assigned to worker %zu. "
          "Number of connected publishers: %zu",
-         self->pub_connected);
+         worker->rank, pub_connected);
 
     return err;
 }
+
+void _free_workers(bxilog_remote_receiver_p self) {
+    if (_workers_detached(self)) {
+        // Still used by a worker left behind: leaked on purpose
+        self->workers = NULL;
+        return;
+    }
+    for (size_t i = 0; NULL != self->workers && i < self->workers_nb; i++) {
+        worker_p worker = &self->workers[i];
+        BXIFREE(worker->data_url);
+        for (size_t p = 0; p < worker->publishers_size; p++) {
+            BXIFREE(worker->publishers[p].source);
+        }
+        BXIFREE(worker->publishers);
+        pthread_mutex_destroy(&worker->publishers_lock);
+    }
+    BXIFREE(self->workers);
+}
+
+bool _workers_detached(bxilog_remote_receiver_p self) {
+    for (size_t i = 0; NULL != self->workers && i < self->workers_nb; i++) {
+        if (self->workers[i].detached) return true;
+    }
+    return false;
+}
+
+publisher_p _get_publisher(worker_p worker, const char * source, size_t len) {
+    if (2 * (worker->publishers_nb + 1) > worker->publishers_size) {
+        // Keep the load factor below 1/2: move everything to a larger table
+        const size_t old_size = worker->publishers_size;
+        publisher_p old = worker->publishers;
+        worker->publishers_size = (0 == old_size) ? BXILOG_RECEIVER_PUBLISHERS_INIT_SIZE
+                                                  : 2 * old_size;
+        worker->publishers = bximem_calloc(worker->publishers_size * sizeof(*old));
+        for (size_t i = 0; i < old_size; i++) {
+            if (NULL == old[i].source) continue;
+            *_publisher_slot(worker, old[i].source, old[i].source_len) = old[i];
+        }
+        BXIFREE(old);
+    }
+
+    publisher_p pub = _publisher_slot(worker, source, len);
+    if (NULL == pub->source) {
+        pub->source = bximem_calloc(len + 1);
+        memcpy(pub->source, source, len);
+        pub->source_len = len;
+        worker->publishers_nb++;
+    }
+    return pub;
+}
+
+publisher_p _publisher_slot(worker_p worker, const char * source, size_t len) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ (uint8_t) source[i]) * 1099511628211ULL;
+    }
+
+    const size_t mask = worker->publishers_size - 1;
+    for (size_t i = (size_t) hash & mask;; i = (i + 1) & mask) {
+        publisher_p pub = &worker->publishers[i];
+        if (NULL == pub->source) return pub;
+        if (pub->source_len == len && 0 == memcmp(pub->source, source, len)) return pub;
+    }
+}
+
+void _account_sequence(worker_p worker, bxilog__wire_decoder_p decoder) {
+    const uint64_t first = decoder->first_seq;
+    const size_t n = decoder->records_nb;
+    size_t lost = 0, reordered = 0, found = 0;
+
+    pthread_mutex_lock(&worker->publishers_lock);
+    publisher_p pub = _get_publisher(worker, decoder->source, decoder->source_len);
+    const bool new_pub = (0 == pub->received_nb && 0 == pub->lost_nb);
+
+    if (new_pub || first == pub->next_seq) {
+        // Records sent before the subscription are not lost
+        pub->next_seq = first + n;
+    } else if (first > pub->next_seq) {
+        lost = (size_t) (first - pub->next_seq);
+        pub->lost_nb += lost;
+        pub->next_seq = first + n;
+    } else if (0 == first) {
+        // The publisher has been restarted with the same identifier
+        pub->next_seq = n;
+    } else {
+        // Late batch: its records have already been accounted as lost
+        reordered = n;
+        found = (reordered < pub->lost_nb) ? reordered : pub->lost_nb;
+        pub->reordered_nb += reordered;
+        pub->lost_nb -= found;
+    }
+    pub->received_nb += n;
+    pthread_mutex_unlock(&worker->publishers_lock);
+
+    if (0 != lost) {
+        __atomic_add_fetch(&worker->stats.lost_nb, lost, __ATOMIC_RELAXED);
+    }
+    if (0 != reordered) {
+        __atomic_add_fetch(&worker->stats.reordered_nb, reordered, __ATOMIC_RELAXED);
+        __atomic_sub_fetch(&worker->stats.lost_nb, found, __ATOMIC_RELAXED);
+    }
+}
+
+void _loss_summary(worker_p worker, bool force) {
+    double elapsed = 0;
+    bxierr_p tmp = bxitime_duration(CLOCK_MONOTONIC, worker->last_summary, &elapsed);
+    bxierr_destroy(&tmp);
+    if (!force && elapsed < BXILOG_RECEIVER_LOSS_SUMMARY_PERIOD_S) return;
+
+    tmp = bxitime_get(CLOCK_MONOTONIC, &worker->last_summary);
+    bxierr_destroy(&tmp);
+
+    // Only the worker itself updates its counters
+    const size_t lost = worker->stats.lost_nb;
+    const size_t reordered = worker->stats.reordered_nb;
+    if (lost == worker->summary_lost_nb && reordered == worker->summary_reordered_nb) {
+        return;
+    }
+
+    WARNING(LOGGER,
+            "Worker %zu: %zd records lost and %zu reordered in the last %.1fs "
+            "(total: %zu lost, %zu reordered, %zu received)",
+            worker->rank,
+            (ssize_t) (lost - worker->summary_lost_nb),
+            reordered - worker->summary_reordered_nb,
+            elapsed, lost, reordered, worker->stats.records_nb);
+
+    pthread_mutex_lock(&worker->publishers_lock);
+    for (size_t i = 0; i < worker->publishers_size; i++) {
+        publisher_p pub = &worker->publishers[i];
+        if (NULL == pub->source || (0 == pub->lost_nb && 0 == pub->reordered_nb)) {
+            continue;
+        }
+        DEBUG(LOGGER, "Worker %zu: publisher %s: %zu received, %zu lost, %zu reordered",
+              worker->rank, pub->source,
+              pub->received_nb, pub->lost_nb, pub->reordered_nb);
+    }
+    pthread_mutex_unlock(&worker->publishers_lock);
+
+    worker->summary_lost_nb = lost;
+    worker->summary_reordered_nb = reordered;
+}
@@ -0,0 +1,424 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+
+#include "bxi/base/err.h"
+#include "bxi/base/mem.h"
+#include "bxi/base/str.h"
+#include "bxi/base/zmq.h"
+#include "bxi/base/log.h"
+
+#include "log_impl.h"
+#include "tsd_impl.h"
+#include "handler_impl.h"
+#include "inline_impl.h"
+#include "stats_impl.h"
+
+//*********************************************************************************
+//********************************** Defines **************************************
+//*********************************************************************************
+
+#define SUB_BUCKETS_NB (1u << BXILOG_HISTOGRAM_SUB_BITS)
+
+//*********************************************************************************
+//********************************** Types ****************************************
+//*********************************************************************************
+
+//*********************************************************************************
+//********************************** Static Functions  ****************************
+//*********************************************************************************
+static bxierr_p _get_handler_stats(size_t handler_rank, bxilog_handler_stats_p stats);
+static void * _stats_thread(void * dummy);
+static void _log_period(void);
+static void _log_stats(bxilog_stats_p stats);
+static void _log_talkers(size_t handler_rank, const char * title,
+                         const bxilog_talker_s * talkers);
+static size_t _histogram_index(uint64_t value);
+static uint64_t _histogram_upper(size_t index);
+
+//*********************************************************************************
+//********************************** Global Variables  ****************************
+//*********************************************************************************
+
+SET_LOGGER(LOGGER, BXILOG_LIB_PREFIX "bxilog.stats");
+
+// Periodic statistics are gathered by a thread of their own: asking the handlers
+// is a round trip no logging thread should wait for
+static pthread_t STATS_THREAD;
+static bool STATS_RUNNING = false;
+// Protect STATS_STOP, STATS_COND wakes the thread up when it is set
+static pthread_mutex_t STATS_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t STATS_COND;
+static bool STATS_STOP = false;
+
+//*********************************************************************************
+//********************************** Implementation    ****************************
+//*********************************************************************************
+
+bxierr_p bxilog_stats_get(bxilog_stats_p * result) {
+    bxiassert(NULL != result);
+
+    *result = NULL;
+    if (INITIALIZED != BXILOG__GLOBALS->state) {
+        return bxierr_new(BXILOG_ILLEGAL_STATE_ERR, NULL, NULL, NULL, NULL,
+                          "Illegal state: %d", BXILOG__GLOBALS->state);
+    }
+
+    bxilog_config_p config = BXILOG__GLOBALS->config;
+    const bool inlined = bxilog__inline_mode();
+    bxilog_stats_p stats = bximem_calloc(sizeof(*stats));
+    stats->handlers_nb = config->handlers_nb;
+    stats->handlers = bximem_calloc(stats->handlers_nb * sizeof(*stats->handlers));
+
+    bxierr_list_p errlist = bxierr_list_new();
+    for (size_t i = 0; i < stats->handlers_nb; i++) {
+        bxilog_handler_stats_p hstats = &stats->handlers[i];
+        bxierr_p err = BXIERR_OK;
+        if (inlined) {
+            err = bxilog__inline_stats(i, hstats);
+        } else if (i < BXILOG__GLOBALS->internal_handlers_nb &&
+                   ESRCH != pthread_kill(BXILOG__GLOBALS->handlers_threads[i], 0)) {
+            err = _get_handler_stats(i, hstats);
+        }
+        if (bxierr_isko(err)) bxierr_list_append(errlist, err);
+
+        hstats->name = (NULL == config->handlers[i]) ? NULL :
+                       strdup(config->handlers[i]->name);
+        hstats->dropped_nb = __atomic_load_n(&BXILOG__GLOBALS->handlers_dropped[i],
+                                             __ATOMIC_RELAXED);
+        hstats->retried_nb = __atomic_load_n(&BXILOG__GLOBALS->handlers_retried[i],
+                                             __ATOMIC_RELAXED);
+    }
+
+    // Logs are counted before being sent: gathered after the handlers counters,
+    // there are at least as many of them as records processed by any handler.
+    stats->min_log_size = SIZE_MAX;
+    bxilog__tsd_stats(stats);
+    if (SIZE_MAX == stats->min_log_size) stats->min_log_size = 0;
+
+    // Inline handlers have no queue. Otherwise, each log is sent to all handlers.
+    for (size_t i = 0; !inlined && i < stats->handlers_nb; i++) {
+        bxilog_handler_stats_p hstats = &stats->handlers[i];
+        const size_t done = hstats->processed_nb + hstats->filtered_nb + hstats->dropped_nb;
+        hstats->queue_depth = (stats->log_nb > done) ? stats->log_nb - done : 0;
+    }
+
+    *result = stats;
+    if (0 < errlist->errors_nb) {
+        return bxierr_from_list(BXILOG_STATS_ERR,
+                                errlist,
+                                "At least one error occured while "
+                                "gathering statistics of %zu handlers.",
+                                stats->handlers_nb);
+    }
+    bxierr_list_destroy(&errlist);
+
+    return BXIERR_OK;
+}
+
+void bxilog_stats_destroy(bxilog_stats_p * stats_p) {
+    bxiassert(NULL != stats_p);
+
+    bxilog_stats_p stats = *stats_p;
+    if (NULL == stats) return;
+
+    for (size_t i = 0; i < stats->handlers_nb; i++) BXIFREE(stats->handlers[i].name);
+    BXIFREE(stats->handlers);
+    BXIFREE(*stats_p);
+}
+
+void bxilog_histogram_add(bxilog_histogram_p self, uint64_t value) {
+    if (0 == self->count || value < self->min) self->min = value;
+    if (value > self->max) self->max = value;
+    self->count++;
+    self->sum += value;
+    self->buckets[_histogram_index(value)]++;
+}
+
+uint64_t bxilog_histogram_percentile(const bxilog_histogram_p self, double percentile) {
+    if (0 == self->count) return 0;
+
+    // Rank of the requested value among the recorded ones, rounded up
+    const double target = percentile * (double) self->count / 100;
+    uint64_t rank = (uint64_t) target;
+    if ((double) rank < target) rank++;
+    if (0 == rank) rank = 1;
+    if (rank > self->count) rank = self->count;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BXILOG_HISTOGRAM_BUCKETS_NB; i++) {
+        seen += self->buckets[i];
+        if (seen < rank) continue;
+        // The last bucket also holds the out of range values
+        uint64_t result = (BXILOG_HISTOGRAM_BUCKETS_NB - 1 == i) ? self->max :
+                                                                    _histogram_upper(i);
+        if (result > self->max) result = self->max;
+        if (result < self->min) result = self->min;
+        return result;
+    }
+    return self->max;
+}
+
+void bxilog__stats_reset(void) {
+    bxilog__tsd_stats_reset();
+}
+
+bxierr_p bxilog__stats_start(void) {
+    if (0 >= BXILOG__GLOBALS->config->stats_period_ms) return BXIERR_OK;
+    bxiassert(!STATS_RUNNING);
+
+    pthread_condattr_t attr;
+    int rc = pthread_condattr_init(&attr);
+    bxiassert(0 == rc);
+    // The period does not depend on the wall clock
+    rc = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    bxiassert(0 == rc);
+    rc = pthread_cond_init(&STATS_COND, &attr);
+    bxiassert(0 == rc);
+    rc = pthread_condattr_destroy(&attr);
+    bxiassert(0 == rc);
+
+    STATS_STOP = false;
+    rc = pthread_create(&STATS_THREAD, NULL, _stats_thread, NULL);
+    if (0 != rc) {
+        int rc2 = pthread_cond_destroy(&STATS_COND);
+        bxiassert(0 == rc2);
+        return bxierr_fromidx(rc, NULL, "Calling pthread_create() failed (rc=%d)", rc);
+    }
+    STATS_RUNNING = true;
+
+    return BXIERR_OK;
+}
+
+bxierr_p bxilog__stats_stop(void) {
+    if (!STATS_RUNNING) return BXIERR_OK;
+
+    int rc = pthread_mutex_lock(&STATS_MUTEX);
+    bxiassert(0 == rc);
+    STATS_STOP = true;
+    rc = pthread_cond_signal(&STATS_COND);
+    bxiassert(0 == rc);
+    rc = pthread_mutex_unlock(&STATS_MUTEX);
+    bxiassert(0 == rc);
+
+    STATS_RUNNING = false;
+    rc = pthread_join(STATS_THREAD, NULL);
+    if (0 != rc) return bxierr_fromidx(rc, NULL, "Calling pthread_join() failed (rc=%d)", rc);
+    rc = pthread_cond_destroy(&STATS_COND);
+    bxiassert(0 == rc);
+
+    return BXIERR_OK;
+}
+
+void bxilog__stats_child_after_fork(void) {
+    // The statistics thread does not exist in the child: it is started again with
+    // the handlers
+    int rc = pthread_mutex_init(&STATS_MUTEX, NULL);
+    bxiassert(0 == rc);
+    STATS_RUNNING = false;
+}
+
+//*********************************************************************************
+//********************************** Static Helpers Implementation ****************
+//*********************************************************************************
+
+bxierr_p _get_handler_stats(size_t handler_rank, bxilog_handler_stats_p stats) {
+    bxierr_p err = BXIERR_OK, err2;
+
+    // The thread control channel is load-balanced over all handlers:
+    // a dedicated one is required to reach a given handler.
+    void * zocket = NULL;
+    const char * url = BXILOG__GLOBALS->config->handlers_params[handler_rank]->ctrl_url;
+    err2 = bxizmq_zocket_create_connected(BXILOG__GLOBALS->zmq_ctx, ZMQ_REQ,
+                                          url, &zocket);
+    BXIERR_CHAIN(err, err2);
+    if (bxierr_isko(err)) return err;
+
+    err2 = bxizmq_str_snd(STATS_CTRL_MSG_REQ, zocket, 0, 0, 0);
+    BXIERR_CHAIN(err, err2);
+    if (bxierr_isko(err)) goto QUIT;
+
+    // A stuck handler must not block the statistics thread, and therefore
+    // bxilog_finalize(), forever
+    const long timeout = BXILOG__GLOBALS->config->handlers_deadline_ms;
+    zmq_pollitem_t items[] = {{zocket, 0, ZMQ_POLLIN, 0}};
+    int rc;
+    do {
+        errno = 0;
+        rc = zmq_poll(items, 1, timeout);
+    } while (-1 == rc && EINTR == errno);
+    if (-1 == rc) {
+        err2 = bxierr_errno("Calling zmq_poll() failed");
+        BXIERR_CHAIN(err, err2);
+        goto QUIT;
+    }
+    if (0 == rc) {
+        err2 = bxierr_new(BXIZMQ_TIMEOUT_ERR, NULL, NULL, NULL, NULL,
+                          "Handler %zu did not send its statistics within %ld ms",
+                          handler_rank, timeout);
+        BXIERR_CHAIN(err, err2);
+        goto QUIT;
+    }
+
+    char * reply = NULL;
+    err2 = bxizmq_str_rcv(zocket, 0, false, &reply);
+    BXIERR_CHAIN(err, err2);
+    if (bxierr_isko(err)) goto QUIT;
+
+    err2 = bxizmq_data_rcv((void**) &stats, sizeof(*stats), zocket, 0, true, NULL);
+    BXIERR_CHAIN(err, err2);
+
+    if (0 != strcmp(STATS_CTRL_MSG_REP, reply)) {
+        err2 = bxierr_new(BXILOG_IHT2BC_PROTO_ERR, NULL, NULL, NULL, NULL,
+                          "Wrong message received in reply to %s: %s. Expecting: %s",
+                          STATS_CTRL_MSG_REQ, reply, STATS_CTRL_MSG_REP);
+        BXIERR_CHAIN(err, err2);
+    }
+    BXIFREE(reply);
+
+QUIT:;
+    // The request of a handler which did not reply must not delay the closing
+    int linger = 0;
+    err2 = bxizmq_zocket_setopt(zocket, ZMQ_LINGER, &linger, sizeof(linger));
+    BXIERR_CHAIN(err, err2);
+    err2 = bxizmq_zocket_destroy(&zocket);
+    BXIERR_CHAIN(err, err2);
+
+    return err;
+}
+
+void * _stats_thread(void * dummy) {
+    UNUSED(dummy);
+
+    // Signals are for the threads of the application, as for the handlers
+    sigset_t mask;
+    int rc = sigfillset(&mask);
+    bxiassert(0 == rc);
+    rc = pthread_sigmask(SIG_BLOCK, &mask, NULL);
+    bxiassert(0 == rc);
+
+    const long period_ms = BXILOG__GLOBALS->config->stats_period_ms;
+    rc = pthread_mutex_lock(&STATS_MUTEX);
+    bxiassert(0 == rc);
+    while (!STATS_STOP) {
+        struct timespec deadline;
+        rc = clock_gettime(CLOCK_MONOTONIC, &deadline);
+        bxiassert(0 == rc);
+        deadline.tv_sec += period_ms / 1000;
+        deadline.tv_nsec += (period_ms % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+        rc = 0;
+        while (!STATS_STOP && ETIMEDOUT != rc) {
+            rc = pthread_cond_timedwait(&STATS_COND, &STATS_MUTEX, &deadline);
+            bxiassert(0 == rc || ETIMEDOUT == rc);
+        }
+        if (STATS_STOP) break;
+
+        rc = pthread_mutex_unlock(&STATS_MUTEX);
+        bxiassert(0 == rc);
+        _log_period();
+        rc = pthread_mutex_lock(&STATS_MUTEX);
+        bxiassert(0 == rc);
+    }
+    rc = pthread_mutex_unlock(&STATS_MUTEX);
+    bxiassert(0 == rc);
+
+    return NULL;
+}
+
+void _log_period(void) {
+    // Started before the end of the initialization
+    if (INITIALIZED != BXILOG__GLOBALS->state) return;
+
+    bxilog_stats_p stats = NULL;
+    bxierr_p err = bxilog_stats_get(&stats);
+    if (NULL != stats) _log_stats(stats);
+    bxilog_stats_destroy(&stats);
+    if (bxierr_isko(err)) {
+        BXILOG_REPORT(LOGGER, BXILOG_WARNING, err,
+                      "Some statistics could not be gathered");
+    }
+}
+
+size_t _histogram_index(uint64_t value) {
+    if (value < SUB_BUCKETS_NB) return (size_t) value;
+
+    const unsigned exp = 63u - (unsigned) __builtin_clzll(value);
+    if (exp >= BXILOG_HISTOGRAM_MAX_EXP) return BXILOG_HISTOGRAM_BUCKETS_NB - 1;
+
+    const size_t sub = (value >> (exp - BXILOG_HISTOGRAM_SUB_BITS)) & (SUB_BUCKETS_NB - 1);
+    return ((exp - BXILOG_HISTOGRAM_SUB_BITS + 1) << BXILOG_HISTOGRAM_SUB_BITS) + sub;
+}
+
+// The largest value recorded in the given bucket
+uint64_t _histogram_upper(size_t index) {
+    if (index < SUB_BUCKETS_NB) return index;
+
+    const size_t exp = (index >> BXILOG_HISTOGRAM_SUB_BITS) + BXILOG_HISTOGRAM_SUB_BITS - 1;
+    const size_t sub = index & (SUB_BUCKETS_NB - 1);
+    return ((SUB_BUCKETS_NB + sub + 1) << (exp - BXILOG_HISTOGRAM_SUB_BITS)) - 1;
+}
+
+void _log_stats(bxilog_stats_p stats) {
+    INFO(LOGGER, "%zu logs from %zu threads, %zu resized, size min/avg/max: %zu/%zu/%zu",
+         stats->log_nb, stats->threads_nb, stats->rsz_log_nb,
+         stats->min_log_size,
+         (0 == stats->log_nb) ? 0 : stats->sum_log_size / stats->log_nb,
+         stats->max_log_size);
+
+    for (size_t i = 0; i < stats->handlers_nb; i++) {
+        bxilog_handler_stats_p hstats = &stats->handlers[i];
+        INFO(LOGGER, "Handler %zu (%s): %zu processed, %zu filtered, %zu dropped, "
+             "%zu retried, queue depth: %zu, "
+             "%zu flushes (total: %.3f ms, max: %.3f ms), "
+             "%zu bytes written, %zu bytes lost",
+             i, (NULL == hstats->name) ? "?" : hstats->name,
+             hstats->processed_nb, hstats->filtered_nb, hstats->dropped_nb,
+             hstats->retried_nb,
+             hstats->queue_depth,
+             hstats->flushes_nb,
+             hstats->flushes_duration * 1e3, hstats->flush_max_duration * 1e3,
+             hstats->bytes_written, hstats->bytes_lost);
+        if (!BXILOG__GLOBALS->config->handlers_talkers) continue;
+
+        _log_talkers(i, "loggers", hstats->top_loggers);
+        _log_talkers(i, "call sites", hstats->top_sites);
+    }
+}
+
+void _log_talkers(size_t handler_rank, const char * title,
+                  const bxilog_talker_s * talkers) {
+    if (0 == talkers[0].records_nb) return;
+
+    bxistr_builder_p builder = bxistr_builder_get();
+    for (size_t i = 0; i < BXILOG_TALKERS_NB && 0 < talkers[i].records_nb; i++) {
+        bxistr_builder_append(builder, "%s%s", (0 == i) ? "" : ", ", talkers[i].name);
+        if (0 < talkers[i].line) bxistr_builder_append(builder, ":%d", talkers[i].line);
+        bxistr_builder_append(builder, " (%" PRIu64 " records, %" PRIu64 " bytes)",
+                              talkers[i].records_nb, talkers[i].bytes_nb);
+    }
+    char * str = bxistr_builder_take(builder, NULL);
+    bxistr_builder_release(&builder);
+
+    INFO(LOGGER, "Handler %zu top %s: %s", handler_rank, title, str);
+    BXIFREE(str);
+}
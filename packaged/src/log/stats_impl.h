@@ -0,0 +1,88 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+#ifndef BXILOG_STATS_IMPL_H
+#define BXILOG_STATS_IMPL_H
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef BXILOG_STAGES_TIMING
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+#include "bxi/base/err.h"
+#include "bxi/base/log.h"
+
+//*********************************************************************************
+//********************************** Defines **************************************
+//*********************************************************************************
+
+#ifdef BXILOG_STAGES_TIMING
+/* Start timing a stage of the pipeline: declare the given start variable */
+#define BXILOG__STAGE_START(start) const uint64_t start = bxilog__stage_ticks()
+
+/* Add the time elapsed since start to the given stage of the given stages array,
+ * only the owner thread writes it (see bxilog_stats_get()) */
+#define BXILOG__STAGE_END(stages, stage, start) do {                                \
+        bxilog_stage_stats_s * __stage__ = &(stages)[(stage)];                      \
+        const uint64_t __ticks__ = bxilog__stage_ticks() - (start);                 \
+        __atomic_store_n(&__stage__->count, __stage__->count + 1, __ATOMIC_RELAXED);\
+        __atomic_store_n(&__stage__->ticks, __stage__->ticks + __ticks__,           \
+                         __ATOMIC_RELAXED);                                         \
+    } while (0)
+#else
+#define BXILOG__STAGE_START(start)
+#define BXILOG__STAGE_END(stages, stage, start) UNUSED(stages)
+#endif
+
+//*********************************************************************************
+//********************************** Types ****************************************
+//*********************************************************************************
+
+//*********************************************************************************
+//********************************** Global Variables  ****************************
+//*********************************************************************************
+
+//*********************************************************************************
+//********************************** Interface         ****************************
+//*********************************************************************************
+
+#ifdef BXILOG_STAGES_TIMING
+/* Return the cycle counter, or the monotonic clock in nanoseconds without one */
+static inline uint64_t bxilog__stage_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000 + (uint64_t) now.tv_nsec;
+#endif
+}
+#endif
+
+/* Forget all counters, called on initialization */
+void bxilog__stats_reset(void);
+
+/* Start the thread logging the statistics periodically, if configured to */
+bxierr_p bxilog__stats_start(void);
+
+/* Stop the thread logging the statistics, before the handlers it asks */
+bxierr_p bxilog__stats_stop(void);
+
+/* Forget the thread logging the statistics, it does not exist in the child */
+void bxilog__stats_child_after_fork(void);
+
+#endif
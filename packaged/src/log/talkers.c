@@ -0,0 +1,193 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "bxi/base/err.h"
+#include "bxi/base/mem.h"
+#include "bxi/base/log.h"
+
+#include "log_impl.h"
+#include "talkers_impl.h"
+
+//*********************************************************************************
+//********************************** Defines **************************************
+//*********************************************************************************
+
+#define NO_ENTRY (-1)
+
+// FNV-1a
+#define HASH_OFFSET 14695981039346656037ULL
+#define HASH_PRIME 1099511628211ULL
+
+//*********************************************************************************
+//********************************** Types ****************************************
+//*********************************************************************************
+
+typedef struct {
+    bxilog_talker_s talker;
+    uint64_t hash;
+    int32_t next;                                   // Next entry of the same bucket
+} entry_s;
+
+typedef entry_s * entry_p;
+
+typedef struct {
+    size_t entries_nb;
+    entry_s entries[BXILOG__TALKERS_CAPACITY];
+    int32_t buckets[BXILOG__TALKERS_CAPACITY];      // First entry of each bucket
+} table_s;
+
+typedef table_s * table_p;
+
+struct bxilog__talkers_s {
+    table_s loggers;
+    table_s sites;
+};
+
+//*********************************************************************************
+//********************************** Static Functions  ****************************
+//*********************************************************************************
+
+static void _table_init(table_p self);
+static void _table_count(table_p self, const char * name, size_t name_len, int line,
+                         size_t bytes);
+static void _table_top(const table_p self, bxilog_talker_s * top);
+static entry_p _table_evict(table_p self);
+static uint64_t _hash(const char * name, size_t name_len, int line);
+
+//*********************************************************************************
+//********************************** Global Variables  ****************************
+//*********************************************************************************
+
+//*********************************************************************************
+//********************************** Implementation    ****************************
+//*********************************************************************************
+
+bxilog__talkers_p bxilog__talkers_new(void) {
+    if (!BXILOG__GLOBALS->config->handlers_talkers) return NULL;
+
+    bxilog__talkers_p self = bximem_calloc(sizeof(*self));
+    _table_init(&self->loggers);
+    _table_init(&self->sites);
+
+    return self;
+}
+
+void bxilog__talkers_destroy(bxilog__talkers_p * self_p) {
+    BXIFREE(*self_p);
+}
+
+void bxilog__talkers_count(bxilog__talkers_p self, const bxilog_record_p record) {
+    if (NULL == self) return;
+
+    const char * filename = (char *) record + sizeof(*record);
+    const char * loggername = filename + record->filename_len + record->funcname_len;
+
+    _table_count(&self->loggers, loggername, record->logname_len, 0, record->logmsg_len);
+    _table_count(&self->sites, filename, record->filename_len, record->line_nb,
+                 record->logmsg_len);
+}
+
+void bxilog__talkers_top(const bxilog__talkers_p self, bxilog_handler_stats_p stats) {
+    memset(stats->top_loggers, 0, sizeof(stats->top_loggers));
+    memset(stats->top_sites, 0, sizeof(stats->top_sites));
+    if (NULL == self) return;
+
+    _table_top(&self->loggers, stats->top_loggers);
+    _table_top(&self->sites, stats->top_sites);
+}
+
+//*********************************************************************************
+//********************************** Static Helpers Implementation ****************
+//*********************************************************************************
+
+void _table_init(table_p self) {
+    self->entries_nb = 0;
+    for (size_t i = 0; i < BXILOG__TALKERS_CAPACITY; i++) self->buckets[i] = NO_ENTRY;
+}
+
+void _table_count(table_p self, const char * name, size_t name_len, int line,
+                  size_t bytes) {
+    const uint64_t hash = _hash(name, name_len, line);
+    const size_t bucket = hash & (BXILOG__TALKERS_CAPACITY - 1);
+
+    for (int32_t i = self->buckets[bucket]; NO_ENTRY != i; i = self->entries[i].next) {
+        entry_p entry = &self->entries[i];
+        if (hash != entry->hash || line != entry->talker.line) continue;
+        if (0 != strncmp(name, entry->talker.name, BXILOG_TALKER_NAME_LEN - 1)) continue;
+
+        entry->talker.records_nb++;
+        entry->talker.bytes_nb += bytes;
+        return;
+    }
+
+    entry_p entry;
+    if (self->entries_nb < BXILOG__TALKERS_CAPACITY) {
+        entry = &self->entries[self->entries_nb++];
+        memset(&entry->talker, 0, sizeof(entry->talker));
+    } else {
+        // The new talker might have produced the evicted one's records
+        entry = _table_evict(self);
+        entry->talker.records_error_nb = entry->talker.records_nb;
+        entry->talker.bytes_error_nb = entry->talker.bytes_nb;
+    }
+    size_t len = strnlen(name, name_len);
+    if (len >= BXILOG_TALKER_NAME_LEN) len = BXILOG_TALKER_NAME_LEN - 1;
+    memcpy(entry->talker.name, name, len);
+    entry->talker.name[len] = '\0';
+    entry->talker.line = line;
+    entry->talker.records_nb++;
+    entry->talker.bytes_nb += bytes;
+    entry->hash = hash;
+    entry->next = self->buckets[bucket];
+    self->buckets[bucket] = (int32_t) (entry - self->entries);
+}
+
+// Unlink the entry with the fewest bytes from its bucket and return it
+entry_p _table_evict(table_p self) {
+    size_t min = 0;
+    for (size_t i = 1; i < self->entries_nb; i++) {
+        if (self->entries[i].talker.bytes_nb < self->entries[min].talker.bytes_nb) min = i;
+    }
+
+    int32_t * link = &self->buckets[self->entries[min].hash & (BXILOG__TALKERS_CAPACITY - 1)];
+    while ((int32_t) min != *link) link = &self->entries[*link].next;
+    *link = self->entries[min].next;
+
+    return &self->entries[min];
+}
+
+// Keep the BXILOG_TALKERS_NB entries with the most bytes, sorted
+void _table_top(const table_p self, bxilog_talker_s * top) {
+    size_t top_nb = 0;
+    for (size_t i = 0; i < self->entries_nb; i++) {
+        const bxilog_talker_s * talker = &self->entries[i].talker;
+        size_t rank = top_nb;
+        while (0 < rank && top[rank - 1].bytes_nb < talker->bytes_nb) rank--;
+        if (BXILOG_TALKERS_NB <= rank) continue;
+
+        const size_t last = (BXILOG_TALKERS_NB == top_nb) ? top_nb - 1 : top_nb++;
+        memmove(&top[rank + 1], &top[rank], (last - rank) * sizeof(*top));
+        top[rank] = *talker;
+    }
+}
+
+uint64_t _hash(const char * name, size_t name_len, int line) {
+    uint64_t hash = HASH_OFFSET;
+    for (size_t i = 0; i < name_len && '\0' != name[i]; i++) {
+        hash = (hash ^ (uint8_t) name[i]) * HASH_PRIME;
+    }
+    return (hash ^ (uint32_t) line) * HASH_PRIME;
+}
@@ -0,0 +1,64 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+#ifndef BXILOG_TALKERS_IMPL_H
+#define BXILOG_TALKERS_IMPL_H
+
+#include <stdlib.h>
+
+#include "bxi/base/log.h"
+
+//*********************************************************************************
+//********************************** Defines **************************************
+//*********************************************************************************
+
+// Number of loggers (resp. call sites) tracked by each handler, a power of 2
+#define BXILOG__TALKERS_CAPACITY 256
+
+//*********************************************************************************
+//********************************** Types ****************************************
+//*********************************************************************************
+
+typedef struct bxilog__talkers_s bxilog__talkers_s;
+
+typedef bxilog__talkers_s * bxilog__talkers_p;
+
+//*********************************************************************************
+//********************************** Global Variables  ****************************
+//*********************************************************************************
+
+//*********************************************************************************
+//********************************** Interface         ****************************
+//*********************************************************************************
+
+/*
+ * The accounting of the records processed by a handler per logger and per call
+ * site, with the Space-Saving algorithm: a bounded hash table where a new key
+ * replaces the one with the fewest bytes when full.
+ *
+ * Only the handler owning it uses a bxilog__talkers_p: it is not thread-safe.
+ */
+
+/* Return new empty talkers, or NULL if the configuration does not track them */
+bxilog__talkers_p bxilog__talkers_new(void);
+
+/* Release the given talkers and nullify the pointer */
+void bxilog__talkers_destroy(bxilog__talkers_p * self_p);
+
+/* Account for the given processed record (followed by its strings) */
+void bxilog__talkers_count(bxilog__talkers_p self, const bxilog_record_p record);
+
+/* Fill the top talkers of the given statistics */
+void bxilog__talkers_top(const bxilog__talkers_p self, bxilog_handler_stats_p stats);
+
+#endif
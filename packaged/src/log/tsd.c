@@ -13,12 +13,14 @@
 
 
 #include <pthread.h>
+#include <string.h>
 #include <sys/syscall.h>
 
 #include "bxi/base/zmq.h"
 
 #include "log_impl.h"
 #include "tsd_impl.h"
+#include "inline_impl.h"
 
 
 
@@ -37,6 +39,11 @@
 //*********************************************************************************
 //********************************** Static Functions  ****************************
 //*********************************************************************************
+static void _register(tsd_p tsd);
+static void _unregister(tsd_p tsd);
+static void _add_counters(const tsd_p tsd, bxilog_stats_p stats);
+static void _lock(void);
+static void _unlock(void);
 
 //*********************************************************************************
 //********************************** Global Variables  ****************************
@@ -47,6 +54,12 @@
  * we use thread-specific data to holds thread specific sockets,
  */
 
+// All the thread-specific data: their counters are summed by bxilog_stats_get()
+static pthread_mutex_t TSD_LIST_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+static tsd_p TSD_LIST = NULL;
+// The counters of the threads that exited
+static bxilog_stats_s RETIRED_STATS = { .min_log_size = SIZE_MAX };
+
 //*********************************************************************************
 //********************************** Interface         ****************************
 //*********************************************************************************
@@ -55,6 +68,7 @@
 void bxilog__tsd_free(void * const data) {
     const tsd_p tsd = (tsd_p) data;
 
+    _unregister(tsd);
     if (NULL != tsd->data_channel) {
         bxierr_p err = BXIERR_OK, err2;
         err2 = bxizmq_zocket_destroy(&tsd->data_channel);
@@ -91,7 +105,9 @@ bxierr_p bxilog__tsd_get(tsd_p * result) {
         return bxierr_gen("No configuration available");
     }
 
-    if (0 != BXILOG__GLOBALS->config->handlers_nb &&
+    // Inline handlers are called directly, without any socket
+    const bool inlined = bxilog__inline_mode();
+    if (0 != BXILOG__GLOBALS->config->handlers_nb && !inlined &&
         NULL == BXILOG__GLOBALS->zmq_ctx) {
         //In this case we will try to create a socket with a null context
         *result = NULL;
@@ -106,7 +122,7 @@ bxierr_p bxilog__tsd_get(tsd_p * result) {
     tsd->log_buf = bximem_calloc(BXILOG__GLOBALS->config->tsd_log_buf_size);
 
     bxierr_list_p errlist = bxierr_list_new();
-    for (size_t i = 0; i < BXILOG__GLOBALS->config->handlers_nb; i++) {
+    for (size_t i = 0; !inlined && i < BXILOG__GLOBALS->config->handlers_nb; i++) {
         char * url = BXILOG__GLOBALS->config->handlers_params[i]->data_url;
         bxiassert(NULL != url);
         bxierr_p err = BXIERR_OK, err2;
@@ -169,6 +185,7 @@ bxierr_p bxilog__tsd_get(tsd_p * result) {
     // Nothing to do otherwise. Using a log will add a recursive call... Bad.
     // And the man page specified that there is
     bxiassert(0 == rc);
+    _register(tsd);
 
     *result = tsd;
 
@@ -176,7 +193,115 @@ bxierr_p bxilog__tsd_get(tsd_p * result) {
 }
 
 
+void bxilog__tsd_stats(bxilog_stats_p stats) {
+    _lock();
+    stats->threads_nb += RETIRED_STATS.threads_nb;
+    stats->log_nb += RETIRED_STATS.log_nb;
+    stats->rsz_log_nb += RETIRED_STATS.rsz_log_nb;
+    stats->sum_log_size += RETIRED_STATS.sum_log_size;
+    for (size_t i = 0; i < BXILOG_STAGES_NB; i++) {
+        stats->stages[i].count += RETIRED_STATS.stages[i].count;
+        stats->stages[i].ticks += RETIRED_STATS.stages[i].ticks;
+    }
+    if (RETIRED_STATS.max_log_size > stats->max_log_size) {
+        stats->max_log_size = RETIRED_STATS.max_log_size;
+    }
+    if (RETIRED_STATS.min_log_size < stats->min_log_size) {
+        stats->min_log_size = RETIRED_STATS.min_log_size;
+    }
+    for (tsd_p tsd = TSD_LIST; NULL != tsd; tsd = tsd->next) _add_counters(tsd, stats);
+    _unlock();
+}
+
+void bxilog__tsd_stats_reset(void) {
+    _lock();
+    while (NULL != TSD_LIST) {
+        tsd_p tsd = TSD_LIST;
+        TSD_LIST = tsd->next;
+        tsd->prev = tsd->next = NULL;
+        tsd->registered = false;
+    }
+    memset(&RETIRED_STATS, 0, sizeof(RETIRED_STATS));
+    RETIRED_STATS.min_log_size = SIZE_MAX;
+    _unlock();
+}
+
+void bxilog__tsd_before_fork(void) {
+    _lock();
+}
+
+void bxilog__tsd_parent_after_fork(void) {
+    _unlock();
+}
+
+void bxilog__tsd_child_after_fork(bool keep) {
+    // Held by the forking thread, see bxilog__tsd_before_fork()
+    int rc = pthread_mutex_init(&TSD_LIST_MUTEX, NULL);
+    bxiassert(0 == rc);
+    // Do not walk the list: the tsd of the calling thread might have been freed
+    TSD_LIST = NULL;
+    memset(&RETIRED_STATS, 0, sizeof(RETIRED_STATS));
+    RETIRED_STATS.min_log_size = SIZE_MAX;
+    if (!keep) return;
+
+    tsd_p tsd = pthread_getspecific(BXILOG__GLOBALS->tsd_key);
+    if (NULL != tsd) _register(tsd);
+}
+
 //*********************************************************************************
 //********************************** Static Helpers Implementation ****************
 //*********************************************************************************
 
+void _lock(void) {
+    int rc = pthread_mutex_lock(&TSD_LIST_MUTEX);
+    bxiassert(0 == rc);
+}
+
+void _unlock(void) {
+    int rc = pthread_mutex_unlock(&TSD_LIST_MUTEX);
+    bxiassert(0 == rc);
+}
+
+void _register(tsd_p tsd) {
+    _lock();
+    tsd->prev = NULL;
+    tsd->next = TSD_LIST;
+    if (NULL != TSD_LIST) TSD_LIST->prev = tsd;
+    TSD_LIST = tsd;
+    tsd->registered = true;
+    _unlock();
+}
+
+// Keep the counters of an exiting thread
+void _unregister(tsd_p tsd) {
+    _lock();
+    if (tsd->registered) {
+        _add_counters(tsd, &RETIRED_STATS);
+        if (NULL != tsd->prev) tsd->prev->next = tsd->next;
+        else TSD_LIST = tsd->next;
+        if (NULL != tsd->next) tsd->next->prev = tsd->prev;
+        tsd->prev = tsd->next = NULL;
+        tsd->registered = false;
+    }
+    _unlock();
+}
+
+// The owner thread may update the counters meanwhile
+void _add_counters(const tsd_p tsd, bxilog_stats_p stats) {
+    size_t log_nb = __atomic_load_n(&tsd->log_nb, __ATOMIC_RELAXED);
+    if (0 == log_nb) return;
+
+    stats->threads_nb++;
+    stats->log_nb += log_nb;
+    stats->rsz_log_nb += __atomic_load_n(&tsd->rsz_log_nb, __ATOMIC_RELAXED);
+    stats->sum_log_size += __atomic_load_n(&tsd->sum_log_size, __ATOMIC_RELAXED);
+    size_t size = __atomic_load_n(&tsd->max_log_size, __ATOMIC_RELAXED);
+    if (size > stats->max_log_size) stats->max_log_size = size;
+    size = __atomic_load_n(&tsd->min_log_size, __ATOMIC_RELAXED);
+    if (size < stats->min_log_size) stats->min_log_size = size;
+    for (size_t i = 0; i < BXILOG_STAGES_NB; i++) {
+        stats->stages[i].count += __atomic_load_n(&tsd->stages[i].count, __ATOMIC_RELAXED);
+        stats->stages[i].ticks += __atomic_load_n(&tsd->stages[i].ticks, __ATOMIC_RELAXED);
+    }
+}
+
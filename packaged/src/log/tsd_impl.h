@@ -16,8 +16,10 @@
 
 #include <unistd.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "bxi/base/err.h"
+#include "bxi/base/log/stats.h"
 
 //*********************************************************************************
 //********************************** Defines **************************************
@@ -28,11 +30,16 @@
 //*********************************************************************************
 
 struct tsd_s {
+    // Written by the owner thread only, read by bxilog_stats_get() (relaxed atomics)
     size_t log_nb;
     size_t rsz_log_nb;
     size_t max_log_size;
     size_t min_log_size;
     size_t sum_log_size;
+    bxilog_stage_stats_s stages[BXILOG_STAGES_NB]; // Only with BXILOG_STAGES_TIMING
+    struct tsd_s * prev;            // Registered thread-specific data list
+    struct tsd_s * next;
+    bool registered;                // True while in the list above
 
     char *  log_buf;                 // The per-thread log buffer
     void * data_channel;             // The thread-specific zmq logging socket;
@@ -63,5 +70,21 @@ void bxilog__tsd_key_new();
 /* Return the thread-specific data.*/
 bxierr_p bxilog__tsd_get(tsd_p * result);
 
+/* Add the log counters of all threads, including exited ones, to the given stats */
+void bxilog__tsd_stats(bxilog_stats_p stats);
+
+/* Forget the log counters of all threads */
+void bxilog__tsd_stats_reset(void);
+
+/* The list of all the thread-specific data is locked across a fork() */
+void bxilog__tsd_before_fork(void);
+void bxilog__tsd_parent_after_fork(void);
+
+/*
+ * Forget the other threads in a child: only the calling thread exists there.
+ * Its own thread-specific data is kept when keep is true.
+ */
+void bxilog__tsd_child_after_fork(bool keep);
+
 
 #endif
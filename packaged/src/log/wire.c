@@ -0,0 +1,428 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+#include <string.h>
+
+#include "bxi/base/err.h"
+#include "bxi/base/mem.h"
+
+#include "wire_impl.h"
+
+//*********************************************************************************
+//********************************** Defines **************************************
+//*********************************************************************************
+
+#define WIRE_INIT_SIZE 4096
+
+// Maximum number of bytes of a LEB128 encoded uint64_t
+#define VARINT_MAX_SIZE 10
+
+// Maximum size of the fixed part of an encoded record
+#define RECORD_MAX_HEADER_SIZE (1 + 7 * VARINT_MAX_SIZE + 4 * VARINT_MAX_SIZE)
+
+// Offset of the records number in the batch header
+#define RECORDS_NB_OFFSET 2
+
+#define NSEC_PER_SEC 1000000000L
+
+//*********************************************************************************
+//********************************** Types ****************************************
+//*********************************************************************************
+
+//*********************************************************************************
+//********************************** Static Functions  ****************************
+//*********************************************************************************
+
+static void _reserve(bxilog__wire_encoder_p self, size_t n);
+static uint8_t * _put_varint(uint8_t * p, uint64_t n);
+static uint8_t * _put_svarint(uint8_t * p, int64_t n);
+static bxierr_p _get_varint(bxilog__wire_decoder_p self, uint64_t * result);
+static bxierr_p _get_svarint(bxilog__wire_decoder_p self, int64_t * result);
+static int64_t _timespec_delta_ns(const struct timespec * from,
+                                  const struct timespec * to);
+static void _timespec_add_ns(struct timespec * ts, int64_t ns);
+
+//*********************************************************************************
+//********************************** Global Variables  ****************************
+//*********************************************************************************
+
+//*********************************************************************************
+//********************************** Implementation    ****************************
+//*********************************************************************************
+
+void bxilog__wire_encoder_init(bxilog__wire_encoder_p self) {
+    bxiassert(NULL != self);
+
+    self->buf = NULL;
+    self->len = 0;
+    self->allocated = 0;
+    self->records_nb = 0;
+    self->last_time.tv_sec = 0;
+    self->last_time.tv_nsec = 0;
+    self->source = NULL;
+    self->source_len = 0;
+    self->next_seq = 0;
+}
+
+void bxilog__wire_encoder_clean(bxilog__wire_encoder_p self) {
+    bxiassert(NULL != self);
+
+    BXIFREE(self->buf);
+    bxilog__wire_encoder_init(self);
+}
+
+void bxilog__wire_encoder_reset(bxilog__wire_encoder_p self) {
+    bxiassert(NULL != self);
+
+    self->len = 0;
+    self->records_nb = 0;
+}
+
+void bxilog__wire_encoder_set_source(bxilog__wire_encoder_p self, const char * source) {
+    bxiassert(NULL != self);
+    bxiassert(0 == self->records_nb);
+
+    self->source = source;
+    self->source_len = (NULL == source) ? 0 : strlen(source);
+    self->next_seq = 0;
+}
+
+void bxilog__wire_encode(bxilog__wire_encoder_p self,
+                         const bxilog_record_p record,
+                         const char * filename,
+                         const char * funcname,
+                         const char * loggername,
+                         const char * logmsg) {
+
+    bxiassert(NULL != self);
+    bxiassert(NULL != record);
+
+    const size_t var_len = record->filename_len + record->funcname_len + \
+                           record->logname_len + record->logmsg_len;
+
+    _reserve(self, BXILOG__WIRE_HEADER_MAX_SIZE + self->source_len + \
+                   RECORD_MAX_HEADER_SIZE + var_len);
+
+    uint8_t * p;
+    if (0 == self->records_nb) {
+        // New batch: the first record timestamp is the base of all deltas
+        p = self->buf;
+        *p++ = BXILOG__WIRE_VERSION;
+        *p++ = (NULL == self->source) ? 0 : BXILOG__WIRE_FLAG_SEQ;
+        p += 4;     // Records number, written by bxilog__wire_encoder_data()
+        p = _put_varint(p, (uint64_t) record->detail_time.tv_sec);
+        p = _put_varint(p, (uint64_t) record->detail_time.tv_nsec);
+        if (NULL != self->source) {
+            p = _put_varint(p, self->next_seq);
+            p = _put_varint(p, self->source_len);
+            memcpy(p, self->source, self->source_len);
+            p += self->source_len;
+        }
+        self->last_time = record->detail_time;
+    } else {
+        p = self->buf + self->len;
+    }
+
+    *p++ = (uint8_t) record->level;
+    p = _put_svarint(p, _timespec_delta_ns(&self->last_time, &record->detail_time));
+    self->last_time = record->detail_time;
+
+    p = _put_varint(p, (uint32_t) record->pid);
+#ifdef __linux__
+    p = _put_varint(p, (uint32_t) record->tid);
+#else
+    p = _put_varint(p, 0);
+#endif
+    p = _put_varint(p, record->thread_rank);
+    p = _put_svarint(p, record->line_nb);
+
+    p = _put_varint(p, record->filename_len);
+    p = _put_varint(p, record->funcname_len);
+    p = _put_varint(p, record->logname_len);
+    p = _put_varint(p, record->logmsg_len);
+
+    memcpy(p, filename, record->filename_len);
+    p += record->filename_len;
+    memcpy(p, funcname, record->funcname_len);
+    p += record->funcname_len;
+    memcpy(p, loggername, record->logname_len);
+    p += record->logname_len;
+    memcpy(p, logmsg, record->logmsg_len);
+    p += record->logmsg_len;
+
+    self->len = (size_t) (p - self->buf);
+    self->records_nb++;
+    self->next_seq++;
+}
+
+size_t bxilog__wire_encoder_data(bxilog__wire_encoder_p self, const uint8_t ** data) {
+    bxiassert(NULL != self);
+    bxiassert(NULL != data);
+
+    if (0 == self->records_nb) {
+        *data = NULL;
+        return 0;
+    }
+
+    uint8_t * p = self->buf + RECORDS_NB_OFFSET;
+    p[0] = (uint8_t) (self->records_nb);
+    p[1] = (uint8_t) (self->records_nb >> 8);
+    p[2] = (uint8_t) (self->records_nb >> 16);
+    p[3] = (uint8_t) (self->records_nb >> 24);
+
+    *data = self->buf;
+    return self->len;
+}
+
+bxierr_p bxilog__wire_decoder_init(bxilog__wire_decoder_p self,
+                                   const void * data, size_t len) {
+    bxiassert(NULL != self);
+
+    bxierr_p err = BXIERR_OK, err2;
+
+    self->buf = data;
+    self->len = len;
+    self->offset = 0;
+    self->records_nb = 0;
+    self->decoded_nb = 0;
+    self->sequenced = false;
+    self->first_seq = 0;
+    self->source = NULL;
+    self->source_len = 0;
+
+    if (len < RECORDS_NB_OFFSET + 4) {
+        return bxierr_simple(BXILOG__WIRE_BAD_DATA_ERR,
+                             "Wrong bxilog wire batch: size=%zu is too small", len);
+    }
+    if (BXILOG__WIRE_VERSION != self->buf[0]) {
+        return bxierr_simple(BXILOG__WIRE_BAD_DATA_ERR,
+                             "Unsupported bxilog wire version: %u (expected %u)",
+                             self->buf[0], BXILOG__WIRE_VERSION);
+    }
+    const uint8_t * p = self->buf + RECORDS_NB_OFFSET;
+    self->records_nb = (uint32_t) p[0] | (uint32_t) p[1] << 8 | \
+                       (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+    self->offset = RECORDS_NB_OFFSET + 4;
+
+    uint64_t sec = 0, nsec = 0;
+    err2 = _get_varint(self, &sec);
+    BXIERR_CHAIN(err, err2);
+    err2 = _get_varint(self, &nsec);
+    BXIERR_CHAIN(err, err2);
+    if (bxierr_isko(err)) return err;
+
+    self->last_time.tv_sec = (time_t) sec;
+    self->last_time.tv_nsec = (long) nsec;
+
+    if (self->buf[1] & BXILOG__WIRE_FLAG_SEQ) {
+        uint64_t source_len = 0;
+        err2 = _get_varint(self, &self->first_seq);
+        BXIERR_CHAIN(err, err2);
+        err2 = _get_varint(self, &source_len);
+        BXIERR_CHAIN(err, err2);
+        if (bxierr_isko(err)) return err;
+
+        if (source_len > self->len - self->offset) {
+            return bxierr_simple(BXILOG__WIRE_BAD_DATA_ERR,
+                                 "Wrong bxilog wire batch: publisher identifier of "
+                                 "%zu bytes, only %zu remaining",
+                                 (size_t) source_len, self->len - self->offset);
+        }
+        self->source = (const char *) self->buf + self->offset;
+        self->source_len = (size_t) source_len;
+        self->offset += self->source_len;
+        self->sequenced = true;
+    }
+
+    return err;
+}
+
+bool bxilog__wire_decoder_has_next(bxilog__wire_decoder_p self) {
+    bxiassert(NULL != self);
+
+    return self->decoded_nb < self->records_nb;
+}
+
+bxierr_p bxilog__wire_decode_record(bxilog__wire_decoder_p self,
+                                    bxilog_record_p record,
+                                    const char ** strings) {
+    bxiassert(NULL != self);
+    bxiassert(NULL != record);
+    bxiassert(NULL != strings);
+
+    bxierr_p err = BXIERR_OK, err2;
+
+    if (!bxilog__wire_decoder_has_next(self) || self->offset >= self->len) {
+        return bxierr_simple(BXILOG__WIRE_BAD_DATA_ERR,
+                             "Wrong bxilog wire batch: no more record to decode "
+                             "(%u/%u decoded)", self->decoded_nb, self->records_nb);
+    }
+
+    uint8_t level = self->buf[self->offset++];
+    int64_t delta_ns = 0, line_nb = 0;
+    uint64_t pid = 0, tid = 0, thread_rank = 0;
+    uint64_t lens[4] = {0, 0, 0, 0};
+
+    err2 = _get_svarint(self, &delta_ns);
+    BXIERR_CHAIN(err, err2);
+    err2 = _get_varint(self, &pid);
+    BXIERR_CHAIN(err, err2);
+    err2 = _get_varint(self, &tid);
+    BXIERR_CHAIN(err, err2);
+    err2 = _get_varint(self, &thread_rank);
+    BXIERR_CHAIN(err, err2);
+    err2 = _get_svarint(self, &line_nb);
+    BXIERR_CHAIN(err, err2);
+    for (size_t i = 0; i < ARRAYLEN(lens); i++) {
+        err2 = _get_varint(self, lens + i);
+        BXIERR_CHAIN(err, err2);
+    }
+    if (bxierr_isko(err)) return err;
+
+    if (level > BXILOG_LOWEST) {
+        return bxierr_simple(BXILOG__WIRE_BAD_DATA_ERR,
+                             "Wrong bxilog wire record: unknown level %u", level);
+    }
+
+    const size_t remaining = self->len - self->offset;
+    size_t var_len = 0;
+    for (size_t i = 0; i < ARRAYLEN(lens); i++) {
+        if (lens[i] > remaining - var_len) {
+            return bxierr_simple(BXILOG__WIRE_BAD_DATA_ERR,
+                                 "Wrong bxilog wire record: "
+                                 "%zu bytes remaining in batch, at least %zu required",
+                                 remaining, var_len + (size_t) lens[i]);
+        }
+        var_len += (size_t) lens[i];
+    }
+
+    _timespec_add_ns(&self->last_time, delta_ns);
+    record->level = (bxilog_level_e) level;
+    record->detail_time = self->last_time;
+    record->pid = (pid_t) pid;
+#ifdef __linux__
+    record->tid = (pid_t) tid;
+#endif
+    record->thread_rank = (uintptr_t) thread_rank;
+    record->line_nb = (int) line_nb;
+    record->filename_len = (size_t) lens[0];
+    record->funcname_len = (size_t) lens[1];
+    record->logname_len = (size_t) lens[2];
+    record->logmsg_len = (size_t) lens[3];
+
+    *strings = (const char *) self->buf + self->offset;
+    self->offset += var_len;
+    self->decoded_nb++;
+
+    return err;
+}
+
+bxierr_p bxilog__wire_decode_next(bxilog__wire_decoder_p self,
+                                  char ** buf_p, size_t * buf_size,
+                                  size_t * record_len) {
+    bxiassert(NULL != buf_p);
+    bxiassert(NULL != buf_size);
+    bxiassert(NULL != record_len);
+
+    *record_len = 0;
+
+    bxilog_record_s record;
+    const char * strings;
+    bxierr_p err = bxilog__wire_decode_record(self, &record, &strings);
+    if (bxierr_isko(err)) return err;
+
+    const size_t var_len = record.filename_len + record.funcname_len + \
+                           record.logname_len + record.logmsg_len;
+    const size_t len = sizeof(record) + var_len;
+    if (*buf_size < len) {
+        *buf_p = bximem_realloc(*buf_p, *buf_size, len);
+        *buf_size = len;
+    }
+
+    memcpy(*buf_p, &record, sizeof(record));
+    memcpy(*buf_p + sizeof(record), strings, var_len);
+
+    *record_len = len;
+
+    return err;
+}
+
+//*********************************************************************************
+//********************************** Static Helpers Implementation ****************
+//*********************************************************************************
+
+void _reserve(bxilog__wire_encoder_p self, size_t n) {
+    if (self->len + n <= self->allocated) return;
+
+    size_t new_size = (0 == self->allocated) ? WIRE_INIT_SIZE : self->allocated;
+    while (new_size < self->len + n) new_size *= 2;
+
+    self->buf = bximem_realloc(self->buf, self->allocated, new_size);
+    self->allocated = new_size;
+}
+
+uint8_t * _put_varint(uint8_t * p, uint64_t n) {
+    while (n >= 0x80) {
+        *p++ = (uint8_t) (n | 0x80);
+        n >>= 7;
+    }
+    *p++ = (uint8_t) n;
+    return p;
+}
+
+uint8_t * _put_svarint(uint8_t * p, int64_t n) {
+    // Zigzag: small absolute values map to small unsigned values
+    return _put_varint(p, ((uint64_t) n << 1) ^ (uint64_t) (n >> 63));
+}
+
+bxierr_p _get_varint(bxilog__wire_decoder_p self, uint64_t * result) {
+    uint64_t n = 0;
+    for (unsigned shift = 0; shift < 7 * VARINT_MAX_SIZE; shift += 7) {
+        if (self->offset >= self->len) break;
+        uint8_t b = self->buf[self->offset++];
+        n |= (uint64_t) (b & 0x7f) << shift;
+        if (0 == (b & 0x80)) {
+            *result = n;
+            return BXIERR_OK;
+        }
+    }
+    return bxierr_simple(BXILOG__WIRE_BAD_DATA_ERR,
+                         "Wrong bxilog wire batch: truncated integer at offset %zu",
+                         self->offset);
+}
+
+bxierr_p _get_svarint(bxilog__wire_decoder_p self, int64_t * result) {
+    uint64_t n = 0;
+    bxierr_p err = _get_varint(self, &n);
+    *result = (int64_t) (n >> 1) ^ -(int64_t) (n & 1);
+    return err;
+}
+
+int64_t _timespec_delta_ns(const struct timespec * from, const struct timespec * to) {
+    return ((int64_t) to->tv_sec - (int64_t) from->tv_sec) * NSEC_PER_SEC + \
+            ((int64_t) to->tv_nsec - (int64_t) from->tv_nsec);
+}
+
+void _timespec_add_ns(struct timespec * ts, int64_t ns) {
+    int64_t nsec = (int64_t) ts->tv_nsec + ns % NSEC_PER_SEC;
+    int64_t sec = (int64_t) ts->tv_sec + ns / NSEC_PER_SEC;
+    if (nsec < 0) {
+        nsec += NSEC_PER_SEC;
+        sec--;
+    } else if (nsec >= NSEC_PER_SEC) {
+        nsec -= NSEC_PER_SEC;
+        sec++;
+    }
+    ts->tv_sec = (time_t) sec;
+    ts->tv_nsec = (long) nsec;
+}
@@ -0,0 +1,159 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+#ifndef BXILOG_WIRE_IMPL_H
+#define BXILOG_WIRE_IMPL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "bxi/base/err.h"
+#include "bxi/base/log/handler.h"
+
+//*********************************************************************************
+//********************************** Defines **************************************
+//*********************************************************************************
+
+/*
+ * Wire encoding of bxilog records sent over the network by the remote handler.
+ *
+ * A wire message is a batch of records sharing the same log level:
+ *
+ *      u8          version (BXILOG__WIRE_VERSION)
+ *      u8          flags (BXILOG__WIRE_FLAG_*)
+ *      u32 (LE)    number of records in the batch
+ *      varint      timestamp of the first record: seconds
+ *      varint      timestamp of the first record: nanoseconds
+ *
+ * and when flags contains BXILOG__WIRE_FLAG_SEQ:
+ *
+ *      varint      sequence number of the first record
+ *      varint      publisher identifier length
+ *      bytes       publisher identifier
+ *
+ * Records of a publisher are numbered from 0 without gap: a receiver can tell
+ * how many records were lost on their way.
+ *
+ * followed by each record:
+ *
+ *      u8          level
+ *      svarint     timestamp delta in ns with the previous record of the batch
+ *      varint      pid
+ *      varint      tid
+ *      varint      thread rank
+ *      svarint     line number
+ *      varint      filename, funcname, loggername and logmsg lengths
+ *      bytes       filename, funcname, loggername and logmsg
+ *
+ * varint are LEB128 unsigned integers, svarint are zigzag encoded signed integers.
+ * The encoding does not depend on the host word size nor on its byte order.
+ */
+#define BXILOG__WIRE_VERSION 1
+
+/* Size of the batch header before the first record (publisher identifier excluded) */
+#define BXILOG__WIRE_HEADER_MAX_SIZE (1 + 1 + 4 + 10 + 10 + 10 + 10)
+
+/* The batch header holds a sequence number and a publisher identifier */
+#define BXILOG__WIRE_FLAG_SEQ 0x1
+
+#define BXILOG__WIRE_BAD_DATA_ERR 34047474  // B4D.D4T4 in leet speak
+
+//*********************************************************************************
+//********************************** Types ****************************************
+//*********************************************************************************
+
+/* Accumulate records into a wire batch */
+typedef struct {
+    uint8_t * buf;                  // The encoded batch
+    size_t len;                     // Number of bytes used in buf
+    size_t allocated;               // Number of bytes allocated for buf
+    uint32_t records_nb;            // Number of records in the batch
+    struct timespec last_time;      // Timestamp of the last encoded record
+    const char * source;            // Publisher identifier (not owned), NULL if none
+    size_t source_len;              // Length of source
+    uint64_t next_seq;              // Sequence number of the next encoded record
+} bxilog__wire_encoder_s;
+
+typedef bxilog__wire_encoder_s * bxilog__wire_encoder_p;
+
+/* Iterate over the records of a wire batch */
+typedef struct {
+    const uint8_t * buf;            // The encoded batch (not owned)
+    size_t len;                     // Size of buf
+    size_t offset;                  // Offset of the next record to decode
+    uint32_t records_nb;            // Number of records in the batch
+    uint32_t decoded_nb;            // Number of records already decoded
+    struct timespec last_time;      // Timestamp of the last decoded record
+    bool sequenced;                 // True if the batch holds the fields below
+    uint64_t first_seq;             // Sequence number of the first record
+    const char * source;            // Publisher identifier inside the batch
+    size_t source_len;              // Length of source
+} bxilog__wire_decoder_s;
+
+typedef bxilog__wire_decoder_s * bxilog__wire_decoder_p;
+
+//*********************************************************************************
+//********************************** Interface         ****************************
+//*********************************************************************************
+
+/* Initialize an empty encoder */
+void bxilog__wire_encoder_init(bxilog__wire_encoder_p self);
+
+/* Release the memory used by the given encoder */
+void bxilog__wire_encoder_clean(bxilog__wire_encoder_p self);
+
+/* Drop all encoded records, keep the allocated buffer for the next batch */
+void bxilog__wire_encoder_reset(bxilog__wire_encoder_p self);
+
+/*
+ * Number the records from now on, on behalf of the given publisher.
+ * The source must outlive the encoder, and the current batch must be empty.
+ */
+void bxilog__wire_encoder_set_source(bxilog__wire_encoder_p self, const char * source);
+
+/* Append the given record to the current batch */
+void bxilog__wire_encode(bxilog__wire_encoder_p self,
+                         const bxilog_record_p record,
+                         const char * filename,
+                         const char * funcname,
+                         const char * loggername,
+                         const char * logmsg);
+
+/* Finish the current batch: return its data and its size (until next reset) */
+size_t bxilog__wire_encoder_data(bxilog__wire_encoder_p self, const uint8_t ** data);
+
+/* Initialize a decoder on the given batch, check its header */
+bxierr_p bxilog__wire_decoder_init(bxilog__wire_decoder_p self,
+                                   const void * data, size_t len);
+
+/* Return true if some records remain to be decoded */
+bool bxilog__wire_decoder_has_next(bxilog__wire_decoder_p self);
+
+/*
+ * Decode the next record header into *record, *strings is set to its strings
+ * (filename, funcname, loggername and logmsg, contiguous) inside the batch.
+ */
+bxierr_p bxilog__wire_decode_record(bxilog__wire_decoder_p self,
+                                    bxilog_record_p record,
+                                    const char ** strings);
+
+/*
+ * Decode the next record into *buf_p as a bxilog_record_s followed by its strings,
+ * the layout expected by the handlers. The buffer is reallocated when required.
+ */
+bxierr_p bxilog__wire_decode_next(bxilog__wire_decoder_p self,
+                                  char ** buf_p, size_t * buf_size,
+                                  size_t * record_len);
+
+#endif
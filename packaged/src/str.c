@@ -16,6 +16,13 @@
 #include <stdarg.h>
 #include <stdbool.h>
 #include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <limits.h>
+#include <pthread.h>
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
 
 #include "bxi/base/mem.h"
 #include "bxi/base/str.h"
@@ -26,84 +33,302 @@
 // *********************************************************************************
 
 #define STR_INIT_SIZE 128
+#define BUILDER_TLS_NB 4            // Number of builders kept per thread
+#define BUILDER_KEEP_MAX_SIZE 65536 // Larger buffers are released on builder release
+#define LINES_OFFSETS_NB 64         // Newlines found per pass by bxistr_apply_lines()
+
+// Reading past the end of a string is safe as long as the read does not cross a
+// page boundary, which aligned loads never do, but the address sanitizer cannot know.
+#define NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
 
 // *********************************************************************************
 // ********************************** Types ****************************************
 // *********************************************************************************
 
+// Output of the format engine: bytes that do not fit are counted only
+typedef struct {
+    char * buf;
+    size_t size;                    // Number of bytes that can be written in buf
+    size_t len;                     // Length of the whole result so far
+} fmt_out_s;
+
+typedef fmt_out_s * fmt_out_p;
+
+typedef enum {
+    FMT_LEN_NONE, FMT_LEN_HH, FMT_LEN_H, FMT_LEN_L, FMT_LEN_LL,
+    FMT_LEN_Z, FMT_LEN_T, FMT_LEN_J, FMT_LEN_BIG_L,
+} fmt_len_e;
+
+// A parsed conversion specification
+typedef struct {
+    bool left;                      // '-' flag
+    bool plus;                      // '+' flag
+    bool space;                     // ' ' flag
+    bool alt;                       // '#' flag
+    bool zero;                      // '0' flag
+    int width;
+    int precision;                  // -1 when not given
+    fmt_len_e length;
+} fmt_spec_s;
 
 // *********************************************************************************
 // **************************** Static function declaration ************************
 // *********************************************************************************
+static void _builder_reserve(bxistr_builder_p self, size_t len);
+static void _builder_create_key(void);
+static void _builder_release_all(void * dummy);
+static bool _format(fmt_out_p out, const char * fmt, va_list * ap);
+static bool _fmt_number(const char ** fmt_p, int * n);
+static void _fmt_put(fmt_out_p out, const char * s, size_t n);
+static void _fmt_fill(fmt_out_p out, char c, size_t n);
+static void _fmt_padded(fmt_out_p out, const fmt_spec_s * spec, const char * s, size_t n);
+static void _fmt_int(fmt_out_p out, const fmt_spec_s * spec,
+                     uint64_t value, bool negative, char conv);
+static bool _fmt_float(fmt_out_p out, const fmt_spec_s * spec, char conv, va_list * ap);
+static size_t _newlines_scalar(const char * s, size_t len, size_t * offsets, size_t max);
+static size_t _count_scalar(const char * s, char c);
+static const char * _rfind_scalar(const char * s, size_t len, char c);
+static bool _hex2bytes_scalar(const char * s, size_t len, uint8_t * buf, size_t * bad);
+static void _bytes2hex_scalar(const uint8_t * buf, size_t len, char * out);
+#ifdef __x86_64__
+static size_t _newlines_sse2(const char * s, size_t len, size_t * offsets, size_t max);
+static size_t _count_sse2(const char * s, char c);
+static const char * _rfind_sse2(const char * s, size_t len, char c);
+static bool _hex2bytes_sse2(const char * s, size_t len, uint8_t * buf, size_t * bad);
+static void _bytes2hex_sse2(const uint8_t * buf, size_t len, char * out);
+static size_t _newlines_avx2(const char * s, size_t len, size_t * offsets, size_t max);
+static size_t _count_avx2(const char * s, char c);
+static const char * _rfind_avx2(const char * s, size_t len, char c);
+#endif
+static void __bxistr_simd_init__(void);
 
 // *********************************************************************************
 // ********************************** Global Variables *****************************
 // *********************************************************************************
 
+// Builders of the current thread, and the bitmask of those in use
+static __thread bxistr_builder_s BUILDERS[BUILDER_TLS_NB];
+static __thread unsigned BUILDERS_USED = 0;
+static __thread bool BUILDERS_REGISTERED = false;
+static pthread_key_t BUILDERS_KEY;
+static pthread_once_t BUILDERS_KEY_ONCE = PTHREAD_ONCE_INIT;
+
+// String kernels, upgraded at load time to the best instruction set available
+static size_t (*NEWLINES)(const char *, size_t, size_t *, size_t) = _newlines_scalar;
+static size_t (*COUNT)(const char *, char) = _count_scalar;
+static const char * (*RFIND)(const char *, size_t, char) = _rfind_scalar;
+static bool (*HEX2BYTES)(const char *, size_t, uint8_t *, size_t *) = _hex2bytes_scalar;
+static void (*BYTES2HEX)(const uint8_t *, size_t, char *) = _bytes2hex_scalar;
+
 // *********************************************************************************
 // ********************************** Implementation   *****************************
 // *********************************************************************************
 
-/*
- * Taken from the GCC manual and cleaned up a bit.
- */
 size_t bxistr_vnew(char ** str, const char * const fmt, va_list ap) {
-    /* Start with 100 bytes. */
-    int size = STR_INIT_SIZE;
-    *str = (char *) malloc((size_t) size);
-    if (*str == NULL) return 0;
+    // Format once into a thread-local buffer: twice only when it is too small
+    bxistr_builder_p builder = bxistr_builder_get();
+    bxistr_builder_vappend(builder, fmt, ap);
+    size_t len;
+    *str = bxistr_builder_take(builder, &len);
+    bxistr_builder_release(&builder);
 
-    while(1) {
-        char *np;
-        va_list apc;
-
-        /* Try to print in the allocated space. */
-        va_copy(apc, ap);
-        int n = vsnprintf(*str, (size_t) size, fmt, apc);
-        va_end(apc);
+    return len;
+}
 
-        /* Check error code */
-        if (n < 0) {
-            free(*str);
-            *str = NULL;
-            return 0;
-        }
+char* bxistr_new(const char * const fmt, ...) {
+    va_list ap;
+    char *msg;
 
-        /* If that worked, return the string. */
-        if (n < size) {
-            return (size_t) n;
-        }
+    va_start(ap, fmt);
+    bxistr_vnew(&msg, fmt, ap);
+    va_end(ap);
 
-        /* Else try again with more space. */
-        size = n + 1; /* Exactly what is needed */
+    return (msg);
+}
 
-        np = (char *) realloc(*str, (size_t) size);
-        if (!np) {
-            free(*str);
-            *str = NULL;
+size_t bxistr_vformat(char * buf, size_t size, const char * fmt, va_list ap) {
+    bxiassert(NULL != buf || 0 == size);
+    bxiassert(NULL != fmt);
+
+    // The last byte of the buffer is kept for the NULL byte
+    fmt_out_s out = {buf, (0 == size) ? 0 : size - 1, 0};
+    va_list args;
+    va_copy(args, ap);
+    bool done = _format(&out, fmt, &args);
+    va_end(args);
+
+    if (!done) {
+        // Some conversion is not supported: let the libc do it all
+        va_copy(args, ap);
+        int n = vsnprintf(buf, size, fmt, args);
+        va_end(args);
+        if (0 > n) {
+            if (0 < size) buf[0] = '\0';
             return 0;
         }
-        *str = np;
+        return (size_t) n;
     }
+    if (0 < size) buf[(out.len < out.size) ? out.len : out.size] = '\0';
 
-    return 0;
+    return out.len;
 }
 
+size_t bxistr_vformat_len(const char * fmt, va_list ap) {
+    return bxistr_vformat(NULL, 0, fmt, ap);
+}
 
-/*
- * Equivalent to make_message but using an ellipsis instead of a va_list.
- */
-char* bxistr_new(const char * const fmt, ...) {
+size_t bxistr_format(char * buf, size_t size, const char * fmt, ...) {
     va_list ap;
-    char *msg;
+    va_start(ap, fmt);
+    size_t n = bxistr_vformat(buf, size, fmt, ap);
+    va_end(ap);
+
+    return n;
+}
+
 
+bxistr_builder_p bxistr_builder_get(void) {
+    for (int i = 0; i < BUILDER_TLS_NB; i++) {
+        if (0 != (BUILDERS_USED & (1u << i))) continue;
+        BUILDERS_USED |= (1u << i);
+        bxistr_builder_p self = &BUILDERS[i];
+        self->tls_slot = i;
+        bxistr_builder_reset(self);
+        return self;
+    }
+    // All thread-local builders are in use
+    bxistr_builder_p self = bximem_calloc(sizeof(*self));
+    bxistr_builder_init(self);
+    self->allocated = true;
+    return self;
+}
+
+void bxistr_builder_release(bxistr_builder_p * self_p) {
+    bxiassert(NULL != self_p);
+    bxistr_builder_p self = *self_p;
+    if (NULL == self) return;
+    *self_p = NULL;
+
+    if (0 > self->tls_slot) {
+        bxistr_builder_cleanup(self);
+        if (self->allocated) BXIFREE(self);
+        return;
+    }
+    if (BUILDER_KEEP_MAX_SIZE < self->size) {
+        BXIFREE(self->buf);
+        self->size = 0;
+    }
+    if (NULL != self->buf && !BUILDERS_REGISTERED) {
+        // Only for the destructor to be called when the thread exits
+        int rc = pthread_once(&BUILDERS_KEY_ONCE, _builder_create_key);
+        bxiassert(0 == rc);
+        rc = pthread_setspecific(BUILDERS_KEY, BUILDERS);
+        bxiassert(0 == rc);
+        BUILDERS_REGISTERED = true;
+    }
+    BUILDERS_USED &= ~(1u << self->tls_slot);
+}
+
+void bxistr_builder_init(bxistr_builder_p self) {
+    bxiassert(NULL != self);
+    self->allocated = false;
+    self->tls_slot = -1;
+    self->buf = NULL;
+    self->len = 0;
+    self->size = 0;
+}
+
+void bxistr_builder_cleanup(bxistr_builder_p self) {
+    if (NULL == self) return;
+    BXIFREE(self->buf);
+    self->len = 0;
+    self->size = 0;
+}
+
+void bxistr_builder_reset(bxistr_builder_p self) {
+    self->len = 0;
+    if (NULL != self->buf) self->buf[0] = '\0';
+}
+
+size_t bxistr_builder_append(bxistr_builder_p self, const char * fmt, ...) {
+    va_list ap;
     va_start(ap, fmt);
-    bxistr_vnew(&msg, fmt, ap);
+    size_t n = bxistr_builder_vappend(self, fmt, ap);
     va_end(ap);
 
-    return (msg);
+    return n;
+}
+
+size_t bxistr_builder_vappend(bxistr_builder_p self, const char * fmt, va_list ap) {
+    bxiassert(NULL != self);
+    bxiassert(NULL != fmt);
+
+    _builder_reserve(self, STR_INIT_SIZE);
+    va_list apc;
+    va_copy(apc, ap);
+    size_t n = bxistr_vformat(self->buf + self->len, self->size - self->len, fmt, apc);
+    va_end(apc);
+    if (n >= self->size - self->len) {
+        // Try again with exactly what is needed
+        _builder_reserve(self, n + 1);
+        va_copy(apc, ap);
+        n = bxistr_vformat(self->buf + self->len, self->size - self->len, fmt, apc);
+        va_end(apc);
+        bxiassert(n < self->size - self->len);
+    }
+    self->len += n;
+
+    return n;
+}
+
+void bxistr_builder_append_bytes(bxistr_builder_p self, const char * bytes, size_t len) {
+    bxiassert(NULL != self);
+
+    _builder_reserve(self, len + 1);
+    memcpy(self->buf + self->len, bytes, len);
+    self->len += len;
+    self->buf[self->len] = '\0';
 }
 
+void bxistr_builder_append_int(bxistr_builder_p self, int64_t n) {
+    if (0 <= n) {
+        bxistr_builder_append_uint(self, (uint64_t) n);
+        return;
+    }
+    bxistr_builder_append_bytes(self, "-", 1);
+    // Do not overflow on INT64_MIN
+    bxistr_builder_append_uint(self, (uint64_t) (-(n + 1)) + 1);
+}
+
+void bxistr_builder_append_uint(bxistr_builder_p self, uint64_t n) {
+    // Digits are produced from the end
+    char digits[20];
+    size_t i = sizeof(digits);
+    do {
+        digits[--i] = (char) ('0' + n % 10);
+        n /= 10;
+    } while (0 != n);
+    bxistr_builder_append_bytes(self, digits + i, sizeof(digits) - i);
+}
+
+char * bxistr_builder_take(bxistr_builder_p self, size_t * len_p) {
+    bxiassert(NULL != self);
+
+    char * result = malloc(self->len + 1);
+    bxiassert(NULL != result);
+    if (0 < self->len) memcpy(result, self->buf, self->len);
+    result[self->len] = '\0';
+    if (NULL != len_p) *len_p = self->len;
+    bxistr_builder_reset(self);
+
+    return result;
+}
+
+size_t bxistr_newlines(const char * str, size_t len, size_t * offsets, size_t offsets_max) {
+    bxiassert(NULL != str || 0 == len);
+
+    return NEWLINES(str, len, offsets, offsets_max);
+}
 
 bxierr_p bxistr_apply_lines(char * str,
                             size_t str_len,
@@ -115,17 +340,21 @@ bxierr_p bxistr_apply_lines(char * str,
 
         char * s = str;
         char * eol = str + str_len;
+        size_t offsets[LINES_OFFSETS_NB];
         while (true) {
-            char * next = memchr(s, '\n', (size_t) (eol - s));
-            next = (NULL == next) ? eol : next;
-            size_t sub_len = (size_t) (next - s);
-            bool last = next == eol;
-            bxierr_p err = f(s, sub_len, last, param);
-            if (bxierr_isko(err)) return err;
-            if (last) break;
-            s = next + 1;
+            // Find the next newlines at once, then call f() on each line
+            const size_t n = NEWLINES(s, (size_t) (eol - s), offsets, LINES_OFFSETS_NB);
+            char * line = s;
+            for (size_t i = 0; i < n; i++) {
+                char * next = s + offsets[i];
+                bxierr_p err = f(line, (size_t) (next - line), false, param);
+                if (bxierr_isko(err)) return err;
+                line = next + 1;
+            }
+            if (n < LINES_OFFSETS_NB) return f(line, (size_t) (eol - line), true, param);
+            // The scan resumes after the last newline found
+            s = line;
         }
-        return BXIERR_OK;
 }
 
 void bxistr_prefixer_init(bxistr_prefixer_p self,
@@ -234,7 +463,7 @@ size_t bxistr_rsub(const char * const str,
         return 0;
     }
 
-    const char * r = strrchr(str, c);
+    const char * r = RFIND(str, str_len, c);
 
     if (NULL == r) {
         *result = str;
@@ -272,16 +501,7 @@ size_t bxistr_digits_nb(int32_t n) {
 size_t bxistr_count(const char * s, const char c) {
    bxiassert(NULL != s);
 
-   // Trick: increment either i or s. s+i is the current character to check.
-   size_t i = 0;
-   while (s[i] != '\0') {
-       if (s[i] == c) {
-           i++; // Character found, increment i
-       } else {
-           s++; // Character not found, increment s, so s+i is the next character
-       }
-   }
-   return i;
+   return COUNT(s, c);
 }
 
 char * bxistr_mkshorter(char * s, size_t max_len, char sep) {
@@ -324,45 +544,16 @@ bxierr_p bxistr_hex2bytes(char * s, size_t len, uint8_t ** pbuf) {
     size_t dlength = len / 2;
 
     if (NULL == *pbuf) *pbuf = bximem_calloc(dlength * sizeof(**pbuf));
-    uint8_t * buf = *pbuf;
 
-    size_t index = 0;
-
-    while (index < len) {
-        const char c = s[index];
-
-        int value;
-        if (c >= '0' && c <= '9') value = (c - '0');
-        else if (c >= 'A' && c <= 'F') value = (10 + (c - 'A'));
-        else if (c >= 'a' && c <= 'f') value = (10 + (c - 'a'));
-        else return bxierr_gen("Non hexadecimal digit: %c in %s", c, s);
-
-        // Multiple lines required to remove GCC warning conversion removals
-
-        // (index + 1) % 2: We want odd numbers to result to 1 and even to 0
-        // since the first digit of a hex string is the most significant and
-        // needs to be multiplied by 16. so for index 0 => 0 + 1 % 2 = 1,
-        // index 1 => 1 + 1 % 2 = 0 etc.
-        // << 4: Shift by 4 is multiplying by 16. example: b00000001 << 4 = b00010000
-        uint8_t add = (uint8_t) (value << (((index + 1) % 2) * 4));
-        // index / 2 :
-        // Division between integers will round down the value,
-        // so 0/2 = 0, 1/2 = 0, 2/2 = 1, 3/2 = 0 etc.
-        // So, for every 2 string characters we add the value to 1 data byte.
-        uint8_t cur = buf[(index/2)];
-        buf[(index/2)] = (uint8_t) (cur + add);
-        index++;
+    size_t bad;
+    if (!HEX2BYTES(s, len, *pbuf, &bad)) {
+        return bxierr_gen("Non hexadecimal digit: %c in %s", s[bad], s);
     }
 
     return BXIERR_OK;
 }
 
 bxierr_p bxistr_bytes2hex(uint8_t * buf, size_t len, char ** ps) {
-    // Modified from:
-    // http://stackoverflow.com/questions/6357031/how-do-you-convert-buffer-byte-array-to-hex-string-in-c
-
-    static const char hex_str[]= "0123456789ABCDEF";
-
     if (NULL == buf) return bxierr_gen("Null pointer given for buf parameter.");
     if (NULL == ps) return bxierr_gen("Null pointer given for ps parameter");
 
@@ -370,15 +561,48 @@ bxierr_p bxistr_bytes2hex(uint8_t * buf, size_t len, char ** ps) {
 
     char * out = *ps;
     out[len * 2] = '\0';
-
-    for (size_t i = 0; i < len; i++) {
-        out[i * 2 + 0] = hex_str[(buf[i] >> 4) & 0x0F];
-        out[i * 2 + 1] = hex_str[(buf[i]     ) & 0x0F];
-    }
+    BYTES2HEX(buf, len, out);
 
     return BXIERR_OK;
 }
 
+bxistr_simd_e bxistr_simd_set(bxistr_simd_e simd) {
+#ifdef __x86_64__
+    __builtin_cpu_init();
+    if (BXISTR_SIMD_AVX2 == simd && !__builtin_cpu_supports("avx2")) simd = BXISTR_SIMD_SSE2;
+#else
+    simd = BXISTR_SIMD_SCALAR;
+#endif
+    switch (simd) {
+#ifdef __x86_64__
+        case BXISTR_SIMD_AVX2:
+            __atomic_store_n(&NEWLINES, _newlines_avx2, __ATOMIC_RELAXED);
+            __atomic_store_n(&COUNT, _count_avx2, __ATOMIC_RELAXED);
+            __atomic_store_n(&RFIND, _rfind_avx2, __ATOMIC_RELAXED);
+            // 16 hexadecimal digits at a time are enough
+            __atomic_store_n(&HEX2BYTES, _hex2bytes_sse2, __ATOMIC_RELAXED);
+            __atomic_store_n(&BYTES2HEX, _bytes2hex_sse2, __ATOMIC_RELAXED);
+            break;
+        case BXISTR_SIMD_SSE2:
+            __atomic_store_n(&NEWLINES, _newlines_sse2, __ATOMIC_RELAXED);
+            __atomic_store_n(&COUNT, _count_sse2, __ATOMIC_RELAXED);
+            __atomic_store_n(&RFIND, _rfind_sse2, __ATOMIC_RELAXED);
+            __atomic_store_n(&HEX2BYTES, _hex2bytes_sse2, __ATOMIC_RELAXED);
+            __atomic_store_n(&BYTES2HEX, _bytes2hex_sse2, __ATOMIC_RELAXED);
+            break;
+#endif
+        default:
+            simd = BXISTR_SIMD_SCALAR;
+            __atomic_store_n(&NEWLINES, _newlines_scalar, __ATOMIC_RELAXED);
+            __atomic_store_n(&COUNT, _count_scalar, __ATOMIC_RELAXED);
+            __atomic_store_n(&RFIND, _rfind_scalar, __ATOMIC_RELAXED);
+            __atomic_store_n(&HEX2BYTES, _hex2bytes_scalar, __ATOMIC_RELAXED);
+            __atomic_store_n(&BYTES2HEX, _bytes2hex_scalar, __ATOMIC_RELAXED);
+            break;
+    }
+    return simd;
+}
+
 
 char * bxistr_from_signal(const siginfo_t * siginfo,
                          const struct signalfd_siginfo * sfdinfo) {
@@ -423,3 +647,552 @@ char * bxistr_from_signal(const siginfo_t * siginfo,
 // ********************************** Static Functions  ****************************
 // *********************************************************************************
 
+void _builder_reserve(bxistr_builder_p self, size_t len) {
+    if (self->size - self->len >= len && NULL != self->buf) return;
+
+    size_t new_size = (0 == self->size) ? STR_INIT_SIZE : self->size;
+    while (new_size - self->len < len) new_size *= 2;
+    self->buf = bximem_realloc(self->buf, self->size, new_size);
+    self->size = new_size;
+}
+
+void _builder_create_key(void) {
+    int rc = pthread_key_create(&BUILDERS_KEY, _builder_release_all);
+    bxiassert(0 == rc);
+}
+
+void _builder_release_all(void * dummy) {
+    UNUSED(dummy);
+    for (int i = 0; i < BUILDER_TLS_NB; i++) {
+        BXIFREE(BUILDERS[i].buf);
+        BUILDERS[i].size = 0;
+        BUILDERS[i].len = 0;
+    }
+    BUILDERS_REGISTERED = false;
+}
+
+void _fmt_put(fmt_out_p out, const char * s, size_t n) {
+    if (out->len < out->size) {
+        size_t room = out->size - out->len;
+        memcpy(out->buf + out->len, s, (n < room) ? n : room);
+    }
+    out->len += n;
+}
+
+void _fmt_fill(fmt_out_p out, char c, size_t n) {
+    if (out->len < out->size) {
+        size_t room = out->size - out->len;
+        memset(out->buf + out->len, c, (n < room) ? n : room);
+    }
+    out->len += n;
+}
+
+void _fmt_padded(fmt_out_p out, const fmt_spec_s * spec, const char * s, size_t n) {
+    size_t pad = ((size_t) spec->width > n) ? (size_t) spec->width - n : 0;
+    if (!spec->left) _fmt_fill(out, ' ', pad);
+    _fmt_put(out, s, n);
+    if (spec->left) _fmt_fill(out, ' ', pad);
+}
+
+void _fmt_int(fmt_out_p out, const fmt_spec_s * spec,
+              uint64_t value, bool negative, char conv) {
+    static const char LOWER[] = "0123456789abcdef";
+    static const char UPPER[] = "0123456789ABCDEF";
+
+    char digits[24];
+    char * const end = digits + sizeof(digits);
+    char * p = end;
+    const bool zero_value = (0 == value);
+    if ('o' == conv) {
+        do { *--p = (char) ('0' + (value & 7)); value >>= 3; } while (0 != value);
+    } else if ('x' == conv || 'X' == conv || 'p' == conv) {
+        const char * hex = ('X' == conv) ? UPPER : LOWER;
+        do { *--p = hex[value & 15]; value >>= 4; } while (0 != value);
+    } else {
+        do { *--p = (char) ('0' + value % 10); value /= 10; } while (0 != value);
+    }
+    // An explicit zero precision prints nothing for a zero value
+    if (zero_value && 0 == spec->precision) p = end;
+    size_t digits_nb = (size_t) (end - p);
+
+    char prefix[2];
+    size_t prefix_len = 0;
+    int precision = spec->precision;
+    if ('d' == conv || 'i' == conv) {
+        if (negative) prefix[prefix_len++] = '-';
+        else if (spec->plus) prefix[prefix_len++] = '+';
+        else if (spec->space) prefix[prefix_len++] = ' ';
+    } else if (('x' == conv || 'X' == conv) && spec->alt && !zero_value) {
+        prefix[prefix_len++] = '0';
+        prefix[prefix_len++] = conv;
+    } else if ('p' == conv) {
+        prefix[prefix_len++] = '0';
+        prefix[prefix_len++] = 'x';
+    } else if ('o' == conv && spec->alt && (0 == digits_nb || '0' != *p) &&
+               precision <= (int) digits_nb) {
+        // The first digit must be a zero
+        precision = (int) digits_nb + 1;
+    }
+
+    size_t zeros = (precision > 0 && (size_t) precision > digits_nb) ?
+                   (size_t) precision - digits_nb : 0;
+    size_t len = prefix_len + zeros + digits_nb;
+    size_t pad = ((size_t) spec->width > len) ? (size_t) spec->width - len : 0;
+    if (spec->left) {
+        _fmt_put(out, prefix, prefix_len);
+        _fmt_fill(out, '0', zeros);
+        _fmt_put(out, p, digits_nb);
+        _fmt_fill(out, ' ', pad);
+    } else if (spec->zero && 0 > spec->precision) {
+        _fmt_put(out, prefix, prefix_len);
+        _fmt_fill(out, '0', zeros + pad);
+        _fmt_put(out, p, digits_nb);
+    } else {
+        _fmt_fill(out, ' ', pad);
+        _fmt_put(out, prefix, prefix_len);
+        _fmt_fill(out, '0', zeros);
+        _fmt_put(out, p, digits_nb);
+    }
+}
+
+bool _fmt_float(fmt_out_p out, const fmt_spec_s * spec, char conv, va_list * ap) {
+    // Rebuild the conversion with explicit width and precision arguments
+    char f[16];
+    size_t i = 0;
+    f[i++] = '%';
+    if (spec->left) f[i++] = '-';
+    if (spec->plus) f[i++] = '+';
+    if (spec->space) f[i++] = ' ';
+    if (spec->alt) f[i++] = '#';
+    if (spec->zero) f[i++] = '0';
+    f[i++] = '*';
+    f[i++] = '.';
+    f[i++] = '*';
+    if (FMT_LEN_BIG_L == spec->length) f[i++] = 'L';
+    f[i++] = conv;
+    f[i] = '\0';
+
+    char tmp[128];
+    int n;
+    if (FMT_LEN_BIG_L == spec->length) {
+        long double value = va_arg(*ap, long double);
+        n = snprintf(tmp, sizeof(tmp), f, spec->width, spec->precision, value);
+        if (0 <= n && (size_t) n >= sizeof(tmp) && out->len < out->size) {
+            char * big = bximem_calloc((size_t) n + 1);
+            snprintf(big, (size_t) n + 1, f, spec->width, spec->precision, value);
+            _fmt_put(out, big, (size_t) n);
+            BXIFREE(big);
+            return true;
+        }
+    } else {
+        double value = va_arg(*ap, double);
+        n = snprintf(tmp, sizeof(tmp), f, spec->width, spec->precision, value);
+        if (0 <= n && (size_t) n >= sizeof(tmp) && out->len < out->size) {
+            char * big = bximem_calloc((size_t) n + 1);
+            snprintf(big, (size_t) n + 1, f, spec->width, spec->precision, value);
+            _fmt_put(out, big, (size_t) n);
+            BXIFREE(big);
+            return true;
+        }
+    }
+    if (0 > n) return false;
+    // Only the length matters when nothing can be written anymore
+    if ((size_t) n >= sizeof(tmp)) out->len += (size_t) n;
+    else _fmt_put(out, tmp, (size_t) n);
+
+    return true;
+}
+
+bool _fmt_number(const char ** fmt_p, int * n) {
+    const char * fmt = *fmt_p;
+    int value = 0;
+    while ('0' <= *fmt && *fmt <= '9') {
+        if (value > (INT_MAX - 9) / 10) return false;
+        value = value * 10 + (*fmt - '0');
+        fmt++;
+    }
+    // Positional arguments are not supported
+    if ('$' == *fmt) return false;
+    *fmt_p = fmt;
+    *n = value;
+
+    return true;
+}
+
+bool _format(fmt_out_p out, const char * fmt, va_list * ap) {
+    while (true) {
+        // Copy the literal text up to the next conversion
+        size_t n = strcspn(fmt, "%");
+        _fmt_put(out, fmt, n);
+        fmt += n;
+        if ('\0' == *fmt) return true;
+        fmt++;
+        if ('%' == *fmt) {
+            _fmt_put(out, fmt, 1);
+            fmt++;
+            continue;
+        }
+
+        fmt_spec_s spec = {.precision = -1, .length = FMT_LEN_NONE};
+        for (bool flag = true; flag; ) {
+            switch (*fmt) {
+                case '-': spec.left = true; fmt++; break;
+                case '+': spec.plus = true; fmt++; break;
+                case ' ': spec.space = true; fmt++; break;
+                case '#': spec.alt = true; fmt++; break;
+                case '0': spec.zero = true; fmt++; break;
+                default: flag = false; break;
+            }
+        }
+        if ('*' == *fmt) {
+            fmt++;
+            if ('0' <= *fmt && *fmt <= '9') return false;
+            spec.width = va_arg(*ap, int);
+            if (0 > spec.width) {
+                // A negative width is a '-' flag
+                if (INT_MIN == spec.width) return false;
+                spec.left = true;
+                spec.width = -spec.width;
+            }
+        } else if (!_fmt_number(&fmt, &spec.width)) {
+            return false;
+        }
+        if ('.' == *fmt) {
+            fmt++;
+            if ('*' == *fmt) {
+                fmt++;
+                if ('0' <= *fmt && *fmt <= '9') return false;
+                spec.precision = va_arg(*ap, int);
+                // A negative precision is taken as if it were omitted
+                if (0 > spec.precision) spec.precision = -1;
+            } else if (!_fmt_number(&fmt, &spec.precision)) {
+                return false;
+            }
+        }
+        switch (*fmt) {
+            case 'h':
+                fmt++;
+                spec.length = FMT_LEN_H;
+                if ('h' == *fmt) { fmt++; spec.length = FMT_LEN_HH; }
+                break;
+            case 'l':
+                fmt++;
+                spec.length = FMT_LEN_L;
+                if ('l' == *fmt) { fmt++; spec.length = FMT_LEN_LL; }
+                break;
+            case 'z': fmt++; spec.length = FMT_LEN_Z; break;
+            case 't': fmt++; spec.length = FMT_LEN_T; break;
+            case 'j': fmt++; spec.length = FMT_LEN_J; break;
+            case 'L': fmt++; spec.length = FMT_LEN_BIG_L; break;
+            default: break;
+        }
+
+        const char conv = *fmt++;
+        switch (conv) {
+            case 'd': case 'i': {
+                int64_t value;
+                switch (spec.length) {
+                    case FMT_LEN_NONE: value = va_arg(*ap, int); break;
+                    case FMT_LEN_HH: value = (signed char) va_arg(*ap, int); break;
+                    case FMT_LEN_H: value = (short) va_arg(*ap, int); break;
+                    case FMT_LEN_L: value = va_arg(*ap, long); break;
+                    case FMT_LEN_LL: value = va_arg(*ap, long long); break;
+                    case FMT_LEN_Z: value = va_arg(*ap, ssize_t); break;
+                    case FMT_LEN_T: value = va_arg(*ap, ptrdiff_t); break;
+                    case FMT_LEN_J: value = va_arg(*ap, intmax_t); break;
+                    default: return false;
+                }
+                // Negate as unsigned: INT64_MIN has no positive counterpart
+                uint64_t abs = (0 > value) ? 0 - (uint64_t) value : (uint64_t) value;
+                _fmt_int(out, &spec, abs, 0 > value, conv);
+                break;
+            }
+            case 'u': case 'x': case 'X': case 'o': {
+                uint64_t value;
+                switch (spec.length) {
+                    case FMT_LEN_NONE: value = va_arg(*ap, unsigned); break;
+                    case FMT_LEN_HH: value = (unsigned char) va_arg(*ap, unsigned); break;
+                    case FMT_LEN_H: value = (unsigned short) va_arg(*ap, unsigned); break;
+                    case FMT_LEN_L: value = va_arg(*ap, unsigned long); break;
+                    case FMT_LEN_LL: value = va_arg(*ap, unsigned long long); break;
+                    case FMT_LEN_Z: value = va_arg(*ap, size_t); break;
+                    case FMT_LEN_T: value = (size_t) va_arg(*ap, ptrdiff_t); break;
+                    case FMT_LEN_J: value = va_arg(*ap, uintmax_t); break;
+                    default: return false;
+                }
+                _fmt_int(out, &spec, value, false, conv);
+                break;
+            }
+            case 'p': {
+                // Only the flags seen in practice
+                if (spec.plus || spec.space || spec.zero || 0 <= spec.precision) return false;
+                if (FMT_LEN_NONE != spec.length) return false;
+                void * value = va_arg(*ap, void *);
+                if (NULL == value) _fmt_padded(out, &spec, "(nil)", 5);
+                else _fmt_int(out, &spec, (uintptr_t) value, false, conv);
+                break;
+            }
+            case 's': {
+                if (FMT_LEN_NONE != spec.length || spec.zero) return false;
+                const char * value = va_arg(*ap, const char *);
+                if (NULL == value) value = (0 <= spec.precision && 6 > spec.precision) ?
+                                           "" : "(null)";
+                size_t len = (0 <= spec.precision) ?
+                              strnlen(value, (size_t) spec.precision) : strlen(value);
+                _fmt_padded(out, &spec, value, len);
+                break;
+            }
+            case 'c': {
+                if (FMT_LEN_NONE != spec.length || spec.zero) return false;
+                char value = (char) va_arg(*ap, int);
+                _fmt_padded(out, &spec, &value, 1);
+                break;
+            }
+            case 'f': case 'F': case 'e': case 'E':
+            case 'g': case 'G': case 'a': case 'A':
+                if (FMT_LEN_NONE != spec.length && FMT_LEN_L != spec.length &&
+                    FMT_LEN_BIG_L != spec.length) return false;
+                if (!_fmt_float(out, &spec, conv, ap)) return false;
+                break;
+            default:
+                // %n, %m, %C, %S, ...
+                return false;
+        }
+    }
+}
+
+__attribute__((constructor)) void __bxistr_simd_init__(void) {
+    bxistr_simd_set(BXISTR_SIMD_AVX2);
+}
+
+size_t _newlines_scalar(const char * s, size_t len, size_t * offsets, size_t max) {
+    size_t n = 0;
+    const char * p = s;
+    const char * const end = s + len;
+    while (n < max && NULL != (p = memchr(p, '\n', (size_t) (end - p)))) {
+        offsets[n++] = (size_t) (p - s);
+        p++;
+    }
+    return n;
+}
+
+size_t _count_scalar(const char * s, char c) {
+   // Trick: increment either i or s. s+i is the current character to check.
+   size_t i = 0;
+   while (s[i] != '\0') {
+       if (s[i] == c) {
+           i++; // Character found, increment i
+       } else {
+           s++; // Character not found, increment s, so s+i is the next character
+       }
+   }
+   return i;
+}
+
+const char * _rfind_scalar(const char * s, size_t len, char c) {
+    while (0 < len) {
+        len--;
+        if (s[len] == c) return s + len;
+    }
+    return NULL;
+}
+
+bool _hex2bytes_scalar(const char * s, size_t len, uint8_t * buf, size_t * bad) {
+    for (size_t index = 0; index < len; index++) {
+        const char c = s[index];
+
+        int value;
+        if (c >= '0' && c <= '9') value = (c - '0');
+        else if (c >= 'A' && c <= 'F') value = (10 + (c - 'A'));
+        else if (c >= 'a' && c <= 'f') value = (10 + (c - 'a'));
+        else {
+            *bad = index;
+            return false;
+        }
+        // The first digit of a pair is the most significant one
+        if (0 == index % 2) {
+            buf[index / 2] = (uint8_t) (value << 4);
+        } else {
+            buf[index / 2] = (uint8_t) (buf[index / 2] | value);
+        }
+    }
+    return true;
+}
+
+void _bytes2hex_scalar(const uint8_t * buf, size_t len, char * out) {
+    static const char hex_str[]= "0123456789ABCDEF";
+
+    for (size_t i = 0; i < len; i++) {
+        out[i * 2 + 0] = hex_str[(buf[i] >> 4) & 0x0F];
+        out[i * 2 + 1] = hex_str[(buf[i]     ) & 0x0F];
+    }
+}
+
+#ifdef __x86_64__
+// SSE2 is always available on x86_64: no target attribute required
+size_t _newlines_sse2(const char * s, size_t len, size_t * offsets, size_t max) {
+    const __m128i nl = _mm_set1_epi8('\n');
+    size_t n = 0, i = 0;
+    if (0 == max) return 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (s + i));
+        unsigned mask = (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(v, nl));
+        for (; 0 != mask; mask &= mask - 1) {
+            offsets[n++] = i + (size_t) __builtin_ctz(mask);
+            if (max == n) return n;
+        }
+    }
+    for (; i < len; i++) {
+        if ('\n' != s[i]) continue;
+        offsets[n++] = i;
+        if (max == n) return n;
+    }
+    return n;
+}
+
+NO_SANITIZE_ADDRESS size_t _count_sse2(const char * s, char c) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i cc = _mm_set1_epi8(c);
+    // Aligned loads only: the first one may start before s
+    const uintptr_t skip = (uintptr_t) s & 15;
+    const char * p = s - skip;
+    unsigned valid = 0xFFFFu << skip;
+    size_t n = 0;
+    while (true) {
+        __m128i v = _mm_load_si128((const __m128i *) p);
+        unsigned zmask = (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)) & valid;
+        unsigned cmask = (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(v, cc)) & valid;
+        if (0 != zmask) {
+            // Only characters before the terminating NULL byte count
+            cmask &= (zmask & -zmask) - 1;
+            return n + (size_t) __builtin_popcount(cmask);
+        }
+        n += (size_t) __builtin_popcount(cmask);
+        p += 16;
+        valid = 0xFFFFu;
+    }
+}
+
+const char * _rfind_sse2(const char * s, size_t len, char c) {
+    const __m128i cc = _mm_set1_epi8(c);
+    while (16 <= len) {
+        len -= 16;
+        __m128i v = _mm_loadu_si128((const __m128i *) (s + len));
+        unsigned mask = (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(v, cc));
+        if (0 != mask) return s + len + (31 - __builtin_clz(mask));
+    }
+    return _rfind_scalar(s, len, c);
+}
+
+bool _hex2bytes_sse2(const char * s, size_t len, uint8_t * buf, size_t * bad) {
+    const __m128i zero_m1 = _mm_set1_epi8('0' - 1);
+    const __m128i nine_p1 = _mm_set1_epi8('9' + 1);
+    const __m128i a_m1 = _mm_set1_epi8('a' - 1);
+    const __m128i f_p1 = _mm_set1_epi8('f' + 1);
+    const __m128i lower = _mm_set1_epi8(0x20);
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i a_10 = _mm_set1_epi8('a' - 10);
+    const __m128i low_bytes = _mm_set1_epi16(0x00FF);
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (s + i));
+        // Bytes above 0x7F are negative: neither digits nor letters
+        __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(v, zero_m1),
+                                         _mm_cmplt_epi8(v, nine_p1));
+        __m128i l = _mm_or_si128(v, lower);
+        __m128i is_alpha = _mm_and_si128(_mm_cmpgt_epi8(l, a_m1),
+                                         _mm_cmplt_epi8(l, f_p1));
+        if (0xFFFF != _mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha))) break;
+        __m128i value = _mm_or_si128(_mm_and_si128(is_digit, _mm_sub_epi8(v, zero)),
+                                     _mm_andnot_si128(is_digit, _mm_sub_epi8(l, a_10)));
+        // Most significant digits are in the low byte of each 16 bits word
+        __m128i high = _mm_slli_epi16(_mm_and_si128(value, low_bytes), 4);
+        __m128i low = _mm_srli_epi16(value, 8);
+        __m128i bytes = _mm_packus_epi16(_mm_or_si128(high, low), _mm_setzero_si128());
+        _mm_storel_epi64((__m128i *) (buf + i / 2), bytes);
+    }
+    // The remaining digits, or the ones with an error to report
+    if (!_hex2bytes_scalar(s + i, len - i, buf + i / 2, bad)) {
+        *bad += i;
+        return false;
+    }
+    return true;
+}
+
+void _bytes2hex_sse2(const uint8_t * buf, size_t len, char * out) {
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i zero = _mm_set1_epi8('0');
+    // Distance between '9' + 1 and 'A'
+    const __m128i letters = _mm_set1_epi8('A' - '9' - 1);
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        __m128i v = _mm_loadl_epi64((const __m128i *) (buf + i));
+        __m128i high = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+        __m128i low = _mm_and_si128(v, nibble);
+        __m128i digits = _mm_unpacklo_epi8(high, low);
+        __m128i hex = _mm_add_epi8(_mm_add_epi8(digits, zero),
+                                   _mm_and_si128(_mm_cmpgt_epi8(digits, nine), letters));
+        _mm_storeu_si128((__m128i *) (out + 2 * i), hex);
+    }
+    _bytes2hex_scalar(buf + i, len - i, out + 2 * i);
+}
+
+__attribute__((target("avx2")))
+size_t _newlines_avx2(const char * s, size_t len, size_t * offsets, size_t max) {
+    const __m256i nl = _mm256_set1_epi8('\n');
+    size_t n = 0, i = 0;
+    if (0 == max) return 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *) (s + i));
+        unsigned mask = (unsigned) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nl));
+        for (; 0 != mask; mask &= mask - 1) {
+            offsets[n++] = i + (size_t) __builtin_ctz(mask);
+            if (max == n) return n;
+        }
+    }
+    // Less than 32 bytes remain
+    for (; i < len; i++) {
+        if ('\n' != s[i]) continue;
+        offsets[n++] = i;
+        if (max == n) return n;
+    }
+    return n;
+}
+
+__attribute__((target("avx2"))) NO_SANITIZE_ADDRESS
+size_t _count_avx2(const char * s, char c) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i cc = _mm256_set1_epi8(c);
+    // Aligned loads only: the first one may start before s
+    const uintptr_t skip = (uintptr_t) s & 31;
+    const char * p = s - skip;
+    unsigned valid = 0xFFFFFFFFu << skip;
+    size_t n = 0;
+    while (true) {
+        __m256i v = _mm256_load_si256((const __m256i *) p);
+        unsigned zmask = (unsigned) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, zero)) & valid;
+        unsigned cmask = (unsigned) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, cc)) & valid;
+        if (0 != zmask) {
+            // Only characters before the terminating NULL byte count
+            cmask &= (zmask & -zmask) - 1;
+            return n + (size_t) __builtin_popcount(cmask);
+        }
+        n += (size_t) __builtin_popcount(cmask);
+        p += 32;
+        valid = 0xFFFFFFFFu;
+    }
+}
+
+__attribute__((target("avx2")))
+const char * _rfind_avx2(const char * s, size_t len, char c) {
+    const __m256i cc = _mm256_set1_epi8(c);
+    while (32 <= len) {
+        len -= 32;
+        __m256i v = _mm256_loadu_si256((const __m256i *) (s + len));
+        unsigned mask = (unsigned) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, cc));
+        if (0 != mask) return s + len + (31 - __builtin_clz(mask));
+    }
+    return _rfind_sse2(s, len, c);
+}
+#endif
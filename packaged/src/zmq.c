@@ -73,6 +73,11 @@ static bxierr_p _process_sub_last_msg(void * sync_zocket,
 // ********************************** Global Variables *****************************
 // *********************************************************************************
 
+// Returned on each non-blocking receive with nothing to receive: allocate nothing
+static bxierr_s EAGAIN_RCV_ERR_S = BXIERR_STATIC_INIT(EAGAIN,
+                                                      "Can't receive a msg: "
+                                                      "Resource temporarily unavailable");
+
 // *********************************************************************************
 // ********************************** Implementation   *****************************
 // *********************************************************************************
@@ -462,6 +467,7 @@ bxierr_p bxizmq_msg_rcv(void * const zocket,
                                                  "through zocket: %p:"
                                                  " ZMQ EFSM (man zmq_msg_recv)",
                                                  zocket);
+            if (EAGAIN == errno) return &EAGAIN_RCV_ERR_S;
 
             return bxizmq_err(errno, "Can't receive a msg through zocket %p", zocket);
         }
@@ -545,13 +551,10 @@ bxierr_p bxizmq_msg_snd(zmq_msg_t * const zmsg,
         const int n = zmq_msg_send(zmsg, zocket, flags);
         if (n >= 0) {
             if (0 == retries) return BXIERR_OK;
-            bxierr_p new = bxierr_new(BXIZMQ_RETRIES_MAX_ERR,
-                                      (void *) retries,
-                                      NULL,
-                                      NULL,
-                                      NULL,
-                                      "Sending a message "
-                                      "needed %zu retries", retries);
+            bxierr_p new = bxierr_pooled(BXIZMQ_RETRIES_MAX_ERR,
+                                         "Sending a message "
+                                         "needed %zu retries", retries);
+            new->data = (void *) retries;
             BXIERR_CHAIN(current, new);
             return current;
         }
@@ -12,6 +12,8 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
 #include <time.h>
 
 #include <CUnit/Basic.h>
@@ -20,6 +22,8 @@
 #include "bxi/base/err.h"
 #include "bxi/base/log.h"
 
+#include "err_impl.h"
+
 SET_LOGGER(TEST_LOGGER, "test.bxierr");
 
 void test_bxierr() {
@@ -146,3 +150,127 @@ void test_bxierr_chain() {
     bxierr_destroy(&err);
 }
 
+
+void test_bxierr_backtrace() {
+    bxierr_p err = bxierr_gen("Backtrace captured");
+    CU_ASSERT_PTR_NULL(err->backtrace);
+    CU_ASSERT_PTR_NOT_NULL(err->pcs);
+    CU_ASSERT_TRUE(0 < err->pcs_nb);
+
+    // Symbolized when reported only
+    char * str = bxierr_str(err);
+    CU_ASSERT_PTR_NOT_NULL(strstr(str, "Backtrace end"));
+    CU_ASSERT_PTR_NOT_NULL(err->backtrace);
+    CU_ASSERT_PTR_NULL(err->pcs);
+    BXIFREE(str);
+    bxierr_destroy(&err);
+
+    CU_ASSERT_TRUE(bxierr_backtrace_disable(EAGAIN));
+    err = bxierr_simple(EAGAIN, "No backtrace");
+    CU_ASSERT_PTR_NULL(err->pcs);
+    str = bxierr_str(err);
+    CU_ASSERT_PTR_NULL(strstr(str, "Backtrace end"));
+    BXIFREE(str);
+    bxierr_destroy(&err);
+
+    bxierr_backtrace_enable(EAGAIN);
+    err = bxierr_simple(EAGAIN, "Backtrace captured again");
+    CU_ASSERT_PTR_NOT_NULL(err->pcs);
+    bxierr_destroy(&err);
+}
+
+void test_bxierr_backtrace_cache() {
+    char * backtraces[2];
+    size_t hits_nb[3], misses_nb[3];
+    int pcs_nb = 0;
+    bxierr__symcache_counters(&hits_nb[0], &misses_nb[0]);
+    for (size_t i = 0; i < 2; i++) {
+        // Same call site: the second symbolization is served by the cache
+        bxierr_p err = bxierr_gen("Same place");
+        pcs_nb = err->pcs_nb;
+        char * str = bxierr_str(err);
+        backtraces[i] = strdup(err->backtrace);
+        BXIFREE(str);
+        bxierr_destroy(&err);
+        bxierr__symcache_counters(&hits_nb[i + 1], &misses_nb[i + 1]);
+    }
+    CU_ASSERT_TRUE_FATAL(0 < pcs_nb);
+    // This call site was never symbolized before
+    CU_ASSERT_TRUE(0 < misses_nb[1] - misses_nb[0]);
+    CU_ASSERT_EQUAL(hits_nb[1] - hits_nb[0] + misses_nb[1] - misses_nb[0], (size_t) pcs_nb);
+    CU_ASSERT_EQUAL(hits_nb[2] - hits_nb[1], (size_t) pcs_nb);
+    CU_ASSERT_EQUAL(misses_nb[2], misses_nb[1]);
+    CU_ASSERT_STRING_EQUAL(backtraces[0], backtraces[1]);
+    BXIFREE(backtraces[0]);
+    BXIFREE(backtraces[1]);
+}
+
+void test_bxierr_set() {
+    bxierr_set_p set = bxierr_set_new();
+    const size_t codes_nb = 1000;
+    for (size_t n = 0; n < 3; n++) {
+        for (size_t i = 0; i < codes_nb; i++) {
+            bxierr_p err = bxierr_simple((int) (i * 4096), "Error %zu", i);
+            CU_ASSERT_EQUAL(bxierr_set_add(set, &err), 0 == n);
+            if (0 < n) CU_ASSERT_PTR_NULL(err);
+        }
+    }
+    CU_ASSERT_EQUAL(set->distinct_err.errors_nb, codes_nb);
+    CU_ASSERT_EQUAL(set->total_seen_nb, 3 * codes_nb);
+    for (size_t i = 0; i < codes_nb; i++) {
+        CU_ASSERT_EQUAL(set->distinct_err.errors[i]->code, (int) (i * 4096));
+        CU_ASSERT_EQUAL(set->seen_nb[i], 3);
+        CU_ASSERT_TRUE(set->first_seen[i].tv_sec <= set->last_seen[i].tv_sec);
+    }
+
+    bxierr_p err = bxierr_from_set(BXIERR_GROUP_CODE, set, "Error set");
+    char * str = bxierr_str(err);
+    CU_ASSERT_PTR_NOT_NULL(strstr(str, "seen 3 times"));
+    BXIFREE(str);
+    bxierr_destroy(&err);
+}
+
+static bxierr_s STATIC_ERR_S = BXIERR_STATIC_INIT(EAGAIN, "Expected");
+
+void test_bxierr_static_pooled() {
+    bxierr_p err = &STATIC_ERR_S;
+    CU_ASSERT_TRUE(bxierr_isko(err));
+    char * str = bxierr_str(err);
+    CU_ASSERT_PTR_NOT_NULL(strstr(str, "Expected"));
+    BXIFREE(str);
+    bxierr_destroy(&err);
+    CU_ASSERT_EQUAL(STATIC_ERR_S.code, EAGAIN);
+
+    // Chaining a static error singleton does not modify it
+    bxierr_p current = bxierr_gen("First");
+    err = &STATIC_ERR_S;
+    BXIERR_CHAIN(current, err);
+    CU_ASSERT_PTR_NOT_EQUAL(current, &STATIC_ERR_S);
+    CU_ASSERT_EQUAL(current->code, EAGAIN);
+    CU_ASSERT_PTR_NULL(STATIC_ERR_S.cause);
+    bxierr_destroy(&current);
+
+    // Pooled errors are recycled
+    err = bxierr_pooled(EAGAIN, "Pooled %d", 1);
+    CU_ASSERT_STRING_EQUAL(err->msg, "Pooled 1");
+    CU_ASSERT_PTR_NULL(err->pcs);
+    bxierr_p first = err;
+    bxierr_destroy(&err);
+    err = bxierr_pooled(EAGAIN, "Pooled %d", 2);
+    CU_ASSERT_PTR_EQUAL(err, first);
+    CU_ASSERT_STRING_EQUAL(err->msg, "Pooled 2");
+
+    err->cause = bxierr_gen("Cause");
+    str = bxierr_str(err);
+    CU_ASSERT_PTR_NOT_NULL(strstr(str, "Cause"));
+    BXIFREE(str);
+    bxierr_destroy(&err);
+
+    char msg[2 * BXIERR_POOLED_MSG_MAX];
+    memset(msg, 'm', sizeof(msg) - 1);
+    msg[sizeof(msg) - 1] = '\0';
+    err = bxierr_pooled(EAGAIN, "%s", msg);
+    CU_ASSERT_EQUAL(err->msg_len, BXIERR_POOLED_MSG_MAX - 1);
+    CU_ASSERT_EQUAL(strlen(err->msg), BXIERR_POOLED_MSG_MAX - 1);
+    bxierr_destroy(&err);
+}
@@ -17,6 +17,7 @@
 #include <time.h>
 #include <string.h>
 #include <pthread.h>
+#include <sched.h>
 #include <libgen.h>
 #include <sysexits.h>
 #include <sys/types.h>
@@ -29,19 +30,25 @@
 #include <signal.h>
 #include <syslog.h>
 #include <inttypes.h>
+#include <dirent.h>
 
 #include <CUnit/Basic.h>
 
 #include "bxi/base/str.h"
 #include "bxi/base/time.h"
+#include "bxi/base/zmq.h"
 #include "bxi/base/log.h"
 
 #include "bxi/base/log/console_handler.h"
 #include "bxi/base/log/file_handler.h"
 #include "bxi/base/log/syslog_handler.h"
 #include "bxi/base/log/remote_handler.h"
+#include "bxi/base/log/remote_receiver.h"
 #include "bxi/base/log/null_handler.h"
 
+#include "log/wire_impl.h"
+#include "log/talkers_impl.h"
+
 SET_LOGGER(TEST_LOGGER, "test.bxibase.log");
 SET_LOGGER(BAD_LOGGER1, "test.bad.logger");
 SET_LOGGER(BAD_LOGGER2, "test.bad.logger");
@@ -215,6 +222,36 @@ void test_logger_levels(void) {
     bxierr_abort_ifko(err);
 }
 
+void test_logger_compile_level(void) {
+    bxilog_config_p config = bxilog_unit_test_config(PROGNAME,
+                                                     FULLFILENAME,
+                                                     BXI_APPEND_OPEN_FLAGS);
+    bxierr_p err = bxilog_init(config);
+    bxierr_report_keep(err, STDERR_FILENO);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+
+    bxilog_level_e level = bxilog_logger_get_level(TEST_LOGGER);
+    bxilog_logger_set_level(TEST_LOGGER, BXILOG_LOWEST);
+
+    // Arguments of calls not compiled in are not evaluated
+    int evaluated = 0;
+    ERROR(TEST_LOGGER, "Always compiled in: %d", ++evaluated);
+    CU_ASSERT_EQUAL(evaluated, 1);
+    LOWEST(TEST_LOGGER, "Compiled in up to %d: %d",
+           (int) BXILOG_COMPILE_MIN_LEVEL, ++evaluated);
+    CU_ASSERT_EQUAL(evaluated, BXILOG_IS_COMPILED(BXILOG_LOWEST) ? 2 : 1);
+
+    // The error is destroyed even when not reported
+    err = bxierr_gen("Reported at the LOWEST level");
+    BXILOG_REPORT(TEST_LOGGER, BXILOG_LOWEST, err, "Compiled in up to %d",
+                  (int) BXILOG_COMPILE_MIN_LEVEL);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+
+    bxilog_logger_set_level(TEST_LOGGER, level);
+    err = bxilog_finalize(true);
+    bxierr_abort_ifko(err);
+}
+
 void test_very_long_log(void) {
     char * dirtmp = strdup(FULLFILENAME);
     char * basetmp = strdup(FULLFILENAME);
@@ -310,6 +347,499 @@ void test_logger_init() {
     CU_ASSERT_FALSE_FATAL(bxilog_is_ready());
 }
 
+void test_logger_handlers_deadline() {
+    const size_t handlers_nb = 5;
+    for (size_t n = 0; n < 10; n++) {
+        bxilog_config_p config = bxilog_config_new(PROGNAME);
+        CU_ASSERT_EQUAL(config->handlers_deadline_ms, 10000);
+        config->handlers_deadline_ms = 5000;
+        for (size_t i = 0; i < handlers_nb; i++) {
+            bxilog_config_add_handler(config, BXILOG_NULL_HANDLER, BXILOG_FILTERS_ALL_OFF);
+        }
+        struct timespec start;
+        bxierr_p err = bxitime_get(CLOCK_MONOTONIC, &start);
+        bxierr_abort_ifko(err);
+
+        // All handlers are started then stopped concurrently within the deadline
+        err = bxilog_init(config);
+        CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+        CU_ASSERT_TRUE_FATAL(bxilog_is_ready());
+        err = bxilog_finalize(true);
+        CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+
+        double duration;
+        err = bxitime_duration(CLOCK_MONOTONIC, start, &duration);
+        bxierr_abort_ifko(err);
+        CU_ASSERT_TRUE(duration < 2 * 5.0);
+    }
+}
+
+// A handler hanging on exit until it is released
+static bool BLOCKING_HANDLER_HANGS = false;
+static bool BLOCKING_HANDLER_EXITED = false;
+
+static bxilog_handler_param_p _blocking_param_new(bxilog_handler_p self,
+                                                  bxilog_filters_p filters,
+                                                  va_list ap) {
+    UNUSED(ap);
+    bxilog_handler_param_p result = bximem_calloc(sizeof(*result));
+    bxilog_handler_init_param(self, filters, result);
+    return result;
+}
+
+static bxierr_p _blocking_process_implicit_flush(bxilog_handler_param_p param) {
+    UNUSED(param);
+    while (__atomic_load_n(&BLOCKING_HANDLER_HANGS, __ATOMIC_ACQUIRE)) usleep(1000);
+    return BXIERR_OK;
+}
+
+static bxierr_p _blocking_process_exit(bxilog_handler_param_p param) {
+    UNUSED(param);
+    __atomic_store_n(&BLOCKING_HANDLER_EXITED, true, __ATOMIC_RELEASE);
+    return BXIERR_OK;
+}
+
+static bxierr_p _blocking_param_destroy(bxilog_handler_param_p * param_p) {
+    bxilog_handler_clean_param(*param_p);
+    bximem_destroy((char**) param_p);
+    return BXIERR_OK;
+}
+
+static const bxilog_handler_s BLOCKING_HANDLER_S = {
+                  .name = "Test Blocking Handler",
+                  .param_new = _blocking_param_new,
+                  .process_implicit_flush = _blocking_process_implicit_flush,
+                  .process_exit = _blocking_process_exit,
+                  .param_destroy = _blocking_param_destroy,
+};
+
+void test_logger_handlers_deadline_expired() {
+    bxilog_config_p config = bxilog_config_new(PROGNAME);
+    config->handlers_deadline_ms = 500;
+    bxilog_config_add_handler(config, BXILOG_NULL_HANDLER, BXILOG_FILTERS_ALL_OFF);
+    bxilog_config_add_handler(config, (bxilog_handler_p) &BLOCKING_HANDLER_S,
+                              BXILOG_FILTERS_ALL_OFF);
+    bxierr_p err = bxilog_init(config);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+
+    __atomic_store_n(&BLOCKING_HANDLER_HANGS, true, __ATOMIC_RELEASE);
+    __atomic_store_n(&BLOCKING_HANDLER_EXITED, false, __ATOMIC_RELEASE);
+    struct timespec start;
+    err = bxitime_get(CLOCK_MONOTONIC, &start);
+    bxierr_abort_ifko(err);
+
+    // The hanging handler is left behind when the deadline expires
+    err = bxilog_finalize(true);
+    double duration;
+    bxierr_p err2 = bxitime_duration(CLOCK_MONOTONIC, start, &duration);
+    bxierr_abort_ifko(err2);
+    CU_ASSERT_TRUE(duration < 2 * 0.5);
+    CU_ASSERT_TRUE_FATAL(bxierr_isko(err));
+    CU_ASSERT_EQUAL_FATAL(err->code, BXIERR_GROUP_CODE);
+    bxierr_list_p errlist = err->data;
+    CU_ASSERT_EQUAL(errlist->errors_nb, 1);
+    CU_ASSERT_EQUAL(errlist->errors[0]->code, BXIZMQ_TIMEOUT_ERR);
+    bxierr_destroy(&err);
+
+    // Its parameters and its zmq context are still there when it is released
+    __atomic_store_n(&BLOCKING_HANDLER_HANGS, false, __ATOMIC_RELEASE);
+    for (size_t n = 0; n < 5000; n++) {
+        if (__atomic_load_n(&BLOCKING_HANDLER_EXITED, __ATOMIC_ACQUIRE)) break;
+        usleep(1000);
+    }
+    CU_ASSERT_TRUE(__atomic_load_n(&BLOCKING_HANDLER_EXITED, __ATOMIC_ACQUIRE));
+
+    err = bxilog_finalize(true);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+}
+
+static void * _inline_logging_thread(void * data) {
+    size_t rank = (size_t) data;
+    for (size_t i = 0; i < 1000; i++) {
+        DEBUG(TEST_LOGGER, "Inline thread %zu: log %zu", rank, i);
+    }
+    return NULL;
+}
+
+void test_logger_inline() {
+    char * filename = strdup("/tmp/test_logger_inline.XXXXXX");
+    int fd = mkstemp(filename);
+    bxiassert(0 < fd);
+
+    bxilog_config_p config = bxilog_unit_test_config(PROGNAME,
+                                                     FULLFILENAME,
+                                                     BXI_APPEND_OPEN_FLAGS);
+    config->handlers_mode = BXILOG_HANDLERS_INLINE;
+    bxilog_filters_p filters = bxilog_filters_new();
+    bxilog_filters_add(&filters, "", BXILOG_OFF);
+    bxilog_filters_add(&filters, TEST_LOGGER->name, BXILOG_ALL);
+    bxilog_config_add_handler(config,
+                              BXILOG_FILE_HANDLER,
+                              filters,
+                              PROGNAME, filename, BXI_APPEND_OPEN_FLAGS);
+    bxierr_p err = bxilog_init(config);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+    CU_ASSERT_TRUE_FATAL(bxilog_is_ready());
+
+    // Handlers are called by the logging threads themselves, one at a time
+    pthread_t threads[4];
+    for (size_t i = 0; i < ARRAYLEN(threads); i++) {
+        int rc = pthread_create(&threads[i], NULL, _inline_logging_thread, (void *) i);
+        CU_ASSERT_EQUAL_FATAL(rc, 0);
+    }
+    for (size_t i = 0; i < ARRAYLEN(threads); i++) {
+        int rc = pthread_join(threads[i], NULL);
+        CU_ASSERT_EQUAL(rc, 0);
+    }
+    err = bxilog_flush();
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    bxierr_destroy(&err);
+
+    // None is lost
+    size_t lines_nb = 0;
+    while (true) {
+        char c;
+        ssize_t n = read(fd, &c, 1);
+        if (0 >= n) break;
+        if ('\n' == c) lines_nb++;
+    }
+    CU_ASSERT_EQUAL(lines_nb, ARRAYLEN(threads) * 1000);
+    close(fd);
+    unlink(filename);
+    BXIFREE(filename);
+
+    errno = 0;
+    pid_t cpid = fork();
+    if (-1 == cpid) {
+        BXIEXIT(EXIT_FAILURE, bxierr_errno("Can't fork()"), TEST_LOGGER, BXILOG_CRITICAL);
+    }
+    if (0 == cpid) {
+        // The child starts its own inline handlers (BXILOG_FORK_RESTART)
+        bool ready = bxilog_is_ready();
+        config = bxilog_unit_test_config(PROGNAME, FULLFILENAME, BXI_APPEND_OPEN_FLAGS);
+        config->handlers_mode = BXILOG_HANDLERS_INLINE;
+        err = bxilog_init(config);
+        OUT(TEST_LOGGER, "Inline child: one log line");
+        bxierr_p err2 = bxilog_finalize(true);
+        BXIERR_CHAIN(err, err2);
+        exit((!ready && bxierr_isok(err)) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    int status;
+    pid_t w = waitpid(cpid, &status, 0);
+    CU_ASSERT_EQUAL(w, cpid);
+    CU_ASSERT_TRUE(WIFEXITED(status));
+    CU_ASSERT_EQUAL(WEXITSTATUS(status), EXIT_SUCCESS);
+    CU_ASSERT_TRUE(bxilog_is_ready());
+
+    err = bxilog_finalize(true);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+    CU_ASSERT_FALSE_FATAL(bxilog_is_ready());
+}
+
+// A handler raising a signal while it processes a log
+static bxierr_p _raising_process_log(bxilog_record_p record,
+                                     char * filename,
+                                     char * funcname,
+                                     char * loggername,
+                                     char * logmsg,
+                                     bxilog_handler_param_p param) {
+    UNUSED(record); UNUSED(filename); UNUSED(funcname);
+    UNUSED(loggername); UNUSED(logmsg); UNUSED(param);
+    raise(SIGTERM);
+    return BXIERR_OK;
+}
+
+static const bxilog_handler_s RAISING_HANDLER_S = {
+                  .name = "Test Raising Handler",
+                  .param_new = _blocking_param_new,
+                  .process_log = _raising_process_log,
+                  .param_destroy = _blocking_param_destroy,
+};
+
+void test_logger_inline_signal() {
+    int pipefd[2];
+    int rc = pipe(pipefd);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+    errno = 0;
+    pid_t cpid = fork();
+    CU_ASSERT_TRUE_FATAL(-1 != cpid);
+    if (0 == cpid) {
+        // Hanging in the signal handler is caught
+        alarm(10);
+        close(pipefd[0]);
+        dup2(pipefd[1], STDERR_FILENO);
+        bxilog_config_p config = bxilog_config_new(PROGNAME);
+        config->handlers_mode = BXILOG_HANDLERS_INLINE;
+        bxilog_config_add_handler(config, (bxilog_handler_p) &RAISING_HANDLER_S,
+                                  BXILOG_FILTERS_ALL_OUTPUT);
+        bxierr_p err = bxilog_init(config);
+        if (bxierr_isko(err)) exit(EXIT_FAILURE);
+        err = bxilog_install_sighandler();
+        if (bxierr_isko(err)) exit(EXIT_FAILURE);
+        // The signal handler runs on this thread, inside the handler callback
+        OUT(TEST_LOGGER, "Inline signal child: one log line");
+        exit(EXIT_FAILURE);
+    }
+    close(pipefd[1]);
+    char buf[4096];
+    size_t len = 0;
+    while (len < sizeof(buf) - 1) {
+        ssize_t n = read(pipefd[0], buf + len, sizeof(buf) - 1 - len);
+        if (0 >= n) break;
+        len += (size_t) n;
+    }
+    buf[len] = '\0';
+    close(pipefd[0]);
+
+    int status;
+    pid_t w = waitpid(cpid, &status, 0);
+    CU_ASSERT_EQUAL(w, cpid);
+    CU_ASSERT_TRUE(WIFSIGNALED(status));
+    CU_ASSERT_EQUAL(WTERMSIG(status), SIGTERM);
+    // The handlers are not stopped: this is reported instead
+    CU_ASSERT_PTR_NOT_NULL(strstr(buf, "can't be stopped"));
+}
+
+void test_logger_stats() {
+    bxilog_stats_p stats = NULL;
+    bxierr_p err = bxilog_stats_get(&stats);
+    CU_ASSERT_TRUE(bxierr_isko(err));
+    CU_ASSERT_PTR_NULL(stats);
+    bxierr_destroy(&err);
+
+    const bxilog_handlers_mode_e modes[] = {BXILOG_HANDLERS_THREADED,
+                                            BXILOG_HANDLERS_INLINE};
+    for (size_t m = 0; m < ARRAYLEN(modes); m++) {
+        bxilog_config_p config = bxilog_unit_test_config(PROGNAME,
+                                                         FULLFILENAME,
+                                                         BXI_APPEND_OPEN_FLAGS);
+        bxilog_config_add_handler(config, BXILOG_NULL_HANDLER, BXILOG_FILTERS_ALL_OFF);
+        config->handlers_mode = modes[m];
+        config->stats_period_ms = 10;
+        config->handlers_process_time = true;
+        config->handlers_latency_dump = true;
+        err = bxilog_init(config);
+        CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+
+        pthread_t threads[4];
+        for (size_t i = 0; i < ARRAYLEN(threads); i++) {
+            int rc = pthread_create(&threads[i], NULL,
+                                    _inline_logging_thread, (void *) i);
+            CU_ASSERT_EQUAL_FATAL(rc, 0);
+        }
+        for (size_t i = 0; i < ARRAYLEN(threads); i++) {
+            int rc = pthread_join(threads[i], NULL);
+            CU_ASSERT_EQUAL(rc, 0);
+        }
+        // The statistics are logged by their own thread
+        usleep(20000);
+        OUT(TEST_LOGGER, "Logging thread stopped");
+        err = bxilog_flush();
+        CU_ASSERT_TRUE(bxierr_isok(err));
+        bxierr_destroy(&err);
+
+        err = bxilog_stats_get(&stats);
+        CU_ASSERT_TRUE(bxierr_isok(err));
+        bxierr_destroy(&err);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(stats);
+
+        // Exited threads are accounted for
+        CU_ASSERT_TRUE(stats->threads_nb >= ARRAYLEN(threads));
+        CU_ASSERT_TRUE(stats->log_nb >= ARRAYLEN(threads) * 1000);
+        CU_ASSERT_TRUE(0 < stats->min_log_size);
+        CU_ASSERT_TRUE(stats->min_log_size <= stats->max_log_size);
+        CU_ASSERT_TRUE(stats->sum_log_size >= stats->log_nb * stats->min_log_size);
+        CU_ASSERT_EQUAL_FATAL(stats->handlers_nb, 2);
+
+        bxilog_handler_stats_p file = &stats->handlers[0];
+        CU_ASSERT_PTR_NOT_NULL(file->name);
+        CU_ASSERT_TRUE(file->processed_nb >= ARRAYLEN(threads) * 1000);
+        CU_ASSERT_TRUE(file->processed_nb + file->filtered_nb +
+                       file->dropped_nb <= stats->log_nb);
+        // Records sent after retries are not lost
+        CU_ASSERT_TRUE(file->retried_nb <= file->processed_nb + file->filtered_nb);
+        if (BXILOG_HANDLERS_THREADED == modes[m]) CU_ASSERT_EQUAL(file->dropped_nb, 0);
+        CU_ASSERT_TRUE(0 < file->flushes_nb);
+        CU_ASSERT_TRUE(file->flush_max_duration <= file->flushes_duration);
+        CU_ASSERT_TRUE(0 < file->bytes_written);
+        CU_ASSERT_EQUAL(file->queue_delay.count, file->processed_nb);
+        CU_ASSERT_EQUAL(file->process_time.count, file->processed_nb);
+        CU_ASSERT_TRUE(file->queue_delay.min <= file->queue_delay.max);
+
+        bxilog_handler_stats_p null = &stats->handlers[1];
+        CU_ASSERT_TRUE(null->filtered_nb >= ARRAYLEN(threads) * 1000);
+        CU_ASSERT_EQUAL(null->bytes_written, 0);
+        if (BXILOG_HANDLERS_INLINE == modes[m]) {
+            CU_ASSERT_EQUAL(file->queue_depth, 0);
+        }
+
+        CU_ASSERT_EQUAL(null->queue_delay.count, 0);
+        // Talkers are not tracked by default
+        CU_ASSERT_EQUAL(file->top_loggers[0].records_nb, 0);
+        CU_ASSERT_EQUAL(file->top_sites[0].records_nb, 0);
+#ifdef BXILOG_STAGES_TIMING
+        CU_ASSERT_TRUE(0 < stats->stages[BXILOG_STAGE_FORMAT].count);
+        CU_ASSERT_TRUE(stats->stages[BXILOG_STAGE_FORMAT].count <= stats->log_nb);
+        CU_ASSERT_TRUE(0 < stats->stages[BXILOG_STAGE_RECORD].ticks);
+        CU_ASSERT_EQUAL(file->stages[BXILOG_STAGE_FILTER].count,
+                        file->processed_nb + file->filtered_nb);
+        if (BXILOG_HANDLERS_THREADED == modes[m]) {
+            CU_ASSERT_TRUE(0 < stats->stages[BXILOG_STAGE_SEND].count);
+            // One receive per record: the EAGAIN ending a flush does not count
+            CU_ASSERT_EQUAL(file->stages[BXILOG_STAGE_RECEIVE].count,
+                            file->stages[BXILOG_STAGE_FILTER].count);
+        }
+#endif
+
+        bxilog_stats_destroy(&stats);
+        CU_ASSERT_PTR_NULL(stats);
+
+        err = bxilog_finalize(true);
+        CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+    }
+}
+
+// A handler hanging on its first log until it is released
+static bxierr_p _hanging_process_log(bxilog_record_p record,
+                                     char * filename,
+                                     char * funcname,
+                                     char * loggername,
+                                     char * logmsg,
+                                     bxilog_handler_param_p param) {
+    UNUSED(record); UNUSED(filename); UNUSED(funcname);
+    UNUSED(loggername); UNUSED(logmsg); UNUSED(param);
+    while (__atomic_load_n(&BLOCKING_HANDLER_HANGS, __ATOMIC_ACQUIRE)) usleep(1000);
+    return BXIERR_OK;
+}
+
+// Keep the internal errors: bxilog_finalize() reports them
+static bxierr_p _hanging_process_ierr(bxierr_p * err, bxilog_handler_param_p param) {
+    UNUSED(param);
+    return *err;
+}
+
+static const bxilog_handler_s HANGING_HANDLER_S = {
+                  .name = "Test Hanging Handler",
+                  .param_new = _blocking_param_new,
+                  .process_log = _hanging_process_log,
+                  .process_ierr = _hanging_process_ierr,
+                  .param_destroy = _blocking_param_destroy,
+};
+
+void test_logger_stats_hanging() {
+    bxilog_config_p config = bxilog_config_new(PROGNAME);
+    config->stats_period_ms = 10;
+    config->handlers_deadline_ms = 500;
+    bxilog_config_add_handler(config, (bxilog_handler_p) &HANGING_HANDLER_S,
+                              BXILOG_FILTERS_ALL_OUTPUT);
+    __atomic_store_n(&BLOCKING_HANDLER_HANGS, true, __ATOMIC_RELEASE);
+    bxierr_p err = bxilog_init(config);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+
+    struct timespec start;
+    err = bxitime_get(CLOCK_MONOTONIC, &start);
+    bxierr_abort_ifko(err);
+
+    // The handler can't send its statistics: logging does not wait for them
+    for (size_t i = 0; i < 100; i++) {
+        OUT(TEST_LOGGER, "Stats hanging: log %zu", i);
+        usleep(1000);
+    }
+    double duration;
+    err = bxitime_duration(CLOCK_MONOTONIC, start, &duration);
+    bxierr_abort_ifko(err);
+    CU_ASSERT_TRUE(duration < 0.5);
+
+    __atomic_store_n(&BLOCKING_HANDLER_HANGS, false, __ATOMIC_RELEASE);
+    err = bxilog_finalize(true);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+}
+
+void test_logger_talkers() {
+    const bxilog_handlers_mode_e modes[] = {BXILOG_HANDLERS_THREADED,
+                                            BXILOG_HANDLERS_INLINE};
+    char msg[256];
+    memset(msg, 'x', sizeof(msg) - 1);
+    msg[sizeof(msg) - 1] = '\0';
+    for (size_t m = 0; m < ARRAYLEN(modes); m++) {
+        bxilog_config_p config = bxilog_unit_test_config(PROGNAME,
+                                                         FULLFILENAME,
+                                                         BXI_APPEND_OPEN_FLAGS);
+        config->handlers_mode = modes[m];
+        config->handlers_talkers = true;
+        bxierr_p err = bxilog_init(config);
+        CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+
+        const int line = __LINE__ + 2;
+        for (size_t i = 0; i < 100; i++) {
+            OUT(TEST_LOGGER, "Talking a lot: %s", msg);
+        }
+        OUT(BAD_LOGGER1, "Talking a little: %s", msg);
+        // More call sites than tracked: the largest one must be found anyway
+        for (int i = 1; i <= 4 * BXILOG__TALKERS_CAPACITY; i++) {
+            bxilog_logger_log_rawstr(BAD_LOGGER2, BXILOG_OUTPUT, "sites.c", 8,
+                                     __func__, ARRAYLEN(__func__), i, "x", 2);
+        }
+        err = bxilog_flush();
+        CU_ASSERT_TRUE(bxierr_isok(err));
+        bxierr_destroy(&err);
+
+        bxilog_stats_p stats = NULL;
+        err = bxilog_stats_get(&stats);
+        CU_ASSERT_TRUE(bxierr_isok(err));
+        bxierr_destroy(&err);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(stats);
+        CU_ASSERT_TRUE_FATAL(0 < stats->handlers_nb);
+
+        bxilog_handler_stats_p file = &stats->handlers[0];
+        CU_ASSERT_STRING_EQUAL(file->top_loggers[0].name, TEST_LOGGER->name);
+        CU_ASSERT_EQUAL(file->top_loggers[0].line, 0);
+        CU_ASSERT_TRUE(file->top_loggers[0].records_nb >= 100);
+        CU_ASSERT_TRUE(file->top_loggers[0].bytes_nb >= 100 * sizeof(msg));
+        CU_ASSERT_EQUAL(file->top_loggers[0].records_error_nb, 0);
+        CU_ASSERT_STRING_EQUAL(file->top_sites[0].name, "test_logger.c");
+        CU_ASSERT_EQUAL(file->top_sites[0].line, line);
+        CU_ASSERT_TRUE(file->top_sites[0].records_nb >= 100);
+        for (size_t i = 1; i < BXILOG_TALKERS_NB; i++) {
+            CU_ASSERT_TRUE(file->top_loggers[i].bytes_nb <= file->top_loggers[i - 1].bytes_nb);
+            CU_ASSERT_TRUE(file->top_sites[i].bytes_nb <= file->top_sites[i - 1].bytes_nb);
+        }
+        bxilog_stats_destroy(&stats);
+
+        err = bxilog_finalize(true);
+        CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+    }
+}
+
+void test_logger_histogram() {
+    bxilog_histogram_s histogram;
+    memset(&histogram, 0, sizeof(histogram));
+    CU_ASSERT_EQUAL(bxilog_histogram_percentile(&histogram, 50), 0);
+
+    for (uint64_t value = 1; value <= 1000; value++) bxilog_histogram_add(&histogram, value);
+    CU_ASSERT_EQUAL(histogram.count, 1000);
+    CU_ASSERT_EQUAL(histogram.min, 1);
+    CU_ASSERT_EQUAL(histogram.max, 1000);
+    CU_ASSERT_EQUAL(histogram.sum, 500500);
+
+    // Small values are exact, others are within 12.5%
+    CU_ASSERT_EQUAL(bxilog_histogram_percentile(&histogram, 0.5), 5);
+    const double percentiles[] = {10, 50, 90, 99, 99.9};
+    for (size_t i = 0; i < ARRAYLEN(percentiles); i++) {
+        const double expected = percentiles[i] * 10;
+        const uint64_t value = bxilog_histogram_percentile(&histogram, percentiles[i]);
+        CU_ASSERT_TRUE(value >= expected);
+        CU_ASSERT_TRUE(value <= expected * 1.125);
+    }
+    CU_ASSERT_EQUAL(bxilog_histogram_percentile(&histogram, 100), 1000);
+
+    // Out of range values end up in the last bucket
+    bxilog_histogram_add(&histogram, UINT64_MAX);
+    CU_ASSERT_EQUAL(histogram.buckets[BXILOG_HISTOGRAM_BUCKETS_NB - 1], 1);
+    CU_ASSERT_EQUAL(bxilog_histogram_percentile(&histogram, 100), UINT64_MAX);
+}
+
 static char * _get_filename(int fd) {
     char path[512];
     const size_t n = 512 * sizeof(*path);
@@ -526,11 +1056,167 @@ void test_registry(void) {
     CU_ASSERT_TRUE(bxierr_isok(err));
     CU_ASSERT_PTR_NOT_NULL_FATAL(logger_ab);
 
+    // Enough loggers to grow the index several times
+    for (size_t i = 0; i < 1000; i++) {
+        char * name = bxistr_new("a.many.%zu", i);
+        bxilog_logger_p logger, same;
+        err = bxilog_registry_get(name, &logger);
+        CU_ASSERT_TRUE(bxierr_isok(err));
+        err = bxilog_registry_get(name, &same);
+        CU_ASSERT_TRUE(bxierr_isok(err));
+        CU_ASSERT_PTR_EQUAL(logger, same);
+        CU_ASSERT_STRING_EQUAL(logger->name, name);
+        BXIFREE(name);
+    }
+    bxilog_logger_p logger;
+    err = bxilog_registry_get("a", &logger);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    CU_ASSERT_PTR_EQUAL(logger, logger_a);
+
+    // The registry is returned sorted
+    bxilog_logger_p *loggers;
+    size_t n = bxilog_registry_getall(&loggers);
+    for (size_t i = 1; i < n; i++) {
+        CU_ASSERT_TRUE(strcmp(loggers[i - 1]->name, loggers[i]->name) <= 0);
+    }
+    BXIFREE(loggers);
+
     err = bxilog_finalize(true);
     CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
     bxilog_registry_reset();
 }
 
+// Looks up the loggers given in data until it is asked to stop
+static bool REGISTRY_STRESS_STOP = false;
+// Readers which looked all the loggers up once
+static size_t REGISTRY_READERS_NB = 0;
+
+static void * _registry_reader(void * data) {
+    bxilog_logger_p * loggers = data;
+    size_t lookups_nb = 0;
+    while (!__atomic_load_n(&REGISTRY_STRESS_STOP, __ATOMIC_ACQUIRE)) {
+        for (size_t i = 0; i < 64; i++) {
+            bxilog_logger_p logger;
+            bxierr_p err = bxilog_registry_get(loggers[i]->name, &logger);
+            bxiassert(bxierr_isok(err));
+            bxiassert(logger == loggers[i]);
+            lookups_nb++;
+        }
+        if (64 == lookups_nb) __atomic_add_fetch(&REGISTRY_READERS_NB, 1, __ATOMIC_RELEASE);
+    }
+    return (void *) lookups_nb;
+}
+
+void test_registry_stress(void) {
+    bxilog_registry_reset();
+    bxilog_config_p config = bxilog_unit_test_config(PROGNAME,
+                                                     FULLFILENAME,
+                                                     BXI_APPEND_OPEN_FLAGS);
+    bxierr_p err = bxilog_init(config);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+
+    bxilog_logger_p loggers[64];
+    for (size_t i = 0; i < ARRAYLEN(loggers); i++) {
+        char * name = bxistr_new("test.bxibase.registry.stress.%zu", i);
+        err = bxilog_registry_get(name, &loggers[i]);
+        CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+        BXIFREE(name);
+    }
+
+    __atomic_store_n(&REGISTRY_STRESS_STOP, false, __ATOMIC_RELEASE);
+    __atomic_store_n(&REGISTRY_READERS_NB, 0, __ATOMIC_RELEASE);
+    pthread_t threads[4];
+    for (size_t t = 0; t < ARRAYLEN(threads); t++) {
+        int rc = pthread_create(&threads[t], NULL, _registry_reader, loggers);
+        CU_ASSERT_EQUAL_FATAL(rc, 0);
+    }
+    while (ARRAYLEN(threads) > __atomic_load_n(&REGISTRY_READERS_NB, __ATOMIC_ACQUIRE)) {
+        sched_yield();
+    }
+
+    // Tombstones fill the index: it is replaced, and the old one released,
+    // while lookups are in progress
+    for (size_t i = 0; i < 2000; i++) {
+        char * name = bxistr_new("test.bxibase.registry.churn.%zu", i % 512);
+        bxilog_logger_p logger;
+        err = bxilog_registry_get(name, &logger);
+        CU_ASSERT_TRUE(bxierr_isok(err));
+        BXIFREE(name);
+        bxilog_registry_del(logger);
+        bxilog_logger_destroy(&logger);
+    }
+
+    __atomic_store_n(&REGISTRY_STRESS_STOP, true, __ATOMIC_RELEASE);
+    for (size_t t = 0; t < ARRAYLEN(threads); t++) {
+        void * lookups_nb;
+        int rc = pthread_join(threads[t], &lookups_nb);
+        CU_ASSERT_EQUAL(rc, 0);
+        CU_ASSERT_TRUE(0 < (size_t) lookups_nb);
+    }
+
+    err = bxilog_finalize(true);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+    bxilog_registry_reset();
+}
+
+void test_registry_fork(void) {
+    bxilog_registry_reset();
+    bxilog_config_p config = bxilog_unit_test_config(PROGNAME,
+                                                     FULLFILENAME,
+                                                     BXI_APPEND_OPEN_FLAGS);
+    bxierr_p err = bxilog_init(config);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+
+    bxilog_logger_p loggers[64];
+    for (size_t i = 0; i < ARRAYLEN(loggers); i++) {
+        char * name = bxistr_new("test.bxibase.registry.fork.%zu", i);
+        err = bxilog_registry_get(name, &loggers[i]);
+        CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+        BXIFREE(name);
+    }
+
+    __atomic_store_n(&REGISTRY_STRESS_STOP, false, __ATOMIC_RELEASE);
+    __atomic_store_n(&REGISTRY_READERS_NB, 0, __ATOMIC_RELEASE);
+    pthread_t threads[4];
+    for (size_t t = 0; t < ARRAYLEN(threads); t++) {
+        int rc = pthread_create(&threads[t], NULL, _registry_reader, loggers);
+        CU_ASSERT_EQUAL_FATAL(rc, 0);
+    }
+    while (ARRAYLEN(threads) > __atomic_load_n(&REGISTRY_READERS_NB, __ATOMIC_ACQUIRE)) {
+        sched_yield();
+    }
+
+    // Lookups in progress in the reader threads at fork() time never end in
+    // the child: deleting a logger there must not wait for them
+    for (size_t i = 0; i < 16; i++) {
+        pid_t cpid = fork();
+        CU_ASSERT_TRUE_FATAL(-1 != cpid);
+        if (0 == cpid) {
+            alarm(10);
+            bxilog_logger_p logger;
+            err = bxilog_registry_get("test.bxibase.registry.fork.child", &logger);
+            if (bxierr_isko(err)) _exit(EX_SOFTWARE);
+            bxilog_registry_del(logger);
+            bxilog_logger_destroy(&logger);
+            _exit(EXIT_SUCCESS);
+        }
+        int status;
+        pid_t w = waitpid(cpid, &status, 0);
+        CU_ASSERT_EQUAL(w, cpid);
+        CU_ASSERT_TRUE(WIFEXITED(status));
+        CU_ASSERT_EQUAL(WEXITSTATUS(status), EXIT_SUCCESS);
+    }
+
+    __atomic_store_n(&REGISTRY_STRESS_STOP, true, __ATOMIC_RELEASE);
+    for (size_t t = 0; t < ARRAYLEN(threads); t++) {
+        int rc = pthread_join(threads[t], NULL);
+        CU_ASSERT_EQUAL(rc, 0);
+    }
+
+    err = bxilog_finalize(true);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+    bxilog_registry_reset();
+}
 
 void test_filters_parser(void) {
     bxilog_registry_reset();
@@ -774,6 +1460,85 @@ void test_filters_complex() {
 //    bxilog_filters_destroy(&filters2);
 }
 
+void test_filters_reconfigure() {
+    bxilog_registry_reset();
+
+    char filters1_format[] = "a:debug";
+    bxilog_filters_p filters1 = NULL;
+    bxierr_p err = bxilog_filters_parse(filters1_format, &filters1);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+
+    char filters2_format[] = "a:error,a.b:trace";
+    bxilog_filters_p filters2 = NULL;
+    err = bxilog_filters_parse(filters2_format, &filters2);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+
+    bxilog_config_p config = bxilog_config_new(PROGNAME);
+    bxilog_config_add_handler(config,
+                              BXILOG_NULL_HANDLER,
+                              filters1);
+    bxilog_config_add_handler(config,
+                              BXILOG_NULL_HANDLER,
+                              filters2);
+    err = bxilog_init(config);
+    bxiassert(bxierr_isok(err));
+
+    bxilog_logger_p a, ab;
+    err = bxilog_registry_get("a", &a);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    err = bxilog_registry_get("a.b", &ab);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    CU_ASSERT_EQUAL(BXILOG_DEBUG, a->level);
+    CU_ASSERT_EQUAL(BXILOG_TRACE, ab->level);
+
+    // Only the second handler changes
+    char filters3_format[] = "a:warning";
+    bxilog_filters_p filters[2] = {NULL, NULL};
+    err = bxilog_filters_parse(filters3_format, &filters[1]);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    err = bxilog_reconfigure(filters, 2);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    CU_ASSERT_PTR_NULL(filters[1]);
+    // Levels are refreshed on first use only
+    CU_ASSERT_EQUAL(BXILOG_TRACE, ab->level);
+    CU_ASSERT_NOT_EQUAL(bxilog__config_epoch, ab->epoch);
+    CU_ASSERT_EQUAL(BXILOG_DEBUG, bxilog_logger_get_level(a));
+    CU_ASSERT_EQUAL(BXILOG_DEBUG, bxilog_logger_get_level(ab));
+    CU_ASSERT_EQUAL(bxilog__config_epoch, ab->epoch);
+    CU_ASSERT_STRING_EQUAL("a", config->handlers_params[1]->filters->list[0]->prefix);
+
+    // Loggers created afterwards use the new filters
+    bxilog_logger_p abc;
+    err = bxilog_registry_get("a.b.c", &abc);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    CU_ASSERT_EQUAL(BXILOG_DEBUG, abc->level);
+
+    char filters4_format[] = "a:lowest";
+    err = bxilog_filters_parse(filters4_format, &filters[0]);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    DEBUG(a, "Logged before the reconfiguration");
+    err = bxilog_reconfigure(filters, 2);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    CU_ASSERT_TRUE(bxilog_logger_is_enabled_for(abc, BXILOG_LOWEST));
+    CU_ASSERT_EQUAL(BXILOG_LOWEST, bxilog_logger_get_level(a));
+    LOWEST(abc, "Logged after the reconfiguration");
+
+    // An explicit level remains until the next configuration change
+    bxilog_logger_set_level(abc, BXILOG_ERROR);
+    CU_ASSERT_FALSE(bxilog_logger_is_enabled_for(abc, BXILOG_WARNING));
+
+    // The number of filters must match the number of handlers
+    err = bxilog_filters_parse(filters4_format, &filters[0]);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    err = bxilog_reconfigure(filters, 1);
+    CU_ASSERT_TRUE(bxierr_isko(err));
+    CU_ASSERT_PTR_NULL(filters[0]);
+    bxierr_destroy(&err);
+
+    err = bxilog_finalize(true);
+    bxiassert(bxierr_isok(err));
+}
+
 
 void _fork_childs(size_t n) {
     if (n == 0) return;
@@ -857,6 +1622,120 @@ void test_logger_fork(void) {
     CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
 }
 
+void test_logger_fork_quiesce(void) {
+    bxilog_config_p config = bxilog_unit_test_config(PROGNAME,
+                                                     FULLFILENAME,
+                                                     BXI_APPEND_OPEN_FLAGS);
+    config->fork_mode = BXILOG_FORK_QUIESCE;
+    bxierr_p err = bxilog_init(config);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+
+    for (size_t i = 0; i < 20; i++) {
+        OUT(TEST_LOGGER, "Parent: forking child #%zu", i);
+        errno = 0;
+        pid_t cpid = fork();
+        if (-1 == cpid) {
+            BXIEXIT(EXIT_FAILURE, bxierr_errno("Can't fork()"), TEST_LOGGER, BXILOG_CRITICAL);
+        }
+        if (0 == cpid) {
+            // Handlers of the child are started on its first log, without bxilog_init()
+            bool ready = bxilog_is_ready();
+            if (0 == i % 2) OUT(TEST_LOGGER, "Child #%zu: One log line", i);
+            err = bxilog_finalize(true);
+            exit((!ready && bxierr_isok(err)) ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+        // Handlers of the parent are still there
+        CU_ASSERT_TRUE(bxilog_is_ready());
+        OUT(TEST_LOGGER, "Parent: child #%zu forked", i);
+        int status;
+        pid_t w = waitpid(cpid, &status, 0);
+        CU_ASSERT_EQUAL(w, cpid);
+        CU_ASSERT_TRUE(WIFEXITED(status));
+        CU_ASSERT_EQUAL(WEXITSTATUS(status), EXIT_SUCCESS);
+    }
+    err = bxilog_finalize(true);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+}
+
+// Logs, and takes the locks of the library, until it is asked to stop
+static void * _busy_thread(void * data) {
+    bool * stop = data;
+    for (size_t i = 0; !__atomic_load_n(stop, __ATOMIC_ACQUIRE); i++) {
+        INFO(TEST_LOGGER, "Busy thread: log %zu", i);
+        // The registry and the compiled filters (level of a new logger)
+        char * name = bxistr_new("test.bxibase.log.fork.busy.%zu", i % 1024);
+        bxilog_logger_p logger;
+        bxierr_p err = bxilog_registry_get(name, &logger);
+        bxiassert(bxierr_isok(err));
+        BXIFREE(name);
+        // The list of the thread-specific data
+        bxilog_stats_p stats = NULL;
+        err = bxilog_stats_get(&stats);
+        bxierr_destroy(&err);
+        bxilog_stats_destroy(&stats);
+        // The cache of the symbolized backtraces
+        err = bxierr_gen("Busy thread: error %zu", i);
+        char * str = bxierr_str(err);
+        BXIFREE(str);
+        bxierr_destroy(&err);
+    }
+    return NULL;
+}
+
+void test_logger_fork_quiesce_busy(void) {
+    bxilog_config_p config = bxilog_unit_test_config(PROGNAME,
+                                                     FULLFILENAME,
+                                                     BXI_APPEND_OPEN_FLAGS);
+    config->fork_mode = BXILOG_FORK_QUIESCE;
+    bxierr_p err = bxilog_init(config);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+
+    bool stop = false;
+    pthread_t threads[4];
+    for (size_t t = 0; t < ARRAYLEN(threads); t++) {
+        int rc = pthread_create(&threads[t], NULL, _busy_thread, &stop);
+        CU_ASSERT_EQUAL_FATAL(rc, 0);
+    }
+
+    for (size_t i = 0; i < 200; i++) {
+        errno = 0;
+        pid_t cpid = fork();
+        if (-1 == cpid) {
+            BXIEXIT(EXIT_FAILURE, bxierr_errno("Can't fork()"), TEST_LOGGER, BXILOG_CRITICAL);
+        }
+        if (0 == cpid) {
+            // A lock inherited held would hang the child
+            alarm(30);
+            OUT(TEST_LOGGER, "Child #%zu: One log line", i);
+            char * name = bxistr_new("test.bxibase.log.fork.child.%zu", i);
+            bxilog_logger_p logger;
+            err = bxilog_registry_get(name, &logger);
+            BXIFREE(name);
+            bool ok = bxierr_isok(err);
+            bxilog_stats_p stats = NULL;
+            err = bxilog_stats_get(&stats);
+            ok = ok && bxierr_isok(err) && 1 <= stats->log_nb;
+            bxilog_stats_destroy(&stats);
+            err = bxierr_gen("Child #%zu: One error", i);
+            char * str = bxierr_str(err);
+            BXIFREE(str);
+            bxierr_destroy(&err);
+            err = bxilog_finalize(true);
+            exit((ok && bxierr_isok(err)) ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+        int status;
+        pid_t w = waitpid(cpid, &status, 0);
+        CU_ASSERT_EQUAL(w, cpid);
+        CU_ASSERT_TRUE(WIFEXITED(status));
+        CU_ASSERT_EQUAL(WEXITSTATUS(status), EXIT_SUCCESS);
+    }
+
+    __atomic_store_n(&stop, true, __ATOMIC_RELEASE);
+    for (size_t t = 0; t < ARRAYLEN(threads); t++) pthread_join(threads[t], NULL);
+    err = bxilog_finalize(true);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+}
+
 void * logging_thread(void * data) {
     bxilog_logger_p logger = (bxilog_logger_p) data;
 
@@ -1190,3 +2069,439 @@ void test_handlers(void) {
 //    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
 //}
 //
+
+void test_remote_wire(void) {
+    const char * filename = "test_logger.c";
+    const char * funcname = __func__;
+    const char * msgs[] = {"First record", "", "A record with\na new line"};
+    const int lines[] = {12, -1, 1234567};
+    const struct timespec times[] = {{.tv_sec = 1500000000, .tv_nsec = 999999999},
+                                     {.tv_sec = 1500000001, .tv_nsec = 1},
+                                     {.tv_sec = 1499999999, .tv_nsec = 500}};
+
+    const char * source = "tcp://test:4242";
+
+    bxilog__wire_encoder_s encoder;
+    bxilog__wire_encoder_init(&encoder);
+    bxilog__wire_encoder_set_source(&encoder, source);
+
+    // Encode twice to check the encoder can be reused after a reset
+    for (size_t round = 0; round < 2; round++) {
+        bxilog__wire_encoder_reset(&encoder);
+        for (size_t i = 0; i < ARRAYLEN(msgs); i++) {
+            bxilog_record_s record;
+            record.level = BXILOG_DEBUG;
+            record.detail_time = times[i];
+            record.pid = 4242;
+#ifdef __linux__
+            record.tid = 4243 + (pid_t) i;
+#endif
+            record.thread_rank = UINTPTR_MAX - i;
+            record.line_nb = lines[i];
+            record.filename_len = strlen(filename) + 1;
+            record.funcname_len = strlen(funcname) + 1;
+            record.logname_len = TEST_LOGGER->name_length;
+            record.logmsg_len = strlen(msgs[i]) + 1;
+            bxilog__wire_encode(&encoder, &record,
+                                filename, funcname, TEST_LOGGER->name, msgs[i]);
+        }
+    }
+
+    const uint8_t * data;
+    size_t len = bxilog__wire_encoder_data(&encoder, &data);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(data);
+    CU_ASSERT_EQUAL(encoder.records_nb, ARRAYLEN(msgs));
+
+    bxilog__wire_decoder_s decoder;
+    bxierr_p err = bxilog__wire_decoder_init(&decoder, data, len);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+    CU_ASSERT_EQUAL(decoder.records_nb, ARRAYLEN(msgs));
+    // Records of the first round were dropped by the reset
+    CU_ASSERT_TRUE(decoder.sequenced);
+    CU_ASSERT_EQUAL(decoder.first_seq, ARRAYLEN(msgs));
+    CU_ASSERT_EQUAL(decoder.source_len, strlen(source));
+    CU_ASSERT_NSTRING_EQUAL(decoder.source, source, strlen(source));
+
+    char * buf = NULL;
+    size_t buf_size = 0;
+    for (size_t i = 0; i < ARRAYLEN(msgs); i++) {
+        CU_ASSERT_TRUE_FATAL(bxilog__wire_decoder_has_next(&decoder));
+        size_t record_len;
+        err = bxilog__wire_decode_next(&decoder, &buf, &buf_size, &record_len);
+        CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+
+        bxilog_record_p record = (bxilog_record_p) buf;
+        CU_ASSERT_EQUAL(record->level, BXILOG_DEBUG);
+        CU_ASSERT_EQUAL(record->detail_time.tv_sec, times[i].tv_sec);
+        CU_ASSERT_EQUAL(record->detail_time.tv_nsec, times[i].tv_nsec);
+        CU_ASSERT_EQUAL(record->pid, 4242);
+#ifdef __linux__
+        CU_ASSERT_EQUAL(record->tid, 4243 + (pid_t) i);
+#endif
+        CU_ASSERT_EQUAL(record->thread_rank, UINTPTR_MAX - i);
+        CU_ASSERT_EQUAL(record->line_nb, lines[i]);
+        CU_ASSERT_EQUAL(record_len, sizeof(*record) + record->filename_len + \
+                                    record->funcname_len + record->logname_len + \
+                                    record->logmsg_len);
+
+        char * rfilename = buf + sizeof(*record);
+        char * rfuncname = rfilename + record->filename_len;
+        char * rloggername = rfuncname + record->funcname_len;
+        char * rlogmsg = rloggername + record->logname_len;
+        CU_ASSERT_STRING_EQUAL(rfilename, filename);
+        CU_ASSERT_STRING_EQUAL(rfuncname, funcname);
+        CU_ASSERT_STRING_EQUAL(rloggername, TEST_LOGGER->name);
+        CU_ASSERT_STRING_EQUAL(rlogmsg, msgs[i]);
+    }
+    CU_ASSERT_FALSE(bxilog__wire_decoder_has_next(&decoder));
+
+    // Truncated batches must be rejected, never read out of bounds
+    for (size_t truncated = 0; truncated < len; truncated++) {
+        err = bxilog__wire_decoder_init(&decoder, data, truncated);
+        while (bxierr_isok(err) && bxilog__wire_decoder_has_next(&decoder)) {
+            size_t record_len;
+            err = bxilog__wire_decode_next(&decoder, &buf, &buf_size, &record_len);
+        }
+        CU_ASSERT_TRUE(bxierr_isko(err));
+        bxierr_destroy(&err);
+    }
+
+    // Unknown versions must be rejected
+    uint8_t bad_version[16] = {BXILOG__WIRE_VERSION + 1};
+    err = bxilog__wire_decoder_init(&decoder, bad_version, sizeof(bad_version));
+    CU_ASSERT_TRUE(bxierr_isko(err));
+    CU_ASSERT_EQUAL(err->code, BXILOG__WIRE_BAD_DATA_ERR);
+    bxierr_destroy(&err);
+
+    BXIFREE(buf);
+    bxilog__wire_encoder_clean(&encoder);
+}
+
+// Start the library with a relay handler bound to ctrl_url, only for TEST_LOGGER
+static void _relay_start(const char * spool_dir, const char * ctrl_url) {
+    bxilog_filters_p filters = bxilog_filters_new();
+    bxilog_filters_add(&filters, "", BXILOG_OFF);
+    bxilog_filters_add(&filters, TEST_LOGGER->name, BXILOG_OUTPUT);
+    bxilog_config_p config = bxilog_config_new(PROGNAME);
+    bxilog_config_add_handler(config, BXILOG_REMOTE_RELAY_HANDLER, filters,
+                              ctrl_url, true, spool_dir);
+    bxierr_p err = bxilog_init(config);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+}
+
+static char * _relay_spool_path(const char * spool_dir) {
+    return bxistr_new("%s/bxilog-relay.spool", spool_dir);
+}
+
+static off_t _relay_spool_size(const char * spool_dir) {
+    char * path = _relay_spool_path(spool_dir);
+    struct stat st;
+    int rc = stat(path, &st);
+    BXIFREE(path);
+    return (0 == rc) ? st.st_size : -1;
+}
+
+// Remove the spool directory with the spool and the ipc sockets left by zeromq
+static void _relay_cleanup(const char * spool_dir) {
+    DIR * dir = opendir(spool_dir);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(dir);
+    struct dirent * entry;
+    while (NULL != (entry = readdir(dir))) {
+        if ('.' == entry->d_name[0]) continue;
+        char * path = bxistr_new("%s/%s", spool_dir, entry->d_name);
+        CU_ASSERT_EQUAL(unlink(path), 0);
+        BXIFREE(path);
+    }
+    closedir(dir);
+    CU_ASSERT_EQUAL(rmdir(spool_dir), 0);
+}
+
+// Subscribe to the relay handler bound to ctrl_url, as its upstream does
+static void * _relay_subscribe(void * ctx, const char * ctrl_url) {
+    void * dealer = NULL;
+    bxierr_p err = bxizmq_zocket_create_connected(ctx, ZMQ_DEALER, ctrl_url, &dealer);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+    err = bxizmq_str_snd(BXILOG_REMOTE_HANDLER_URLS, dealer, 0, 0, 0);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+    char * pub_url = NULL;
+    err = bxizmq_str_rcv(dealer, 0, false, &pub_url);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+    err = bxizmq_zocket_destroy(&dealer);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+
+    void * sub = NULL;
+    err = bxizmq_zocket_create_connected(ctx, ZMQ_SUB, pub_url, &sub);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+    err = bxizmq_zocket_setopt(sub, ZMQ_SUBSCRIBE, "", 0);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+    BXIFREE(pub_url);
+
+    return sub;
+}
+
+// Receive the messages of the records relayed, up to the given one
+static size_t _relay_receive(void * sub, const char * last, char ** msgs, size_t msgs_max) {
+    size_t n = 0;
+    char * buf = NULL;
+    size_t buf_size = 0;
+    // Spooled batches are sent once the subscription reaches the relay handler
+    for (size_t tries = 0; tries < 100 && n < msgs_max; tries++) {
+        bxierr_p err = bxilog_flush();
+        CU_ASSERT_TRUE(bxierr_isok(err));
+        zmq_pollitem_t items[] = {{sub, 0, ZMQ_POLLIN, 0}};
+        if (0 >= zmq_poll(items, 1, 100)) continue;
+
+        char * header = NULL;
+        err = bxizmq_str_rcv(sub, 0, false, &header);
+        CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+        zmq_msg_t batch;
+        err = bxizmq_msg_init(&batch);
+        CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+        err = bxizmq_msg_rcv(sub, &batch, 0);
+        CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+
+        bool exiting = 0 == strcmp(BXILOG_REMOTE_HANDLER_EXITING_HEADER, header);
+        BXIFREE(header);
+        bxilog__wire_decoder_s decoder;
+        err = exiting ? BXIERR_OK : bxilog__wire_decoder_init(&decoder,
+                                                              zmq_msg_data(&batch),
+                                                              zmq_msg_size(&batch));
+        CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+        bool done = false;
+        while (!exiting && !done && n < msgs_max && bxilog__wire_decoder_has_next(&decoder)) {
+            size_t record_len;
+            err = bxilog__wire_decode_next(&decoder, &buf, &buf_size, &record_len);
+            CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+            bxilog_record_p record = (bxilog_record_p) buf;
+            char * logmsg = buf + sizeof(*record) + record->filename_len
+                          + record->funcname_len + record->logname_len;
+            msgs[n++] = strdup(logmsg);
+            done = 0 == strcmp(logmsg, last);
+        }
+        err = bxizmq_msg_close(&batch);
+        CU_ASSERT_TRUE(bxierr_isok(err));
+        if (done) break;
+    }
+    BXIFREE(buf);
+
+    return n;
+}
+
+void test_remote_relay_spool(void) {
+    char dir[] = "/tmp/test_relay_spool.XXXXXX";
+    CU_ASSERT_PTR_NOT_NULL_FATAL(mkdtemp(dir));
+    char * ctrl_url = bxistr_new("ipc://%s/ctrl", dir);
+    _relay_start(dir, ctrl_url);
+
+    // Nobody subscribed yet: batches are kept in the spool
+    for (size_t i = 0; i < 10; i++) OUT(TEST_LOGGER, "Spooled %zu", i);
+    bxierr_p err = bxilog_flush();
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    CU_ASSERT_TRUE(0 < _relay_spool_size(dir));
+
+    void * ctx = NULL;
+    err = bxizmq_context_new(&ctx);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+    void * sub = _relay_subscribe(ctx, ctrl_url);
+
+    // Once subscribed, the spool is replayed before the new records
+    OUT(TEST_LOGGER, "Live");
+    char * msgs[16];
+    size_t n = _relay_receive(sub, "Live", msgs, ARRAYLEN(msgs));
+    CU_ASSERT_EQUAL(n, 11);
+    for (size_t i = 0; i < n; i++) {
+        char * expected = (10 == i) ? strdup("Live") : bxistr_new("Spooled %zu", i);
+        CU_ASSERT_STRING_EQUAL(msgs[i], expected);
+        BXIFREE(expected);
+        BXIFREE(msgs[i]);
+    }
+    err = bxilog_flush();
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    CU_ASSERT_EQUAL(_relay_spool_size(dir), 0);
+
+    err = bxilog_finalize(true);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    err = bxizmq_zocket_destroy(&sub);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    err = bxizmq_context_destroy(&ctx);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+
+    _relay_cleanup(dir);
+    BXIFREE(ctrl_url);
+}
+
+void test_remote_relay_spool_corrupted(void) {
+    char dir[] = "/tmp/test_relay_spool.XXXXXX";
+    CU_ASSERT_PTR_NOT_NULL_FATAL(mkdtemp(dir));
+    char * ctrl_url = bxistr_new("ipc://%s/ctrl", dir);
+    char * path = _relay_spool_path(dir);
+
+    // Batches nobody received are kept for the next run
+    _relay_start(dir, ctrl_url);
+    for (size_t i = 0; i < 5; i++) OUT(TEST_LOGGER, "Previous %zu", i);
+    bxierr_p err = bxilog_finalize(true);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    const off_t previous_size = _relay_spool_size(dir);
+    CU_ASSERT_TRUE_FATAL(0 < previous_size);
+
+    // Followed by an entry truncated by a crash: its header announces 1000 bytes
+    int fd = open(path, O_WRONLY | O_APPEND);
+    CU_ASSERT_TRUE_FATAL(-1 != fd);
+    const uint8_t truncated[] = {BXILOG_OUTPUT, 0xE8, 0x03, 0, 0, 'a', 'b', 'c'};
+    CU_ASSERT_EQUAL(write(fd, truncated, sizeof(truncated)), sizeof(truncated));
+    close(fd);
+
+    void * ctx = NULL;
+    err = bxizmq_context_new(&ctx);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+
+    // The valid entries are replayed, the truncated one is discarded
+    _relay_start(dir, ctrl_url);
+    void * sub = _relay_subscribe(ctx, ctrl_url);
+    OUT(TEST_LOGGER, "Live");
+    char * msgs[16];
+    size_t n = _relay_receive(sub, "Live", msgs, ARRAYLEN(msgs));
+    CU_ASSERT_EQUAL(n, 6);
+    for (size_t i = 0; i < n; i++) {
+        char * expected = (5 == i) ? strdup("Live") : bxistr_new("Previous %zu", i);
+        CU_ASSERT_STRING_EQUAL(msgs[i], expected);
+        BXIFREE(expected);
+        BXIFREE(msgs[i]);
+    }
+    err = bxilog_flush();
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    CU_ASSERT_EQUAL(_relay_spool_size(dir), 0);
+    err = bxilog_finalize(true);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    err = bxizmq_zocket_destroy(&sub);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+
+    // An entry with an unknown level is discarded with all the entries after it
+    fd = open(path, O_WRONLY | O_TRUNC);
+    CU_ASSERT_TRUE_FATAL(-1 != fd);
+    const uint8_t corrupted[] = {0xFF, 3, 0, 0, 0, 'a', 'b', 'c'};
+    CU_ASSERT_EQUAL(write(fd, corrupted, sizeof(corrupted)), sizeof(corrupted));
+    close(fd);
+
+    _relay_start(dir, ctrl_url);
+    sub = _relay_subscribe(ctx, ctrl_url);
+    OUT(TEST_LOGGER, "Live");
+    n = _relay_receive(sub, "Live", msgs, ARRAYLEN(msgs));
+    CU_ASSERT_EQUAL(n, 1);
+    for (size_t i = 0; i < n; i++) {
+        CU_ASSERT_STRING_EQUAL(msgs[i], "Live");
+        BXIFREE(msgs[i]);
+    }
+    err = bxilog_flush();
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    CU_ASSERT_EQUAL(_relay_spool_size(dir), 0);
+    err = bxilog_finalize(true);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    err = bxizmq_zocket_destroy(&sub);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    err = bxizmq_context_destroy(&ctx);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+
+    _relay_cleanup(dir);
+    BXIFREE(path);
+    BXIFREE(ctrl_url);
+}
+
+void test_remote_receiver_workers(void) {
+    const char * urls[] = {"ipc:///tmp/test_receiver_workers-0",
+                           "ipc:///tmp/test_receiver_workers-1"};
+
+    // When connecting, each url is read by a single worker
+    bxilog_remote_receiver_p receiver = bxilog_remote_receiver_new(urls, 1, false, NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(receiver);
+    bxierr_p err = bxilog_remote_receiver_set_workers_nb(receiver, 2);
+    CU_ASSERT_TRUE(bxierr_isko(err));
+    bxierr_destroy(&err);
+    err = bxilog_remote_receiver_set_workers_nb(receiver, 1);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    bxilog_remote_receiver_destroy(&receiver);
+
+    receiver = bxilog_remote_receiver_new(urls, ARRAYLEN(urls), false, NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(receiver);
+    err = bxilog_remote_receiver_set_workers_nb(receiver, 2);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    bxilog_remote_receiver_destroy(&receiver);
+
+    // When binding, publishers are spread among workers whatever their number
+    receiver = bxilog_remote_receiver_new(urls, 1, true, NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(receiver);
+    err = bxilog_remote_receiver_set_workers_nb(receiver, 4);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    bxilog_remote_receiver_destroy(&receiver);
+}
+
+void test_remote_mixed_levels(void) {
+    char dir[] = "/tmp/test_relay_spool.XXXXXX";
+    CU_ASSERT_PTR_NOT_NULL_FATAL(mkdtemp(dir));
+    char * ctrl_url = bxistr_new("ipc://%s/ctrl", dir);
+    _relay_start(dir, ctrl_url);
+
+    void * ctx = NULL;
+    bxierr_p err = bxizmq_context_new(&ctx);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+    void * sub = _relay_subscribe(ctx, ctrl_url);
+    // Wait for the subscription to reach the relay handler
+    OUT(TEST_LOGGER, "Subscribed");
+    char * msgs[1];
+    size_t n = _relay_receive(sub, "Subscribed", msgs, ARRAYLEN(msgs));
+    CU_ASSERT_EQUAL_FATAL(n, 1);
+    BXIFREE(msgs[0]);
+
+    // Records of different levels are sent in the same batch
+    const bxilog_level_e levels[] = {BXILOG_OUTPUT, BXILOG_WARNING, BXILOG_OUTPUT};
+    for (size_t i = 0; i < ARRAYLEN(levels); i++) {
+        bxilog_logger_log(TEST_LOGGER, levels[i], (char *) __FILE__, ARRAYLEN(__FILE__),
+                          __func__, ARRAYLEN(__func__), __LINE__, "Mixed %zu", i);
+    }
+    err = bxilog_flush();
+    CU_ASSERT_TRUE(bxierr_isok(err));
+
+    zmq_pollitem_t items[] = {{sub, 0, ZMQ_POLLIN, 0}};
+    CU_ASSERT_EQUAL_FATAL(zmq_poll(items, 1, 5000), 1);
+    // The level header is the one of the most severe record
+    char * header = NULL;
+    err = bxizmq_str_rcv(sub, 0, false, &header);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+    CU_ASSERT_STRING_EQUAL(header, BXILOG_REMOTE_HANDLER_RECORD_HEADER "LTFDIONW");
+    BXIFREE(header);
+    zmq_msg_t batch;
+    err = bxizmq_msg_init(&batch);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+    err = bxizmq_msg_rcv(sub, &batch, 0);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+
+    // Each record carries its own level
+    bxilog__wire_decoder_s decoder;
+    err = bxilog__wire_decoder_init(&decoder, zmq_msg_data(&batch), zmq_msg_size(&batch));
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+    char * buf = NULL;
+    size_t buf_size = 0;
+    n = 0;
+    while (bxilog__wire_decoder_has_next(&decoder)) {
+        size_t record_len;
+        err = bxilog__wire_decode_next(&decoder, &buf, &buf_size, &record_len);
+        CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+        CU_ASSERT_TRUE_FATAL(n < ARRAYLEN(levels));
+        bxilog_record_p record = (bxilog_record_p) buf;
+        CU_ASSERT_EQUAL(record->level, levels[n]);
+        n++;
+    }
+    CU_ASSERT_EQUAL(n, ARRAYLEN(levels));
+    BXIFREE(buf);
+    err = bxizmq_msg_close(&batch);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+
+    err = bxilog_finalize(true);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    err = bxizmq_zocket_destroy(&sub);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    err = bxizmq_context_destroy(&ctx);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    _relay_cleanup(dir);
+    BXIFREE(ctrl_url);
+}
@@ -0,0 +1,312 @@
+/* -*- coding: utf-8 -*-
+ ###############################################################################
+ # Author: agent <agent@local>
+ # Created on: Oct 19, 2026
+ # Contributors:
+ ###############################################################################
+ # Copyright (C) 2026  Bull S. A. S.  -  All rights reserved
+ # Bull, Rue Jean Jaures, B.P.68, 78340, Les Clayes-sous-Bois
+ # This is not Free or Open Source software.
+ # Please contact Bull S. A. S. for details about its license.
+ ###############################################################################
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <wait.h>
+
+#include <cstdarg>
+#include <string>
+#include <string_view>
+
+#include <bxi/base/log.hpp>
+
+#include <CUnit/Basic.h>
+
+extern "C" {
+#include "bxi/base/mem.h"
+}
+
+extern "C" char * PROGNAME;
+
+// Called from unit_t.c
+extern "C" void test_logger_cxx_message(void);
+extern "C" void test_logger_cxx_site(void);
+extern "C" void test_logger_cxx_disabled(void);
+extern "C" void test_logger_cxx_rawstr(void);
+
+SET_LOGGER(CXX_LOGGER, "test.bxibase.cxx");
+
+// What the capture handler received
+struct capture_s {
+    size_t nb;                  // Records of CXX_LOGGER
+    size_t stats_nb;            // Records of the statistics logger
+    bxilog_level_e level;       // Of the last record of CXX_LOGGER
+    int line;
+    std::string filename;
+    std::string funcname;
+    std::string logmsg;
+};
+
+static pthread_mutex_t CAPTURE_LOCK = PTHREAD_MUTEX_INITIALIZER;
+static capture_s CAPTURE;
+
+static const std::string STATS_LOGGER = BXILOG_LIB_PREFIX "bxilog.stats";
+
+//*********************************************************************************
+//********************************** Capture Handler ******************************
+//*********************************************************************************
+
+static bxilog_handler_param_p _capture_param_new(bxilog_handler_p self,
+                                                 bxilog_filters_p filters,
+                                                 va_list ap) {
+    UNUSED(ap);
+    bxilog_handler_param_p result = static_cast<bxilog_handler_param_p>(
+                                            bximem_calloc(sizeof(*result)));
+    bxilog_handler_init_param(self, filters, result);
+    return result;
+}
+
+static bxierr_p _capture_process_log(bxilog_record_p record,
+                                     char * filename,
+                                     char * funcname,
+                                     char * loggername,
+                                     char * logmsg,
+                                     bxilog_handler_param_p param) {
+    UNUSED(param);
+    pthread_mutex_lock(&CAPTURE_LOCK);
+    if (STATS_LOGGER == loggername) CAPTURE.stats_nb++;
+    if (std::string_view(CXX_LOGGER->name) == loggername) {
+        CAPTURE.nb++;
+        CAPTURE.level = record->level;
+        CAPTURE.line = record->line_nb;
+        CAPTURE.filename = filename;
+        CAPTURE.funcname = funcname;
+        CAPTURE.logmsg = logmsg;
+    }
+    pthread_mutex_unlock(&CAPTURE_LOCK);
+    return BXIERR_OK;
+}
+
+// Keep the internal errors: bxilog_finalize() reports them
+static bxierr_p _capture_process_ierr(bxierr_p * err, bxilog_handler_param_p param) {
+    UNUSED(param);
+    return *err;
+}
+
+static bxierr_p _capture_param_destroy(bxilog_handler_param_p * param_p) {
+    bxilog_handler_clean_param(*param_p);
+    bximem_destroy(reinterpret_cast<char **>(param_p));
+    return BXIERR_OK;
+}
+
+static bxilog_handler_s _capture_handler() {
+    bxilog_handler_s handler{};
+    handler.name = const_cast<char *>("Test C++ Capture Handler");
+    handler.param_new = _capture_param_new;
+    handler.process_log = _capture_process_log;
+    handler.process_ierr = _capture_process_ierr;
+    handler.param_destroy = _capture_param_destroy;
+    return handler;
+}
+
+static bxilog_handler_s CAPTURE_HANDLER_S = _capture_handler();
+
+// Start the library with the capture handler only, DEBUG logs disabled
+static void _init(bxilog_fork_mode_e fork_mode, long stats_period_ms) {
+    pthread_mutex_lock(&CAPTURE_LOCK);
+    CAPTURE = capture_s{};
+    pthread_mutex_unlock(&CAPTURE_LOCK);
+
+    bxilog_config_p config = bxilog_config_new(PROGNAME);
+    config->fork_mode = fork_mode;
+    config->stats_period_ms = stats_period_ms;
+    bxilog_filters_p filters = bxilog_filters_new();
+    bxilog_filters_add(&filters, "", BXILOG_INFO);
+    bxilog_config_add_handler(config, &CAPTURE_HANDLER_S, filters);
+    bxierr_p err = bxilog_init(config);
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+}
+
+// What the capture handler received, once all logs have been processed
+static capture_s _captured() {
+    bxierr_p err = bxilog_flush();
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    bxierr_destroy(&err);
+
+    pthread_mutex_lock(&CAPTURE_LOCK);
+    const capture_s result = CAPTURE;
+    pthread_mutex_unlock(&CAPTURE_LOCK);
+    return result;
+}
+
+static void _finalize() {
+    bxierr_p err = bxilog_finalize();
+    CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+}
+
+//*********************************************************************************
+//********************************** Tests ****************************************
+//*********************************************************************************
+
+enum plain_e { PLAIN_THREE = 3 };
+enum class scoped_e : unsigned char { HIGH = 200 };
+
+void test_logger_cxx_message(void) {
+    _init(BXILOG_FORK_RESTART, 0);
+
+    BXILOG_LOG(CXX_LOGGER, BXILOG_INFO, "{{}}");
+    CU_ASSERT_STRING_EQUAL(_captured().logmsg.c_str(), "{}");
+    BXILOG_LOG(CXX_LOGGER, BXILOG_INFO, "}}{{{}}}{{", 42);
+    CU_ASSERT_STRING_EQUAL(_captured().logmsg.c_str(), "}{42}{");
+    BXILOG_LOG(CXX_LOGGER, BXILOG_INFO, "No argument");
+    CU_ASSERT_STRING_EQUAL(_captured().logmsg.c_str(), "No argument");
+
+    // Strings
+    const char * const null_str = nullptr;
+    const std::string str("a string");
+    const std::string_view view = std::string_view("a view of something", 9);
+    BXILOG_LOG(CXX_LOGGER, BXILOG_INFO, "{}|{}|{}|{}|{}",
+               "literal", null_str, str, view, std::string());
+    CU_ASSERT_STRING_EQUAL(_captured().logmsg.c_str(),
+                           "literal|(null)|a string|a view of|");
+
+    // Numbers
+    BXILOG_LOG(CXX_LOGGER, BXILOG_INFO, "{} {} {} {} {} {}",
+               0, -17, INT64_MIN, UINT64_MAX, static_cast<short>(-3), 12345u);
+    CU_ASSERT_STRING_EQUAL(_captured().logmsg.c_str(),
+                           "0 -17 -9223372036854775808 18446744073709551615 -3 12345");
+    BXILOG_LOG(CXX_LOGGER, BXILOG_INFO, "{} {} {} {}", 0.75, -2.5, 1e20, 0.1f);
+    CU_ASSERT_STRING_EQUAL(_captured().logmsg.c_str(), "0.75 -2.5 1e+20 0.1");
+    BXILOG_LOG(CXX_LOGGER, BXILOG_INFO, "{} {} {}", true, false, 'c');
+    CU_ASSERT_STRING_EQUAL(_captured().logmsg.c_str(), "true false c");
+
+    // Enumerations, as their underlying integer
+    BXILOG_LOG(CXX_LOGGER, BXILOG_INFO, "{} {}", PLAIN_THREE, scoped_e::HIGH);
+    CU_ASSERT_STRING_EQUAL(_captured().logmsg.c_str(), "3 200");
+
+    // Pointers, in hexadecimal
+    const int * const null_ptr = nullptr;
+    BXILOG_LOG(CXX_LOGGER, BXILOG_INFO, "{} {}",
+               reinterpret_cast<void *>(0xdeadbeef), null_ptr);
+    CU_ASSERT_STRING_EQUAL(_captured().logmsg.c_str(), "0xdeadbeef 0x0");
+
+    // Messages built on the stack, then on the heap
+    const size_t sizes[] = {BXILOG_CXX_BUF_SIZE - 3, BXILOG_CXX_BUF_SIZE - 2,
+                            BXILOG_CXX_BUF_SIZE, 4 * BXILOG_CXX_BUF_SIZE};
+    for (const size_t size : sizes) {
+        const std::string big(size, 'x');
+        BXILOG_LOG(CXX_LOGGER, BXILOG_INFO, "<{}>", big);
+        const capture_s captured = _captured();
+        CU_ASSERT_EQUAL(captured.logmsg.size(), size + 2);
+        CU_ASSERT_TRUE(("<" + big + ">") == captured.logmsg);
+    }
+
+    CU_ASSERT_EQUAL(_captured().nb, 9 + ARRAYLEN(sizes));
+    _finalize();
+}
+
+void test_logger_cxx_site(void) {
+    _init(BXILOG_FORK_RESTART, 0);
+
+    const int line = __LINE__ + 1;
+    BXILOG_LOG(CXX_LOGGER, BXILOG_WARNING, "From the macro");
+    capture_s captured = _captured();
+    CU_ASSERT_EQUAL(captured.level, BXILOG_WARNING);
+    CU_ASSERT_EQUAL(captured.line, line);
+    CU_ASSERT_STRING_EQUAL(captured.filename.c_str(), "test_logger_cxx.cc");
+    CU_ASSERT_STRING_EQUAL(captured.funcname.c_str(), __func__);
+
+    const int fline = __LINE__ + 1;
+    bxilog::log<BXILOG_NOTICE>(CXX_LOGGER, BXILOG_FMT("From the function"));
+    captured = _captured();
+    CU_ASSERT_EQUAL(captured.level, BXILOG_NOTICE);
+    CU_ASSERT_EQUAL(captured.line, fline);
+    CU_ASSERT_STRING_EQUAL(captured.filename.c_str(), "test_logger_cxx.cc");
+    CU_ASSERT_STRING_EQUAL(captured.funcname.c_str(), __func__);
+    CU_ASSERT_STRING_EQUAL(captured.logmsg.c_str(), "From the function");
+
+    _finalize();
+}
+
+static size_t EVALUATED_NB = 0;
+
+static size_t _evaluated() {
+    return ++EVALUATED_NB;
+}
+
+void test_logger_cxx_disabled(void) {
+    _init(BXILOG_FORK_RESTART, 0);
+    EVALUATED_NB = 0;
+
+    // The arguments are not evaluated for a disabled level
+    BXILOG_LOG(CXX_LOGGER, BXILOG_DEBUG, "Evaluated {} times", _evaluated());
+    BXILOG_LOG(CXX_LOGGER, BXILOG_LOWEST, "Evaluated {} times", _evaluated());
+    CU_ASSERT_EQUAL(EVALUATED_NB, 0);
+    CU_ASSERT_EQUAL(_captured().nb, 0);
+
+    BXILOG_LOG(CXX_LOGGER, BXILOG_INFO, "Evaluated {} times", _evaluated());
+    CU_ASSERT_EQUAL(EVALUATED_NB, 1);
+    capture_s captured = _captured();
+    CU_ASSERT_EQUAL(captured.nb, 1);
+    CU_ASSERT_STRING_EQUAL(captured.logmsg.c_str(), "Evaluated 1 times");
+
+    // The function evaluates them, but does not log either
+    bxilog::log<BXILOG_DEBUG>(CXX_LOGGER, BXILOG_FMT("Evaluated {} times"), _evaluated());
+    CU_ASSERT_EQUAL(EVALUATED_NB, 2);
+    CU_ASSERT_EQUAL(_captured().nb, 1);
+
+    _finalize();
+}
+
+void test_logger_cxx_rawstr(void) {
+    _init(BXILOG_FORK_QUIESCE, 10);
+
+    // The statistics are logged even when nothing else is
+    BXILOG_LOG(CXX_LOGGER, BXILOG_INFO, "Before the period");
+    usleep(20000);
+    capture_s captured = _captured();
+    CU_ASSERT_EQUAL(captured.nb, 1);
+    CU_ASSERT_TRUE(0 < captured.stats_nb);
+
+    bxilog_stats_p stats = nullptr;
+    bxierr_p err = bxilog_stats_get(&stats);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    bxierr_destroy(&err);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(stats);
+    CU_ASSERT_TRUE(stats->log_nb >= 2);
+    bxilog_stats_destroy(&stats);
+
+    for (size_t i = 0; i < 10; i++) {
+        BXILOG_LOG(CXX_LOGGER, BXILOG_INFO, "Parent: forking child #{}", i);
+        errno = 0;
+        pid_t cpid = fork();
+        if (-1 == cpid) {
+            BXIEXIT(EXIT_FAILURE, bxierr_errno("Can't fork()"), CXX_LOGGER, BXILOG_CRITICAL);
+        }
+        if (0 == cpid) {
+            // The first log of the child restarts its handlers
+            bool ready = bxilog_is_ready();
+            pthread_mutex_init(&CAPTURE_LOCK, NULL);
+            CAPTURE.nb = 0;
+            BXILOG_LOG(CXX_LOGGER, BXILOG_INFO, "Child #{}: one log line", i);
+            ready = !ready && bxilog_is_ready();
+            captured = _captured();
+            ready = ready && 1 == captured.nb
+                    && "Child #" + std::to_string(i) + ": one log line" == captured.logmsg;
+            err = bxilog_finalize();
+            exit((ready && bxierr_isok(err)) ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+        CU_ASSERT_TRUE(bxilog_is_ready());
+        int status;
+        pid_t w = waitpid(cpid, &status, 0);
+        CU_ASSERT_EQUAL(w, cpid);
+        CU_ASSERT_TRUE(WIFEXITED(status));
+        CU_ASSERT_EQUAL(WEXITSTATUS(status), EXIT_SUCCESS);
+    }
+
+    _finalize();
+}
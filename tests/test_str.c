@@ -12,9 +12,12 @@
  */
 
 
+#include <ctype.h>
+
 #include <CUnit/Basic.h>
 
 #include "bxi/base/str.h"
+#include "bxi/base/time.h"
 
 
 static bxierr_p count_lines(char * line, size_t line_len, bool last, void * param) {
@@ -86,6 +89,48 @@ void test_bxistr_apply_lines(void) {
     bxierr_destroy(&err);
 }
 
+static bxierr_p count_all_lines(char * line, size_t line_len, bool last, void * param) {
+    UNUSED(line);
+    UNUSED(line_len);
+    UNUSED(last);
+
+    (*(size_t *) param)++;
+
+    return BXIERR_OK;
+}
+
+void test_bxistr_apply_many_lines(void) {
+    // The scan stops at the last offset wanted
+    char s[100];
+    memset(s, '\n', sizeof(s));
+    size_t offsets[64];
+    CU_ASSERT_EQUAL(bxistr_newlines(s, sizeof(s), offsets, 64), 64);
+    CU_ASSERT_EQUAL(offsets[63], 63);
+    CU_ASSERT_EQUAL(bxistr_newlines(s + 64, sizeof(s) - 64, offsets, 64), 36);
+
+    // Each byte is scanned once: a quadratic scan would last minutes
+    const size_t lines_nb = 4 * 1024 * 1024;
+    char * text = bximem_calloc(2 * lines_nb);
+    for (size_t i = 0; i < lines_nb; i++) {
+        text[2 * i] = 'x';
+        text[2 * i + 1] = '\n';
+    }
+    struct timespec start;
+    bxierr_p err = bxitime_get(CLOCK_MONOTONIC, &start);
+    bxierr_abort_ifko(err);
+
+    size_t n = 0;
+    err = bxistr_apply_lines(text, 2 * lines_nb, count_all_lines, &n);
+    CU_ASSERT_TRUE(bxierr_isok(err));
+    // The empty one after the last newline included
+    CU_ASSERT_EQUAL(n, lines_nb + 1);
+
+    double duration;
+    err = bxitime_duration(CLOCK_MONOTONIC, start, &duration);
+    bxierr_abort_ifko(err);
+    CU_ASSERT_TRUE(duration < 2.0);
+    BXIFREE(text);
+}
 
 void test_bxistr_prefix_lines(void) {
 
@@ -401,3 +446,215 @@ void test_bxistr_hex(void) {
     BXIFREE(t);
 
 }
+
+void test_bxistr_builder(void) {
+    bxistr_builder_p builder = bxistr_builder_get();
+    CU_ASSERT_PTR_NOT_NULL_FATAL(builder);
+    CU_ASSERT_EQUAL(builder->len, 0);
+
+    bxistr_builder_append(builder, "%s=%d", "answer", 42);
+    bxistr_builder_append_bytes(builder, ", ", 2);
+    bxistr_builder_append_int(builder, INT64_MIN);
+    bxistr_builder_append_bytes(builder, ", ", 2);
+    bxistr_builder_append_uint(builder, UINT64_MAX);
+    bxistr_builder_append_bytes(builder, ", ", 2);
+    bxistr_builder_append_int(builder, 0);
+    CU_ASSERT_STRING_EQUAL(builder->buf, "answer=42, -9223372036854775808, "
+                                         "18446744073709551615, 0");
+
+    // Nested uses get distinct builders
+    bxistr_builder_p nested = bxistr_builder_get();
+    CU_ASSERT_PTR_NOT_EQUAL(builder, nested);
+    char * s = bxistr_new("%s", "nested");
+    CU_ASSERT_STRING_EQUAL(s, "nested");
+    BXIFREE(s);
+    bxistr_builder_release(&nested);
+    CU_ASSERT_PTR_NULL(nested);
+
+    // Grow past the initial buffer
+    char big[1000];
+    memset(big, 'b', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    bxistr_builder_append(builder, "%s", big);
+    size_t len = 0;
+    s = bxistr_builder_take(builder, &len);
+    CU_ASSERT_EQUAL(len, strlen(s));
+    CU_ASSERT_EQUAL(len, 56 + sizeof(big) - 1);
+    CU_ASSERT_EQUAL(builder->len, 0);
+    BXIFREE(s);
+    bxistr_builder_release(&builder);
+
+    bxistr_builder_s local;
+    bxistr_builder_init(&local);
+    bxistr_builder_append_uint(&local, 7);
+    CU_ASSERT_STRING_EQUAL(local.buf, "7");
+    bxistr_builder_cleanup(&local);
+}
+
+void test_bxistr_simd(void) {
+    // Every level must give the same results than the scalar one
+    char str[300];
+    uint8_t bytes[150];
+    for (size_t i = 0; i < sizeof(str) - 1; i++) {
+        str[i] = (0 == i % 7 || 0 == i % 11) ? '\n' : (char) ('a' + i % 26);
+        bytes[i / 2] = (uint8_t) (i * 37);
+    }
+    str[sizeof(str) - 1] = '\0';
+
+    bxistr_simd_e levels[] = {BXISTR_SIMD_SSE2, BXISTR_SIMD_AVX2};
+    for (size_t l = 0; l < sizeof(levels) / sizeof(*levels); l++) {
+        for (size_t start = 0; start < 33; start++) {
+            for (size_t len = 0; start + len < sizeof(str); len += 13) {
+                const char * s = str + start;
+                size_t expected[64], offsets[64];
+                bxistr_simd_set(BXISTR_SIMD_SCALAR);
+                size_t expected_nb = bxistr_newlines(s, len, expected, 64);
+                const char * expected_sub;
+                size_t expected_sub_len = bxistr_rsub(s, strlen(s), 'q', &expected_sub);
+                size_t expected_count = bxistr_count(s, '\n');
+
+                bxistr_simd_set(levels[l]);
+                size_t nb = bxistr_newlines(s, len, offsets, 64);
+                CU_ASSERT_EQUAL(nb, expected_nb);
+                nb = (nb < 64) ? nb : 64;
+                CU_ASSERT_EQUAL(memcmp(offsets, expected, nb * sizeof(*offsets)), 0);
+                const char * sub;
+                CU_ASSERT_EQUAL(bxistr_rsub(s, strlen(s), 'q', &sub), expected_sub_len);
+                CU_ASSERT_PTR_EQUAL(sub, expected_sub);
+                CU_ASSERT_EQUAL(bxistr_count(s, '\n'), expected_count);
+            }
+        }
+
+        // Hexadecimal round trip, all digits, both cases
+        char * hex = NULL;
+        bxierr_p err = bxistr_bytes2hex(bytes, sizeof(bytes), &hex);
+        CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+        CU_ASSERT_EQUAL(strlen(hex), 2 * sizeof(bytes));
+        for (size_t i = 0; i < 2 * sizeof(bytes); i += 3) hex[i] = (char) tolower(hex[i]);
+        uint8_t * back = NULL;
+        err = bxistr_hex2bytes(hex, strlen(hex), &back);
+        CU_ASSERT_TRUE_FATAL(bxierr_isok(err));
+        CU_ASSERT_EQUAL(memcmp(back, bytes, sizeof(bytes)), 0);
+
+        // The wrong digit is reported whatever the level
+        hex[21] = 'g';
+        err = bxistr_hex2bytes(hex, strlen(hex), &back);
+        CU_ASSERT_TRUE(bxierr_isko(err));
+        CU_ASSERT_PTR_NOT_NULL(strstr(err->msg, "digit: g"));
+        bxierr_destroy(&err);
+        BXIFREE(back);
+        BXIFREE(hex);
+    }
+    bxistr_simd_set(BXISTR_SIMD_AVX2);
+}
+
+// Build a random conversion for the given conversion character
+static void _random_spec(unsigned * seed, char * spec, const char * flags,
+                         bool precision, const char * length, char conv) {
+    char * p = spec;
+    p += sprintf(p, "<%%");
+    for (const char * f = flags; '\0' != *f; f++) {
+        if (0 == rand_r(seed) % 3) *p++ = *f;
+    }
+    if (0 == rand_r(seed) % 2) p += sprintf(p, "%d", rand_r(seed) % 24);
+    if (precision && 0 == rand_r(seed) % 2) p += sprintf(p, ".%d", rand_r(seed) % 24);
+    p += sprintf(p, "%s%c>", length, conv);
+}
+
+void test_bxistr_format(void) {
+    // Compare with the libc on randomly generated conversions
+    char spec[64], expected[256], buf[256];
+    const char * const strings[] = {"", "a", "hello world", "%d%s", NULL};
+    unsigned seed = 1;
+    for (int i = 0; i < 20000; i++) {
+        const int64_t big = (int64_t) (((uint64_t) rand_r(&seed) << 33) ^
+                                       (uint64_t) rand_r(&seed));
+        const int small = rand_r(&seed) % 3 - 1;
+        const size_t size = (0 == i % 4) ? (size_t) rand_r(&seed) % 16 : sizeof(buf);
+        int n;
+        switch (rand_r(&seed) % 12) {
+            case 0:
+                _random_spec(&seed, spec, "-+ 0", true, "", 'd');
+                n = snprintf(expected, size, spec, (0 == i % 2) ? small : (int) big);
+                CU_ASSERT_EQUAL(bxistr_format(buf, size, spec, (0 == i % 2) ? small : (int) big),
+                                (size_t) n);
+                break;
+            case 1:
+                _random_spec(&seed, spec, "-+ 0", true, "ll", 'i');
+                n = snprintf(expected, size, spec, (0 == i % 2) ? (long long) small : big);
+                CU_ASSERT_EQUAL(bxistr_format(buf, size, spec, (0 == i % 2) ? (long long) small : big),
+                                (size_t) n);
+                break;
+            case 2:
+                _random_spec(&seed, spec, "-0", true, "z", 'u');
+                n = snprintf(expected, size, spec, (size_t) big);
+                CU_ASSERT_EQUAL(bxistr_format(buf, size, spec, (size_t) big), (size_t) n);
+                break;
+            case 3:
+                _random_spec(&seed, spec, "-#0", true, "l", "xXo"[i % 3]);
+                n = snprintf(expected, size, spec, (unsigned long) (big * small));
+                CU_ASSERT_EQUAL(bxistr_format(buf, size, spec, (unsigned long) (big * small)),
+                                (size_t) n);
+                break;
+            case 4:
+                _random_spec(&seed, spec, "-+ 0", true, "hh", 'd');
+                n = snprintf(expected, size, spec, (int) big);
+                CU_ASSERT_EQUAL(bxistr_format(buf, size, spec, (int) big), (size_t) n);
+                break;
+            case 5:
+                _random_spec(&seed, spec, "-#0", true, "h", "uxo"[i % 3]);
+                n = snprintf(expected, size, spec, (unsigned) big);
+                CU_ASSERT_EQUAL(bxistr_format(buf, size, spec, (unsigned) big), (size_t) n);
+                break;
+            case 6:
+                _random_spec(&seed, spec, "-", true, "", 's');
+                n = snprintf(expected, size, spec, strings[i % 5]);
+                CU_ASSERT_EQUAL(bxistr_format(buf, size, spec, strings[i % 5]), (size_t) n);
+                break;
+            case 7:
+                _random_spec(&seed, spec, "-", false, "", 'c');
+                n = snprintf(expected, size, spec, 'A' + i % 26);
+                CU_ASSERT_EQUAL(bxistr_format(buf, size, spec, 'A' + i % 26), (size_t) n);
+                break;
+            case 8:
+                _random_spec(&seed, spec, "-", false, "", 'p');
+                n = snprintf(expected, size, spec, (0 == i % 5) ? NULL : (void *) big);
+                CU_ASSERT_EQUAL(bxistr_format(buf, size, spec, (0 == i % 5) ? NULL : (void *) big),
+                                (size_t) n);
+                break;
+            case 9:
+                _random_spec(&seed, spec, "-+ #0", true, "", "fegEG"[i % 5]);
+                n = snprintf(expected, size, spec, (double) big / 1e6 * small);
+                CU_ASSERT_EQUAL(bxistr_format(buf, size, spec, (double) big / 1e6 * small),
+                                (size_t) n);
+                break;
+            case 10:
+                _random_spec(&seed, spec, "-+ 0", true, "j", 'd');
+                n = snprintf(expected, size, spec, (intmax_t) (0 == i % 2) ? INT64_MIN : big);
+                CU_ASSERT_EQUAL(bxistr_format(buf, size, spec,
+                                              (intmax_t) (0 == i % 2) ? INT64_MIN : big),
+                                (size_t) n);
+                break;
+            default:
+                // Unsupported conversions fall back to the libc
+                sprintf(spec, "<%%2$s %%1$0*3$d %%%%>");
+                n = snprintf(expected, size, spec, (int) big, "pos", small + 5);
+                CU_ASSERT_EQUAL(bxistr_format(buf, size, spec, (int) big, "pos", small + 5),
+                                (size_t) n);
+                break;
+        }
+        if (0 < size) CU_ASSERT_STRING_EQUAL(buf, expected);
+    }
+
+    // The usual log messages, and their length without writing anything
+    const char * fmt = "%s: %zu records in %d batches (%.2f%%), %p%c%-5s|%08.3lld";
+    char * s = bxistr_new(fmt, "worker", (size_t) 1234567, -42, 99.5, (void *) fmt,
+                          '!', "ab", 12LL);
+    snprintf(expected, sizeof(expected), fmt, "worker", (size_t) 1234567, -42, 99.5,
+             (void *) fmt, '!', "ab", 12LL);
+    CU_ASSERT_STRING_EQUAL(s, expected);
+    CU_ASSERT_EQUAL(bxistr_format(NULL, 0, fmt, "worker", (size_t) 1234567, -42, 99.5,
+                                  (void *) fmt, '!', "ab", 12LL),
+                    strlen(expected));
+    BXIFREE(s);
+}
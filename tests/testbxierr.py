@@ -34,8 +34,10 @@ class TestBXIError(unittest.TestCase):
     
     def test_bxierr_set(self):
         bxierr_set = bxibase.__CAPI__.bxierr_set_new()
+        codes = set()
         for i in range(10):
             rc = random.randrange(0, 5)
+            codes.add(rc)
             err_p = __FFI__.new('bxierr_p *')
             err_p[0] = bxibase.__CAPI__.bxierr_new(rc,
                                                    __FFI__.NULL,
@@ -45,7 +47,10 @@ class TestBXIError(unittest.TestCase):
                                                     "A random error: rc=%d",
                                                     __FFI__.cast('int', rc))
             bxibase.__CAPI__.bxierr_set_add(bxierr_set, err_p);
-        
+        self.assertEquals(bxierr_set.distinct_err.errors_nb, len(codes))
+        self.assertEquals(bxierr_set.total_seen_nb, 10)
+        self.assertEquals(sum(bxierr_set.seen_nb[i] for i in range(len(codes))), 10)
+
         func = __FFI__.cast('void (*)(void*)', bxibase.__CAPI__.bxierr_set_free)
 
         err = bxibase.__CAPI__.bxierr_new(10, 
@@ -348,6 +348,29 @@ class BXILogTest(unittest.TestCase):
             self.assertFalse(thread.is_alive())
 
 
+    def test_stats(self):
+        """Test the logging statistics"""
+        for i in range(10):
+            bxilog.out("Some stuff %d", i)
+        bxilog.flush()
+        stats = bxilog.get_stats()
+        self.assertTrue(stats['log_nb'] >= 10)
+        self.assertTrue(stats['threads_nb'] >= 1)
+        self.assertTrue(stats['min_log_size'] <= stats['max_log_size'])
+        self.assertTrue(len(stats['handlers']) > 0)
+        for handler in stats['handlers']:
+            self.assertTrue(handler['processed_nb'] + handler['filtered_nb'] >= 10)
+            self.assertTrue(handler['retried_nb'] <=
+                            handler['processed_nb'] + handler['filtered_nb'])
+            self.assertTrue(handler['flushes_nb'] >= 1)
+            queue_delay = handler['queue_delay']
+            self.assertEqual(queue_delay['count'], handler['processed_nb'])
+            self.assertTrue(queue_delay['p50'] <= queue_delay['p99'] <= queue_delay['max'])
+            # Talkers are not tracked by default
+            self.assertEqual(handler['top_loggers'], [])
+            self.assertEqual(handler['top_sites'], [])
+
+
     def test_multiprocessing(self):
         processes = []
         again = multiprocessing.Value(ctypes.c_bool, True, lock=False)
@@ -94,6 +94,56 @@ class BXIRemoteLoggerTest(unittest.TestCase):
             lines = file_.readlines()
         self.assertEquals(len(lines), logs_nb)
 
+    def test_remote_logging_bind_workers(self):
+        """
+        Process Parent receives logs from two children through two workers
+        """
+        tmpdir = tempfile.mkdtemp(suffix="tmp",
+                                  prefix=BXIRemoteLoggerTest.__name__)
+        child = os.path.join(tmpdir, 'child.bxilog')
+        parent_config = {'handlers': ['child'],
+                        'child': {'module': 'bxi.base.log.file_handler',
+                                'filters': ':off,%s:lowest' % LOGGER_CMD,
+                                'path': child,
+                                'append': True,
+                               }
+                        }
+        bxilog.set_config(configobj.ConfigObj(parent_config))
+        url = 'ipc://%s/rh-cfg.zock' % tmpdir
+        logs_nb = 25
+        children_nb = 2
+        full_cmd_path = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                     LOGGER_CMD)
+        receiver = remote_receiver.RemoteReceiver([url], bind=True, workers_nb=2)
+        receiver.start()
+        popens = []
+        for i in range(children_nb):
+            logger_output_file = os.path.join(tmpdir, '%s-%d.bxilog' %
+                                              (os.path.splitext(LOGGER_CMD)[0], i))
+            args = [sys.executable, full_cmd_path, logger_output_file, url,
+                    'False', '1', str(logs_nb)]
+            popens.append(subprocess.Popen(args))
+        for popen in popens:
+            popen.wait()
+            self.assertEquals(popen.returncode, logs_nb)
+        # Wait a bit for the logs to be processed
+        time.sleep(1)
+        receiver.stop(True)
+        bxilog.flush()
+        with open(child) as file_:
+            lines = file_.readlines()
+        self.assertEquals(len(lines), children_nb * logs_nb)
+        stats = receiver.get_stats()
+        self.assertEquals(len(stats), 2)
+        for stat in stats:
+            self.assertTrue(stat['records_nb'] > 0)
+            self.assertEquals(stat['lost_nb'], 0)
+        pub_stats = receiver.get_publishers_stats()
+        self.assertEquals(len(pub_stats), children_nb)
+        for url, stat in pub_stats.items():
+            self.assertTrue(stat['received_nb'] >= logs_nb, url)
+            self.assertEquals(stat['lost_nb'], 0, url)
+
     def test_remote_logging_connect(self):
         pass
     
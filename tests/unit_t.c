@@ -48,16 +48,24 @@ void test_free(void);
 
 // From test_str.c
 void test_bxistr_apply_lines(void);
+void test_bxistr_apply_many_lines(void);
 void test_bxistr_prefix_lines(void);
 void test_bxistr_join(void);
 void test_bxistr_rfind(void);
 void test_bxistr_count(void);
 void test_bxistr_mkshorter(void);
 void test_bxistr_hex(void);
+void test_bxistr_builder(void);
+void test_bxistr_simd(void);
+void test_bxistr_format(void);
 
 // From test_err.c
 void test_bxierr(void);
 void test_bxierr_chain(void);
+void test_bxierr_backtrace(void);
+void test_bxierr_backtrace_cache(void);
+void test_bxierr_static_pooled(void);
+void test_bxierr_set(void);
 
 // From test_time.c
 void test_time(void);
@@ -71,14 +79,27 @@ void test_1pub_1sub_sync_fork(void);
 
 // From test_logger.c
 void test_logger_init(void);
+void test_logger_handlers_deadline(void);
+void test_logger_handlers_deadline_expired(void);
+void test_logger_inline(void);
+void test_logger_inline_signal(void);
+void test_logger_stats(void);
+void test_logger_stats_hanging(void);
+void test_logger_talkers(void);
+void test_logger_histogram(void);
 void test_logger_levels(void);
+void test_logger_compile_level(void);
 void test_logger_existing_file(void);
 void test_logger_non_existing_file(void);
 void test_logger_non_existing_dir(void);
 void test_logger_fork(void);
+void test_logger_fork_quiesce(void);
+void test_logger_fork_quiesce_busy(void);
 void test_logger_signal(void);
 void test_single_logger_instance(void);
 void test_registry(void);
+void test_registry_stress(void);
+void test_registry_fork(void);
 void test_filters_parser(void);
 void test_filter_merge_same(void);
 void test_filter_merge_distinct(void);
@@ -88,10 +109,22 @@ void test_filters_distinct(void);
 void test_filters_simple(void);
 void test_filters_symetric(void);
 void test_filters_complex(void);
+void test_filters_reconfigure(void);
 void test_logger_threads(void);
 void test_handlers(void);
 void test_very_long_log(void);
 void test_strange_log(void);
+void test_remote_wire(void);
+void test_remote_relay_spool(void);
+void test_remote_relay_spool_corrupted(void);
+void test_remote_receiver_workers(void);
+void test_remote_mixed_levels(void);
+
+// From test_logger_cxx.cc
+void test_logger_cxx_message(void);
+void test_logger_cxx_site(void);
+void test_logger_cxx_disabled(void);
+void test_logger_cxx_rawstr(void);
 
 
 /* The suite initialization function.
@@ -204,12 +237,16 @@ int main(int argc, char * argv[]) {
         /* add the tests to the suite */
         if (false
                 || (NULL == CU_add_test(bxistr_suite, "test bxistr_apply_lines", test_bxistr_apply_lines))
+                || (NULL == CU_add_test(bxistr_suite, "test bxistr_apply_many_lines", test_bxistr_apply_many_lines))
                 || (NULL == CU_add_test(bxistr_suite, "test bxistr_prefix_lines", test_bxistr_prefix_lines))
                 || (NULL == CU_add_test(bxistr_suite, "test bxistr_join", test_bxistr_join))
                 || (NULL == CU_add_test(bxistr_suite, "test bxistr_rfind", test_bxistr_rfind))
                 || (NULL == CU_add_test(bxistr_suite, "test bxistr_count", test_bxistr_count))
                 || (NULL == CU_add_test(bxistr_suite, "test bxistr_mkshorter", test_bxistr_mkshorter))
                 || (NULL == CU_add_test(bxistr_suite, "test bxistr_hex", test_bxistr_hex))
+                || (NULL == CU_add_test(bxistr_suite, "test bxistr_builder", test_bxistr_builder))
+                || (NULL == CU_add_test(bxistr_suite, "test bxistr_simd", test_bxistr_simd))
+                || (NULL == CU_add_test(bxistr_suite, "test bxistr_format", test_bxistr_format))
                 || false) {
             CU_cleanup_registry();
             return (CU_get_error());
@@ -231,6 +268,16 @@ int main(int argc, char * argv[]) {
                 || (NULL == CU_add_test(bxierr_suite, "test bxierr", test_bxierr))
                 || (NULL == CU_add_test(bxierr_suite,
                                         "test bxierr_chain", test_bxierr_chain))
+                || (NULL == CU_add_test(bxierr_suite,
+                                        "test bxierr_backtrace", test_bxierr_backtrace))
+                || (NULL == CU_add_test(bxierr_suite,
+                                        "test bxierr_backtrace_cache",
+                                        test_bxierr_backtrace_cache))
+                || (NULL == CU_add_test(bxierr_suite,
+                                        "test bxierr_static_pooled",
+                                        test_bxierr_static_pooled))
+                || (NULL == CU_add_test(bxierr_suite,
+                                        "test bxierr_set", test_bxierr_set))
                                         || false) {
             CU_cleanup_registry();
             return (CU_get_error());
@@ -288,23 +335,46 @@ int main(int argc, char * argv[]) {
     /* add the tests to the suite */
     if (false
         || (NULL == CU_add_test(bxilog_suite, "test logger init", test_logger_init))
+        || (NULL == CU_add_test(bxilog_suite, "test logger handlers deadline", test_logger_handlers_deadline))
+        || (NULL == CU_add_test(bxilog_suite, "test logger handlers deadline expired", test_logger_handlers_deadline_expired))
+        || (NULL == CU_add_test(bxilog_suite, "test logger inline", test_logger_inline))
+        || (NULL == CU_add_test(bxilog_suite, "test logger inline signal", test_logger_inline_signal))
+        || (NULL == CU_add_test(bxilog_suite, "test logger stats", test_logger_stats))
+        || (NULL == CU_add_test(bxilog_suite, "test logger stats hanging", test_logger_stats_hanging))
+        || (NULL == CU_add_test(bxilog_suite, "test logger talkers", test_logger_talkers))
+        || (NULL == CU_add_test(bxilog_suite, "test logger histogram", test_logger_histogram))
         || (NULL == CU_add_test(bxilog_suite, "test logger existing file", test_logger_existing_file))
         || (NULL == CU_add_test(bxilog_suite, "test logger non existing file", test_logger_non_existing_file))
         || (NULL == CU_add_test(bxilog_suite, "test logger non existing dir", test_logger_non_existing_dir))
         || (NULL == CU_add_test(bxilog_suite, "test logger levels", test_logger_levels))
+        || (NULL == CU_add_test(bxilog_suite, "test logger compile level", test_logger_compile_level))
         || (NULL == CU_add_test(bxilog_suite, "test very long log", test_very_long_log))
         || (NULL == CU_add_test(bxilog_suite, "test strange log", test_strange_log))
         || (NULL == CU_add_test(bxilog_suite, "test single logger instance", test_single_logger_instance))
         || (NULL == CU_add_test(bxilog_suite, "test logger registry", test_registry))
+        || (NULL == CU_add_test(bxilog_suite, "test logger registry stress", test_registry_stress))
+        || (NULL == CU_add_test(bxilog_suite, "test logger registry fork", test_registry_fork))
         || (NULL == CU_add_test(bxilog_suite, "test logger filters parser", test_filters_parser))
         || (NULL == CU_add_test(bxilog_suite, "test logger filters same", test_filters_same))
         || (NULL == CU_add_test(bxilog_suite, "test logger filters distinct", test_filters_distinct))
         || (NULL == CU_add_test(bxilog_suite, "test logger filters simple", test_filters_simple))
         || (NULL == CU_add_test(bxilog_suite, "test logger filters symetric", test_filters_symetric))
         || (NULL == CU_add_test(bxilog_suite, "test logger filters complex", test_filters_complex))
+        || (NULL == CU_add_test(bxilog_suite, "test logger filters reconfigure", test_filters_reconfigure))
         || (NULL == CU_add_test(bxilog_suite, "test handlers", test_handlers))
+        || (NULL == CU_add_test(bxilog_suite, "test remote wire encoding", test_remote_wire))
+        || (NULL == CU_add_test(bxilog_suite, "test remote relay spool", test_remote_relay_spool))
+        || (NULL == CU_add_test(bxilog_suite, "test remote relay spool corrupted", test_remote_relay_spool_corrupted))
+        || (NULL == CU_add_test(bxilog_suite, "test remote receiver workers", test_remote_receiver_workers))
+        || (NULL == CU_add_test(bxilog_suite, "test remote mixed levels", test_remote_mixed_levels))
+        || (NULL == CU_add_test(bxilog_suite, "test logger cxx message", test_logger_cxx_message))
+        || (NULL == CU_add_test(bxilog_suite, "test logger cxx site", test_logger_cxx_site))
+        || (NULL == CU_add_test(bxilog_suite, "test logger cxx disabled", test_logger_cxx_disabled))
+        || (NULL == CU_add_test(bxilog_suite, "test logger cxx rawstr", test_logger_cxx_rawstr))
         || (NULL == CU_add_test(bxilog_suite, "test logger threads", test_logger_threads))
         || (NULL == CU_add_test(bxilog_suite, "test logger fork", test_logger_fork))
+        || (NULL == CU_add_test(bxilog_suite, "test logger fork quiesce", test_logger_fork_quiesce))
+        || (NULL == CU_add_test(bxilog_suite, "test logger fork quiesce busy", test_logger_fork_quiesce_busy))
 //        || (NULL == CU_add_test(bxilog_suite, "test logger signal", test_logger_signal))
 
         || false) {